@@ -38,9 +38,7 @@ struct cleri_grammar_s
 {
     cleri_t * start;
     pcre2_code * re_keywords;
-    pcre2_match_data * md_keywords;
     pcre2_code * re_whitespace;
-    pcre2_match_data * md_whitespace;
 };
 
 #endif /* CLERI_GRAMMAR_H_ */
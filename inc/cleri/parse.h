@@ -78,6 +78,10 @@ struct cleri_parse_s
     cleri_expecting_t * expecting;
     cleri_grammar_t * grammar;
     uint8_t * kwcache;
+    uint16_t * rxcache;
+    size_t rxcache_n;           /* number of positions in the rxcache */
+    pcre2_match_data * md;      /* match data for this parse only, this
+                                   allows parsing in multiple threads */
 };
 
 static inline cleri_parse_t * cleri_parse(
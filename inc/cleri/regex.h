@@ -10,6 +10,7 @@
 #include <stddef.h>
 #include <inttypes.h>
 #include <cleri/cleri.h>
+#include <cleri/rxscan.h>
 
 /* typedefs */
 typedef struct cleri_s cleri_t;
@@ -30,7 +31,7 @@ cleri_t * cleri_regex(uint32_t gid, const char * pattern);
 struct cleri_regex_s
 {
     pcre2_code * regex;
-    pcre2_match_data * match_data;
+    cleri_rxscan_t rxscan;      /* native scanner, or CLERI_RXSCAN_NONE */
 };
 
 #endif /* CLERI_REGEX_H_ */
\ No newline at end of file
@@ -0,0 +1,35 @@
+/*
+ * rxscan.h - native scanners for common regular expression terminals.
+ */
+#ifndef CLERI_RXSCAN_H_
+#define CLERI_RXSCAN_H_
+
+#include <sys/types.h>
+#include <inttypes.h>
+
+/* typedefs */
+typedef struct cleri_parse_s cleri_parse_t;
+
+/* enums */
+typedef enum cleri_rxscan_e {
+    CLERI_RXSCAN_NONE,          /* no native scanner, use pcre2 */
+    CLERI_RXSCAN_NAME,
+    CLERI_RXSCAN_INT,
+    CLERI_RXSCAN_FLOAT,
+    CLERI_RXSCAN_STRING,
+    CLERI_RXSCAN_REGEX,
+    CLERI_RXSCAN_PREOPR,
+    CLERI_RXSCAN_TEMPLATE,
+    CLERI_RXSCAN_END
+} cleri_rxscan_t;
+
+/* private functions */
+cleri_rxscan_t cleri__rxscan_kind(const char * pattern);
+ssize_t cleri__rxscan(cleri_rxscan_t kind, const char * str);
+ssize_t cleri__rxscan_match(
+        cleri_parse_t * pr,
+        cleri_rxscan_t kind,
+        const char * str);
+void cleri__rxscan_free(uint16_t * rxcache);
+
+#endif /* CLERI_RXSCAN_H_ */
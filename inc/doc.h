@@ -18,6 +18,7 @@
 #define DOC_BASE64_DECODE           DOC_SEE("collection-api/base64_decode")
 #define DOC_BASE64_ENCODE           DOC_SEE("collection-api/base64_encode")
 #define DOC_BOOL                    DOC_SEE("collection-api/bool")
+#define DOC_BULK_LOAD               DOC_SEE("collection-api/bulk_load")
 #define DOC_BYTES                   DOC_SEE("collection-api/bytes")
 #define DOC_CHANGE_ID               DOC_SEE("collection-api/change_id")
 #define DOC_CLOSURE                 DOC_SEE("collection-api/closure")
@@ -106,6 +107,7 @@
 #define DOC_NEW_TYPE                DOC_SEE("collection-api/new_type")
 #define DOC_NOW                     DOC_SEE("collection-api/now")
 #define DOC_NSE                     DOC_SEE("collection-api/nse")
+#define DOC_PROFILE                 DOC_SEE("collection-api/profile")
 #define DOC_RAISE                   DOC_SEE("collection-api/raise")
 #define DOC_RAND                    DOC_SEE("collection-api/rand")
 #define DOC_RANDINT                 DOC_SEE("collection-api/randint")
@@ -203,6 +205,8 @@
 #define DOC_PROCEDURES_INFO         DOC_SEE("procedures-api/procedures_info")
 #define DOC_RENAME_PROCEDURE        DOC_SEE("procedures-api/rename_procedure")
 #define DOC_RUN_PROCEDURE           DOC_SEE("procedures-api/run")
+#define DOC_SET_PROCEDURE_CACHE \
+    DOC_SEE("procedures-api/set_procedure_cache")
 
 /* Data Types */
 #define DOC_BYTES_LEN               DOC_SEE("data-types/bytes/len")
@@ -228,6 +232,7 @@
 #define DOC_LIST_CLEAR              DOC_SEE("data-types/list/clear")
 #define DOC_LIST_COPY               DOC_SEE("data-types/list/copy")
 #define DOC_LIST_COUNT              DOC_SEE("data-types/list/count")
+#define DOC_LIST_DIFFERENCE         DOC_SEE("data-types/list/difference")
 #define DOC_LIST_DUP                DOC_SEE("data-types/list/dup")
 #define DOC_LIST_EACH               DOC_SEE("data-types/list/each")
 #define DOC_LIST_EVERY              DOC_SEE("data-types/list/every")
@@ -241,6 +246,7 @@
 #define DOC_LIST_FLAT               DOC_SEE("data-types/list/flat")
 #define DOC_LIST_HAS                DOC_SEE("data-types/list/has")
 #define DOC_LIST_INDEX_OF           DOC_SEE("data-types/list/index_of")
+#define DOC_LIST_INTERSECTION       DOC_SEE("data-types/list/intersection")
 #define DOC_LIST_IS_UNIQUE          DOC_SEE("data-types/list/is_unique")
 #define DOC_LIST_JOIN               DOC_SEE("data-types/list/join")
 #define DOC_LIST_LAST               DOC_SEE("data-types/list/last")
@@ -31,8 +31,10 @@ ti_backup_t * ti_backup_create(
         uint64_t created_at,
         queue_t * files);
 _Bool ti_backup_is_gcloud(ti_backup_t * backup);
+_Bool ti_backup_is_incremental(ti_backup_t * backup);
 char * ti_backup_gcloud_task(ti_backup_t * backup);
 char * ti_backup_file_task(ti_backup_t * backup);
+char * ti_backup_incremental_task(ti_backup_t * backup);
 void ti_backup_destroy(ti_backup_t * backup);
 int ti_backup_info_to_pk(ti_backup_t * backup, msgpack_packer * pk);
 ti_val_t * ti_backup_as_mpval(ti_backup_t * backup);
@@ -44,12 +46,17 @@ struct ti_backup_s
     uint64_t next_run;      /* Next run, UNIX time-stamp in seconds */
     uint64_t repeat;        /* Repeat every X seconds */
     uint64_t created_at;    /* UNIX time-stamp in seconds */
-    char * fn_template;     /* {CHANGE_ID} {DATE} {TIME} */
+    char * fn_template;     /* {CHANGE_ID} {DATE} {TIME}, or a directory
+                               ending with a slash for incremental backups */
     char * result_msg;      /* last status message */
     ti_raw_t * work_fn;     /* current backup file name */
     queue_t * files;        /* ti_raw_t, successful files, size: >=max_files */
-    size_t max_files;       /* max files queue size */
+    size_t max_files;       /* max files queue size, or max snapshots */
+    uint64_t stream_id;     /* last change id in an incremental backup */
     _Bool scheduled;        /* true when the backup is scheduled to run */
+    _Bool new_chain;        /* true when an incremental backup must start
+                               with a new snapshot (for example after a
+                               restore) */
     int result_code;        /* last status code (0 = OK) */
 };
 
@@ -23,6 +23,8 @@ int ti_backups_store(void);
 size_t ti_backups_scheduled(void);
 size_t ti_backups_pending(void);
 _Bool ti_backups_require_away(void);
+uint64_t ti_backups_stream_id(void);
+void ti_backups_new_chains(void);
 ti_varr_t * ti_backups_info(void);
 _Bool ti_backups_ok(void);
 void ti_backups_del_backup(uint64_t backup_id, _Bool delete_files, ex_t * e);
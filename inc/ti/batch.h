@@ -0,0 +1,36 @@
+/*
+ * ti/batch.h
+ *
+ * A batch request contains many queries and procedure calls for the same
+ * scope. Queries without side effects run directly, in order, while all the
+ * queries in a batch with at least one query with side effects run together
+ * using a single change. The result is a single array with the result of
+ * each query at the same position as the query in the request. A query
+ * which has failed does not affect the other queries; the result for a
+ * failed query is packed as `{error_code, error_msg}`, equal to an error
+ * package.
+ */
+#ifndef TI_BATCH_H_
+#define TI_BATCH_H_
+
+#include <ex.h>
+#include <ti/batch.t.h>
+#include <ti/query.t.h>
+#include <ti/scope.t.h>
+#include <ti/stream.t.h>
+#include <ti/user.t.h>
+#include <util/mpack.h>
+
+int ti_batch_query(
+        ti_stream_t * stream,
+        ti_user_t * user,
+        ti_scope_t * scope,
+        mp_unp_t * up,
+        uint16_t pkg_id,
+        ex_t * e);
+void ti_batch_destroy(ti_batch_t * batch);
+void ti_batch_set_data(ti_batch_t * batch, uint16_t idx, ti_data_t * data);
+void ti_batch_set_err(ti_batch_t * batch, uint16_t idx, ex_t * e);
+void ti_batch_done(ti_batch_t * batch);
+
+#endif  /* TI_BATCH_H_ */
@@ -0,0 +1,31 @@
+/*
+ * ti/batch.t.h
+ */
+#ifndef TI_BATCH_T_H_
+#define TI_BATCH_T_H_
+
+/*
+ * The position of a query within a batch is stored as the package id of the
+ * query, so the number of queries in a batch must fit an uint16_t.
+ */
+#define TI_BATCH_MAX_QUERIES 8192
+
+typedef struct ti_batch_s ti_batch_t;
+
+#include <inttypes.h>
+#include <ti/data.h>
+#include <ti/query.t.h>
+#include <util/vec.h>
+
+struct ti_batch_s
+{
+    uint32_t n;                 /* number of queries in the batch */
+    uint32_t pending;           /* number of results still to receive, plus
+                                   one while the batch query is running */
+    ti_query_t * query;         /* the batch query, without reference */
+    vec_t * queries;            /* ti_query_t, queries waiting to run */
+    ti_data_t * results[];      /* packed result for each query, NULL when
+                                   the result is not yet received */
+};
+
+#endif  /* TI_BATCH_T_H_ */
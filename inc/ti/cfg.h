@@ -41,9 +41,29 @@ struct ti_cfg_s
                                            remove from cache. This check only
                                            takes place while in `away` mode.
                                        */
+    size_t regex_jit_stack_size;        /* maximum JIT stack size for regular
+                                           expressions, 0 disables JIT
+                                           compilation.
+                                        */
+    size_t threshold_parse_thread;      /* parse client queries with a length
+                                           equal or above this threshold on a
+                                           worker thread, 0 disables parsing
+                                           on worker threads.
+                                        */
+    size_t pack_cache_size;             /* maximum size in bytes for the
+                                           packed things in the pack cache
+                                           of each collection, 0 disables
+                                           the cache.
+                                        */
+    size_t procedure_cache_size;        /* maximum size in bytes for cached
+                                           procedure results, 0 disables the
+                                           cache.
+                                        */
     int ip_support;                    /* AF_UNSPEC / AF_INET / AF_INET6 */
     _Bool wait_for_modules;            /* wait for modules to load before
                                           listening to nodes and clients */
+    _Bool sync_compression;            /* compress data while synchronizing
+                                          the store to another node */
     char * node_name;
     char * bind_client_addr;
     char * bind_node_addr;
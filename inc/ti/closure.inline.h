@@ -10,6 +10,8 @@
 #include <ti/do.h>
 #include <ti/prop.h>
 #include <ti/query.h>
+#include <time.h>
+#include <util/util.h>
 
 static inline int ti_closure_do_statement(
         ti_closure_t * closure,
@@ -78,6 +80,23 @@ static inline void ti_closure_dec_future(ti_closure_t * closure)
     --closure->future_count;
 }
 
+/*
+ * Update the cumulative profile of a procedure closure with the time since
+ * `start`. The profile is not stored and resets when ThingsDB is restarted.
+ */
+static inline void ti_closure_upd_profile(
+        ti_closure_t * closure,
+        struct timespec * start)
+{
+    struct timespec end;
+
+    if (!closure->hist && !(closure->hist = hist_create()))
+        return;
+
+    clock_gettime(TI_CLOCK_MONOTONIC, &end);
+    hist_add(closure->hist, util_time_diff(start, &end));
+}
+
 static inline void ti_closure_unsafe_drop(ti_closure_t * closure)
 {
     if (!--closure->ref)
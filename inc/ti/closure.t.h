@@ -32,6 +32,7 @@ enum
 
 #include <cleri/cleri.h>
 #include <inttypes.h>
+#include <util/hist.h>
 #include <util/vec.h>
 
 /*
@@ -51,6 +52,8 @@ struct ti_closure_s
     vec_t * vars;               /* ti_prop_t - arguments */
     vec_t * stacked;            /* ti_val_t - stacked values */
     cleri_node_t * node;
+    hist_t * hist;              /* call latency, only for procedures and
+                                   NULL until the first call */
     uint32_t stack_pos[TI_CLOSURE_MAX_RECURSION_DEPTH];
 };
 
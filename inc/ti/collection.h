@@ -53,10 +53,13 @@ int ti_collection_unpack(
         ti_collection_t * collection,
         mp_unp_t * up,
         ex_t * e);
+int ti_collection_import_flags(mp_unp_t * up);
+void ti_collection_import_release(ti_collection_t * collection);
 void ti_collection_tasks_clear(ti_collection_t * collection);
 int ti_collection_load(
         ti_collection_t * collection,
         ti_raw_t * bytes,
         ex_t * e);
+void ti_collection_upd_hist(ti_collection_t * collection, double duration);
 
 #endif /* TI_COLLECTION_H_ */
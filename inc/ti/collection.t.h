@@ -10,12 +10,15 @@ typedef struct ti_collection_s  ti_collection_t;
 #include <inttypes.h>
 #include <ti/enums.t.h>
 #include <ti/commit.h>
+#include <ti/pcache.t.h>
 #include <ti/raw.t.h>
 #include <ti/thing.t.h>
 #include <ti/types.t.h>
 #include <ti/tz.h>
 #include <util/guid.h>
+#include <util/hist.h>
 #include <util/imap.h>
+#include <util/ptrmap.h>
 #include <util/queue.h>
 
 struct ti_collection_s
@@ -26,6 +29,8 @@ struct ti_collection_s
     uint64_t id;            /* collection Id (>= 2) */
     uint64_t next_free_id;
     uint64_t created_at;    /* UNIX time-stamp in seconds */
+    uint64_t change_id;     /* last change which touched the collection, used
+                               as version for cached procedure results */
     ti_tz_t * tz;
     ti_raw_t * name;
     ti_raw_t * scope;
@@ -43,6 +48,17 @@ struct ti_collection_s
     vec_t * futures;        /* no reference, type: ti_future_t */
     vec_t * vtasks;         /* tasks, type: ti_vtask_t */
     vec_t * commits;        /* migration changes ti_commit_t */
+    hist_t * hist_query;    /* query latency, NULL until the first query */
+    ptrmap_t * index;       /* property index for things with many
+                               properties, NULL until the first lookup; like
+                               the things, guarded by `lock` in away-mode */
+    uint64_t import_id;     /* Id of an unfinished streaming import, the
+                               things in the collection are kept until the
+                               import is finished or aborted; 0 if none */
+    ti_pcache_t * pcache;   /* packed things, NULL until a thing is packed
+                               or when the pack cache is disabled */
+    uint32_t pcache_gen;    /* packed things with another generation in the
+                               pack cache are invalid */
     guid_t guid;            /* derived from collection->id */
 };
 
@@ -11,13 +11,16 @@ extern ti_counters_t counters_;
 #include <inttypes.h>
 #include <sys/time.h>
 #include <ti/val.h>
+#include <util/hist.h>
 #include <util/mpack.h>
+#include <uv.h>
 
 int ti_counters_create(void);
 void ti_counters_destroy(void);
 void ti_counters_reset(void);
 double ti_counters_upd_commit_change(struct timespec * start);
 double ti_counters_upd_success_query(struct timespec * start);
+double ti_counters_upd_hist(hist_t * hist, struct timespec * start);
 int ti_counters_to_pk(msgpack_packer * pk);
 ti_val_t * ti_counters_as_mpval(void);
 
@@ -63,6 +66,26 @@ struct ti_counters_s
     uint64_t queries_from_cache;    /* number of queries which are loaded from
                                        cache.
                                     */
+    uint64_t regex_cache_hits;      /* number of regular expressions which are
+                                       loaded from cache instead of compiled.
+                                    */
+    uint64_t regex_jit_matches;     /* number of regular expression matches
+                                       using JIT compiled code.
+                                    */
+    uint64_t pack_cache_hits;       /* number of things which are packed
+                                       using data from the pack cache.
+                                    */
+    uint64_t pack_cache_misses;     /* number of things which are packed
+                                       while the pack cache is enabled, but
+                                       not found (or invalid) in the cache.
+                                    */
+    uint64_t procedure_cache_hits;  /* number of procedure calls which are
+                                       answered using a cached result.
+                                    */
+    uint64_t procedure_cache_misses;/* number of procedure calls with a
+                                       result cache enabled, but without a
+                                       valid result in the cache.
+                                    */
     /*
      * Both `garbage_collected` and `wasted_cache` may be accessed by multiple
      * threads at equal times.
@@ -87,6 +110,16 @@ struct ti_counters_s
                                        total_change_duration / changes_committed
                                         (in seconds)
                                     */
+    /*
+     * Latency histograms, exposed on the HTTP status port at `/metrics`.
+     */
+    hist_t hist_query;              /* successful queries */
+    hist_t hist_change;             /* committed changes */
+    hist_t hist_quorum;             /* quorum rounds for a change id */
+    hist_t hist_archive;            /* writing archived changes to disk */
+    hist_t hist_store;              /* full store to disk */
+    hist_t hist_gc;                 /* garbage collection, all collections */
+    uv_mutex_t hist_lock;           /* for histograms written by `away` */
 };
 
 #define ti_counters_garbage_collected() \
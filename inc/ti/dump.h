@@ -7,6 +7,28 @@
 #include <ti/raw.h>
 #include <ti/collection.h>
 
+typedef enum
+{
+    TI_DUMP_PHASE_HEAD,     /* enumerators, types, tasks and an empty root */
+    TI_DUMP_PHASE_THINGS,   /* the Id and type of all other things */
+    TI_DUMP_PHASE_DATA,     /* the data of all things, including the root */
+    TI_DUMP_PHASE_TAIL,     /* enum data, task arguments, relations,
+                               procedures and named rooms */
+    TI_DUMP_PHASE_DONE,
+} ti_dump_phase_t;
+
+typedef struct
+{
+    ti_dump_phase_t phase;
+    uint64_t thing_id;      /* continue with the things after this Id */
+    uint64_t change_id;     /* collection change Id when the export started */
+    uint64_t import_id;     /* random Id, carried by all segments */
+} ti_dump_cursor_t;
+
 ti_raw_t * ti_dump_collection(ti_collection_t * collection);
+ti_raw_t * ti_dump_segment(
+        ti_collection_t * collection,
+        ti_dump_cursor_t * cursor,
+        size_t size);
 
 #endif  /* TI_DUMP_H_ */
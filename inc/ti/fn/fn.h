@@ -31,6 +31,7 @@
 #include <ti/future.h>
 #include <ti/future.inline.h>
 #include <ti/gc.h>
+#include <ti/ibackup.h>
 #include <ti/item.h>
 #include <ti/item.t.h>
 #include <ti/member.h>
@@ -48,6 +49,7 @@
 #include <ti/nil.h>
 #include <ti/opr.h>
 #include <ti/procedures.h>
+#include <ti/profile.h>
 #include <ti/prop.h>
 #include <ti/qbind.h>
 #include <ti/query.inline.h>
@@ -68,6 +70,7 @@
 #include <ti/vbool.h>
 #include <ti/verror.h>
 #include <ti/vfloat.h>
+#include <ti/vhash.h>
 #include <ti/vint.h>
 #include <ti/vset.h>
 #include <ti/vset.inline.h>
@@ -82,6 +85,7 @@
 #include <util/buf.h>
 #include <util/cryptx.h>
 #include <util/fx.h>
+#include <util/jsonp.h>
 #include <util/mpjson.h>
 #include <util/rbuf.h>
 #include <util/strx.h>
@@ -0,0 +1,213 @@
+#include <ti/fn/fn.h>
+
+static void bulk__drop_vals(ti_val_t ** vals, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        ti_val_gc_drop(vals[i]);
+        vals[i] = NULL;
+    }
+}
+
+/*
+ * A record is either an array with a value for each field, in the order of
+ * the fields, or a map with field names and values. Missing fields in a map
+ * get the default value of the field.
+ */
+static ti_thing_t * bulk__record(
+        ti_type_t * type,
+        ti_vup_t * vup,
+        ti_val_t ** vals,
+        uint32_t idx,
+        ex_t * e)
+{
+    mp_obj_t obj, mp_key;
+    ti_val_t * val;
+    ti_field_t * field;
+    uint32_t n = type->fields->n;
+    ti_thing_t * thing = ti_thing_t_create(0, type, type->types->collection);
+    if (!thing)
+    {
+        ex_set_mem(e);
+        return NULL;
+    }
+
+    switch (mp_next(vup->up, &obj))
+    {
+    case MP_ARR:
+        if (obj.via.sz != n)
+        {
+            ex_set(e, EX_VALUE_ERROR,
+                    "record %"PRIu32" for type `%s` must have %"PRIu32" "
+                    "values but got %zu"DOC_BULK_LOAD,
+                    idx, type->name, n, obj.via.sz);
+            goto failed;
+        }
+        for (vec_each(type->fields, ti_field_t, field))
+        {
+            val = ti_val_from_vup_e(vup, e);
+            if (!val)
+                goto failed;
+            vals[field->idx] = val;
+            if (ti_field_make_assignable(field, &vals[field->idx], thing, e))
+                goto failed;
+        }
+        break;
+    case MP_MAP:
+        for (size_t i = obj.via.sz; i--;)
+        {
+            if (mp_next(vup->up, &mp_key) != MP_STR)
+            {
+                ex_set(e, EX_TYPE_ERROR,
+                        "record %"PRIu32" for type `%s` must have keys of "
+                        "type `"TI_VAL_STR_S"`"DOC_BULK_LOAD,
+                        idx, type->name);
+                goto failed;
+            }
+
+            field = ti_field_by_strn_e(
+                    type,
+                    mp_key.via.str.data,
+                    mp_key.via.str.n,
+                    e);
+            if (!field)
+                goto failed;
+
+            val = ti_val_from_vup_e(vup, e);
+            if (!val)
+                goto failed;
+
+            ti_val_gc_drop(vals[field->idx]);  /* last value wins */
+            vals[field->idx] = val;
+            if (ti_field_make_assignable(field, &vals[field->idx], thing, e))
+                goto failed;
+        }
+        for (vec_each(type->fields, ti_field_t, field))
+        {
+            if (vals[field->idx])
+                continue;
+            val = field->dval_cb(field);
+            if (!val)
+            {
+                ex_set_mem(e);
+                goto failed;
+            }
+            ti_val_attach(val, thing, field);
+            vals[field->idx] = val;
+        }
+        break;
+    default:
+        ex_set(e, EX_TYPE_ERROR,
+                "record %"PRIu32" for type `%s` must be an array or a map"
+                DOC_BULK_LOAD,
+                idx, type->name);
+        goto failed;
+    }
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        VEC_push(thing->items.vec, vals[i]);
+        vals[i] = NULL;
+    }
+    return thing;
+
+failed:
+    assert(e->nr);
+    bulk__drop_vals(vals, n);
+    ti_thing_cancel(thing);
+    return NULL;
+}
+
+/*
+ * Creates instances of a type directly from packed records, without first
+ * creating a thing for each record as `new(..)` would require. The new
+ * instances are returned as a list, attaching this list to the collection
+ * results in a single task containing all the instances.
+ */
+static int do__f_bulk_load(ti_query_t * query, cleri_node_t * nd, ex_t * e)
+{
+    const int nargs = fn_get_nargs(nd);
+    mp_unp_t up;
+    mp_obj_t obj;
+    ti_raw_t * raw;
+    ti_type_t * type;
+    ti_varr_t * varr;
+    ti_thing_t * thing;
+    ti_val_t ** vals;
+    ti_vup_t vup = {
+            .isclient = true,
+            .collection = query->collection,
+            .up = &up,
+    };
+
+    if (fn_not_collection_scope("bulk_load", query, e) ||
+        fn_nargs("bulk_load", DOC_BULK_LOAD, 2, nargs, e) ||
+        ti_do_statement(query, nd->children, e) ||
+        fn_arg_str("bulk_load", DOC_BULK_LOAD, 1, query->rval, e))
+        return e->nr;
+
+    type = ti_types_by_raw(query->collection->types, (ti_raw_t *) query->rval);
+    if (!type)
+        return ti_raw_err_not_found((ti_raw_t *) query->rval, "type", e);
+
+    if (ti_type_wrap_only_e(type, e))
+        return e->nr;
+
+    ti_val_unsafe_drop(query->rval);
+    query->rval = NULL;
+
+    if (ti_do_statement(query, nd->children->next->next, e))
+        return e->nr;
+
+    if (!ti_val_is_bytes(query->rval) && !ti_val_is_mpdata(query->rval))
+    {
+        ex_set(e, EX_TYPE_ERROR,
+            "function `bulk_load` expects argument 2 to be of "
+            "type `"TI_VAL_BYTES_S"` or `"TI_VAL_MPDATA_S"` "
+            "but got type `%s` instead"DOC_BULK_LOAD,
+            ti_val_str(query->rval));
+        return e->nr;
+    }
+
+    raw = (ti_raw_t *) query->rval;
+    mp_unp_init(&up, raw->data, raw->n);
+
+    if (mp_next(&up, &obj) != MP_ARR)
+    {
+        ex_set(e, EX_TYPE_ERROR,
+            "function `bulk_load` expects argument 2 to contain "
+            "an array with records"DOC_BULK_LOAD);
+        return e->nr;
+    }
+
+    vals = calloc(type->fields->n, sizeof(ti_val_t *));
+    varr = ti_varr_create(obj.via.sz);
+    if ((!vals && type->fields->n) || !varr)
+    {
+        ex_set_mem(e);
+        goto fail;
+    }
+
+    for (uint32_t i = 0; i < obj.via.sz; ++i)
+    {
+        thing = bulk__record(type, &vup, vals, i, e);
+        if (!thing)
+            goto fail;
+
+        if (ti_val_varr_append(varr, (ti_val_t **) &thing, e))
+        {
+            ti_val_unsafe_drop((ti_val_t *) thing);
+            goto fail;
+        }
+    }
+
+    free(vals);
+    ti_val_unsafe_drop(query->rval);
+    query->rval = (ti_val_t *) varr;
+    return e->nr;
+
+fail:
+    free(vals);
+    ti_val_drop((ti_val_t *) varr);
+    return e->nr;
+}
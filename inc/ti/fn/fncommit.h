@@ -42,6 +42,9 @@ static int do__f_commit(ti_query_t * query, cleri_node_t * nd, ex_t * e)
             ex_set(e, EX_OPERATION,
                 "function `commit` is not allowed in a task");
             goto fail0;
+        case TI_QUERY_WITH_BATCH:
+            ex_set_internal(e);  /* a batch query never runs code */
+            goto fail0;
     }
 
     if (!query->change)
@@ -0,0 +1,68 @@
+#include <ti/fn/fn.h>
+
+static int do__f_difference(ti_query_t * query, cleri_node_t * nd, ex_t * e)
+{
+    const int nargs = fn_get_nargs(nd);
+    ti_varr_t * varr, * other, * retv = NULL;
+    ti_vhash_t * vhash = NULL;
+
+    if (!ti_val_is_array(query->rval))
+        return fn_call_try("difference", query, nd, e);
+
+    if (fn_nargs("difference", DOC_LIST_DIFFERENCE, 1, nargs, e))
+        return e->nr;
+
+    varr = (ti_varr_t *) query->rval;
+    query->rval = NULL;
+
+    if (ti_do_statement(query, nd->children, e))
+        goto fail0;
+
+    if (!ti_val_is_array(query->rval))
+    {
+        ex_set(e, EX_TYPE_ERROR,
+                "function `difference` expects argument 1 to be of "
+                "type `"TI_VAL_LIST_S"` or type `"TI_VAL_TUPLE_S"` "
+                "but got type `%s` instead"
+                DOC_LIST_DIFFERENCE,
+                ti_val_str(query->rval));
+        goto fail0;
+    }
+
+    other = (ti_varr_t *) query->rval;
+    query->rval = NULL;
+
+    vhash = ti_vhash_create(other->vec->n);
+    retv = ti_varr_create(varr->vec->n);
+    if (!vhash || !retv)
+        goto fail1;
+
+    ti_varr_set_may_flags(retv, varr);
+
+    for (vec_each(other->vec, ti_val_t, v))
+        if (ti_vhash_add(vhash, v) < 0)
+            goto fail1;
+
+    for (vec_each(varr->vec, ti_val_t, v))
+    {
+        if (ti_vhash_has(vhash, v))
+            continue;
+        ti_incref(v);
+        VEC_push(retv->vec, v);
+    }
+
+    (void) vec_may_shrink(&retv->vec);
+    query->rval = (ti_val_t *) retv;
+    retv = NULL;
+    goto done;
+
+fail1:
+    ex_set_mem(e);
+done:
+    ti_val_drop((ti_val_t *) retv);
+    ti_vhash_destroy(vhash);
+    ti_val_unsafe_drop((ti_val_t *) other);
+fail0:
+    ti_val_unsafe_drop((ti_val_t *) varr);
+    return e->nr;
+}
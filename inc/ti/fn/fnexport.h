@@ -1,9 +1,14 @@
 #include <ti/fn/fn.h>
 
+#define EXPORT__SEGMENT_SIZE_DEF    4194304     /* 4 MiB */
+#define EXPORT__SEGMENT_SIZE_MIN    1024
+#define EXPORT__SEGMENT_SIZE_MAX    268435456   /* 256 MiB */
 
 typedef struct
 {
     _Bool * dump;
+    ti_val_t ** segment;        /* weak reference */
+    int64_t * segment_size;
     ex_t * e;
 } export__walk_t;
 
@@ -27,16 +32,198 @@ static int do__export_option(
         return 0;
     }
 
+    if (ti_raw_eq_strn(key, "segment", 7))
+    {
+        if (!ti_val_is_nil(val) && !ti_val_is_array(val))
+        {
+            ex_set(w->e, EX_TYPE_ERROR,
+                    "segment must be of type `"TI_VAL_NIL_S"` or "
+                    "`"TI_VAL_LIST_S"` but got type `%s` instead"DOC_EXPORT,
+                    ti_val_str(val));
+            return w->e->nr;
+        }
+        *w->segment = val;
+        return 0;
+    }
+
+    if (ti_raw_eq_strn(key, "segment_size", 12))
+    {
+        if (!ti_val_is_int(val))
+        {
+            ex_set(w->e, EX_TYPE_ERROR,
+                    "segment_size must be of type `"TI_VAL_INT_S"` but "
+                    "got type `%s` instead"DOC_EXPORT,
+                    ti_val_str(val));
+            return w->e->nr;
+        }
+        *w->segment_size = VINT(val);
+        if (*w->segment_size < EXPORT__SEGMENT_SIZE_MIN ||
+            *w->segment_size > EXPORT__SEGMENT_SIZE_MAX)
+        {
+            ex_set(w->e, EX_VALUE_ERROR,
+                    "segment_size must be a value between %d and %d (bytes)"
+                    DOC_EXPORT,
+                    EXPORT__SEGMENT_SIZE_MIN, EXPORT__SEGMENT_SIZE_MAX);
+            return w->e->nr;
+        }
+        return 0;
+    }
+
     ex_set(w->e, EX_VALUE_ERROR,
             "invalid export option `%.*s`"DOC_EXPORT, key->n, key->data);
 
     return w->e->nr;
 }
 
+/*
+ * The first segment is exported using `nil`, other segments with the `next`
+ * value of the previous segment; this value is a list with the phase, the
+ * last exported thing Id, the change Id of the collection and the import Id.
+ * The import Id is a random value which is carried by all segments so the
+ * import can reject segments of another export.
+ */
+static int export__cursor(
+        ti_val_t * val,
+        ti_dump_cursor_t * cursor,
+        ti_collection_t * collection,
+        ex_t * e)
+{
+    vec_t * vec;
+
+    if (ti_val_is_nil(val))
+    {
+        cursor->phase = TI_DUMP_PHASE_HEAD;
+        cursor->thing_id = 0;
+        cursor->change_id = collection->change_id;
+
+        util_get_random(&cursor->import_id, sizeof(uint64_t));
+        cursor->import_id &= INT64_MAX;
+        if (!cursor->import_id)
+            cursor->import_id = 1;
+        return 0;
+    }
+
+    vec = VARR(val);
+    if (vec->n != 4 ||
+        !ti_val_is_int(vec->data[0]) ||
+        !ti_val_is_int(vec->data[1]) ||
+        !ti_val_is_int(vec->data[2]) ||
+        !ti_val_is_int(vec->data[3]) ||
+        VINT(vec->data[0]) < TI_DUMP_PHASE_THINGS ||
+        VINT(vec->data[0]) > TI_DUMP_PHASE_TAIL ||
+        VINT(vec->data[1]) < 0 ||
+        VINT(vec->data[2]) < 0 ||
+        VINT(vec->data[3]) <= 0)
+    {
+        ex_set(e, EX_VALUE_ERROR,
+                "invalid segment; expecting `nil` for the first segment or "
+                "the value of `next` from the previous segment"DOC_EXPORT);
+        return e->nr;
+    }
+
+    cursor->phase = (ti_dump_phase_t) VINT(vec->data[0]);
+    cursor->thing_id = (uint64_t) VINT(vec->data[1]);
+    cursor->change_id = (uint64_t) VINT(vec->data[2]);
+    cursor->import_id = (uint64_t) VINT(vec->data[3]);
+
+    if (cursor->change_id != collection->change_id)
+        ex_set(e, EX_OPERATION,
+                "the collection has changed after the first segment was "
+                "exported; start again using `nil` as segment"DOC_EXPORT);
+
+    return e->nr;
+}
+
+static ti_val_t * export__next(ti_dump_cursor_t * cursor)
+{
+    ti_varr_t * varr;
+    ti_vint_t * vint;
+    int64_t values[4] = {
+            cursor->phase,
+            (int64_t) cursor->thing_id,
+            (int64_t) cursor->change_id,
+            (int64_t) cursor->import_id,
+    };
+
+    if (cursor->phase == TI_DUMP_PHASE_DONE)
+        return (ti_val_t *) ti_nil_get();
+
+    varr = ti_varr_create(4);
+    if (!varr)
+        return NULL;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        vint = ti_vint_create(values[i]);
+        if (!vint)
+        {
+            ti_val_unsafe_drop((ti_val_t *) varr);
+            return NULL;
+        }
+        VEC_push(varr->vec, vint);
+    }
+    return (ti_val_t *) varr;
+}
+
+/*
+ * Returns a thing with the segment as `data` and the value for the next
+ * segment as `next`. When `next` is `nil`, the export is complete.
+ */
+static int export__segment(
+        ti_query_t * query,
+        ti_val_t * segment,
+        int64_t segment_size,
+        ex_t * e)
+{
+    ti_dump_cursor_t cursor;
+    ti_thing_t * thing;
+    ti_name_t * name;
+    ti_val_t * val;
+
+    if (export__cursor(segment, &cursor, query->collection, e))
+        return e->nr;
+
+    ti_val_unsafe_drop(query->rval);
+    query->rval = NULL;
+
+    thing = ti_thing_o_create(0, 2, query->collection);
+    if (!thing)
+        goto fail0;
+
+    query->rval = (ti_val_t *) thing;
+
+    val = (ti_val_t *) ti_dump_segment(
+            query->collection,
+            &cursor,
+            (size_t) segment_size);
+    if (!val)
+        goto fail0;
+
+    name = (ti_name_t *) ti_val_data_name();
+    if (!ti_thing_p_prop_add(thing, name, val))
+        goto fail1;
+
+    val = export__next(&cursor);
+    name = ti_names_get("next", 4);
+    if (!val || !name || !ti_thing_p_prop_add(thing, name, val))
+        goto fail1;
+
+    return e->nr;
+
+fail1:
+    ti_name_drop(name);
+    ti_val_drop(val);
+fail0:
+    ex_set_mem(e);
+    return e->nr;
+}
+
 static int do__f_export(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 {
     const int nargs = fn_get_nargs(nd);
     _Bool dump = false;
+    ti_val_t * segment = NULL;
+    int64_t segment_size = EXPORT__SEGMENT_SIZE_DEF;
 
     if (fn_not_collection_scope("export", query, e) ||
         fn_nargs_max("export", DOC_EXPORT, 1, nargs, e))
@@ -54,14 +241,20 @@ static int do__f_export(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 
         export__walk_t w = {
                 .dump = &dump,
+                .segment = &segment,
+                .segment_size = &segment_size,
                 .e = e,
         };
 
         if (ti_thing_walk(thing, (ti_thing_item_cb) do__export_option, &w))
             return e->nr;
 
-        ti_val_unsafe_drop(query->rval);
-        query->rval = NULL;
+        /* the options are dropped after reading the segment */
+        if (!segment)
+        {
+            ti_val_unsafe_drop(query->rval);
+            query->rval = NULL;
+        }
     }
 
     if (query->change || query->futures.n)
@@ -71,6 +264,9 @@ static int do__f_export(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         return e->nr;
     }
 
+    if (segment)
+        return export__segment(query, segment, segment_size, e);
+
     query->rval = dump
             ? (ti_val_t *) ti_dump_collection(query->collection)
             : (ti_val_t *) ti_export_collection(query->collection);
@@ -5,6 +5,7 @@ static int do__f_extend_unique(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     const int nargs = fn_get_nargs(nd);
     uint32_t current_n, n = 0;
     ti_varr_t * varr_dest, * varr_source;
+    ti_vhash_t * vhash;
 
     if (!ti_val_is_list(query->rval))
         return fn_call_try("extend_unique", query, nd, e);
@@ -36,10 +37,23 @@ static int do__f_extend_unique(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     varr_source = (ti_varr_t *) query->rval;
     query->rval = NULL;
 
+    vhash = ti_vhash_create(current_n + varr_source->vec->n);
+    if (!vhash)
+        goto alloc_err;
+
+    for (vec_each(varr_dest->vec, ti_val_t, v))
+        if (ti_vhash_add(vhash, v) < 0)
+            goto alloc_err;
+
     for (vec_each(varr_source->vec, ti_val_t, v))
     {
-        if (ti_varr_has_val(varr_dest, v))
+        switch (ti_vhash_add(vhash, v))
+        {
+        case -1:
+            goto alloc_err;
+        case 1:
             continue;
+        }
 
         ti_incref(v);
         if (ti_val_varr_append(varr_dest, &v, e))
@@ -79,6 +93,7 @@ undo:
     (void) vec_shrink(&varr_dest->vec);
 
 done:
+    ti_vhash_destroy(vhash);
     ti_val_unsafe_drop((ti_val_t *) varr_source);
 
 fail1:
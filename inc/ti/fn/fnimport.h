@@ -32,17 +32,62 @@ static int do__import_option(
     return w->e->nr;
 }
 
+/*
+ * Abort an unfinished streaming import; things which are created by the
+ * import are no longer kept and will be removed by the garbage collector
+ * when they are not used.
+ */
+static int import__abort(ti_query_t * query, int nargs, ex_t * e)
+{
+    ti_task_t * task;
+    ti_collection_t * collection = query->collection;
+
+    if (nargs != 1)
+    {
+        ex_set(e, EX_NUM_ARGUMENTS,
+                "function `import` takes no options when aborting a "
+                "streaming import"DOC_IMPORT);
+        return e->nr;
+    }
+
+    if (!collection->import_id)
+    {
+        ex_set(e, EX_OPERATION,
+                "collection `%.*s` has no unfinished streaming import"
+                DOC_IMPORT,
+                collection->name->n, (char *) collection->name->data);
+        return e->nr;
+    }
+
+    task = ti_task_get_task(query->change, collection->root);
+    if (!task || ti_task_add_import_abort(task, collection->import_id))
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    ti_collection_import_release(collection);
+    return e->nr;  /* the return value is `nil` */
+}
+
 static int do__f_import(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 {
     const int nargs = fn_get_nargs(nd);
     _Bool import_tasks = false;
+    int flags;
+    mp_unp_t up;
     ti_task_t * task;
     ti_raw_t * bytes;
 
     if (fn_not_collection_scope("import", query, e) ||
         fn_nargs_range("import", DOC_IMPORT, 1, 2, nargs, e) ||
-        ti_do_statement(query, nd->children, e) ||
-        fn_arg_bytes("import", DOC_IMPORT, 1, query->rval, e))
+        ti_do_statement(query, nd->children, e))
+        return e->nr;
+
+    if (ti_val_is_nil(query->rval))
+        return import__abort(query, nargs, e);
+
+    if (fn_arg_bytes("import", DOC_IMPORT, 1, query->rval, e))
         return e->nr;
 
     bytes = (ti_raw_t *) query->rval;
@@ -78,8 +123,13 @@ static int do__f_import(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         goto fail0;
     }
 
-    /* check late as the arguments are parsed at this point */
-    if (ti_collection_check_empty(query->collection, e))
+    mp_unp_init(&up, bytes->data, bytes->n);
+    flags = ti_collection_import_flags(&up);
+
+    /* check late as the arguments are parsed at this point; only the first
+     * segment of a streaming export requires an empty collection */
+    if ((flags & TI_EXPORT_SEGMENT_FIRST) &&
+        ti_collection_check_empty(query->collection, e))
         goto fail0;
 
     switch(ti_collection_load(query->collection, bytes, e))
@@ -110,18 +160,23 @@ static int do__f_import(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         goto fail0;
     }
 
-    if (!import_tasks)
-    {
-        ti_collection_tasks_clear(query->collection);
-    }
-    else for (vec_each(query->collection->vtasks, ti_vtask_t, vtask))
+    /* tasks may be used by the data of a streaming export, thus the tasks
+     * are handled with the last segment */
+    if (flags & TI_EXPORT_SEGMENT_LAST)
     {
-        /* get ownership of all the tasks */
-        ti_user_drop(vtask->user);
-        vtask->user = query->user;
-        ti_incref(query->user);
-        if (ti_task_add_vtask_set_owner(task, vtask))
-            ex_set_mem(e);  /* task cleanup is not required */
+        if (!import_tasks)
+        {
+            ti_collection_tasks_clear(query->collection);
+        }
+        else for (vec_each(query->collection->vtasks, ti_vtask_t, vtask))
+        {
+            /* get ownership of all the tasks */
+            ti_user_drop(vtask->user);
+            vtask->user = query->user;
+            ti_incref(query->user);
+            if (ti_task_add_vtask_set_owner(task, vtask))
+                ex_set_mem(e);  /* task cleanup is not required */
+        }
     }
 
 fail0:
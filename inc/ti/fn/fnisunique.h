@@ -5,6 +5,7 @@ static int do__f_is_unique(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     const int nargs = fn_get_nargs(nd);
     _Bool is_unique = true;
     ti_varr_t * varr;
+    ti_vhash_t * vhash;
 
     if (!ti_val_is_array(query->rval))
         return fn_call_try("is_unique", query, nd, e);
@@ -13,21 +14,30 @@ static int do__f_is_unique(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         return e->nr;
 
     varr = (ti_varr_t *) query->rval;
-    for (vec_each_addr(varr->vec, ti_val_t, va))
+    vhash = ti_vhash_create(varr->vec->n);
+    if (!vhash)
     {
-        ti_val_t ** vp = (ti_val_t **) (varr->vec)->data;
-
-        for (; vp < va; vp++)
-            if (ti_opr_eq(*va, *vp))
-                break;
+        ex_set_mem(e);
+        return e->nr;
+    }
 
-        if (vp != va)
+    for (vec_each(varr->vec, ti_val_t, v))
+    {
+        int rc = ti_vhash_add(vhash, v);
+        if (rc < 0)
+        {
+            ti_vhash_destroy(vhash);
+            ex_set_mem(e);
+            return e->nr;
+        }
+        if (rc)
         {
             is_unique = false;
             break;
         }
     }
 
+    ti_vhash_destroy(vhash);
     ti_val_unsafe_drop(query->rval);
     query->rval = (ti_val_t *) ti_vbool_get(is_unique);
 
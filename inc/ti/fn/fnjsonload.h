@@ -1,263 +1,202 @@
 #include <ti/fn/fn.h>
 
+static ti_val_t * jload__val(
+        jsonp_t * jp,
+        jsonp_tp_t tp,
+        ti_collection_t * collection,
+        ex_t * e);
 
-typedef int (*jload__set_cb) (void *, ti_val_t *, ex_t *);
-
-static ti_raw_t * jload__key;
-
-typedef struct
-{
-    size_t deep;
-    ti_val_t * out;
-    void * parents[YAJL_MAX_DEPTH];
-    jload__set_cb callbacks[YAJL_MAX_DEPTH];
-    ex_t * e;
-    ti_collection_t * collection;
-} jload__convert_t;
-
-static int jload__root_cb(
-        jload__convert_t * parent,
-        ti_val_t * val,
-        ex_t * UNUSED(e))
+static void jload__set_err(jsonp_t * jp, ex_t * e)
 {
-    parent->out = val;
-    return 0;
-}
+    if (e->nr)
+        return;
 
-static int jload__array_cb(ti_varr_t * parent, ti_val_t * val, ex_t * e)
-{
-    if (ti_val_varr_append(parent, &val, e))
-        ti_val_unsafe_drop(val);
-    return e->nr;
-}
-
-static int jload__map_cb(ti_thing_t * parent, ti_val_t * val, ex_t * e)
-{
-    if (ti_thing_o_set(parent, jload__key, val))
+    switch (jp->err)
     {
+    case JSONP_ERR_NONE:
+        /* the parser accepted the token but it is not expected at this
+         * position, thus the JSON input is invalid */
+        ex_set(e, EX_VALUE_ERROR, "parse error: unexpected JSON token");
+        return;
+    case JSONP_ERR_SYNTAX:
+        ex_set(e, EX_VALUE_ERROR, "%s", jp->errmsg);
+        return;
+    case JSONP_ERR_MAX_DEPTH:
+        ex_set(e, EX_OPERATION, "JSON max depth exceeded");
+        return;
+    case JSONP_ERR_ALLOC:
         ex_set_mem(e);
-        ti_val_unsafe_drop(val);
-        return e->nr;
+        return;
     }
-    jload__key = NULL;
-    return 0;
-}
-
-static int jload__null(void * ctx)
-{
-    jload__convert_t * c = (jload__convert_t *) ctx;
-    ti_val_t * val = (ti_val_t *) ti_nil_get();
-    return 0 == c->callbacks[c->deep](c->parents[c->deep], val, c->e);
 }
 
-static int jload__boolean(void * ctx, int boolean)
+static ti_val_t * jload__map(
+        jsonp_t * jp,
+        ti_collection_t * collection,
+        ex_t * e)
 {
-    jload__convert_t * c = (jload__convert_t *) ctx;
-    ti_val_t * val = (ti_val_t *) ti_vbool_get(boolean);
-    return 0 == c->callbacks[c->deep](c->parents[c->deep], val, c->e);
-}
-
-static int jload__integer(void * ctx, long long i)
-{
-    jload__convert_t * c = (jload__convert_t *) ctx;
-    ti_val_t * val = (ti_val_t *) ti_vint_create(i);
-    if (!val)
-    {
-        ex_set_mem(c->e);
-        return 0;  /* failed */
-    }
-    return 0 == c->callbacks[c->deep](c->parents[c->deep], val, c->e);
-}
-
-static int jload__double(void * ctx, double d)
-{
-    jload__convert_t * c = (jload__convert_t *) ctx;
-    ti_val_t * val = (ti_val_t *) ti_vfloat_create(d);
-    if (!val)
+    jsonp_tp_t tp;
+    ti_raw_t * key;
+    ti_val_t * val;
+    ti_thing_t * thing = ti_thing_o_create(0, 7, collection);
+    if (!thing)
     {
-        ex_set_mem(c->e);
-        return 0;  /* failed */
+        ex_set_mem(e);
+        return NULL;
     }
-    return 0 == c->callbacks[c->deep](c->parents[c->deep], val, c->e);
-}
 
-static int jload__string(void * ctx, const unsigned char * s, size_t n)
-{
-    jload__convert_t * c = (jload__convert_t *) ctx;
-    ti_val_t * val = (ti_val_t *) ti_str_create((const char * ) s, n);
-    if (!val)
+    while ((tp = jsonp_next(jp)) == JSONP_KEY)
     {
-        ex_set_mem(c->e);
-        return 0;  /* failed */
-    }
-    return 0 == c->callbacks[c->deep](c->parents[c->deep], val, c->e);
-}
+        if (ti_is_reserved_key_strn(jp->str, jp->n))
+        {
+            ex_set(e, EX_VALUE_ERROR,
+                    "property `%c` is reserved"DOC_PROPERTIES,
+                    *jp->str);
+            goto fail;
+        }
 
-static int jload__start_map(void * ctx)
-{
-    jload__convert_t * c = (jload__convert_t *) ctx;
+        /* keys which are valid names are interned, like with MessagePack */
+        key = ti_name_is_valid_strn(jp->str, jp->n)
+            ? (ti_raw_t *) ti_names_get(jp->str, jp->n)
+            : ti_str_create(jp->str, jp->n);
+        if (!key)
+        {
+            ex_set_mem(e);
+            goto fail;
+        }
 
-    ti_val_t * val = (ti_val_t *) ti_thing_o_create(0, 7, c->collection);
-    if (!val)
-    {
-        ex_set_mem(c->e);
-        return 0;  /* failed */
+        val = jload__val(jp, jsonp_next(jp), collection, e);
+        if (!val || ti_thing_o_set(thing, key, val))
+        {
+            if (!e->nr)
+                ex_set_mem(e);
+            ti_val_drop(val);
+            ti_val_unsafe_drop((ti_val_t *) key);
+            goto fail;
+        }
     }
 
-    if (c->callbacks[c->deep](c->parents[c->deep], val, c->e))
-        return 0;  /* failed */
-
-    if (++c->deep >= YAJL_MAX_DEPTH)
-    {
-        ex_set(c->e, EX_OPERATION, "JSON max depth exceeded");
-        return 0;  /* error */
-    }
+    if (tp == JSONP_MAP_END)
+        return (ti_val_t *) thing;
 
-    c->parents[c->deep] = val;
-    c->callbacks[c->deep] = (jload__set_cb) jload__map_cb;
-    return 1;  /* success */
+    jload__set_err(jp, e);
+fail:
+    ti_val_unsafe_drop((ti_val_t *) thing);
+    return NULL;
 }
 
-static int jload__map_key(void * ctx, const unsigned char * s, size_t n)
+static ti_val_t * jload__arr(
+        jsonp_t * jp,
+        ti_collection_t * collection,
+        ex_t * e)
 {
-    jload__convert_t * c = (jload__convert_t *) ctx;
-
-    if (!strx_is_utf8n((const char *) s, n))
+    jsonp_tp_t tp;
+    ti_val_t * val;
+    ti_varr_t * varr = ti_varr_create(7);
+    if (!varr)
     {
-        ex_set(c->e, EX_VALUE_ERROR,
-                "properties must have valid UTF-8 encoding");
-        return 0;  /* failed */
+        ex_set_mem(e);
+        return NULL;
     }
 
-    if (ti_is_reserved_key_strn((const char *) s, n))
+    while ((tp = jsonp_next(jp)) != JSONP_ARR_END)
     {
-        ex_set(c->e, EX_VALUE_ERROR,
-                "property `%c` is reserved"DOC_PROPERTIES,
-                *s);
-        return 0;  /* failed */
-    }
+        val = jload__val(jp, tp, collection, e);
+        if (!val)
+            goto fail;
 
-    jload__key = ti_str_create((const char *) s, n);
-    if (!jload__key)
-    {
-        ex_set_mem(c->e);
-        return 0;  /* failed */
+        if (ti_val_varr_append(varr, &val, e))
+        {
+            ti_val_unsafe_drop(val);
+            goto fail;
+        }
     }
-    return 1;  /* success */
-}
+    return (ti_val_t *) varr;
 
-static int jload__end_map(void * ctx)
-{
-    jload__convert_t * c = (jload__convert_t *) ctx;
-    --c->deep;
-    return 1;  /* success */
+fail:
+    ti_val_unsafe_drop((ti_val_t *) varr);
+    return NULL;
 }
 
-static int jload__start_array(void * ctx)
+/*
+ * Values are created directly while reading the JSON tokens; nested maps
+ * and arrays are read recursively, the depth is limited by the parser.
+ */
+static ti_val_t * jload__val(
+        jsonp_t * jp,
+        jsonp_tp_t tp,
+        ti_collection_t * collection,
+        ex_t * e)
 {
-    jload__convert_t * c = (jload__convert_t *) ctx;
     ti_val_t * val;
 
-    val = (ti_val_t *) ti_varr_create(7);
-    if (!val)
-    {
-        ex_set_mem(c->e);
-        return 0;  /* failed */
-    }
-
-    if (c->callbacks[c->deep](c->parents[c->deep], val, c->e))
-        return 0;  /* failed */
-
-    if (++c->deep >= YAJL_MAX_DEPTH)
+    switch (tp)
     {
-        ex_set(c->e, EX_OPERATION, "JSON max depth exceeded");
-        return 0;  /* error */
+    case JSONP_NULL:
+        return (ti_val_t *) ti_nil_get();
+    case JSONP_TRUE:
+        return (ti_val_t *) ti_vbool_get(true);
+    case JSONP_FALSE:
+        return (ti_val_t *) ti_vbool_get(false);
+    case JSONP_INT:
+        val = (ti_val_t *) ti_vint_create(jp->via.i64);
+        break;
+    case JSONP_FLOAT:
+        val = (ti_val_t *) ti_vfloat_create(jp->via.f64);
+        break;
+    case JSONP_STR:
+        val = (ti_val_t *) ti_str_create(jp->str, jp->n);
+        break;
+    case JSONP_MAP_START:
+        return jload__map(jp, collection, e);
+    case JSONP_ARR_START:
+        return jload__arr(jp, collection, e);
+    case JSONP_ERR:
+    case JSONP_END:
+    case JSONP_KEY:
+    case JSONP_MAP_END:
+    case JSONP_ARR_END:
+        jload__set_err(jp, e);
+        return NULL;
     }
 
-    c->parents[c->deep] = val;
-    c->callbacks[c->deep] = (jload__set_cb) jload__array_cb;
-    return 1;  /* success */
-}
-
-static int jload__end_array(void * ctx)
-{
-    jload__convert_t * c = (jload__convert_t *) ctx;
-    --c->deep;
-    return 1;  /* success */
+    if (!val)
+        ex_set_mem(e);
+    return val;
 }
 
-static yajl_callbacks jload__callbacks = {
-    jload__null,
-    jload__boolean,
-    jload__integer,
-    jload__double,
-    NULL,
-    jload__string,
-    jload__start_map,
-    jload__map_key,
-    jload__end_map,
-    jload__start_array,
-    jload__end_array
-};
-
 static int do__f_json_load(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 {
     const int nargs = fn_get_nargs(nd);
-
-    yajl_handle hand;
-    yajl_status stat = yajl_status_error;
-    jload__convert_t ctx = {0};
+    jsonp_t jp;
+    jsonp_tp_t tp;
     ti_raw_t * raw;
-
-    ctx.collection = query->collection;
-    ctx.e = e;
-    ctx.callbacks[0] = (jload__set_cb) jload__root_cb;
-    ctx.parents[0] = &ctx;
+    ti_val_t * val;
 
     if (fn_nargs("json_load", DOC_JSON_LOAD, 1, nargs, e) ||
         ti_do_statement(query, nd->children, e) ||
         fn_arg_str("json_load", DOC_JSON_LOAD, 1, query->rval, e))
         return e->nr;
 
-    hand = yajl_alloc(&jload__callbacks, NULL, &ctx);
-    if (!hand)
-    {
-        ex_set_mem(e);
-        return e->nr;
-    }
-
     raw = (ti_raw_t *) query->rval;
-    stat = yajl_parse(hand, raw->data, raw->n);
+    jsonp_init(&jp, raw->data, raw->n);
+
+    tp = jsonp_next(&jp);
+    val = tp == JSONP_END
+        ? (ti_val_t *) ti_nil_get()
+        : jload__val(&jp, tp, query->collection, e);
 
-    if (stat == yajl_status_ok)
+    if (val && jsonp_next(&jp) != JSONP_END)
     {
-        ti_val_unsafe_drop(query->rval);
-        query->rval = ctx.out ? ctx.out : (ti_val_t *) ti_nil_get();
+        jload__set_err(&jp, e);
+        ti_val_unsafe_drop(val);
     }
-    else
+    else if (val)
     {
-        if (e->nr == 0)
-        {
-            static const int verbose = 0;
-            unsigned char * yerr = yajl_get_error(
-                    hand,
-                    verbose,
-                    raw->data,
-                    raw->n);
-            if (yerr)
-            {
-                ex_sets(e, EX_VALUE_ERROR, (const char *) yerr);
-                yajl_free_error(hand, yerr);
-            }
-            else
-                ex_set_mem(e);
-        }
-
-        ti_val_drop(ctx.out);
-        free(jload__key);
-        jload__key = NULL;
+        ti_val_unsafe_drop(query->rval);
+        query->rval = val;
     }
 
-    yajl_free(hand);
+    jsonp_clear(&jp);
     return e->nr;
 }
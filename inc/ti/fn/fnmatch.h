@@ -15,14 +15,7 @@ static int do__f_match_all(
         ex_set_mem(e);
         return e->nr;
     }
-    while ((rc = pcre2_match(
-            regex->code,
-            (PCRE2_SPTR8) vstr->data,
-            vstr->n,
-            pos,                    /* start looking at this point */
-            0,                      /* OPTIONS */
-            regex->match_data,
-            NULL)) >= 0)
+    while ((rc = ti_regex_match(regex, vstr, pos)) >= 0)
     {
         ti_raw_t * substr;
         PCRE2_SIZE * ovector = pcre2_get_ovector_pointer(regex->match_data);
@@ -86,14 +79,7 @@ static int do__f_match(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         (void) do__f_match_all(query, regex, vstr, e);
         goto done;  /* in case of failure, the error is set */
     }
-    rc = pcre2_match(
-            regex->code,
-            (PCRE2_SPTR8) vstr->data,
-            vstr->n,
-            0,                     /* start looking at this point */
-            0,                     /* OPTIONS */
-            regex->match_data,
-            NULL);
+    rc = ti_regex_match(regex, vstr, 0);
 
     if (rc < 0)
     {
@@ -13,6 +13,7 @@ static int do__f_new_backup(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     ti_raw_t * tar_gz_str = (ti_raw_t *) ti_val_borrow_tar_gz_str();
     ti_raw_t * gs_str = (ti_raw_t *) ti_val_borrow_gs_str();
     queue_t * files_queue;
+    _Bool is_incremental;
 
     if (fn_not_node_scope("new_backup", query, e) ||
         ti_access_check_err(ti.access_node, query->user, TI_AUTH_CHANGE, e) ||
@@ -25,17 +26,29 @@ static int do__f_new_backup(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     query->rval = NULL;
 
 
-    if (!ti_raw_endswith(rname, tar_gz_str))
+    is_incremental = rname->n && rname->data[rname->n-1] == '/';
+
+    if (!is_incremental && !ti_raw_endswith(rname, tar_gz_str))
     {
         /* The ti_backup_is_gcloud() function depends on a filename size of at
-         * least 5 characters, this ensures 7 characters;
+         * least 5 characters, this ensures 7 characters; A directory for an
+         * incremental backup ends with a slash, which is safe as well.
          */
         ex_set(e, EX_VALUE_ERROR,
-            "expecting a backup file-name to end with `%.*s`"
+            "expecting a backup file-name to end with `%.*s` or a directory "
+            "to end with `/` for an incremental backup"
             DOC_NEW_BACKUP, tar_gz_str->n, (char *) tar_gz_str->data);
         goto fail0;
     }
 
+    if (is_incremental && ti_raw_startswith(rname, gs_str))
+    {
+        ex_set(e, EX_VALUE_ERROR,
+            "incremental backups are not supported with Google Cloud storage"
+            DOC_NEW_BACKUP);
+        goto fail0;
+    }
+
     if (ti_raw_startswith(rname, gs_str) && !ti.cfg->gcloud_key_file)
     {
         ex_set(e, EX_OPERATION,
@@ -0,0 +1,73 @@
+#include <ti/fn/fn.h>
+
+static int do__f_profile(ti_query_t * query, cleri_node_t * nd, ex_t * e)
+{
+    const int nargs = fn_get_nargs(nd);
+    struct timespec start;
+    struct timespec end;
+    ti_profile_t * profile, * prev = query->profile;
+    ti_val_t * f, * p;
+    ti_thing_t * t;
+
+    if (fn_nargs("profile", DOC_PROFILE, 1, nargs, e))
+        return e->nr;
+
+    profile = ti_profile_create("", 0);
+    if (!profile)
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    query->profile = profile;
+    clock_gettime(TI_CLOCK_MONOTONIC, &start);
+
+    (void) ti_do_statement(query, nd->children, e);
+
+    clock_gettime(TI_CLOCK_MONOTONIC, &end);
+    query->profile = prev;
+
+    if (e->nr)
+        goto done;
+
+    f = (ti_val_t *) ti_vfloat_create(util_time_diff(&start, &end));
+    if (!f)
+        goto fail0;
+
+    p = ti_profile_as_mpval(profile);
+    if (!p)
+        goto fail1;
+
+    t = ti_thing_o_create(0, 3, query->collection);
+    if (!t)
+        goto fail2;
+
+    if (!ti_thing_p_prop_add(t, (ti_name_t *) ti_val_data_name(), query->rval))
+        goto fail3;  /* leaks data name reference */
+
+    query->rval = (ti_val_t *) t;
+
+    if (!ti_thing_p_prop_add(t, (ti_name_t *) ti_val_time_name(), f))
+        goto fail2;  /* skip fail3 now, leaks time name reference */
+
+    if (!ti_thing_p_prop_add(t, (ti_name_t *) ti_val_profile_name(), p))
+    {
+        ex_set_mem(e);  /* leaks profile name reference */
+        ti_val_unsafe_drop(p);
+        goto done;
+    }
+
+    goto done;
+
+fail3:
+    ti_val_unsafe_drop((ti_val_t *) t);
+fail2:
+    ti_val_unsafe_drop(p);
+fail1:
+    ti_val_unsafe_drop(f);
+fail0:
+    ex_set_mem(e);
+done:
+    ti_profile_destroy(profile);
+    return e->nr;
+}
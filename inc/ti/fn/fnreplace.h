@@ -289,14 +289,7 @@ int replacersn(
     buf_t buf;
     buf_init(&buf);
 
-    while (n-- && (rc = pcre2_match(
-            regex->code,
-            (PCRE2_SPTR8) vstr->data,
-            vstr->n,
-            pos,                   /* start looking at this point */
-            0,                     /* OPTIONS */
-            regex->match_data,
-            NULL)) >= 0)
+    while (n-- && (rc = ti_regex_match(regex, vstr, pos)) >= 0)
     {
        PCRE2_SIZE * ovector = pcre2_get_ovector_pointer(regex->match_data);
 
@@ -349,17 +342,15 @@ int replacercn(
         ti_closure_inc(closure, query, e))
         goto fail0;
 
-    while (n-- && (rc = pcre2_match(
-            regex->code,
-            (PCRE2_SPTR8) vstr->data,
-            vstr->n,
-            pos,                   /* start looking at this point */
-            0,                     /* OPTIONS */
-            regex->match_data,
-            NULL)) >= 0)
+    while (n-- && (rc = ti_regex_match(regex, vstr, pos)) >= 0)
     {
         ti_raw_t * new;
         PCRE2_SIZE * ovector = pcre2_get_ovector_pointer(regex->match_data);
+        /*
+         * Compiled expressions are shared, so the closure might use the same
+         * match data; therefore read the end of the match before the call.
+         */
+        PCRE2_SIZE end = ovector[1];
 
         if (buf_append(&buf, s + pos, ovector[0] - pos) ||
             ti_closure_vars_replace_regex(closure, vstr, ovector, rc))
@@ -392,9 +383,9 @@ int replacercn(
         ti_val_unsafe_drop(query->rval);
         query->rval = NULL;
 
-        if (pos == ovector[1])
+        if (pos == end)
             break;
-        pos = ovector[1];
+        pos = end;
     }
 
     if (buf_append(&buf, s + pos, vstr->n - pos))
@@ -4,6 +4,7 @@ typedef struct
 {
     _Bool * take_access;
     _Bool * restore_tasks;
+    uint64_t * change_id;
     ex_t * e;
 } restore__walk_t;
 
@@ -41,6 +42,27 @@ static int do__restore_option(
 
     }
 
+    if (ti_raw_eq_strn(key, "change_id", 9))
+    {
+        if (!ti_val_is_int(val))
+        {
+            ex_set(w->e, EX_TYPE_ERROR,
+                    "change_id must be of type `"TI_VAL_INT_S"` but "
+                    "got type `%s` instead"DOC_RESTORE,
+                    ti_val_str(val));
+            return w->e->nr;
+        }
+        if (VINT(val) < 1)
+        {
+            ex_set(w->e, EX_VALUE_ERROR,
+                    "change_id must be an integer value greater than "
+                    "or equal to 1"DOC_RESTORE);
+            return w->e->nr;
+        }
+        *w->change_id = (uint64_t) VINT(val);
+        return 0;
+    }
+
     ex_set(w->e, EX_VALUE_ERROR,
             "invalid restore option `%.*s`"DOC_RESTORE, key->n, key->data);
 
@@ -50,9 +72,11 @@ static int do__restore_option(
 static int do__f_restore(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 {
     const int nargs = fn_get_nargs(nd);
-    char * restore_task;
+    char * restore_task = NULL;
     _Bool take_access = false;
     _Bool restore_tasks = false;
+    _Bool is_incremental;
+    uint64_t change_id = 0;  /* 0 restores the last change in a backup */
     uint32_t n;
     uint64_t ccid, scid;
     ti_task_t * task;
@@ -84,6 +108,7 @@ static int do__f_restore(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         restore__walk_t w = {
                 .take_access = &take_access,
                 .restore_tasks = &restore_tasks,
+                .change_id = &change_id,
                 .e = e,
         };
 
@@ -124,14 +149,37 @@ static int do__f_restore(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         goto fail0;
     }
 
-    if (ti_restore_chk((const char *) rname->data, rname->n, e))
-        goto fail0;
+    /* a directory ending with a slash is an incremental backup */
+    is_incremental = rname->n && rname->data[rname->n-1] == '/';
 
-    restore_task = ti_restore_task((const char *) rname->data, rname->n);
-    if (!restore_task)
+    if (is_incremental)
     {
-        ex_set_mem(e);
-        goto fail1;
+        if (ti_ibackup_restore_chk(
+                (const char *) rname->data,
+                rname->n,
+                change_id,
+                e))
+            goto fail0;
+    }
+    else
+    {
+        if (change_id)
+        {
+            ex_set(e, EX_VALUE_ERROR,
+                    "option `change_id` requires an incremental backup; "
+                    "expecting a directory ending with `/`"DOC_RESTORE);
+            goto fail0;
+        }
+
+        if (ti_restore_chk((const char *) rname->data, rname->n, e))
+            goto fail0;
+
+        restore_task = ti_restore_task((const char *) rname->data, rname->n);
+        if (!restore_task)
+        {
+            ex_set_mem(e);
+            goto fail1;
+        }
     }
 
     /* check for tasks in the @thingsdb scope, bug #249 */
@@ -248,11 +296,18 @@ static int do__f_restore(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     }
 
     /*
-     * Unpacking is "reasonable" tested by `ti_restore_chk(..)` so at this
-     * point, unpacking the tar file is not expected to fail unless there is
-     * not enough disk space or other serious error.
+     * Unpacking is "reasonable" tested by `ti_restore_chk(..)` or
+     * `ti_ibackup_restore_chk(..)` so at this point, restoring the backup is
+     * not expected to fail unless there is not enough disk space or other
+     * serious error.
      */
-    if (ti_restore_unp(restore_task, e))
+    if (is_incremental
+            ? ti_ibackup_restore(
+                    (const char *) rname->data,
+                    rname->n,
+                    change_id,
+                    e)
+            : ti_restore_unp(restore_task, e))
         goto fail1;
 
     if (ti_restore_master(take_access ? query->user : NULL, restore_tasks))
@@ -9,6 +9,7 @@ static int do__f_run(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     ti_closure_t * closure;
     vec_t * args;
     size_t n;
+    struct timespec start;
     cleri_node_t * child = nd->children;    /* first in argument list */
 
     if (fn_not_thingsdb_or_collection_scope("run", query, e) ||
@@ -47,7 +48,9 @@ static int do__f_run(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     while (n--)
         VEC_push(args, ti_nil_get());
 
+    clock_gettime(TI_CLOCK_MONOTONIC, &start);
     (void) ti_closure_call(closure, query, args, e);
+    ti_closure_upd_profile(closure, &start);
 
 failed:
     ti_val_unsafe_drop((ti_val_t *) closure);
@@ -0,0 +1,78 @@
+#include <ti/fn/fn.h>
+
+static int do__f_set_procedure_cache(
+        ti_query_t * query,
+        cleri_node_t * nd,
+        ex_t * e)
+{
+    const int nargs = fn_get_nargs(nd);
+    int64_t ttl;
+    ti_task_t * task;
+    ti_procedure_t * procedure;
+    smap_t * procedures = ti_query_procedures(query);
+
+    if (fn_not_thingsdb_or_collection_scope("set_procedure_cache", query, e) ||
+        fn_commit("set_procedure_cache", query, e) ||
+        fn_nargs("set_procedure_cache", DOC_SET_PROCEDURE_CACHE, 2, nargs, e) ||
+        ti_do_statement(query, nd->children, e) ||
+        fn_arg_str(
+                "set_procedure_cache",
+                DOC_SET_PROCEDURE_CACHE,
+                1,
+                query->rval,
+                e))
+        return e->nr;
+
+    procedure = ti_procedures_by_name(procedures, (ti_raw_t *) query->rval);
+    if (!procedure)
+        return ti_raw_err_not_found((ti_raw_t *) query->rval, "procedure", e);
+
+    ti_val_unsafe_drop(query->rval);
+    query->rval = NULL;
+
+    if (ti_do_statement(query, nd->children->next->next, e) ||
+        fn_arg_int(
+                "set_procedure_cache",
+                DOC_SET_PROCEDURE_CACHE,
+                2,
+                query->rval,
+                e))
+        return e->nr;
+
+    ttl = VINT(query->rval);
+    if (ttl < 0 || ttl > UINT32_MAX)
+    {
+        ex_set(e, EX_VALUE_ERROR,
+                "function `set_procedure_cache` expects argument 2 to be "
+                "a value between 0 and %"PRIu32" (seconds)"
+                DOC_SET_PROCEDURE_CACHE,
+                UINT32_MAX);
+        return e->nr;
+    }
+
+    if (ttl && (procedure->closure->flags & TI_CLOSURE_FLAG_WSE))
+    {
+        ex_set(e, EX_OPERATION,
+                "procedure `%s` has side effects; only the results of "
+                "procedures without side effects can be cached"
+                DOC_SET_PROCEDURE_CACHE,
+                procedure->name->str);
+        return e->nr;
+    }
+
+    ti_val_unsafe_drop(query->rval);
+    query->rval = (ti_val_t *) ti_nil_get();
+
+    if (procedure->cache_ttl == (uint32_t) ttl)
+        return e->nr;
+
+    ti_procedure_set_cache_ttl(procedure, (uint32_t) ttl);
+
+    task = ti_task_get_task(
+            query->change,
+            query->collection ? query->collection->root : ti.thing0);
+    if (!task || ti_task_add_set_procedure_cache(task, procedure))
+        ex_set_mem(e);  /* task cleanup is not required */
+
+    return e->nr;
+}
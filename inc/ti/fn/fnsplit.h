@@ -148,14 +148,7 @@ ti_varr_t * splitrn(ti_raw_t * vstr, ti_regex_t * regex, ti_vint_t * vnum)
     if (!varr)
         return NULL;
 
-    while (n-- && (rc = pcre2_match(
-            regex->code,
-            (PCRE2_SPTR8) vstr->data,
-            vstr->n,
-            pos,                   /* start looking at this point */
-            0,                     /* OPTIONS */
-            regex->match_data,
-            NULL)) >= 0)
+    while (n-- && (rc = ti_regex_match(regex, vstr, pos)) >= 0)
     {
         size_t i = 1, j = 0, sz = rc;
         PCRE2_SIZE * ovector = pcre2_get_ovector_pointer(regex->match_data);
@@ -133,7 +133,7 @@ static int do__f_task(ti_query_t * query, cleri_node_t * nd, ex_t * e)
                 NULL,
                 args);
 
-        if (!vtask || ti_tasks_append(tasks, vtask))
+        if (!vtask || ti_tasks_append(tasks, vtask, query->collection))
         {
             ex_set_mem(e);
             goto fail3;
@@ -4,6 +4,7 @@ static int do__f_unique(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 {
     const int nargs = fn_get_nargs(nd);
     ti_varr_t * varr, * retv;
+    ti_vhash_t * vhash;
 
     if (!ti_val_is_array(query->rval))
         return fn_call_try("unique", query, nd, e);
@@ -13,36 +14,36 @@ static int do__f_unique(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 
     varr = (ti_varr_t*) query->rval;
 
+    vhash = ti_vhash_create(varr->vec->n);
     retv = ti_varr_create(varr->vec->n);
-    if (!retv)
-    {
-        ex_set_mem(e);
-        return e->nr;
-    }
+    if (!retv || !vhash)
+        goto fail;
 
     ti_varr_set_may_flags(retv, varr);
 
-    for (vec_each_addr(varr->vec, ti_val_t, va))
+    for (vec_each(varr->vec, ti_val_t, v))
     {
-        ti_val_t
-            ** vp = (ti_val_t **) (retv->vec)->data,
-            ** ve = vp + (retv->vec)->n;
-
-        for (;vp < ve; vp++)
-            if (ti_opr_eq(*va, *vp))
-                break;
-
-        if (vp == ve)
+        switch (ti_vhash_add(vhash, v))
         {
-            ti_incref(*va);
-            VEC_push(retv->vec, *va);
+        case -1:
+            goto fail;
+        case 0:
+            ti_incref(v);
+            VEC_push(retv->vec, v);
         }
     }
 
+    ti_vhash_destroy(vhash);
     (void) vec_may_shrink(&retv->vec);
 
     ti_val_unsafe_drop(query->rval);
     query->rval = (ti_val_t *) retv;
 
     return e->nr;
+
+fail:
+    ti_vhash_destroy(vhash);
+    ti_val_drop((ti_val_t *) retv);
+    ex_set_mem(e);
+    return e->nr;
 }
@@ -9,10 +9,13 @@ typedef struct ti_future_s ti_future_t;
 #define VFUT(__v) ((ti_future_t *) (__v))->rval
 
 #include <inttypes.h>
+#include <ti/module.t.h>
+#include <ti/proc.t.h>
 #include <ti/query.t.h>
 #include <ti/val.t.h>
 #include <ti/closure.t.h>
 #include <ti/module.h>
+#include <util/util.h>
 #include <util/vec.h>
 
 struct ti_future_s
@@ -28,6 +31,9 @@ struct ti_future_s
     ti_pkg_t * pkg;
     ti_module_t * module;   /* with an extra reference */
     vec_t * args;           /* NULL when the future is not registered */
+    ti_proc_t * proc;       /* module worker, only while waiting for the
+                               response from this worker */
+    util_time_t sent_at;    /* time the request is written to the worker */
 };
 
 #endif  /* TI_FUTURE_T_H_ */
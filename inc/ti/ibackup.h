@@ -0,0 +1,30 @@
+/*
+ * ti/ibackup.h
+ */
+#ifndef TI_IBACKUP_H_
+#define TI_IBACKUP_H_
+
+#include <ex.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <util/buf.h>
+
+int ti_ibackup_run(
+        const char * path,
+        size_t max_snapshots,
+        _Bool new_chain,
+        uint64_t * change_id,
+        buf_t * buf);
+int ti_ibackup_restore_chk(
+        const char * fn,
+        size_t n,
+        uint64_t change_id,
+        ex_t * e);
+int ti_ibackup_restore(
+        const char * fn,
+        size_t n,
+        uint64_t change_id,
+        ex_t * e);
+
+#endif  /* TI_IBACKUP_H_ */
@@ -1,21 +1,28 @@
 /*
  * ti/map.h
+ *
+ * A map is the compiled plan for wrapping instances of a `from` type into a
+ * `to` type. Maps are created once and cached on the `to` type, see
+ * ti_type_map(), and are removed when one of both types is changed.
  */
 #ifndef TI_MAP_H_
 #define TI_MAP_H_
 
 typedef struct ti_map_s ti_map_t;
 
-#include <util/vec.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <ti/mapping.h>
+#include <ti/type.t.h>
 
-ti_map_t * ti_map_new(vec_t * mappings);
+ti_map_t * ti_map_new(ti_type_t * t_type, ti_type_t * f_type);
 void ti_map_destroy(ti_map_t * map);
 
 struct ti_map_s
 {
-    vec_t * mappings;  /* ti_mapping_t */
-    bool can_skip;   /* true when size might be less */
+    uint32_t n;                 /* number of mappings */
+    bool can_skip;              /* true when size might be less */
+    ti_mapping_t mappings[];    /* in the order of the `to` type fields */
 };
 
 #endif  /* TI_MAP_H_ */
@@ -6,14 +6,26 @@
 
 typedef struct ti_mapping_s ti_mapping_t;
 
-#include <ti/field.h>
+#include <stdint.h>
+#include <ti/field.t.h>
+#include <ti/name.t.h>
 
-ti_mapping_t * ti_mapping_new(ti_field_t * t_field, ti_field_t * f_field);
+void ti_mapping_init(
+        ti_mapping_t * mapping,
+        ti_field_t * t_field,
+        ti_field_t * f_field);
 
+/*
+ * A mapping is one compiled step of a wrap plan; everything required to copy
+ * a property from the `from` type to the `to` type is stored in the mapping
+ * so packing does not need to look at the `from` field.
+ */
 struct ti_mapping_s
 {
-    ti_field_t * t_field;  /* weak reference */
-    ti_field_t * f_field;  /* weak reference */
+    ti_field_t * t_field;   /* weak reference */
+    ti_name_t * name;       /* weak reference */
+    uint32_t f_idx;         /* index of the property in the `from` type */
+    int skip;               /* TI_FIELD_FLAG_SKIP_x flags of `t_field` */
 };
 
 #endif  /* TI_MAPPING_H_ */
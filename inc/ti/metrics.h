@@ -0,0 +1,11 @@
+/*
+ * ti/metrics.h
+ */
+#ifndef TI_METRICS_H_
+#define TI_METRICS_H_
+
+#include <util/buf.h>
+
+int ti_metrics_to_buf(buf_t * buf);
+
+#endif  /* TI_METRICS_H_ */
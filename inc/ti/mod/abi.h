@@ -0,0 +1,97 @@
+/*
+ * ti/mod/abi.h - stable C ABI for native modules.
+ *
+ * A native module is a shared library (`.so`) which is loaded in-process
+ * using dlopen(). The library must export a function with the name
+ * TI_ABI_INIT_SYMBOL which returns a pointer to a static `ti_abi_module_t`.
+ *
+ * This header is part of the ABI and may be copied to a module project; it
+ * must not include other ThingsDB headers. Arguments and results are
+ * MessagePack, exactly as with modules which run as a process, so a module
+ * can be moved between both types without changing the data format.
+ *
+ *   static void add_call(const void * data, size_t n, ti_abi_out_t * out)
+ *   {
+ *       ... unpack `data` and pack a result ...
+ *       out->set_result(out->res, buf, buf_n);
+ *   }
+ *
+ *   static const ti_abi_module_t add_module = {
+ *       .abi_version = TI_ABI_VERSION,
+ *       .flags = TI_ABI_FLAG_SYNC,
+ *       .call = add_call,
+ *   };
+ *
+ *   const ti_abi_module_t * ti_module_init(void)
+ *   {
+ *       return &add_module;
+ *   }
+ */
+#ifndef TI_MOD_ABI_H_
+#define TI_MOD_ABI_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TI_ABI_VERSION 1
+#define TI_ABI_INIT_SYMBOL "ti_module_init"
+
+enum
+{
+    /*
+     * Call the module on the event loop thread and return the result
+     * directly instead of a future. Use this only for short, CPU bound
+     * functions as no other query can run while the module is called.
+     *
+     * Without this flag, calls run on a worker thread and return a future;
+     * the `call` function may then run concurrently in multiple threads.
+     */
+    TI_ABI_FLAG_SYNC    =1<<0,
+};
+
+typedef struct ti_abi_res_s ti_abi_res_t;       /* opaque result */
+
+typedef struct
+{
+    ti_abi_res_t * res;
+
+    /*
+     * Set a MessagePack result, the data is copied. Returns 0 on success or
+     * -1 when the result could not be set.
+     */
+    int (*set_result)(ti_abi_res_t * res, const void * data, size_t n);
+
+    /*
+     * Set an error using a ThingsDB error code (-127..-50) and a message.
+     * Returns 0 on success or -1 when the error could not be set.
+     */
+    int (*set_error)(ti_abi_res_t * res, int code, const char * msg);
+} ti_abi_out_t;
+
+typedef struct
+{
+    uint32_t abi_version;           /* must be TI_ABI_VERSION */
+    uint32_t flags;                 /* TI_ABI_FLAG_... */
+
+    /*
+     * Optional; called on the event loop thread with the MessagePack
+     * configuration. Must return 0 on success.
+     */
+    int (*conf)(const void * data, size_t n);
+
+    /*
+     * Required; called with the MessagePack request. The function must set
+     * either a result or an error before returning.
+     */
+    void (*call)(const void * data, size_t n, ti_abi_out_t * out);
+
+    /*
+     * Optional; called on the event loop thread before the library is
+     * closed. No calls are running at this point.
+     */
+    void (*unload)(void);
+} ti_abi_module_t;
+
+typedef const ti_abi_module_t * (*ti_abi_init_t)(void);
+
+#endif  /* TI_MOD_ABI_H_ */
@@ -14,11 +14,14 @@ typedef struct ti_mod_manifest_s ti_mod_manifest_t;
 struct ti_mod_manifest_s
 {
     _Bool is_py;                        /* true/false */
+    _Bool is_native;                    /* true/false, shared library */
     char * main;                        /* required */
     char * version;                     /* required */
     char * doc;                         /* NULL or string */
     _Bool * load;                       /* NULL or true/false */
     uint8_t * deep;                     /* NULL or 0..127 */
+    uint8_t workers;                    /* 0 (not set) or 1..32 */
+    uint16_t shm_size;                  /* 0 (not set) or 1..1024 MiB */
     vec_t * defaults;                   /* ti_item_t */
     vec_t * includes;                   /* char *, only for installation */
     vec_t * requirements;               /* char *, pip requirements */
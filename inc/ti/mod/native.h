@@ -0,0 +1,30 @@
+/*
+ * ti/mod/native.h
+ */
+#ifndef TI_MOD_NATIVE_H_
+#define TI_MOD_NATIVE_H_
+
+#include <ex.h>
+#include <ti/future.t.h>
+#include <ti/mod/native.t.h>
+#include <ti/module.t.h>
+#include <ti/query.t.h>
+
+int ti_mod_native_load(ti_module_t * module);
+int ti_mod_native_conf(ti_module_t * module);
+void ti_mod_native_unload(ti_module_t * module);
+void ti_mod_native_destroy(ti_mod_native_t * native);
+void ti_mod_native_cb(ti_future_t * future);
+int ti_mod_native_call(
+        ti_module_t * module,
+        ti_query_t * query,
+        uint8_t deep,
+        _Bool load,
+        ex_t * e);
+
+static inline _Bool ti_mod_native_is_sync(ti_module_t * module)
+{
+    return module->native && (module->native->abi->flags & TI_ABI_FLAG_SYNC);
+}
+
+#endif  /* TI_MOD_NATIVE_H_ */
@@ -0,0 +1,20 @@
+/*
+ * ti/mod/native.t.h
+ */
+#ifndef TI_MOD_NATIVE_T_H_
+#define TI_MOD_NATIVE_T_H_
+
+typedef struct ti_mod_native_s ti_mod_native_t;
+
+#include <stdint.h>
+#include <ti/mod/abi.h>
+
+struct ti_mod_native_s
+{
+    void * handle;                  /* handle from dlopen() */
+    const ti_abi_module_t * abi;    /* module functions */
+    uint32_t in_flight;             /* calls running on a worker thread */
+    _Bool unload;                   /* unload when no calls are running */
+};
+
+#endif  /* TI_MOD_NATIVE_T_H_ */
@@ -0,0 +1,20 @@
+/*
+ * ti/mod/shm.h
+ */
+#ifndef TI_MOD_SHM_H_
+#define TI_MOD_SHM_H_
+
+#include <ti/mod/shm.t.h>
+
+ti_mod_shm_t * ti_mod_shm_create(size_t size);
+void ti_mod_shm_destroy(ti_mod_shm_t * shm);
+int ti_mod_shm_write(
+        ti_mod_shm_t * shm,
+        const void * data,
+        size_t n,
+        uint64_t * pos);
+void ti_mod_shm_unwrite(ti_mod_shm_t * shm, uint64_t pos, size_t n);
+const void * ti_mod_shm_read(ti_mod_shm_t * shm, uint64_t pos, size_t n);
+void ti_mod_shm_release(ti_mod_shm_t * shm, uint64_t pos, size_t n);
+
+#endif  /* TI_MOD_SHM_H_ */
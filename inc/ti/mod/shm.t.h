@@ -0,0 +1,66 @@
+/*
+ * ti/mod/shm.t.h
+ */
+#ifndef TI_MOD_SHM_T_H_
+#define TI_MOD_SHM_T_H_
+
+#define TI_MOD_SHM_MAGIC 0x534d4954         /* "TIMS" (little endian) */
+#define TI_MOD_SHM_VERSION 1
+#define TI_MOD_SHM_FD 3                     /* file descriptor in the child */
+#define TI_MOD_SHM_DATA_OFFSET 4096         /* first ring starts at one page */
+#define TI_MOD_SHM_THRESHOLD 65536          /* smaller packages use the pipe */
+
+typedef struct ti_mod_ring_s ti_mod_ring_t;
+typedef struct ti_mod_shm_hdr_s ti_mod_shm_hdr_t;
+typedef struct ti_mod_shm_s ti_mod_shm_t;
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Single producer, single consumer byte ring inside the shared region.
+ * Positions are absolute and only grow, the offset of a position in the ring
+ * is `position % size`. A record is never wrapped; when a record does not fit
+ * at the end of the ring, the producer skips to the start of the ring.
+ */
+struct ti_mod_ring_s
+{
+    uint64_t head;          /* written by the producer */
+    uint64_t tail;          /* written by the consumer */
+    uint64_t offset;        /* offset of the ring data in the region */
+    uint64_t size;          /* size of the ring data in bytes */
+    uint64_t _pad[4];       /* each ring uses its own cache line */
+};
+
+/*
+ * Header at the start of the shared region, the module must check the magic
+ * and version before using the rings.
+ */
+struct ti_mod_shm_hdr_s
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;          /* total size of the region in bytes */
+    uint64_t _pad[6];
+    ti_mod_ring_t req;      /* requests, ThingsDB -> module */
+    ti_mod_ring_t res;      /* responses, module -> ThingsDB */
+};
+
+/*
+ * The module can write to the whole region, thus the ring layout and the
+ * positions written by ThingsDB are kept in private fields and only the
+ * positions written by the module are read from the region.
+ */
+struct ti_mod_shm_s
+{
+    int fd;                 /* memory file, inherited by the module */
+    size_t size;            /* mapped size in bytes */
+    ti_mod_shm_hdr_t * hdr; /* mapped region */
+    uint64_t ring_size;     /* size of each ring in bytes */
+    uint64_t req_offset;    /* offset of the request ring data */
+    uint64_t res_offset;    /* offset of the response ring data */
+    uint64_t req_head;      /* next request position */
+    uint64_t res_tail;      /* next response position */
+};
+
+#endif  /* TI_MOD_SHM_T_H_ */
@@ -6,14 +6,17 @@
 
 #include <cleri/cleri.h>
 #include <ex.h>
+#include <ti/future.t.h>
 #include <ti/module.t.h>
 #include <ti/pkg.t.h>
+#include <ti/proc.t.h>
 #include <ti/query.t.h>
 #include <ti/scope.t.h>
 #include <ti/thing.t.h>
 #include <ti/val.t.h>
 #include <util/fx.h>
 #include <util/mpack.h>
+#include <util/util.h>
 #include <util/vec.h>
 
 ti_module_t * ti_module_create(
@@ -28,7 +31,7 @@ ti_module_t * ti_module_create(
 int ti_module_set_file(ti_module_t * module, const char * file, size_t n);
 int ti_module_deploy(ti_module_t * module, const void * data, size_t n);
 void ti_module_destroy(ti_module_t * module);
-void ti_module_on_exit(ti_module_t * module);
+void ti_module_on_exit(ti_module_t * module, ti_proc_t * proc);
 int ti_module_stop(ti_module_t * module);
 void ti_module_stop_and_destroy(ti_module_t * module);
 void ti_module_del(ti_module_t * module, _Bool delete_files);
@@ -38,9 +41,24 @@ void ti_module_restart(ti_module_t * module);
 void ti_module_update_conf(ti_module_t * module);
 _Bool ti_module_is_ready(ti_module_t * module);
 _Bool ti_module_file_is_py(const char * file, size_t n);
+_Bool ti_module_file_is_native(const char * file, size_t n);
 const char * ti_module_status_str(ti_module_t * module);
 ti_pkg_t * ti_module_conf_pkg(ti_val_t * val, ti_query_t * query);
-void ti_module_on_pkg(ti_module_t * module, ti_pkg_t * pkg);
+void ti_module_on_pkg(ti_proc_t * proc, ti_pkg_t * pkg);
+ti_future_t * ti_module_pop_future(ti_module_t * module, uint16_t pid);
+ti_pkg_t * ti_module_req_pkg(
+        ti_thing_t * thing,
+        ti_query_t * query,
+        uint8_t deep);
+ti_val_t * ti_module_res_val(
+        ti_module_t * module,
+        ti_query_t * query,
+        _Bool load,
+        const void * data,
+        size_t n,
+        ex_t * e);
+void ti_module_on_res(ti_future_t * future, const void * data, size_t n);
+void ti_module_latency(ti_module_t * module, util_time_t * sent_at);
 ti_val_t * ti_module_as_mpval(ti_module_t * module, int flags);
 int ti_module_write(ti_module_t * module, const void * data, size_t n);
 int ti_module_read_args(
@@ -62,6 +80,11 @@ static inline _Bool ti_module_is_py(ti_module_t * module)
     return module->manifest.is_py;
 }
 
+static inline _Bool ti_module_is_native(ti_module_t * module)
+{
+    return module->manifest.is_native;
+}
+
 static inline const char * ti_module_py_fn(ti_module_t * module)
 {
     return module->args[1];
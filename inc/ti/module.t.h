@@ -10,10 +10,13 @@ typedef void (*ti_module_cb)(void * future);
 #define TI_MODULE_MAX_ERR 255
 #define TI_MODULE_DEFAULT_LOAD false
 #define TI_MODULE_DEFAULT_DEEP 1
+#define TI_MODULE_MAX_WORKERS 32
+#define TI_MODULE_MAX_SHM_SIZE 1024  /* MiB */
 
 #include <inttypes.h>
 #include <ti/mod/github.t.h>
 #include <ti/mod/manifest.t.h>
+#include <ti/mod/native.t.h>
 #include <ti/name.t.h>
 #include <ti/pkg.t.h>
 #include <ti/proc.t.h>
@@ -70,6 +73,7 @@ struct ti_module_s
     uint16_t restarts;      /* keep the number of times this module has been
                                restarted */
     uint16_t next_pid;      /* next package id  */
+    uint8_t nprocs;         /* number of worker processes */
     ti_module_cb cb;        /* module callback */
     ti_name_t * name;       /* name of the module */
     char * orig;            /* original source of the module */
@@ -84,7 +88,12 @@ struct ti_module_s
     omap_t * futures;       /* ti_future_t (no reference, parent query holds
                                a reference so no extra is needed) */
     ti_mod_manifest_t manifest;             /* manifest from module.json */
-    ti_proc_t proc;                         /* process */
+    ti_proc_t * procs;                      /* worker processes */
+    ti_mod_native_t * native;               /* loaded native module or NULL */
+    uint64_t calls;                         /* number of calls with a
+                                               response from the module */
+    double latency_sum;                     /* total latency in seconds */
+    double latency_max;                     /* maximum latency in seconds */
     ti_module_source_enum_t source_type;    /* source type: file/GitHub/.. */
     ti_module_source_via_t source;          /* source */
     char source_err[TI_MODULE_MAX_ERR];     /* error message from source;
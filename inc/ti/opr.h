@@ -9,6 +9,11 @@
 #include <ti/val.h>
 
 int ti_opr_a_to_b(ti_val_t * a, cleri_node_t * nd, ti_val_t ** b, ex_t * e);
+int ti_opr_var_a_to_b(
+        ti_val_t ** a,
+        cleri_node_t * nd,
+        ti_val_t ** b,
+        ex_t * e);
 _Bool ti__opr_eq_(ti_val_t * a, ti_val_t * b);
 int ti_opr_compare(ti_val_t * a, ti_val_t * b, ex_t * e);
 
@@ -95,3 +95,38 @@ overflow:
     ex_set(e, EX_OVERFLOW, "integer overflow");
     return e->nr;
 }
+
+/*
+ * Variable `a` is updated in place when it holds a string or bytes value
+ * which is not referenced elsewhere. On success, `b` points to the result,
+ * which is the updated `a` when appended in place.
+ */
+static int opr__add_var(ti_val_t ** a, ti_val_t ** b, ex_t * e)
+{
+    ti_raw_t * raw = (ti_raw_t *) *a;
+
+    if (raw->ref > 1 ||
+        (raw->tp != TI_VAL_STR && raw->tp != TI_VAL_BYTES) ||
+        ((*b)->tp != TI_VAL_STR &&
+         (*b)->tp != TI_VAL_NAME &&
+         (*b)->tp != TI_VAL_BYTES))
+        return opr__add(*a, b, e);
+
+    if (ti_raw_append(
+            &raw,
+            ((ti_raw_t *) *b)->data,
+            ((ti_raw_t *) *b)->n))
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    if ((*b)->tp == TI_VAL_BYTES)
+        raw->tp = TI_VAL_BYTES;
+
+    *a = (ti_val_t *) raw;
+    ti_val_unsafe_drop(*b);
+    *b = *a;
+    ti_incref(*b);
+    return 0;
+}
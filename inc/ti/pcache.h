@@ -0,0 +1,66 @@
+/*
+ * ti/pcache.h
+ *
+ * Cache for the packed MessagePack data of things which are returned to
+ * clients. Only things with an Id, packed with a `deep` value of 1 are
+ * cached, as nested things are then packed using only their Id and changes
+ * to nested things can therefore not invalidate the packed data. Each
+ * collection has its own cache, limited by the `pack_cache_size` option.
+ *
+ * Node info:
+ *   - `cached_things`
+ *   - `pack_cache_size`
+ *
+ * Counters:
+ *   - `pack_cache_hits`
+ *   - `pack_cache_misses`
+ */
+#ifndef TI_PCACHE_H_
+#define TI_PCACHE_H_
+
+#include <stddef.h>
+#include <ti/collection.t.h>
+#include <ti/pcache.t.h>
+#include <ti/thing.t.h>
+#include <ti/vp.t.h>
+
+void ti_pcache_destroy(ti_pcache_t * pcache);
+int ti_pcache_get(ti_thing_t * thing, ti_vp_t * vp, int flags);
+void ti_pcache_set(
+        ti_thing_t * thing,
+        int flags,
+        const char * data,
+        size_t n);
+void ti_pcache__drop(ti_thing_t * thing);
+size_t ti_pcache_n(void);
+
+static inline void ti_pcache_drop(ti_thing_t * thing)
+{
+    if (thing->flags & TI_THING_FLAG_PACKED)
+        ti_pcache__drop(thing);
+}
+
+/*
+ * Invalidate all packed things in a collection; used for changes which
+ * might change the packed data of things without a task for these things,
+ * for example when a type or enumerator is changed.
+ */
+static inline void ti_pcache_drop_collection(ti_collection_t * collection)
+{
+    if (collection)
+        ++collection->pcache_gen;
+}
+
+/*
+ * Must be called for each task on a thing. Type and enumerator changes are
+ * tasks on the collection root, therefore a task on the root invalidates all
+ * packed things in the collection.
+ */
+static inline void ti_pcache_changed(ti_thing_t * thing)
+{
+    ti_pcache_drop(thing);
+    if (thing->collection && thing->collection->root == thing)
+        ti_pcache_drop_collection(thing->collection);
+}
+
+#endif  /* TI_PCACHE_H_ */
@@ -0,0 +1,34 @@
+/*
+ * ti/pcache.t.h
+ */
+#ifndef TI_PCACHE_T_H_
+#define TI_PCACHE_T_H_
+
+typedef struct ti_pcache_s ti_pcache_t;
+typedef struct ti_pcache_item_s ti_pcache_item_t;
+
+#include <stddef.h>
+#include <stdint.h>
+#include <ti/thing.t.h>
+#include <util/ptrmap.h>
+
+struct ti_pcache_item_s
+{
+    ti_pcache_item_t * prev;    /* least recently used order */
+    ti_pcache_item_t * next;
+    ti_thing_t * thing;         /* without reference */
+    uint32_t gen;               /* collection->pcache_gen while packed */
+    int flags;
+    size_t n;
+    char data[];
+};
+
+struct ti_pcache_s
+{
+    ptrmap_t * items;           /* thing -> ti_pcache_item_t */
+    ti_pcache_item_t * head;    /* most recently used */
+    ti_pcache_item_t * tail;    /* least recently used */
+    size_t size;                /* total size of the packed data */
+};
+
+#endif  /* TI_PCACHE_T_H_ */
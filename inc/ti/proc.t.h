@@ -6,19 +6,31 @@
 
 typedef struct ti_proc_s ti_proc_t;
 
+#include <ti/mod/shm.t.h>
 #include <ti/module.t.h>
 #include <util/buf.h>
 #include <uv.h>
 
+enum
+{
+    TI_PROC_FLAG_IN_USE     =1<<0,
+    TI_PROC_FLAG_WAIT_CONF  =1<<1,
+};
+
 struct ti_proc_s
 {
     uv_process_t process;
     uv_process_options_t options;
-    uv_stdio_container_t child_stdio[3];
+    uv_stdio_container_t child_stdio[4];
     uv_pipe_t child_stdin;
     uv_pipe_t child_stdout;
     ti_module_t * module;
     buf_t buf;
+    ti_mod_shm_t * shm;     /* shared memory, NULL when not used */
+    uint32_t in_flight;     /* number of requests waiting for a response */
+    uint16_t restarts;      /* restarts of this worker after an unexpected
+                               exit while the module was running */
+    uint8_t flags;
 };
 
 #endif  /* TI_PROC_T_H_ */
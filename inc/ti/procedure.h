@@ -25,6 +25,7 @@ void ti_procedure_mod(
         ti_procedure_t * procedure,
         ti_closure_t * closure,
         uint64_t created_at);
+void ti_procedure_set_cache_ttl(ti_procedure_t * procedure, uint32_t ttl);
 void ti_procedure_destroy(ti_procedure_t * procedure);
 int ti_procedure_info_to_pk(
         ti_procedure_t * procedure,
@@ -41,6 +42,8 @@ struct ti_procedure_s
     ti_raw_t * doc;             /* documentation, may be NULL */
     ti_raw_t * def;             /* formatted definition, may be NULL */
     ti_closure_t * closure;     /* closure */
+    uint32_t cache_ttl;         /* seconds to cache the result of a procedure
+                                   without side effects, 0 when disabled */
 };
 
 
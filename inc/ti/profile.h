@@ -0,0 +1,21 @@
+/*
+ * ti/profile.h
+ */
+#ifndef TI_PROFILE_H_
+#define TI_PROFILE_H_
+
+#include <stddef.h>
+#include <ti/profile.t.h>
+#include <ti/val.t.h>
+#include <util/mpack.h>
+
+ti_profile_t * ti_profile_create(const char * name, size_t n);
+void ti_profile_destroy(ti_profile_t * profile);
+ti_profile_t * ti_profile_child(
+        ti_profile_t * profile,
+        const char * name,
+        size_t n);
+int ti_profile_to_pk(ti_profile_t * profile, msgpack_packer * pk);
+ti_val_t * ti_profile_as_mpval(ti_profile_t * profile);
+
+#endif  /* TI_PROFILE_H_ */
@@ -0,0 +1,27 @@
+/*
+ * ti/profile.t.h
+ */
+#ifndef TI_PROFILE_T_H_
+#define TI_PROFILE_T_H_
+
+typedef struct ti_profile_s ti_profile_t;
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <util/vec.h>
+
+/*
+ * Function calls are profiled as a tree; calls with the same name and the
+ * same parent are added to a single node.
+ */
+struct ti_profile_s
+{
+    uint64_t calls;             /* number of calls */
+    double time;                /* total time in seconds */
+    ti_profile_t * parent;      /* NULL for the root */
+    vec_t * children;           /* ti_profile_t, NULL when empty */
+    size_t n;                   /* length of the name */
+    char name[];                /* function name, not null terminated */
+};
+
+#endif  /* TI_PROFILE_T_H_ */
@@ -46,6 +46,7 @@ typedef enum
     TI_PROTO_CLIENT_REQ_LEAVE     =39,   /* [scope, ...room id's]}           */
     TI_PROTO_CLIENT_REQ_EMIT      =40,   /* [scope, room_id, event, ...args] */
     TI_PROTO_CLIENT_REQ_EMIT_PEER =41,   /* [scope, room_id, event, ...args] */
+    TI_PROTO_CLIENT_REQ_BATCH     =42,   /* [scope, [[34/37, ...], ...]]     */
 
 
     /*
@@ -57,6 +58,8 @@ typedef enum
     TI_PROTO_MODULE_REQ           =80,    /* data, request */
     TI_PROTO_MODULE_RES           =81,    /* data, response */
     TI_PROTO_MODULE_ERR           =82,    /* [err_nr, message] */
+    TI_PROTO_MODULE_REQ_SHM       =83,    /* [position, size], request */
+    TI_PROTO_MODULE_RES_SHM       =84,    /* [position, size], response */
 
     /*
      * protocol definition for node connections
@@ -80,12 +83,14 @@ typedef enum
     /* expects a client response which will be forwarded back to the client */
     TI_PROTO_NODE_REQ_QUERY     =160,   /* [user_id, [original]] */
     TI_PROTO_NODE_REQ_RUN       =161,   /* [user_id, [original]] */
+    TI_PROTO_NODE_REQ_BATCH     =162,   /* [user_id, [original]] */
 
     TI_PROTO_NODE_REQ_CONNECT   =168,   /* [...] */
     TI_PROTO_NODE_REQ_CHANGE_ID =169,   /* change id */
     TI_PROTO_NODE_REQ_AWAY      =170,   /* empty */
     TI_PROTO_NODE_REQ_SETUP     =171,   /* empty */
-    TI_PROTO_NODE_REQ_SYNC      =172,   /* change_id */
+    TI_PROTO_NODE_REQ_SYNC      =172,   /* change_id, followed by the sync
+                                           protocol version (optional) */
 
     /* [scope_id, file_id, offset, bytes, more]
      * more is a boolean which is set to true in case the file is not yet
@@ -98,6 +103,17 @@ typedef enum
     TI_PROTO_NODE_REQ_SYNCEPART =177,   /* changes sync part */
     TI_PROTO_NODE_REQ_SYNCEDONE =178,   /* changes sync completed */
 
+    /* [scope_id, file_id]
+     * file_id is SYNCFULL__COLLECTION_END for a digest of all the files in
+     * a collection.
+     */
+    TI_PROTO_NODE_REQ_SYNCFDIGEST =179, /* full sync digest */
+
+    /* [scope_id, file_id, offset, bytes, file_size]
+     * writes bytes at the given offset and sets the size of the file.
+     */
+    TI_PROTO_NODE_REQ_SYNCFDPART =180,  /* full sync delta part */
+
     /*
      * 192..223 node responses
      */
@@ -118,6 +134,11 @@ typedef enum
     TI_PROTO_NODE_RES_SYNCADONE =199,   /* empty, ack */
     TI_PROTO_NODE_RES_SYNCEPART =200,   /* changes */
     TI_PROTO_NODE_RES_SYNCEDONE =201,   /* empty, ack */
+    TI_PROTO_NODE_RES_SYNCFDIGEST =202, /* [scope, file, size, digests]
+                                           or [scope, file, digest] for a
+                                           collection digest
+                                         */
+    TI_PROTO_NODE_RES_SYNCFDPART =203,  /* [scope, file, offset] */
 
 
     /*
@@ -138,6 +159,8 @@ typedef enum
 #define TI_PROTO_NODE_REQ_SYNC_TIMEOUT 10
 #define TI_PROTO_NODE_REQ_SYNCFPART_TIMEOUT 10
 #define TI_PROTO_NODE_REQ_SYNCFDONE_TIMEOUT 300
+#define TI_PROTO_NODE_REQ_SYNCFDIGEST_TIMEOUT 60
+#define TI_PROTO_NODE_REQ_SYNCFDPART_TIMEOUT 10
 #define TI_PROTO_NODE_REQ_SYNCAPART_TIMEOUT 10
 #define TI_PROTO_NODE_REQ_SYNCADONE_TIMEOUT 300
 #define TI_PROTO_NODE_REQ_SYNCEPART_TIMEOUT 10
@@ -30,11 +30,17 @@ int ti_query_unp_run(
         size_t n,
         ex_t * e);
 int ti_query_parse(ti_query_t * query, const char * str, size_t n, ex_t * e);
+int ti_query_parse_work(
+        ti_query_t * query,
+        const char * str,
+        size_t n,
+        ti_query_done_cb cb);
 void ti_query_run_parseres(ti_query_t * query);
 void ti_query_run_procedure(ti_query_t * query);
 void ti_query_run_future(ti_query_t * query);
 void ti_query_run_task_finish(ti_query_t * query);
 void ti_query_run_task(ti_query_t * query);
+void ti_query_run_batch(ti_query_t * query);
 void ti_query_send_response(ti_query_t * query, ex_t * e);
 void ti_query_on_then_result(ti_query_t * query, ex_t * e);
 void ti_query_task_result(ti_query_t * query, ex_t * e);
@@ -9,13 +9,16 @@ typedef int (*ti_query_vars_walk_cb)(void * data, void * arg);
 
 #include <cleri/cleri.h>
 #include <ti/api.t.h>
+#include <ti/batch.t.h>
 #include <ti/change.t.h>
 #include <ti/closure.t.h>
 #include <ti/collection.t.h>
 #include <ti/flags.h>
+#include <ti/profile.t.h>
 #include <ti/future.t.h>
 #include <ti/commit.h>
 #include <ti/qbind.t.h>
+#include <ti/rcache.t.h>
 #include <ti/stream.t.h>
 #include <ti/user.t.h>
 #include <ti/val.t.h>
@@ -47,6 +50,7 @@ typedef enum
     TI_QUERY_WITH_FUTURE,
     TI_QUERY_WITH_TASK,
     TI_QUERY_WITH_TASK_FINISH,
+    TI_QUERY_WITH_BATCH,
 } ti_query_with_enum;
 
 typedef int (*ti_query_unpack_cb) (
@@ -71,12 +75,14 @@ typedef union
     ti_closure_t * closure;     /* when called as procedure */
     ti_future_t * future;       /* when called as future->then */
     ti_vtask_t * vtask;         /* when called as task */
+    ti_batch_t * batch;         /* when running a batch of queries */
 } ti_query_with_t;
 
 struct ti_query_s
 {
     uint32_t local_stack;       /* variable scopes start here */
-    uint16_t pkg_id;            /* package id to return the query to */
+    uint16_t pkg_id;            /* package id to return the query to, or
+                                   the position when part of a batch */
     uint8_t with_tp;            /* one of ti_query_with_enum */
     uint8_t flags;
     ti_qbind_t qbind;               /* query binding */
@@ -99,6 +105,17 @@ struct ti_query_s
                                 */
     link_t futures;             /* place to store futures */
     util_time_t time;           /* time query duration */
+    vec_t * vtasks;             /* ti_vtask_t, with reference, tasks which
+                                   are waiting to run as part of a batch;
+                                   NULL when not running a batch of tasks
+                                */
+    ti_profile_t * profile;     /* current profile node while running inside
+                                   `profile(..)`, NULL when not profiling
+                                */
+    ti_rcache_key_t * rcache_key;   /* only for procedures with a result
+                                       cache, NULL otherwise */
+    ti_batch_t * batch;         /* without reference, only when this query
+                                   is part of a batch, NULL otherwise */
 };
 
 #endif /* TI_QUERY_T_H_ */
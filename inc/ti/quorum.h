@@ -30,6 +30,7 @@ struct ti_quorum_s
     uint8_t accept_threshold;   /* minimal required accepted */
     ti_quorum_cb cb_;           /* store the callback function */
     void * data;                /* public data binding */
+    struct timespec start;      /* time the quorum round has started */
 };
 
 /* only call this if something goes wrong before making the requests,
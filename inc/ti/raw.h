@@ -40,6 +40,7 @@ int ti_raw_cmp(const ti_raw_t * a, const ti_raw_t * b);
 int ti_raw_cmp_strn(const ti_raw_t * a, const char * s, size_t n);
 void ti_raw_set_e(ex_t * e, const ti_raw_t * r, ex_enum code);
 ti_raw_t * ti_raw_cat(const ti_raw_t * a, const ti_raw_t * b);
+int ti_raw_append(ti_raw_t ** raw, const void * s, size_t n);
 ti_raw_t * ti_raw_cat_strn(const ti_raw_t * a, const char * s, size_t n);
 ti_raw_t * ti_raw_icat_strn(const ti_raw_t * b, const char * s, size_t n);
 ti_raw_t * ti_raw_cat_strn_strn(
@@ -0,0 +1,62 @@
+/*
+ * ti/rcache.h
+ *
+ * Cache for the packed results of procedures without side effects. The
+ * cache is enabled per procedure using `set_procedure_cache(..)`; results are
+ * cached by procedure, user, `deep` value, flags and the packed arguments.
+ *
+ * A cached result is valid until it expires, or until a change touches the
+ * scope of the procedure. For a collection the version is the last change
+ * which has created a task in the collection, for the `@thingsdb` scope the
+ * committed change id is used.
+ *
+ * Node info:
+ *   - `cached_procedure_results`
+ *   - `procedure_cache_size`
+ *
+ * Counters:
+ *   - `procedure_cache_hits`
+ *   - `procedure_cache_misses`
+ */
+#ifndef TI_RCACHE_H_
+#define TI_RCACHE_H_
+
+#include <stddef.h>
+#include <ti/collection.t.h>
+#include <ti/procedure.h>
+#include <ti/query.t.h>
+#include <ti/rcache.t.h>
+#include <util/mpack.h>
+
+int ti_rcache_create(void);
+void ti_rcache_destroy(void);
+ti_rcache_key_t * ti_rcache_key_create(
+        ti_query_t * query,
+        ti_procedure_t * procedure,
+        const void * args,
+        size_t n);
+_Bool ti_rcache_hit(ti_rcache_key_t * key);
+int ti_rcache_write(ti_rcache_key_t * key, msgpack_sbuffer * buffer);
+void ti_rcache_set(ti_rcache_key_t * key, const char * data, size_t n);
+void ti_rcache__drop_procedure(ti_procedure_t * procedure);
+size_t ti_rcache_n(void);
+
+static inline void ti_rcache_drop_procedure(ti_procedure_t * procedure)
+{
+    if (procedure->cache_ttl)
+        ti_rcache__drop_procedure(procedure);
+}
+
+/*
+ * Must be called for each task in a collection, both on the node where the
+ * query runs and on nodes which process the change.
+ */
+static inline void ti_rcache_changed(
+        ti_collection_t * collection,
+        uint64_t change_id)
+{
+    if (collection)
+        collection->change_id = change_id;
+}
+
+#endif  /* TI_RCACHE_H_ */
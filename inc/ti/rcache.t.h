@@ -0,0 +1,39 @@
+/*
+ * ti/rcache.t.h
+ */
+#ifndef TI_RCACHE_T_H_
+#define TI_RCACHE_T_H_
+
+typedef struct ti_rcache_key_s ti_rcache_key_t;
+typedef struct ti_rcache_item_s ti_rcache_item_t;
+
+#include <inttypes.h>
+#include <stddef.h>
+
+struct ti_procedure_s;
+
+struct ti_rcache_key_s
+{
+    struct ti_procedure_s * procedure;  /* without reference */
+    ti_rcache_item_t * item;        /* set on a cache hit, only valid while
+                                       the response is written */
+    uint64_t hash;
+    uint64_t change_id;             /* version of the scope */
+    size_t n;
+    unsigned char data[];           /* user, deep, flags and arguments */
+};
+
+struct ti_rcache_item_s
+{
+    ti_rcache_item_t * prev;        /* least recently used order */
+    ti_rcache_item_t * next;
+    struct ti_procedure_s * procedure;  /* without reference */
+    uint64_t hash;
+    uint64_t change_id;             /* version of the scope while cached */
+    uint64_t expire_at;             /* UNIX time-stamp in seconds */
+    size_t key_n;
+    size_t n;
+    unsigned char data[];           /* key data, followed by the result */
+};
+
+#endif  /* TI_RCACHE_T_H_ */
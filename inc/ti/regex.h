@@ -9,6 +9,10 @@
 #include <ti/regex.t.h>
 #include <ex.h>
 
+int ti_regex_init(void);
+void ti_regex_drop_common(void);
+size_t ti_regex_cache_n(void);
+_Bool ti_regex_has_jit(void);
 ti_regex_t * ti_regex_from_strn(const char * str, size_t n, ex_t * e);
 ti_regex_t * ti_regex_from_str(const char * str);
 ti_regex_t * ti_regex_create(ti_raw_t * pattern, ti_raw_t * flags, ex_t * e);
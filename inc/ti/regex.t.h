@@ -27,9 +27,12 @@ typedef struct ti_regex_s ti_regex_t;
 
 typedef enum
 {
-    TI_REGEX_FLAG_IS_GLOBAL = 1
+    TI_REGEX_FLAG_IS_GLOBAL     = 1<<0,
+    TI_REGEX_FLAG_JIT           = 1<<1,     /* JIT compiled */
 } ti_regex_flags_t;
 
+int ti_regex_match(ti_regex_t * regex, ti_raw_t * raw, PCRE2_SIZE pos);
+
 struct ti_regex_s
 {
     uint32_t ref;
@@ -59,26 +62,12 @@ static inline bool ti_regex_is_global(ti_regex_t * re)
 
 static inline _Bool ti_regex_test(ti_regex_t * regex, ti_raw_t * raw)
 {
-    return pcre2_match(
-            regex->code,
-            (PCRE2_SPTR8) raw->data,
-            raw->n,
-            0,                     /* start looking at this point */
-            0,                     /* OPTIONS */
-            regex->match_data,
-            NULL) >= 0;
+    return ti_regex_match(regex, raw, 0) >= 0;
 }
 
 static inline _Bool ti_regex_test_or_empty(ti_regex_t * regex, ti_raw_t * raw)
 {
-    return raw->n == 0 || pcre2_match(
-            regex->code,
-            (PCRE2_SPTR8) raw->data,
-            raw->n,
-            0,                     /* start looking at this point */
-            0,                     /* OPTIONS */
-            regex->match_data,
-            NULL) >= 0;
+    return raw->n == 0 || ti_regex_match(regex, raw, 0) >= 0;
 }
 
 static inline _Bool ti_regex_eq(ti_regex_t * ra, ti_regex_t * rb)
@@ -11,7 +11,10 @@ typedef struct ti_syncer_s ti_syncer_t;
 #include <ti/user.h>
 #include <ti/stream.h>
 
-ti_syncer_t * ti_syncer_create(ti_stream_t * stream, uint64_t first);
+ti_syncer_t * ti_syncer_create(
+        ti_stream_t * stream,
+        uint64_t first,
+        uint8_t proto);
 static inline void ti_syncer_destroy(ti_syncer_t * syncer);
 
 /* extends ti_watch_t */
@@ -19,6 +22,7 @@ struct ti_syncer_s
 {
     ti_stream_t * stream;       /* weak reference */
     uint64_t first;             /* first required change */
+    uint8_t proto;              /* synchronization protocol version */
 };
 
 static inline void ti_syncer_destroy(ti_syncer_t * syncer)
@@ -8,7 +8,32 @@
 #include <ti/stream.h>
 #include <ti/pkg.h>
 
-int ti_syncfull_start(ti_stream_t * stream);
+/*
+ * Synchronization protocol version, sent by a synchronizing node after the
+ * first required change id in a `sync` request. Nodes which do not send this
+ * version do not support the digest requests and are synchronized using a
+ * full transfer of all store files.
+ */
+#define TI_SYNCFULL_PROTO_DELTA 1
+
+typedef struct ti_syncfull_stats_s ti_syncfull_stats_t;
+
+int ti_syncfull_start(ti_stream_t * stream, uint8_t proto);
 ti_pkg_t * ti_syncfull_on_part(ti_pkg_t * pkg, ex_t * e);
+ti_pkg_t * ti_syncfull_on_digest(ti_pkg_t * pkg, ex_t * e);
+ti_pkg_t * ti_syncfull_on_dpart(ti_pkg_t * pkg, ex_t * e);
+const ti_syncfull_stats_t * ti_syncfull_stats(void);
+
+/*
+ * Progress of the last (or current) full synchronization. The `bytes_*`
+ * counters are reset when a new synchronization starts.
+ */
+struct ti_syncfull_stats_s
+{
+    size_t parts_in_flight;     /* parts sent, waiting for a response */
+    size_t bytes_compared;      /* local bytes compared with the digests */
+    size_t bytes_sent;          /* bytes sent, after compression */
+    size_t bytes_received;      /* bytes received, before decompression */
+};
 
 #endif  /* TI_FSYNC_H_ */
@@ -155,6 +155,7 @@ int ti_task_add_splice(
         uint32_t n);             /* number of items to add */
 int ti_task_add_restore(ti_task_t * task);
 int ti_task_add_import(ti_task_t * task, ti_raw_t * bytes, _Bool import_tasks);
+int ti_task_add_import_abort(ti_task_t * task, uint64_t import_id);
 int ti_task_add_arr_remove(ti_task_t * task, ti_raw_t * key, vec_t * vec);
 int ti_task_add_thing_remove(ti_task_t * task, vec_t * vec, size_t alloc_sz);
 int ti_task_add_set_enum(ti_task_t * task, ti_enum_t * enum_);
@@ -195,5 +196,8 @@ int ti_task_add_del_history(
         ti_task_t * task,
         uint64_t scope_id,
         vec_t * commits);
+int ti_task_add_set_procedure_cache(
+        ti_task_t * task,
+        ti_procedure_t * procedure);
 
 #endif /* TI_TASK_H_ */
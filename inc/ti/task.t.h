@@ -96,6 +96,10 @@ typedef enum
     TI_TASK_DEL_HISTORY,                    /* 83  */
     TI_TASK_COMMIT,                         /* 84  */
     TI_TASK_MOD_TYPE_IDX,                   /* 85  */
+    TI_TASK_SET_PROCEDURE_CACHE,            /* 86  */
+    TI_TASK_IMPORT_THINGS,                  /* 87  */
+    TI_TASK_IMPORT_DATA,                    /* 88  */
+    TI_TASK_IMPORT_ABORT,                   /* 89  */
 } ti_task_enum;
 
 typedef struct ti_task_s ti_task_t;
@@ -5,7 +5,9 @@
 #define TI_TASKS_H_
 
 typedef struct ti_tasks_s ti_tasks_t;
+typedef struct ti_tasks_item_s ti_tasks_item_t;
 
+#include <ti/collection.t.h>
 #include <ti/vtask.t.h>
 #include <ti/user.t.h>
 #include <ti/varr.t.h>
@@ -15,20 +17,39 @@ typedef struct ti_tasks_s ti_tasks_t;
 int ti_tasks_create(void);
 int ti_tasks_start(void);
 void ti_tasks_stop(void);
-int ti_tasks_append(vec_t ** vtasks, ti_vtask_t * vtask);
+int ti_tasks_append(
+        vec_t ** vtasks,
+        ti_vtask_t * vtask,
+        ti_collection_t * collection);
 void ti_tasks_clear_dropped(vec_t ** vtasks);
 void ti_tasks_del_user(ti_user_t * user);
 void ti_tasks_clear_all(void);
 ti_varr_t * ti_tasks_list(vec_t * tasks);
 vec_t * ti_tasks_from_scope_id(uint64_t scope_id);
-void ti_tasks_reset_lowest_run_at(void);
-void ti_tasks_vtask_finish(ti_vtask_t * vtask);
+void ti_tasks_reschedule(void);
+void ti_tasks_vtask_finish(ti_vtask_t * vtask, ti_collection_t * collection);
+int ti_tasks_schedule(ti_vtask_t * vtask, ti_collection_t * collection);
+void ti_tasks_unschedule(ti_vtask_t * vtask);
+
+/*
+ * Tasks which should run on this node are kept in a binary min-heap ordered
+ * by run time in milliseconds. Each task knows its position in the heap
+ * (vtask->heap_idx) so a task can be re-scheduled or removed in O(log n).
+ */
+struct ti_tasks_item_s
+{
+    uint64_t run_at;            /* UNIX time-stamp in milliseconds */
+    uint64_t scope_id;          /* collection id or 0 for @thingsdb */
+    ti_vtask_t * vtask;         /* no reference */
+};
 
 struct ti_tasks_s
 {
     _Bool is_stopping;
     _Bool is_started;
-    uint64_t lowest_run_at;     /* earliest known run_at value */
+    uint32_t n;                 /* number of scheduled tasks */
+    uint32_t sz;                /* allocated heap size */
+    ti_tasks_item_t * heap;
     vec_t * vtasks;             /* ti_vtask_t */
     uv_timer_t * timer;
 };
@@ -147,6 +147,13 @@ int ti_thing_o_ren(
         size_t nn,
         ex_t * e);
 int ti_thing_id_to_client_pk(ti_thing_t * thing, msgpack_packer * pk);
+ti_prop_t * ti_thing_p_index_get(ti_thing_t * thing, ti_name_t * name);
+
+/*
+ * Objects with strict keys use a linear scan to find a property; from this
+ * number of properties, a hash index is used instead.
+ */
+#define TI_THING_INDEX_MIN 32
 
 #if TI_IS64BIT
 #define THING__KEY_SHIFT 3
@@ -201,12 +208,13 @@ static inline uint32_t ti_thing_n(ti_thing_t * thing)
     return thing->items.vec->n;
 }
 
-static inline ti_prop_t * ti_thing_o_prop_weak_get(
+static inline ti_prop_t * ti_thing_p_prop_weak_get(
         ti_thing_t * thing,
         ti_name_t * name)
 {
-    if (ti_thing_is_dict(thing))
-        return smap_get(thing->items.smap, name->str);
+    if ((thing->flags & TI_THING_FLAG_INDEX) ||
+        thing->items.vec->n >= TI_THING_INDEX_MIN)
+        return ti_thing_p_index_get(thing, name);
 
     for (vec_each(thing->items.vec, ti_prop_t, prop))
         if (prop->name == name)
@@ -214,6 +222,16 @@ static inline ti_prop_t * ti_thing_o_prop_weak_get(
     return NULL;
 }
 
+static inline ti_prop_t * ti_thing_o_prop_weak_get(
+        ti_thing_t * thing,
+        ti_name_t * name)
+{
+    if (ti_thing_is_dict(thing))
+        return smap_get(thing->items.smap, name->str);
+
+    return ti_thing_p_prop_weak_get(thing, name);
+}
+
 #define thing_t_each(t__, name__, val__)                        \
     void ** v__ = t__->items.vec->data,                         \
     ** e__ = v__ + t__->items.vec->n,                           \
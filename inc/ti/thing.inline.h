@@ -105,10 +105,8 @@ static inline ti_val_t * ti_thing_p_val_weak_get(
         ti_thing_t * thing,
         ti_name_t * name)
 {
-    for (vec_each(thing->items.vec, ti_prop_t, prop))
-        if (prop->name == name)
-            return prop->val;
-    return NULL;
+    ti_prop_t * prop = ti_thing_p_prop_weak_get(thing, name);
+    return prop ? prop->val : NULL;
 }
 
 static inline ti_val_t * ti_thing_o_val_weak_get(
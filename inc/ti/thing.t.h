@@ -9,7 +9,8 @@
  *
  * 2. - Object with strict keys, each key is compatible with the name
  * convention. In this case the properties are stored in a vector as key/value
- * pairs. The order is not important.
+ * pairs. The order is not important. Objects with many properties are
+ * additionally stored in a hash index, see ti_thing_p_prop_weak_get().
  *
  * 3. - Object might have keys which are not strict. Properties are stored in
  * a "smap" lookup as key/value pairs. The keys must be UTF-8 compatible and
@@ -57,6 +58,15 @@ enum
     TI_THING_FLAG_DICT      =1<<2,      /* thing is an object and items are
                                            stored in the smap_t. */
     TI_THING_FLAG_DEEP      =1<<3,      /* used for deep copy/duplication */
+    TI_THING_FLAG_INDEX     =1<<4,      /* thing is an object with strict
+                                           keys and the properties are also
+                                           stored in the property index. */
+    TI_THING_FLAG_PACKED    =1<<5,      /* packed data for clients is stored
+                                           in the pack cache. */
+    TI_THING_FLAG_IMPORT    =1<<6,      /* thing is created by an unfinished
+                                           streaming import; the import holds
+                                           a reference and the thing is not
+                                           garbage collected. */
 };
 
 union ti_thing_via_items
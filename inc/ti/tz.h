@@ -5,7 +5,9 @@
 #define TI_TZ_H_
 
 #include <stddef.h>
+#include <time.h>
 #include <ti/val.t.h>
+#include <util/tzif.h>
 typedef struct ti_tz_s ti_tz_t;
 
 #define TI_TZ_UTC_INDEX 0
@@ -15,12 +17,14 @@ struct ti_tz_s
     char * name;    /* null terminated string */
     size_t n;       /* size excluding null terminator */
     size_t index;   /* index number */
+    tzif_t * tzif;  /* loaded on first use, may be NULL */
+    _Bool loaded;   /* true when loading the zone is tried */
 };
 
 void ti_tz_init(void);
-void ti_tz_set_utc(void);
-void ti_tz_set(ti_tz_t * tz);
-void ti_tz_set_offset(int16_t offset);
+void ti_tz_destroy(void);
+int ti_tz_localtime(ti_tz_t * tz, time_t ts, struct tm * tm);
+time_t ti_tz_mktime(ti_tz_t * tz, struct tm * tm);
 ti_tz_t * ti_tz_utc(void);
 ti_tz_t * ti_tz_from_index(size_t tz_index);
 ti_tz_t * ti_tz_from_strn(register const char * s, register size_t n);
@@ -15,6 +15,7 @@
 extern ti_val_t * val__async_name;
 extern ti_val_t * val__data_name;
 extern ti_val_t * val__time_name;
+extern ti_val_t * val__profile_name;
 extern ti_val_t * val__year_name;
 extern ti_val_t * val__month_name;
 extern ti_val_t * val__day_name;
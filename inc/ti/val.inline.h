@@ -948,6 +948,11 @@ static inline ti_val_t * ti_val_time_name(void)
     return ti_incref(val__time_name), val__time_name;
 }
 
+static inline ti_val_t * ti_val_profile_name(void)
+{
+    return ti_incref(val__profile_name), val__profile_name;
+}
+
 static inline ti_val_t * ti_val_year_name(void)
 {
     return ti_incref(val__year_name), val__year_name;
@@ -0,0 +1,42 @@
+/*
+ * ti/vhash.h
+ */
+#ifndef TI_VHASH_H_
+#define TI_VHASH_H_
+
+typedef struct ti_vhash_s ti_vhash_t;
+typedef struct ti_vhash_item_s ti_vhash_item_t;
+
+#include <inttypes.h>
+#include <ti/val.t.h>
+#include <util/vec.h>
+
+_Bool ti_val_hash(ti_val_t * val, uint64_t * hash);
+ti_vhash_t * ti_vhash_create(size_t n);
+void ti_vhash_destroy(ti_vhash_t * vhash);
+int ti_vhash_add(ti_vhash_t * vhash, ti_val_t * val);
+_Bool ti_vhash_has(ti_vhash_t * vhash, ti_val_t * val);
+
+/*
+ * A hash set for values which uses the same equality as `ti_opr_eq()`.
+ *
+ * The set does not own a reference to the values; the caller must make sure
+ * the values stay alive as long as the set is in use. Values which are
+ * compared by content but can not be hashed (list, set, regex, error etc.)
+ * are stored in the `others` vector and compared one by one.
+ */
+struct ti_vhash_item_s
+{
+    uint64_t hash;
+    ti_val_t * val;
+};
+
+struct ti_vhash_s
+{
+    size_t n;                   /* number of hashed values */
+    size_t mask;                /* size of the table - 1 */
+    vec_t * others;             /* ti_val_t, values which cannot be hashed */
+    ti_vhash_item_t * table;
+};
+
+#endif  /* TI_VHASH_H_ */
@@ -21,6 +21,7 @@ ti_vtask_t * ti_vtask_create(
 ti_vtask_t * ti_vtask_nil(void);
 void ti_vtask_destroy(ti_vtask_t * vtask);
 int ti_vtask_run(ti_vtask_t * vtask, ti_collection_t * collection);
+int ti_vtask_run_batch(vec_t * vtasks, ti_collection_t * collection);
 void ti_vtask_del(uint64_t vtask_id, ti_collection_t * collection);
 int ti_vtask_to_client_pk(ti_vtask_t * vtask, msgpack_packer * pk);
 int ti_vtask_to_store_pk(ti_vtask_t * vtask, msgpack_packer * pk);
@@ -5,6 +5,7 @@
 #define TI_VTASK_INLINE_H_
 
 #include <ex.h>
+#include <ti/tasks.h>
 #include <ti/val.inline.h>
 #include <ti/vtask.h>
 #include <ti/vtask.t.h>
@@ -26,6 +27,7 @@ static inline void ti_vtask_unsafe_drop(ti_vtask_t * vtask)
 static inline void ti_vtask_cancel(ti_vtask_t * vtask)
 {
     vtask->run_at = 0;
+    ti_tasks_unschedule(vtask);
     ti_val_drop((ti_val_t *) vtask->verr);
     vtask->verr = ti_verror_from_code(EX_CANCELLED);
 }
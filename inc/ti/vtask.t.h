@@ -13,6 +13,8 @@
 #include <ti/verror.h>
 #include <ti/vtask.t.h>
 
+#define TI_VTASK_UNSCHEDULED UINT32_MAX
+
 enum
 {
     TI_VTASK_FLAG_RUNNING   =1<<0,      /* task is running */
@@ -33,6 +35,8 @@ struct ti_vtask_s
     ti_closure_t * closure;         /* Closure to run */
     ti_verror_t * verr;             /* Last run error status */
     vec_t * args;                   /* Argument values */
+    uint32_t heap_idx;              /* Position in the scheduler or
+                                       TI_VTASK_UNSCHEDULED */
 };
 
 #endif /* TI_VTASK_T_H_ */
@@ -23,6 +23,7 @@ struct ti_web_request_s
     uv_stream_t uvstream;
     http_parser parser;
     uv_buf_t * response;
+    uv_buf_t buf;              /* allocated response, for example metrics */
 };
 
 static inline _Bool ti_web_is_handle(uv_handle_t * handle)
@@ -28,6 +28,18 @@
 /* Cached query expiration time in seconds */
 #define TI_DEFAULT_CACHE_EXPIRATION_TIME 900UL
 
+/* Maximum JIT stack size (256KiB) for regular expressions, 0=disabled */
+#define TI_DEFAULT_REGEX_JIT_STACK_SIZE 262144UL
+
+/* Parse queries with a length equal or above this threshold on a worker */
+#define TI_DEFAULT_THRESHOLD_PARSE_THREAD 4096UL
+
+/* Maximum size for packed things in the pack cache, 0=disabled */
+#define TI_DEFAULT_PACK_CACHE_SIZE 0UL
+
+/* Maximum size for cached procedure results, 0=disabled */
+#define TI_DEFAULT_PROCEDURE_CACHE_SIZE 8388608UL
+
 #define TI_COLLECTION_ID "`collection:%"PRIu64"`"
 #define TI_CHANGE_ID "`change:%"PRIu64"`"
 #define TI_NODE_ID "`node:%"PRIu32"`"
@@ -62,9 +74,14 @@
 #define TI_FN_SCHEMA 1
 
 /*
- * Export dump schema
+ * Export dump schema; a streaming export is split in segments and each
+ * segment has flags to tell if it is the first and/or the last segment.
  */
 #define TI_EXPORT_SCHEMA_V1500 1500U
+#define TI_EXPORT_SCHEMA_V1930 1930U
+
+#define TI_EXPORT_SEGMENT_FIRST 1U
+#define TI_EXPORT_SEGMENT_LAST  2U
 
 /*
  * If a system has a WORDSIZE of 64 bits, we can take advantage of storing
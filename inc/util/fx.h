@@ -37,6 +37,8 @@ char * fx_path_join_strn(
         size_t n1,
         const char * s2,
         size_t n2);
+int fx_copy(const char * src, const char * dst);
+_Bool fx_equal(const char * fn1, const char * fn2);
 
 struct fx_mmap_s
 {
@@ -0,0 +1,35 @@
+/*
+ * util/hist.h
+ *
+ * Latency histogram with log-linear buckets, similar to a HDR histogram.
+ * Each power of two is split into HIST_SUB equal sub-buckets, so a value is
+ * recorded with a relative error of at most 1/HIST_SUB. Values are durations
+ * in seconds and are stored with micro-second resolution.
+ */
+#ifndef HIST_H_
+#define HIST_H_
+
+#include <stdint.h>
+
+#define HIST_SUB_BITS 3
+#define HIST_SUB (1<<HIST_SUB_BITS)
+#define HIST_MAX_BITS 40        /* ~12 days in micro-seconds */
+#define HIST_BUCKETS ((HIST_MAX_BITS - HIST_SUB_BITS + 2) * HIST_SUB)
+
+typedef struct hist_s hist_t;
+
+hist_t * hist_create(void);
+void hist_destroy(hist_t * hist);
+void hist_reset(hist_t * hist);
+void hist_add(hist_t * hist, double duration);
+double hist_quantile(hist_t * hist, double q);
+
+struct hist_s
+{
+    uint64_t count;                     /* number of values */
+    double sum;                         /* sum of all values in seconds */
+    double max;                         /* largest value in seconds */
+    uint32_t buckets[HIST_BUCKETS];
+};
+
+#endif  /* HIST_H_ */
@@ -0,0 +1,73 @@
+/*
+ * util/jsonp.h
+ *
+ * Pull parser for JSON documents. The parser does not use callbacks, each
+ * call to jsonp_next() returns the next token so the caller can build its
+ * own values directly.
+ *
+ * Strings are scanned eight bytes at a time; as long as a string contains no
+ * escape sequences, the returned string points into the source document so
+ * no copy is made. Strings are only valid until the next call to
+ * jsonp_next() and are validated for UTF-8 encoding.
+ */
+#ifndef JSONP_H_
+#define JSONP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSONP_MAX_DEPTH 128
+
+typedef enum
+{
+    JSONP_ERR,          /* error, see `jp->errmsg` */
+    JSONP_END,          /* end of the document */
+    JSONP_NULL,
+    JSONP_TRUE,
+    JSONP_FALSE,
+    JSONP_INT,          /* value in `jp->via.i64` */
+    JSONP_FLOAT,        /* value in `jp->via.f64` */
+    JSONP_STR,          /* value in `jp->str` and `jp->n` */
+    JSONP_KEY,          /* value in `jp->str` and `jp->n` */
+    JSONP_MAP_START,
+    JSONP_MAP_END,
+    JSONP_ARR_START,
+    JSONP_ARR_END,
+} jsonp_tp_t;
+
+typedef enum
+{
+    JSONP_ERR_NONE,
+    JSONP_ERR_SYNTAX,
+    JSONP_ERR_MAX_DEPTH,
+    JSONP_ERR_ALLOC,
+} jsonp_err_t;
+
+typedef struct jsonp_s jsonp_t;
+
+void jsonp_init(jsonp_t * jp, const void * data, size_t n);
+void jsonp_clear(jsonp_t * jp);
+jsonp_tp_t jsonp_next(jsonp_t * jp);
+
+struct jsonp_s
+{
+    const char * str;           /* JSONP_STR and JSONP_KEY */
+    size_t n;                   /* JSONP_STR and JSONP_KEY */
+    union
+    {
+        int64_t i64;            /* JSONP_INT */
+        double f64;             /* JSONP_FLOAT */
+    } via;
+    const char * errmsg;        /* JSONP_ERR */
+    jsonp_err_t err;            /* JSONP_ERR */
+    uint32_t deep;              /* current container depth */
+    /* private */
+    const char * pt_;
+    const char * end_;
+    char * buf_;                /* unescaped strings and floats */
+    size_t sz_;
+    int state_;
+    uint8_t stack_[JSONP_MAX_DEPTH];
+};
+
+#endif  /* JSONP_H_ */
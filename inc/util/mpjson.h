@@ -12,6 +12,7 @@
 #include <yajl/yajl_gen.h>
 #include <yajl/yajl_parse.h>
 #include <inttypes.h>
+#include <util/jsonp.h>
 #include <util/mpack.h>
 #include <ex.h>
 
@@ -22,14 +23,6 @@ enum
     MPJSON_FLAG_VALIDATE_UTF8   =1<<4,
 };
 
-typedef struct
-{
-    msgpack_packer pk;
-    size_t deep;
-    size_t buf_n[YAJL_MAX_DEPTH];
-    uint32_t count[YAJL_MAX_DEPTH];
-} mpjson_convert_t;
-
 static yajl_gen_status mp__to_json(yajl_gen g, mp_unp_t * up)
 {
     mp_obj_t obj;
@@ -171,151 +164,96 @@ static void __attribute__((unused))mpjson__set_err(ex_t * e, yajl_gen_status sta
     ex_set(e, EX_INTERNAL, "JSON unexpected error");
 }
 
-static int reformat_null(void * ctx)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    ++c->count[c->deep];
-    return 0 == msgpack_pack_nil(&c->pk);
-}
-
-static int reformat_boolean(void * ctx, int boolean)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    ++c->count[c->deep];
-    return 0 == mp_pack_bool(&c->pk, boolean);
-}
-
-static int reformat_integer(void * ctx, long long i)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    ++c->count[c->deep];
-    return 0 == msgpack_pack_int64(&c->pk, i);
-}
-
-static int reformat_double(void * ctx, double d)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    ++c->count[c->deep];
-    return 0 == msgpack_pack_double(&c->pk, d);
-}
-
-static int reformat_string(void * ctx, const unsigned char * s, size_t n)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    ++c->count[c->deep];
-    return 0 == mp_pack_strn(&c->pk, s, n);
-}
-
-static int reformat_start_map(void * ctx)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    msgpack_sbuffer * buffer = c->pk.data;
-
-    ++c->count[c->deep];
-    if (++c->deep >= YAJL_MAX_DEPTH)
-        return 0;  /* error */
-
-    c->count[c->deep] = 0;
-    c->buf_n[c->deep] = buffer->size+1;
-
-    return 0 == msgpack_pack_map(&c->pk, 0x10000UL);
-}
-
-static int reformat_map_key(void * ctx, const unsigned char * s, size_t n)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    return 0 == mp_pack_strn(&c->pk, s, n);
-}
-
-static int reformat_end_map(void * ctx)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    msgpack_sbuffer * buffer = c->pk.data;
-
-    _msgpack_store32(buffer->data + c->buf_n[c->deep], c->count[c->deep]);
-    --c->deep;
-
-    return 1;  /* success */
-}
-
-static int reformat_start_array(void * ctx)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    msgpack_sbuffer * buffer = c->pk.data;
-
-    ++c->count[c->deep];
-    if (++c->deep >= YAJL_MAX_DEPTH)
-        return 0;  /* error */
-
-    c->count[c->deep] = 0;
-    c->buf_n[c->deep] = buffer->size+1;
-
-    return 0 == msgpack_pack_array(&c->pk, 0x10000L);
-}
-
-static int reformat_end_array(void * ctx)
-{
-    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
-    msgpack_sbuffer * buffer = c->pk.data;
-
-    _msgpack_store32(buffer->data + c->buf_n[c->deep], c->count[c->deep]);
-    --c->deep;
-
-    return 1;  /* success */
-}
-
-static yajl_callbacks mpjson__callbacks = {
-    reformat_null,
-    reformat_boolean,
-    reformat_integer,
-    reformat_double,
-    NULL,
-    reformat_string,
-    reformat_start_map,
-    reformat_map_key,
-    reformat_end_map,
-    reformat_start_array,
-    reformat_end_array
-};
-
-static void take_buffer(
-        msgpack_sbuffer * buffer,
-        char ** dst,
-        size_t * dst_n)
-{
-    *dst = buffer->data;
-    *dst_n = buffer->size;
-    memset(buffer, 0, sizeof(msgpack_sbuffer));
-}
-
-static yajl_status __attribute__((unused))mpjson_json_to_mp(
+/*
+ * Convert JSON to MessagePack using the JSON pull parser. Maps and arrays are
+ * packed with a 32 bit size which is written when the container is closed.
+ * Returns 0 when successful and the result is written to `dst`.
+ */
+static int __attribute__((unused))mpjson_json_to_mp(
         const void * src,
         size_t src_n,
         char ** dst,
         size_t * dst_n)
 {
-    yajl_handle hand;
+    jsonp_t jp;
+    msgpack_packer pk;
     msgpack_sbuffer buffer;
-    yajl_status stat = yajl_status_error;
-    mpjson_convert_t ctx = {0};
+    size_t buf_n[JSONP_MAX_DEPTH];
+    uint32_t count[JSONP_MAX_DEPTH];
+    uint32_t deep = 0;
+    int rc = -1;
 
     if (mp_sbuffer_alloc_init(&buffer, src_n, 0))
-        return stat;
-
-    msgpack_packer_init(&ctx.pk, &buffer, msgpack_sbuffer_write);
+        return rc;
 
-    hand = yajl_alloc(&mpjson__callbacks, NULL, &ctx);
-    if (!hand)
-        goto fail;
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+    jsonp_init(&jp, src, src_n);
+    count[0] = 0;
 
-    stat = yajl_parse(hand, src, src_n);
-    if (stat == yajl_status_ok)
-        take_buffer(&buffer, dst, dst_n);
+    while (1)
+    {
+        jsonp_tp_t tp = jsonp_next(&jp);
+        switch (tp)
+        {
+        case JSONP_ERR:
+            goto done;
+        case JSONP_END:
+            /* take the buffer; destroying the empty buffer is safe */
+            *dst = buffer.data;
+            *dst_n = buffer.size;
+            memset(&buffer, 0, sizeof(msgpack_sbuffer));
+            rc = 0;
+            goto done;
+        case JSONP_NULL:
+            ++count[deep];
+            if (msgpack_pack_nil(&pk))
+                goto done;
+            continue;
+        case JSONP_TRUE:
+        case JSONP_FALSE:
+            ++count[deep];
+            if (mp_pack_bool(&pk, tp == JSONP_TRUE))
+                goto done;
+            continue;
+        case JSONP_INT:
+            ++count[deep];
+            if (msgpack_pack_int64(&pk, jp.via.i64))
+                goto done;
+            continue;
+        case JSONP_FLOAT:
+            ++count[deep];
+            if (msgpack_pack_double(&pk, jp.via.f64))
+                goto done;
+            continue;
+        case JSONP_STR:
+            ++count[deep];
+            /* fall through */
+        case JSONP_KEY:
+            if (mp_pack_strn(&pk, jp.str, jp.n))
+                goto done;
+            continue;
+        case JSONP_MAP_START:
+        case JSONP_ARR_START:
+            ++count[deep++];
+            count[deep] = 0;
+            buf_n[deep] = buffer.size + 1;
+            if (tp == JSONP_MAP_START
+                    ? msgpack_pack_map(&pk, 0x10000UL)
+                    : msgpack_pack_array(&pk, 0x10000UL))
+                goto done;
+            continue;
+        case JSONP_MAP_END:
+        case JSONP_ARR_END:
+            _msgpack_store32(buffer.data + buf_n[deep], count[deep]);
+            --deep;
+            continue;
+        }
+    }
 
-    yajl_free(hand);
-fail:
+done:
+    jsonp_clear(&jp);
     msgpack_sbuffer_destroy(&buffer);
-    return stat;
+    return rc;
 }
 
 #endif  /* MPJSON_H_ */
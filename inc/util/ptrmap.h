@@ -0,0 +1,41 @@
+/*
+ * util/ptrmap.h
+ *
+ * Open addressing hash map with a pair of pointers as key. The map uses
+ * linear probing and removes entries using backward shift deletion, so no
+ * tombstones are left behind. Pointers are compared by address only; the
+ * key pointers must therefore be unique for the lifetime of an entry.
+ */
+#ifndef PTRMAP_H_
+#define PTRMAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PTRMAP_MIN_SZ 64
+
+typedef struct ptrmap_s ptrmap_t;
+typedef struct ptrmap__s ptrmap__t;
+
+ptrmap_t * ptrmap_create(void);
+void ptrmap_destroy(ptrmap_t * ptrmap);
+void * ptrmap_get(ptrmap_t * ptrmap, const void * a, const void * b);
+int ptrmap_set(ptrmap_t * ptrmap, const void * a, const void * b, void * data);
+void * ptrmap_pop(ptrmap_t * ptrmap, const void * a, const void * b);
+
+/* private */
+struct ptrmap__s
+{
+    const void * a_;
+    const void * b_;
+    void * data_;               /* NULL when the slot is empty */
+};
+
+struct ptrmap_s
+{
+    size_t n;                   /* number of entries */
+    size_t mask_;               /* size - 1, size is a power of two */
+    ptrmap__t * slots_;
+};
+
+#endif  /* PTRMAP_H_ */
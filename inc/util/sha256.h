@@ -0,0 +1,27 @@
+/*
+ * util/sha256.h
+ */
+#ifndef SHA256_H_
+#define SHA256_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_BLOCK_SIZE 64
+
+typedef struct sha256_s sha256_t;
+
+void sha256_init(sha256_t * ctx);
+void sha256_update(sha256_t * ctx, const void * data, size_t n);
+void sha256_final(sha256_t * ctx, unsigned char * digest);
+void sha256(const void * data, size_t n, unsigned char * digest);
+
+struct sha256_s
+{
+    uint32_t state[8];
+    uint64_t n;                             /* total size in bytes */
+    unsigned char block[SHA256_BLOCK_SIZE];
+};
+
+#endif /* SHA256_H_ */
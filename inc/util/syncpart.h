@@ -5,12 +5,20 @@
 #define SYNCPART_H_
 
 #include <ex.h>
+#include <sys/types.h>
+#include <util/buf.h>
 #include <util/mpack.h>
+#include <util/sha256.h>
 
 #ifndef SYNCPART_SIZE
 #define SYNCPART_SIZE 131072UL
 #endif
 
+/*
+ * Size of a digest for a single part, see syncpart_digest(..).
+ */
+#define SYNCPART_DIGEST_SIZE SHA256_DIGEST_SIZE
+
 int syncpart_to_pk(msgpack_packer * pk, const char * fn, off_t offset);
 
 int syncpart_write(
@@ -20,4 +28,31 @@ int syncpart_write(
         off_t offset,
         ex_t * e);
 
+int syncpart_write_at(
+        const char * fn,
+        const unsigned char * data,
+        size_t size,
+        off_t offset,
+        off_t fsize,
+        ex_t * e);
+
+void syncpart_digest(
+        const unsigned char * data,
+        size_t size,
+        unsigned char * digest);
+
+int syncpart_digests(const char * fn, off_t * fsize, buf_t * buf);
+
+size_t syncpart_compress(
+        const unsigned char * data,
+        size_t size,
+        unsigned char * dst,
+        size_t dst_size);
+
+int syncpart_decompress(
+        const unsigned char * data,
+        size_t size,
+        unsigned char * dst,
+        size_t dst_size);
+
 #endif  /* SYNCPART_H_ */
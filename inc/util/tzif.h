@@ -0,0 +1,69 @@
+/*
+ * util/tzif.h
+ *
+ * Reader for compiled time zone information files (TZif, RFC 8536) as found
+ * in /usr/share/zoneinfo. A loaded zone is immutable, so conversions do not
+ * depend on the TZ environment variable and are safe to use from multiple
+ * threads.
+ */
+#ifndef TZIF_H_
+#define TZIF_H_
+
+#include <stdint.h>
+#include <time.h>
+
+#define TZIF_ABBR_SZ 16
+
+typedef struct tzif_s tzif_t;
+typedef struct tzif_type_s tzif_type_t;
+typedef struct tzif_date_s tzif_date_t;
+typedef struct tzif_rule_s tzif_rule_t;
+
+tzif_t * tzif_load(const char * fn);
+void tzif_destroy(tzif_t * tzif);
+int tzif_localtime(tzif_t * tzif, int64_t ts, struct tm * tm);
+int64_t tzif_mktime(tzif_t * tzif, struct tm * tm);
+int tzif_gmtime(int64_t ts, int32_t utoff, struct tm * tm);
+int64_t tzif_timegm(struct tm * tm);
+
+struct tzif_type_s
+{
+    int32_t utoff;                  /* seconds east of UTC */
+    uint32_t isdst;
+    const char * abbr;
+};
+
+struct tzif_date_s
+{
+    char kind;                      /* 'J', 'D' or 'M' */
+    int m, w, d;                    /* month, week and day for 'M' */
+    int32_t time;                   /* local time of day in seconds */
+};
+
+/*
+ * POSIX TZ rule from the footer, used for time stamps after the last
+ * transition.
+ */
+struct tzif_rule_s
+{
+    tzif_type_t std;
+    tzif_type_t dst;
+    tzif_date_t start;
+    tzif_date_t end;
+    _Bool has_dst;
+    char std_abbr[TZIF_ABBR_SZ];
+    char dst_abbr[TZIF_ABBR_SZ];
+};
+
+struct tzif_s
+{
+    uint32_t timecnt;               /* number of transitions */
+    uint32_t typecnt;               /* number of local time types */
+    int64_t * times;                /* transition times, ascending */
+    uint8_t * idx;                  /* type index for each transition */
+    tzif_type_t * types;
+    char * chars;                   /* time zone abbreviations */
+    tzif_rule_t * rule;             /* NULL when there is no footer rule */
+};
+
+#endif  /* TZIF_H_ */
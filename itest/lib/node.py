@@ -75,6 +75,7 @@ class Node:
         self.pipe_client_name = options.pop('pipe_client_name', None)
         self.threshold_full_storage = options.pop('threshold_full_storage', 10)
         self.gcloud_key_file = options.pop('gcloud_key_file', None)
+        self.pack_cache_size = options.pop('pack_cache_size', None)
 
         self.storage_path = os.path.join(THINGSDB_TESTDIR, f'tdb{n}')
         self.cfgfile = os.path.join(THINGSDB_TESTDIR, f't{n}.conf')
@@ -194,6 +195,9 @@ class Node:
         if self.gcloud_key_file is not None:
             config.set('thingsdb', 'gcloud_key_file',  self.gcloud_key_file)
 
+        if self.pack_cache_size is not None:
+            config.set('thingsdb', 'pack_cache_size', self.pack_cache_size)
+
         config.set('thingsdb', 'storage_path', self.storage_path)
 
         if self.ws_cert_file is not None:
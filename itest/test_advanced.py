@@ -2966,5 +2966,70 @@ mod_enum('E', 'mod', 'A', {
         self.assertEqual(wrap_nm, "<F>")
 
 
+    async def test_batch(self, client: Client):
+        REQ_QUERY, REQ_RUN, REQ_BATCH = 34, 37, 42
+
+        await client.query("""//ti
+            .batch_n = 0;
+            new_procedure('add_batch_n', |n| .batch_n += n);
+            new_procedure('get_batch_n', || .batch_n);
+        """)
+        async def get_changes_committed():
+            counters = await client.query('counters()', scope='@n')
+            return counters['changes_committed']
+
+        changes_committed = await get_changes_committed()
+
+        res = await client._write_pkg(REQ_BATCH, ['//stuff', [
+            [REQ_QUERY, '.batch_n += 1;'],
+            [REQ_QUERY, '.batch_n + x;', {'x': 10}],
+            [REQ_RUN, 'add_batch_n', [5]],
+            [REQ_QUERY, '.batch_n += ;'],
+            [REQ_RUN, 'get_batch_n'],
+            [REQ_RUN, 'no_such_procedure', []],
+            [REQ_QUERY, 'raise("failed");'],
+            [REQ_QUERY, '.batch_n *= 2;'],
+        ]])
+
+        self.assertEqual(len(res), 8)
+        self.assertEqual(res[0], 1)
+        self.assertEqual(res[1], 11)
+        self.assertEqual(res[2], 6)
+        self.assertEqual(res[3]['error_code'], -52)  # syntax error
+        self.assertEqual(res[4], 6)
+        self.assertEqual(res[5]['error_code'], -54)  # lookup error
+        self.assertEqual(res[6]['error_msg'], 'failed')
+        self.assertEqual(res[7], 12)
+
+        # all changes in the batch are committed with a single change
+        self.assertEqual(
+            await get_changes_committed(),
+            changes_committed + 1)
+        self.assertEqual(await client.query('.batch_n;'), 12)
+
+        # a batch without changes
+        res = await client._write_pkg(REQ_BATCH, ['//stuff', [
+            [REQ_QUERY, '.batch_n;'],
+            [REQ_RUN, 'get_batch_n', []],
+        ]])
+        self.assertEqual(res, [12, 12])
+        self.assertEqual(
+            await get_changes_committed(),
+            changes_committed + 1)
+
+        with self.assertRaisesRegex(
+                TypeError,
+                r'expecting a `batch` request to contain an array with at '
+                r'least one query as second value'):
+            await client._write_pkg(REQ_BATCH, ['//stuff', []])
+
+        res = await client._write_pkg(REQ_BATCH, ['//stuff', [
+            [REQ_QUERY, '.batch_n;'],
+            [99, '.batch_n;'],
+        ]])
+        self.assertEqual(res[0], 12)
+        self.assertIn('unsupported request type `99`', res[1]['error_msg'])
+
+
 if __name__ == '__main__':
     run_test(TestAdvanced())
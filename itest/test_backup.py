@@ -134,6 +134,60 @@ class TestBackup(TestBase):
 
         self.assertNotEqual(res['result_code'], 0)
 
+    async def test_incremental_restore(self, client):
+        with self.assertRaisesRegex(
+                ValueError,
+                r'incremental backups are not supported with '
+                r'Google Cloud storage'):
+            await client.query(r'''new_backup('gs://some_bucket/dir/');''')
+
+        with self.assertRaisesRegex(
+                ValueError,
+                r'option `change_id` requires an incremental backup'):
+            await client.query(r'''
+                restore('/tmp/test.tar.gz', {change_id: 1});
+            ''', scope='@t')
+
+        await client.query(r'''new_backup('/tmp/test_incremental/');''')
+
+        # in 50 seconds both nodes should have been in `away` mode
+        await asyncio.sleep(50)
+
+        await client.query(r''' .foo = 'bar'; ''', scope='//stuff')
+        change_id = await client.query(
+            'node_info().load().committed_change_id;')
+        await client.query(r''' .foo = 'baz'; ''', scope='//stuff')
+
+        await client.query(r'''new_backup('/tmp/test_incremental/');''')
+
+        # in 50 seconds both nodes should have been in `away` mode
+        await asyncio.sleep(50)
+
+        await client.query(r'''del_collection('stuff');''', scope='@t')
+
+        with self.assertRaisesRegex(
+                ValueError,
+                r'cannot restore to `change:\d+` since the last change in '
+                r'incremental backup'):
+            await client.query(r'''
+                restore('/tmp/test_incremental/', {change_id: 1 << 60});
+            ''', scope='@t')
+
+        await client.query(r'''
+            restore('/tmp/test_incremental/', {change_id: change_id});
+        ''', scope='@t', change_id=change_id)
+
+        client.close()
+        await client.wait_closed()
+
+        # in 30 seconds synchronization should have been finished
+        await asyncio.sleep(30)
+
+        client = await get_client(self.node0)
+        foo = await client.query('.foo;', scope='//stuff')
+
+        self.assertEqual(foo, 'bar')
+
 
 if __name__ == '__main__':
     run_test(TestBackup())
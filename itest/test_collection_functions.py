@@ -2922,6 +2922,74 @@ class TestCollectionFunctions(TestBase):
         self.assertEqual(await client.query('[1, 1, 1].unique()'), [1])
         self.assertEqual(await client.query('[[1, 1]].unique()'), [[1, 1]])
         self.assertEqual(await client.query('[[1, 1]][0].unique()'), [1])
+        self.assertEqual(
+            await client.query('[1, 1.0, true, "1", 2.5, 2.5].unique()'),
+            [1, "1", 2.5])
+        self.assertEqual(
+            await client.query('[[1], [1], "a", "a", nil, nil].unique()'),
+            [[1], "a", None])
+        self.assertEqual(
+            await client.query('range(20000).map(|x| str(x % 100)).unique()'),
+            [str(x) for x in range(100)])
+
+    async def test_difference(self, client):
+        with self.assertRaisesRegex(
+                LookupError,
+                'type `nil` has no function `difference`'):
+            await client.query('nil.difference();')
+
+        with self.assertRaisesRegex(
+                NumArgumentsError,
+                'function `difference` takes 1 argument but 0 were given'):
+            await client.query('[].difference();')
+
+        with self.assertRaisesRegex(
+                TypeError,
+                r'function `difference` expects argument 1 to be of '
+                r'type `list` or type `tuple` but got type `nil` instead'):
+            await client.query('[].difference(nil);')
+
+        self.assertEqual(await client.query('[].difference([1])'), [])
+        self.assertEqual(await client.query('[1, 2].difference([])'), [1, 2])
+        self.assertEqual(
+            await client.query('[1, 2, 2, 3, "a"].difference([2.0, "a"])'),
+            [1, 3])
+        self.assertEqual(
+            await client.query('[[1], [2]].difference([[2]])'),
+            [[1]])
+        self.assertEqual(
+            await client.query('range(10000).difference(range(1, 10000))'),
+            [0])
+
+    async def test_intersection(self, client):
+        with self.assertRaisesRegex(
+                LookupError,
+                'type `nil` has no function `intersection`'):
+            await client.query('nil.intersection();')
+
+        with self.assertRaisesRegex(
+                NumArgumentsError,
+                'function `intersection` takes 1 argument but 2 were given'):
+            await client.query('[].intersection([], []);')
+
+        with self.assertRaisesRegex(
+                TypeError,
+                r'function `intersection` expects argument 1 to be of '
+                r'type `list` or type `tuple` but got type `str` instead'):
+            await client.query('[].intersection("a");')
+
+        self.assertEqual(await client.query('[].intersection([1])'), [])
+        self.assertEqual(await client.query('[1, 2].intersection([])'), [])
+        self.assertEqual(
+            await client.query('[1, 2, 2, 3, "a"].intersection([2.0, "a"])'),
+            [2, 2, "a"])
+        self.assertEqual(
+            await client.query('[[1], [2]].intersection([[2]])'),
+            [[2]])
+        self.assertEqual(
+            await client.query(
+                'range(10000).intersection(range(9998, 20000))'),
+            [9998, 9999])
 
     async def test_extend_unique(self, client):
         with self.assertRaisesRegex(
@@ -4234,6 +4302,8 @@ class TestCollectionFunctions(TestBase):
         self.assertTrue(await client.query(r'/hello.*/.test("hello!");'))
         self.assertFalse(await client.query(r'/hi/.test("Hi");'))
         self.assertFalse(await client.query(r'/hello!.*/.test("hello");'))
+        self.assertTrue(await client.query(r'/(*UTF)^h.llo$/.test("hällo");'))
+        self.assertFalse(await client.query(r'/^h.llo$/.test("hällo");'))
 
     async def test_match(self, client):
         with self.assertRaisesRegex(
@@ -4954,6 +5024,12 @@ class TestCollectionFunctions(TestBase):
             '!This Is _some_ very _nice_ test!! _yeah_',
         ])
 
+        # the same (shared) regular expression used within the closure
+        res = await client.query(r"""//ti
+            'a-b a-b'.replace(/a-b/, |w| w.replace(/a-b/, 'x'));
+        """)
+        self.assertEqual(res, 'x x')
+
     async def test_values(self, client):
         with self.assertRaisesRegex(
                 LookupError,
@@ -5715,6 +5791,29 @@ class TestCollectionFunctions(TestBase):
         self.assertIs(await client.query('json_load("");'), None)
         self.assertEqual(await client.query('json_load("{}");'), {})
 
+        with self.assertRaisesRegex(
+                ValueError,
+                'parse error: premature EOF'):
+            await client.query('json_load("[1, 2");')
+
+        with self.assertRaisesRegex(
+                ValueError,
+                'parse error: trailing garbage'):
+            await client.query('json_load("[1, 2] 3");')
+
+        res = await client.query(r"""//ti
+            [
+                json_load('{"b": 1, "a": "\u00e9\ud83d\ude00"}'),
+                json_load('{"b": 1, "a": 2}').keys(),
+                json_load('{"c d": [-1.5, 2]}')
+            ];
+        """)
+        self.assertEqual(res, [
+            {"b": 1, "a": "\u00e9\U0001F600"},
+            ["b", "a"],
+            {"c d": [-1.5, 2]}
+        ])
+
     async def test_log(self, client):
         with self.assertRaisesRegex(
                 NumArgumentsError,
@@ -6118,6 +6217,46 @@ class TestCollectionFunctions(TestBase):
         r = await q('[nil].max()')
         self.assertEqual(r, None)
 
+    async def test_profile(self, client):
+        q = client.query
+
+        with self.assertRaisesRegex(
+                LookupError,
+                'type `nil` has no function `profile`'):
+            await q('nil.profile();')
+
+        with self.assertRaisesRegex(
+                NumArgumentsError,
+                'function `profile` takes 1 argument but 0 were given;'):
+            await q('profile();')
+
+        with self.assertRaisesRegex(
+                ZeroDivisionError,
+                'division or modulo by zero'):
+            await q('profile(1/0);')
+
+        r = await q(r"""//ti
+            square = |x| x * x;
+            profile(range(10).map(|x| square(x)).sum());
+        """)
+        self.assertEqual(r['data'], 285)
+        self.assertIsInstance(r['time'], float)
+
+        names = [node['name'] for node in r['profile']]
+        self.assertEqual(names, ['range', 'map', 'sum'])
+
+        node = r['profile'][1]
+        self.assertEqual(node['calls'], 1)
+        self.assertIsInstance(node['time'], float)
+        self.assertEqual(len(node['profile']), 1)
+        self.assertEqual(node['profile'][0]['name'], 'square')
+        self.assertEqual(node['profile'][0]['calls'], 10)
+        self.assertEqual(node['profile'][0]['profile'], [])
+
+        # profiling ends with the profile function
+        r = await q('[profile(now()), now()];')
+        self.assertEqual(len(r[0]['profile']), 1)
+
 
 if __name__ == '__main__':
     run_test(TestCollectionFunctions())
@@ -441,6 +441,36 @@ class TestDict(TestBase):
             .dict["my set"].add({}, x);
         ''')
 
+    async def test_large_object(self, client):
+        # objects with many properties use a hash index for lookups
+        res = await client.query(r'''
+            .large = {};
+            range(200).each(|i| .large.set(`k{i}`, i));
+            [.large.len(), .large.k0, .large.k150, .large.has('k200')];
+        ''')
+        self.assertEqual(res, [200, 0, 150, False])
+
+        res = await client.query(r'''
+            range(0, 200, 2).each(|i| .large.del(`k{i}`));
+            .large.ren('k199', 'last');
+            .large.k1 = 'one';
+            [.large.len(), .large.has('k0'), .large.k1, .large.last];
+        ''')
+        self.assertEqual(res, [100, False, 'one', 199])
+
+        res = await client.query(r'''
+            x = .large.copy();
+            x.k3 += 1;
+            [x.k3, .large.k3, x.keys().len(), x.values().len()];
+        ''')
+        self.assertEqual(res, [4, 3, 100, 100])
+
+        res = await client.query(r'''
+            .large["not a name"] = 0;
+            [.large.len(), .large.k5, .large.get("not a name")];
+        ''')
+        self.assertEqual(res, [101, 5, 0])
+
 
 if __name__ == '__main__':
     run_test(TestDict())
@@ -1,4 +1,6 @@
 #!/usr/bin/env python
+import asyncio
+import msgpack
 from lib import run_test
 from lib import default_test_setup
 from lib.testbase import TestBase
@@ -268,6 +270,221 @@ class TestImport(TestBase):
                 assert(.msg == 'Hello world!');
             """)
 
+    async def test_segments(self, client0, client1):
+        await client0.query(r"""//ti
+            set_enum('Color', {RED: 'red', BLUE: 'blue'});
+            set_type('Node', {
+                name: 'str',
+                color: 'Color',
+                children: '{Node}',
+                parent: '{Node}',
+            });
+            mod_type('Node', 'rel', 'children', 'parent');
+            new_procedure('count', || .nodes.len());
+            .root = Node{name: 'root'};
+            .nodes = range(500).map(|i| {
+                n = Node{name: `node-${i}`, color: Color{BLUE}};
+                .root.children.add(n);
+                n;
+            });
+            .dict = {};
+            .dict['not a name'] = {x: .nodes[0]};
+            .me = .;
+            .task = task(datetime().move('days', 1), |_, n| n, [.nodes[1]]);
+        """)
+
+        segments = []
+        segment = None
+        while True:
+            res = await client0.query(r"""//ti
+                export({segment:, segment_size: 1024});
+            """, segment=segment)
+            segments.append(res['data'])
+            segment = res['next']
+            if segment is None:
+                break
+
+        self.assertGreater(len(segments), 4)
+
+        with self.assertRaisesRegex(
+                ValueError,
+                'invalid segment; expecting `nil` for the first segment or '
+                'the value of `next` from the previous segment'):
+            await client0.query('export({segment: [0, 0, 0]});')
+
+        with self.assertRaisesRegex(
+                TypeError,
+                'segment must be of type `nil` or `list` but '
+                'got type `int` instead;'):
+            await client0.query('export({segment: 1});')
+
+        with self.assertRaisesRegex(
+                ValueError,
+                'segment_size must be a value between 1024 and 268435456'):
+            await client0.query('export({segment: nil, segment_size: 1});')
+
+        res = await client0.query(r"""//ti
+            export({segment: nil});
+        """)
+        await client0.query('.x = 1;')
+        with self.assertRaisesRegex(
+                OperationError,
+                'the collection has changed after the first segment was '
+                'exported; start again using `nil` as segment'):
+            await client0.query(r"""//ti
+                export({segment:});
+            """, segment=res['next'])
+
+        await client0.query(r"""//ti
+            del_collection('copy') if has_collection('copy');
+            new_collection('copy');
+        """, scope='@thingsdb')
+
+        with self.assertRaisesRegex(
+                OperationError,
+                'collection not empty; collection `stuff` contains'):
+            await client0.query('import(data);', data=segments[0])
+
+        for data in segments:
+            await client0.query(r"""//ti
+                import(data, {import_tasks: true});
+            """, data=data, scope='//copy')
+
+        for client in (client0, client1):
+            await client.query(r"""//ti
+                wse();
+                assert(.root.children.len() == 500);
+                assert(.nodes.len() == 500);
+                assert(.nodes[0].parent.one() == .root);
+                assert(.nodes[42].name == 'node-42');
+                assert(.nodes[42].color == Color{BLUE});
+                assert(.dict['not a name'].x == .nodes[0]);
+                assert(.me == .);
+                assert(.task.args()[0] == .nodes[1]);
+                assert(run('count') == 500);
+            """, scope='//copy')
+
+        await client0.query(r"""//ti
+            del_collection('copy');
+        """, scope='@thingsdb')
+
+    async def test_segments_abort(self, client0, client1):
+        await client0.query(r"""//ti
+            .items = range(200).map(|i| {name: `item-${i}`});
+        """)
+
+        async def export():
+            segments = []
+            segment = None
+            while True:
+                res = await client0.query(r"""//ti
+                    export({segment:, segment_size: 1024});
+                """, segment=segment)
+                segments.append(res['data'])
+                segment = res['next']
+                if segment is None:
+                    return segments
+
+        segments = await export()
+        other = await export()
+        self.assertGreater(len(segments), 4)
+
+        await client0.query(r"""//ti
+            del_collection('copy') if has_collection('copy');
+            new_collection('copy');
+        """, scope='@thingsdb')
+
+        with self.assertRaisesRegex(
+                OperationError,
+                'no streaming import is in progress; '
+                'start with the first export segment'):
+            await client0.query('import(data);', data=segments[1],
+                                scope='//copy')
+
+        # a rejected first segment must not start a streaming import
+        unpacker = msgpack.Unpacker(raw=False)
+        unpacker.feed(segments[0])
+        unpacker.read_array_header()
+        unpacker.skip()  # schema
+        version = unpacker.unpack()
+        newer = segments[0].replace(
+            msgpack.packb(version),
+            msgpack.packb(f'99{version[version.index("."):]}'), 1)
+
+        with self.assertRaisesRegex(
+                ValueError,
+                'export is created using ThingsDB version `99.'):
+            await client0.query('import(data);', data=newer, scope='//copy')
+
+        for client in (client0, client1):
+            with self.assertRaisesRegex(
+                    OperationError,
+                    'collection `copy` has no unfinished streaming import'):
+                await client.query('import(nil);', scope='//copy')
+
+        for data in segments[:3]:
+            await client0.query('import(data);', data=data, scope='//copy')
+
+        with self.assertRaisesRegex(
+                OperationError,
+                'export segment belongs to another streaming import'):
+            await client0.query('import(data);', data=other[3],
+                                scope='//copy')
+
+        with self.assertRaisesRegex(
+                OperationError,
+                'collection not empty; collection `copy` has an unfinished '
+                'streaming import; use `import\\(nil\\)` to abort'):
+            await client0.query('import(data);', data=other[0],
+                                scope='//copy')
+
+        # the import must survive a restart and the garbage collector
+        await self.node1.shutdown()
+        await self.node1.run()
+        await self.wait_nodes_ready(client0)
+        await asyncio.sleep(2)
+
+        for data in segments[3:]:
+            await client0.query('import(data);', data=data, scope='//copy')
+
+        for client in (client0, client1):
+            res = await client.query(r"""//ti
+                wse();
+                .items.map(|i| i.name);
+            """, scope='//copy')
+            self.assertEqual(res, [f'item-{i}' for i in range(200)])
+
+        with self.assertRaisesRegex(
+                OperationError,
+                'collection `copy` has no unfinished streaming import'):
+            await client0.query('import(nil);', scope='//copy')
+
+        await client0.query(r"""//ti
+            del_collection('copy');
+            new_collection('copy');
+        """, scope='@thingsdb')
+
+        for data in segments[:3]:
+            await client0.query('import(data);', data=data, scope='//copy')
+
+        with self.assertRaisesRegex(
+                NumArgumentsError,
+                'function `import` takes no options when aborting a '
+                'streaming import'):
+            await client0.query('import(nil, {});', scope='//copy')
+
+        await client0.query('import(nil);', scope='//copy')
+
+        for client in (client0, client1):
+            with self.assertRaisesRegex(
+                    OperationError,
+                    'collection `copy` has no unfinished streaming import'):
+                await client.query('import(nil);', scope='//copy')
+
+        await client0.query(r"""//ti
+            del_collection('copy');
+        """, scope='@thingsdb')
+
 
 if __name__ == '__main__':
     run_test(TestImport())
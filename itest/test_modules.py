@@ -127,6 +127,10 @@ class TestModules(TestBase):
             "scope": "@collection:stuff",
             "status": "module not installed",
             "tasks": 0,
+            "calls": 0,
+            "average_latency": 0.0,
+            "max_latency": 0.0,
+            "workers": [],
         })
 
         await client.query(r'''
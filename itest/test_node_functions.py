@@ -1,4 +1,6 @@
 #!/usr/bin/env python
+import asyncio
+import urllib.request
 from lib import run_test
 from lib import default_test_setup
 from lib.testbase import TestBase
@@ -32,7 +34,7 @@ class TestNodeFunctions(TestBase):
 
         counters = await client.query('counters();')
 
-        self.assertEqual(len(counters), 20)
+        self.assertEqual(len(counters), 26)
 
         self.assertIn("average_change_duration", counters)
         self.assertIn("average_query_duration", counters)
@@ -50,6 +52,12 @@ class TestNodeFunctions(TestBase):
         self.assertIn("queries_success", counters)
         self.assertIn("queries_with_error", counters)
         self.assertIn("quorum_lost", counters)
+        self.assertIn("regex_cache_hits", counters)
+        self.assertIn("regex_jit_matches", counters)
+        self.assertIn("pack_cache_hits", counters)
+        self.assertIn("pack_cache_misses", counters)
+        self.assertIn("procedure_cache_hits", counters)
+        self.assertIn("procedure_cache_misses", counters)
         self.assertIn("started_at", counters)
         self.assertIn("tasks_success", counters)
         self.assertIn("tasks_with_error", counters)
@@ -71,6 +79,12 @@ class TestNodeFunctions(TestBase):
         self.assertTrue(isinstance(counters["queries_success"], int))
         self.assertTrue(isinstance(counters["queries_with_error"], int))
         self.assertTrue(isinstance(counters["quorum_lost"], int))
+        self.assertTrue(isinstance(counters["regex_cache_hits"], int))
+        self.assertTrue(isinstance(counters["regex_jit_matches"], int))
+        self.assertTrue(isinstance(counters["pack_cache_hits"], int))
+        self.assertTrue(isinstance(counters["pack_cache_misses"], int))
+        self.assertTrue(isinstance(counters["procedure_cache_hits"], int))
+        self.assertTrue(isinstance(counters["procedure_cache_misses"], int))
         self.assertTrue(isinstance(counters["started_at"], int))
         self.assertTrue(isinstance(counters["tasks_success"], int))
         self.assertTrue(isinstance(counters["tasks_with_error"], int))
@@ -84,7 +98,7 @@ class TestNodeFunctions(TestBase):
 
         node = await client.query('node_info();')
 
-        self.assertEqual(len(node), 42)
+        self.assertEqual(len(node), 54)
 
         self.assertIn("node_id", node)
         self.assertIn("version", node)
@@ -128,6 +142,18 @@ class TestNodeFunctions(TestBase):
         self.assertIn('architecture', node)
         self.assertIn('platform', node)
         self.assertIn('commit_history', node)
+        self.assertIn('cached_regex', node)
+        self.assertIn('regex_jit_stack_size', node)
+        self.assertIn('sync_compression', node)
+        self.assertIn('sync_parts_in_flight', node)
+        self.assertIn('sync_bytes_compared', node)
+        self.assertIn('sync_bytes_sent', node)
+        self.assertIn('sync_bytes_received', node)
+        self.assertIn('threshold_parse_thread', node)
+        self.assertIn('pack_cache_size', node)
+        self.assertIn('cached_things', node)
+        self.assertIn('procedure_cache_size', node)
+        self.assertIn('cached_procedure_results', node)
 
         self.assertTrue(isinstance(node["node_id"], int))
         self.assertTrue(isinstance(node["version"], str))
@@ -215,6 +241,52 @@ class TestNodeFunctions(TestBase):
         counters = await client.query('counters();')
         self.assertEqual(counters["queries_with_error"], 0)
 
+    async def test_metrics(self, client):
+        await client.query('nil;', scope='@t')
+
+        url = f'http://localhost:{self.node0.http_status_port}/metrics'
+        loop = asyncio.get_running_loop()
+        resp = await loop.run_in_executor(None, urllib.request.urlopen, url)
+        self.assertEqual(resp.status, 200)
+
+        lines = resp.read().decode().splitlines()
+        self.assertIn(
+            '# TYPE thingsdb_query_duration_seconds summary', lines)
+        self.assertIn(
+            '# TYPE thingsdb_procedure_duration_seconds summary', lines)
+
+        count = [
+            line for line in lines
+            if line.startswith('thingsdb_query_duration_seconds_count ')]
+        self.assertEqual(len(count), 1)
+        self.assertGreater(int(count[0].split()[1]), 0)
+
+        p99 = [
+            line for line in lines
+            if line.startswith(
+                'thingsdb_query_duration_seconds{quantile="0.99"} ')]
+        self.assertEqual(len(p99), 1)
+        self.assertGreaterEqual(float(p99[0].split()[1]), 0.0)
+
+        # labels for long procedure names must not be truncated
+        name = 'p' * 255
+        await client.query(f'new_procedure("{name}", || nil);', scope='@t')
+        await client.run(name, scope='@t')
+
+        resp = await loop.run_in_executor(None, urllib.request.urlopen, url)
+        lines = resp.read().decode().splitlines()
+        labels = f'scope="@thingsdb",procedure="{name}"'
+        self.assertIn(
+            f'thingsdb_procedure_duration_seconds_count{{{labels}}} 1', lines)
+
+        await client.query(f'del_procedure("{name}");', scope='@t')
+
+        # only the GET method is allowed
+        req = urllib.request.Request(url, data=b'', method='POST')
+        with self.assertRaises(urllib.error.HTTPError) as cm:
+            await loop.run_in_executor(None, urllib.request.urlopen, req)
+        self.assertEqual(cm.exception.code, 405)
+
     async def test_set_log_level(self, client):
         with self.assertRaisesRegex(
                 NumArgumentsError,
@@ -390,6 +390,37 @@ class TestOperators(TestBase):
                 3.0 << 1;
             """)
 
+    async def test_str_append(self, client):
+        res = await client.query(r"""//ti
+            s = '';
+            for (i in range(1000)) {
+                s += `{i},`;
+            };
+            s;
+        """)
+        self.assertEqual(res, ''.join(f'{i},' for i in range(1000)))
+
+        # values which are referenced elsewhere must not change
+        res = await client.query(r"""//ti
+            .s = 'a';
+            s = .s;
+            s += 'b';
+            t = s;
+            s += 'c';
+            n = 'x';
+            n += 'y';
+            [.s, s, t, n];
+        """)
+        self.assertEqual(res, ['a', 'abc', 'ab', 'xy'])
+
+        res = await client.query(r"""//ti
+            s = 'a';
+            s += 'b';
+            s += bytes('c');
+            [type(s), s];
+        """)
+        self.assertEqual(res, ['bytes', b'abc'])
+
 
 if __name__ == '__main__':
     run_test(TestOperators())
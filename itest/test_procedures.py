@@ -523,8 +523,9 @@ class TestProcedures(TestBase):
             await client.query('procedure_info("0123");')
 
         procedure_info = await client.query('procedure_info("square");')
-        self.assertEqual(len(procedure_info), 6)
+        self.assertEqual(len(procedure_info), 8)
         self.assertEqual(procedure_info['with_side_effects'], False)
+        self.assertEqual(procedure_info['cache_ttl'], 0)
         self.assertEqual(procedure_info['arguments'], ['x'])
         self.assertEqual(procedure_info['name'], 'square')
         self.assertEqual(procedure_info['doc'], 'No side effects.')
@@ -532,7 +533,7 @@ class TestProcedures(TestBase):
         self.assertTrue(isinstance(procedure_info['definition'], str))
 
         procedure_info = await client.query('procedure_info("set_a");')
-        self.assertEqual(len(procedure_info), 6)
+        self.assertEqual(len(procedure_info), 8)
         self.assertEqual(procedure_info['with_side_effects'], True)
         self.assertEqual(procedure_info['arguments'], ['a'])
         self.assertEqual(procedure_info['name'], 'set_a')
@@ -571,7 +572,7 @@ class TestProcedures(TestBase):
         procedures_info = await client.query('procedures_info();')
         self.assertEqual(len(procedures_info), 2)
         for info in procedures_info:
-            self.assertEqual(len(info), 6)
+            self.assertEqual(len(info), 8)
             self.assertEqual(len(info['arguments']), 1)
             self.assertTrue(isinstance(info['with_side_effects'], bool))
             self.assertTrue(isinstance(info['name'], str))
@@ -630,6 +631,82 @@ class TestProcedures(TestBase):
         self.assertEqual(await client.query('run("test", 6);'), 60)
         self.assertEqual(await client.query('wse(run("test_wse", 42));'), 42)
 
+        self.assertEqual(await client.run('test', 2), 20)
+        self.assertEqual(await client.query('test(3);'), 30)
+
+        info = await client.query('procedure_info("test");')
+        profile = info['profile']
+        self.assertEqual(profile['calls'], 4)
+        self.assertIsInstance(profile['time'], float)
+        self.assertIsInstance(profile['average'], float)
+
+    async def test_procedure_cache(self, client):
+        await client.query(r"""//ti
+            .x = 1;
+            new_procedure('rnd', |a| [a, .x, rand()]);
+            new_procedure('set_x', |x| .x = x);
+        """)
+
+        with self.assertRaisesRegex(
+                NumArgumentsError,
+                'function `set_procedure_cache` takes 2 arguments '
+                'but 1 was given'):
+            await client.query('set_procedure_cache("rnd");')
+
+        with self.assertRaisesRegex(
+                LookupError,
+                'procedure `xxx` not found'):
+            await client.query('set_procedure_cache("xxx", 60);')
+
+        with self.assertRaisesRegex(
+                TypeError,
+                r'function `set_procedure_cache` expects argument 2 to be '
+                r'of type `int` but got type `nil` instead'):
+            await client.query('set_procedure_cache("rnd", nil);')
+
+        with self.assertRaisesRegex(
+                ValueError,
+                r'function `set_procedure_cache` expects argument 2 to be '
+                r'a value between 0 and 4294967295 \(seconds\)'):
+            await client.query('set_procedure_cache("rnd", -1);')
+
+        with self.assertRaisesRegex(
+                OperationError,
+                r'procedure `set_x` has side effects; only the results of '
+                r'procedures without side effects can be cached'):
+            await client.query('set_procedure_cache("set_x", 60);')
+
+        # without a cache, the procedure runs each time
+        a = await client.run('rnd', 1)
+        b = await client.run('rnd', 1)
+        self.assertNotEqual(a, b)
+
+        res = await client.query('set_procedure_cache("rnd", 60);')
+        self.assertIs(res, None)
+        info = await client.query('procedure_info("rnd");')
+        self.assertEqual(info['cache_ttl'], 60)
+
+        a = await client.run('rnd', 1)
+        b = await client.run('rnd', 1)
+        c = await client.run('rnd', 2)
+        self.assertEqual(a, b)
+        self.assertNotEqual(a, c)
+        self.assertEqual(c[0], 2)
+
+        # a change in the collection invalidates the cached results
+        await client.run('set_x', 5)
+        b = await client.run('rnd', 1)
+        self.assertNotEqual(a, b)
+        self.assertEqual(b[1], 5)
+
+        counters = await client.query('counters();', scope='@node')
+        self.assertGreaterEqual(counters['procedure_cache_hits'], 1)
+
+        await client.query('set_procedure_cache("rnd", 0);')
+        a = await client.run('rnd', 1)
+        b = await client.run('rnd', 1)
+        self.assertNotEqual(a, b)
+
     async def test_thing_argument(self, client):
         await client.query(r"""//ti
             new_procedure('test_save_thing', |t| .t = t);
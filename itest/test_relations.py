@@ -21,7 +21,11 @@ class TestRelations(TestBase):
             WARNING: Test requires a second node!!!
         ''')
 
-    @default_test_setup(num_nodes=2, seed=1, threshold_full_storage=10)
+    @default_test_setup(
+            num_nodes=2,
+            seed=1,
+            threshold_full_storage=10,
+            pack_cache_size=1048576)
     async def async_run(self):
 
         await self.node0.init_and_run()
@@ -1648,6 +1652,76 @@ mod_type('D', 'rel', 'da', 'db');
         """)
         self.assertEqual(res, [['many', '{CC}']])
 
+    async def test_pack_cache(self, client0):
+        # things are packed from cache; relations and type changes must
+        # invalidate the cached data, also on other nodes
+        clients = [client0]
+        if self.with_node1():
+            client1 = await get_client(self.node1)
+            client1.set_default_scope('//stuff')
+            clients.append(client1)
+
+        await client0.query(r'''
+            new_type('A');
+            new_type('B');
+            set_type('A', {name: 'str', b: 'B?'});
+            set_type('B', {name: 'str', a: 'A?'});
+            mod_type('A', 'rel', 'b', 'a');
+            .a = A{name: 'a'};
+            .b = B{name: 'b'};
+        ''')
+        await asyncio.sleep(0.2)
+
+        for client in clients:
+            for _ in range(2):
+                res = await client.query('[.a, .b];')
+                self.assertEqual(res[0]['b'], None)
+                self.assertEqual(res[1]['a'], None)
+
+        await client0.query('.a.b = .b;')
+        await asyncio.sleep(0.2)
+
+        for client in clients:
+            res = await client.query('[.a, .b, .b.id()];')
+            self.assertEqual(res[0]['b'], {'#': res[2]})
+            self.assertEqual(res[1]['a'], {'#': res[0]['#']})
+
+        await client0.query(r'''
+            mod_type('A', 'add', 'age', 'int', 6);
+            mod_type('B', 'ren', 'name', 'title');
+        ''')
+        await asyncio.sleep(0.2)
+
+        for client in clients:
+            res = await client.query('[.a, .b];')
+            self.assertEqual(res[0]['age'], 6)
+            self.assertEqual(res[1]['title'], 'b')
+
+            counters = await client.query('counters();', scope='@node')
+            self.assertGreater(counters['pack_cache_hits'], 0)
+
+        # tasks change without a task on the thing holding the task
+        await client0.query(r'''
+            .t = {task: task(datetime().move('days', 1), || nil)};
+        ''')
+        await asyncio.sleep(0.2)
+
+        for client in clients:
+            for _ in range(2):
+                res = await client.query('.t;')
+                self.assertNotIn('run_at:nil', res['task'])
+
+        await client0.query('.t.task.cancel();')
+        await asyncio.sleep(0.2)
+
+        for client in clients:
+            res = await client.query('.t;')
+            self.assertIn('run_at:nil', res['task'])
+
+        if len(clients) > 1:
+            client1.close()
+            await client1.wait_closed()
+
 
 if __name__ == '__main__':
     run_test(TestRelations())
@@ -171,6 +171,53 @@ class TestTasks(TestBase):
         self.assertFalse(await client.query('is_err(.t.err());'))
         self.assertTrue(await client.query('is_err(.f.err());'))
 
+    async def test_task_batch(self, client):
+        await client.query("""//ti
+            .counter = 0;
+            s = datetime();
+            .batch = range(50).map(|i| task(s, |t, i| {
+                .counter += 1;
+                if (i % 10 == 0) {
+                    raise('fail');
+                };
+            }, [i]));
+        """)
+        await asyncio.sleep(num_nodes*3)
+        self.assertEqual(await client.query('.counter;'), 50)
+        res = await client.query("""//ti
+            .batch.filter(|t| bool(t)).map(|t| t.err().msg());
+        """)
+        self.assertEqual(res, ['fail'] * 5)
+
+    async def test_task_batch_del(self, client):
+        # the first task which runs deletes or cancels all other tasks,
+        # including tasks which are already part of a batch
+        await client.query("""//ti
+            .del_counter = 0;
+            s = datetime();
+            .del_batch = range(6).map(|i| task(s, |t, i| {
+                .del_counter += 1;
+                .del_batch.each(|x, j| {
+                    if (j == i) {
+                        return nil;
+                    };
+                    j % 2 ? x.cancel() : x.del();
+                });
+            }, [i]));
+        """)
+        await asyncio.sleep(num_nodes*3)
+
+        for c in (client, client1 := await get_client(self.node1)):
+            self.assertEqual(await c.query('.del_counter;'), 1)
+            res = await c.query("""//ti
+                .del_batch.filter(|t| bool(t)).map(|t| is_nil(t.at()));
+            """)
+            self.assertIn(len(res), (2, 3))
+            self.assertTrue(all(res))
+
+        client1.close()
+        await client1.wait_closed()
+
     async def test_tasks(self, client):
         with self.assertRaisesRegex(
                 LookupError,
@@ -1,5 +1,6 @@
 #!/usr/bin/env python
 import asyncio
+import msgpack
 import time
 from lib import run_test
 from lib import default_test_setup
@@ -2416,5 +2417,82 @@ class TestType(TestBase):
         self.assertEqual(res[1]['data'], res[3]['data'])
 
 
+    async def test_bulk_load(self, client0):
+        await client0.query(r'''
+            set_type('Rec', {
+                name: 'str',
+                score: 'int<0:100>',
+                tags: '[str]',
+            });
+            .recs = [];
+        ''')
+
+        data = msgpack.packb([
+            ['iris', 42, ['a', 'b']],
+            {'name': 'cato', 'score': 7},
+            {'score': 100, 'name': 'tess', 'tags': ['c']},
+        ])
+
+        res = await client0.query(r'''
+            .recs.extend(bulk_load('Rec', data));
+            .recs.map(|r| [type(r), r.name, r.score, r.tags.len()]);
+        ''', data=data)
+        self.assertEqual(res, [
+            ['Rec', 'iris', 42, 2],
+            ['Rec', 'cato', 7, 0],
+            ['Rec', 'tess', 100, 1],
+        ])
+
+        # things get an Id when they are attached to the collection
+        ids = await client0.query('.recs.map(|r| r.id());')
+        self.assertTrue(all(isinstance(i, int) for i in ids))
+
+        with self.assertRaisesRegex(
+                ValueError,
+                r'record 1 for type `Rec` must have 3 values but got 2'):
+            await client0.query('bulk_load("Rec", data);', data=msgpack.packb(
+                [['a', 1, []], ['b', 2]]))
+
+        with self.assertRaisesRegex(
+                LookupError,
+                r'type `Rec` has no property `x`'):
+            await client0.query('bulk_load("Rec", data);', data=msgpack.packb(
+                [{'name': 'a', 'x': 1}]))
+
+        with self.assertRaisesRegex(
+                ValueError,
+                r'mismatch in type `Rec`'):
+            await client0.query('bulk_load("Rec", data);', data=msgpack.packb(
+                [['a', 101, []]]))
+
+        with self.assertRaisesRegex(
+                TypeError,
+                r'function `bulk_load` expects argument 2 to be of type '
+                r'`bytes` or `mpdata` but got type `str` instead'):
+            await client0.query('bulk_load("Rec", "x");')
+
+        with self.assertRaisesRegex(
+                LookupError,
+                r'type `X` not found'):
+            await client0.query('bulk_load("X", bytes());')
+
+        self.assertEqual(
+            await client0.query('bulk_load("Rec", data);', data=msgpack.packb(
+                [])),
+            [])
+
+        client1 = await get_client(self.node1)
+        client1.set_default_scope('//stuff')
+
+        await self.wait_nodes_ready(client0)
+
+        self.assertEqual(
+            await client1.query('.recs.map(|r| r.name);'),
+            ['iris', 'cato', 'tess'])
+
+        client1.close()
+        await client1.wait_closed()
+
+
 if __name__ == '__main__':
     run_test(TestType())
@@ -480,6 +480,53 @@ class TestWrap(TestBase):
         """)
         self.assertEqual(res, "IRIS")
 
+    async def test_wrap_plan(self, client):
+        # wrap maps are cached and must be dropped when a type changes
+        await client.query("""//ti
+            set_type('P', {a: 'int', b: 'str', c: 'int'});
+            set_type('_P', {a: 'int', b: 'str'}, true);
+            .plan = [P{a: 1, b: 'x', c: 2}, P{a: 3, b: 'y', c: 4}];
+        """)
+        res = await client.query("""//ti
+            .plan.map_wrap('_P');
+        """)
+        self.assertEqual(res, [{'a': 1, 'b': 'x'}, {'a': 3, 'b': 'y'}])
+
+        res = await client.query("""//ti
+            mod_type('P', 'del', 'a');
+            mod_type('P', 'add', 'a', 'str', 'z');
+            .plan.map_wrap('_P');
+        """)
+        self.assertEqual(res, [{'b': 'x'}, {'b': 'y'}])
+
+        res = await client.query("""//ti
+            mod_type('_P', 'del', 'a');
+            mod_type('_P', 'add', 'a', 'any');
+            mod_type('_P', 'add', 'c', 'int');
+            .plan.map_wrap('_P');
+        """)
+        self.assertEqual(res, [
+            {'a': 'z', 'b': 'x', 'c': 2},
+            {'a': 'z', 'b': 'y', 'c': 4}
+        ])
+
+        res = await client.query("""//ti
+            mod_type('P', 'ren', 'c', 'd');
+            .plan.map_wrap('_P');
+        """)
+        self.assertEqual(res, [{'a': 'z', 'b': 'x'}, {'a': 'z', 'b': 'y'}])
+
+        # objects with more properties than fit in the stack buffer
+        res = await client.query("""//ti
+            set_type('_Q', {}, true);
+            range(40).each(|i| mod_type('_Q', 'add', `k{i}`, 'int'));
+            o = {};
+            range(40).each(|i| o.set(`k{i}`, i));
+            w = o.wrap('_Q');
+            [w.copy().len(), w.copy().k39];
+        """)
+        self.assertEqual(res, [40, 39])
+
 
 if __name__ == '__main__':
     run_test(TestWrap())
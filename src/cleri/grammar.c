@@ -59,15 +59,6 @@ cleri_grammar_t * cleri_grammar2(
         goto fail0;
     }
 
-    grammar->md_keywords = \
-        pcre2_match_data_create_from_pattern(grammar->re_keywords, NULL);
-
-    if (grammar->md_keywords == NULL)
-    {
-        fprintf(stderr, "failed to create keyword match data\n");
-        goto fail1;
-    }
-
     grammar->re_whitespace = pcre2_compile(
             (PCRE2_SPTR8) re_ws,
             PCRE2_ZERO_TERMINATED,
@@ -88,23 +79,12 @@ cleri_grammar_t * cleri_grammar2(
         goto fail1;
     }
 
-    grammar->md_whitespace = \
-        pcre2_match_data_create_from_pattern(grammar->re_whitespace, NULL);
-
-    if (grammar->md_whitespace == NULL)
-    {
-        fprintf(stderr, "failed to create whitespace match data\n");
-        goto fail2;
-    }
-
     /* bind root element and increment the reference counter */
     grammar->start = start;
     cleri_incref(start);
 
     return grammar;
 
-fail2:
-    pcre2_code_free(grammar->re_whitespace);
 fail1:
     pcre2_code_free(grammar->re_keywords);
 fail0:
@@ -119,9 +99,7 @@ cleri_grammar_t * cleri_grammar(cleri_t * start, const char * re_keywords)
 
 void cleri_grammar_free(cleri_grammar_t * grammar)
 {
-    pcre2_match_data_free(grammar->md_keywords);
     pcre2_code_free(grammar->re_keywords);
-    pcre2_match_data_free(grammar->md_whitespace);
     pcre2_code_free(grammar->re_whitespace);
     cleri_free(grammar->start);
     free(grammar);
@@ -49,12 +49,12 @@ uint8_t cleri__kwcache_match(cleri_parse_t * pr, const char * str)
                     PCRE2_ZERO_TERMINATED,
                     0,                     // start looking at this point
                     PCRE2_ANCHORED,        // OPTIONS
-                    pr->grammar->md_keywords,
+                    pr->md,
                     NULL);
 
         *len = pcre_exec_ret < 0
             ? 0
-            : pcre2_get_ovector_pointer(pr->grammar->md_keywords)[1];
+            : pcre2_get_ovector_pointer(pr->md)[1];
     }
     return *len;
 }
@@ -3,6 +3,7 @@
  */
 #include <cleri/expecting.h>
 #include <cleri/parse.h>
+#include <cleri/rxscan.h>
 #include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
@@ -34,13 +35,17 @@ cleri_parse_t * cleri_parse2(
     pr->str = str;
     pr->tree = NULL;
     pr->kwcache = NULL;
+    pr->rxcache = NULL;
+    pr->rxcache_n = 0;
     pr->expecting = NULL;
+    pr->md = NULL;
     pr->is_valid = 0;
     pr->grammar = grammar;
 
     if (    (pr->tree = cleri__node_new(NULL, str, 0)) == NULL ||
             (pr->kwcache = cleri__kwcache_new(str)) == NULL ||
-            (pr->expecting = cleri__expecting_new(str, flags)) == NULL)
+            (pr->expecting = cleri__expecting_new(str, flags)) == NULL ||
+            (pr->md = pcre2_match_data_create(1, NULL)) == NULL)
     {
         cleri_parse_free(pr);
         return NULL;
@@ -117,6 +122,8 @@ void cleri_parse_free(cleri_parse_t * pr)
 {
     cleri__node_free(pr->tree);
     free(pr->kwcache);
+    cleri__rxscan_free(pr->rxcache);
+    pcre2_match_data_free(pr->md);
     if (pr->expecting != NULL)
     {
         cleri__expecting_free(pr->expecting);
@@ -349,8 +356,8 @@ static inline uint32_t parse__whitespace(cleri_parse_t * pr, const char * str)
             PCRE2_ZERO_TERMINATED,
             0,                     // start looking at this point
             PCRE2_ANCHORED,        // OPTIONS
-            pr->grammar->md_whitespace,
+            pr->md,
             NULL) < 0
             ? n
-            : n + pcre2_get_ovector_pointer(pr->grammar->md_whitespace)[1];
+            : n + pcre2_get_ovector_pointer(pr->md)[1];
 }
@@ -76,19 +76,7 @@ cleri_t * cleri_regex(uint32_t gid, const char * pattern)
         return NULL;
     }
 
-    cl_object->via.regex->match_data = pcre2_match_data_create_from_pattern(
-            cl_object->via.regex->regex,
-            NULL);
-
-    if (cl_object->via.regex->match_data == NULL)
-    {
-        pcre2_code_free(cl_object->via.regex->regex);
-        fprintf(stderr, "error: cannot create match data\n");
-        free(cl_object->via.regex);
-        free(cl_object);
-        return NULL;
-        return NULL;
-    }
+    cl_object->via.regex->rxscan = cleri__rxscan_kind(pattern);
 
     return cl_object;
 }
@@ -98,7 +86,6 @@ cleri_t * cleri_regex(uint32_t gid, const char * pattern)
  */
 static void regex__free(cleri_t * cl_object)
 {
-    pcre2_match_data_free(cl_object->via.regex->match_data);
     pcre2_code_free(cl_object->via.regex->regex);
     free(cl_object->via.regex);
 }
@@ -116,6 +103,21 @@ static cleri_node_t *  regex__parse(
     PCRE2_SIZE * ovector;
     const char * str = parent->str + parent->len;
     cleri_node_t * node;
+    ssize_t n;
+
+    if (cl_obj->via.regex->rxscan != CLERI_RXSCAN_NONE)
+    {
+        n = cleri__rxscan_match(pr, cl_obj->via.regex->rxscan, str);
+        if (n < 0)
+        {
+            if (cleri__expecting_update(pr->expecting, cl_obj, str) == -1)
+            {
+                pr->is_valid = -1; /* error occurred */
+            }
+            return NULL;
+        }
+        goto found;
+    }
 
     pcre_exec_ret = pcre2_match(
             cl_obj->via.regex->regex,
@@ -123,7 +125,7 @@ static cleri_node_t *  regex__parse(
             PCRE2_ZERO_TERMINATED,
             0,                     // start looking at this point
             0,                     // OPTIONS
-            cl_obj->via.regex->match_data,
+            pr->md,
             NULL);
 
     if (pcre_exec_ret < 0)
@@ -134,12 +136,15 @@ static cleri_node_t *  regex__parse(
         }
         return NULL;
     }
-    ovector = pcre2_get_ovector_pointer(cl_obj->via.regex->match_data);
+    ovector = pcre2_get_ovector_pointer(pr->md);
 
     /* since each regex pattern should start with ^ we now sub_str_vec[0]
      * should be 0. sub_str_vec[1] contains the end position in the sting
      */
-    if ((node = cleri__node_new(cl_obj, str, (size_t) ovector[1])) != NULL)
+    n = (ssize_t) ovector[1];
+
+found:
+    if ((node = cleri__node_new(cl_obj, str, (size_t) n)) != NULL)
     {
         parent->len += node->len;
         cleri__node_add(parent, node);
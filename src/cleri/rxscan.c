@@ -0,0 +1,419 @@
+/*
+ * rxscan.c - native scanners for common regular expression terminals.
+ *
+ * Names, numbers, strings and regular expression literals are matched once
+ * for almost every token in a statement. A native scanner replaces pcre2 for
+ * a few well known patterns and must return exactly the same match length as
+ * pcre2 would for the pattern. Results are cached per position while parsing
+ * since choices may test the same position multiple times.
+ */
+#include <cleri/parse.h>
+#include <cleri/rxscan.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RXSCAN__NAME_MAX 255
+#define RXSCAN__NOT_FOUND UINT16_MAX
+
+/*
+ * Only the first X positions of a string are cached; this limits the cache
+ * to about 224 KiB as each position uses a slot for every scanner kind.
+ */
+#define RXSCAN__CACHE_MAX 16384
+
+static const struct
+{
+    const char * pattern;
+    cleri_rxscan_t kind;
+} rxscan__patterns[] = {
+    {
+        "^[A-Za-z_][0-9A-Za-z_]{0,254}(?![0-9A-Za-z_])",
+        CLERI_RXSCAN_NAME,
+    },
+    {
+        "^[-+]?((0b[01]+)|(0o[0-8]+)|(0x[0-9a-fA-F]+)|([0-9]+))"
+        "(?![0-9A-Za-z_\\.])",
+        CLERI_RXSCAN_INT,
+    },
+    {
+        "^[-+]?(inf|nan|[0-9]*\\.[0-9]+(e[+-][0-9]+)?)(?![0-9A-Za-z_\\.])",
+        CLERI_RXSCAN_FLOAT,
+    },
+    {
+        "^(((?:\'(?:[^\']*)\')+)|((?:\"(?:[^\"]*)\")+))",
+        CLERI_RXSCAN_STRING,
+    },
+    {
+        "^/((?:.(?!(?<![\\\\])/))*.?)/[a-z]*",
+        CLERI_RXSCAN_REGEX,
+    },
+    {
+        "^(\\s*~)*(\\s*!|\\s*[\\-+](?=[^0-9]))*",
+        CLERI_RXSCAN_PREOPR,
+    },
+    {
+        "^([^`{}]|``|{{|}})+",
+        CLERI_RXSCAN_TEMPLATE,
+    },
+};
+
+/*
+ * Character classes, the table is used instead of <ctype.h> so the result
+ * does not depend on the locale.
+ */
+enum
+{
+    RXSCAN__DIGIT   =1<<0,  /* [0-9] */
+    RXSCAN__ALPHA   =1<<1,  /* [A-Za-z_] */
+    RXSCAN__HEX     =1<<2,  /* [0-9a-fA-F] */
+    RXSCAN__SPACE   =1<<3,  /* \s */
+    RXSCAN__LOWER   =1<<4,  /* [a-z] */
+};
+
+static uint8_t rxscan__chars[256];
+
+static inline int rxscan__is(char c, int tp)
+{
+    return rxscan__chars[(unsigned char) c] & tp;
+}
+
+static inline int rxscan__is_word(char c)
+{
+    return rxscan__is(c, RXSCAN__DIGIT|RXSCAN__ALPHA);
+}
+
+static void rxscan__init_chars(void)
+{
+    int c;
+    for (c = '0'; c <= '9'; ++c)
+        rxscan__chars[c] |= RXSCAN__DIGIT|RXSCAN__HEX;
+    for (c = 'a'; c <= 'z'; ++c)
+        rxscan__chars[c] |= RXSCAN__ALPHA|RXSCAN__LOWER;
+    for (c = 'A'; c <= 'Z'; ++c)
+        rxscan__chars[c] |= RXSCAN__ALPHA;
+    for (c = 'a'; c <= 'f'; ++c)
+        rxscan__chars[c] |= RXSCAN__HEX;
+    for (c = 'A'; c <= 'F'; ++c)
+        rxscan__chars[c] |= RXSCAN__HEX;
+    rxscan__chars['_'] |= RXSCAN__ALPHA;
+    rxscan__chars[' '] |= RXSCAN__SPACE;
+    rxscan__chars['\t'] |= RXSCAN__SPACE;
+    rxscan__chars['\n'] |= RXSCAN__SPACE;
+    rxscan__chars['\v'] |= RXSCAN__SPACE;
+    rxscan__chars['\f'] |= RXSCAN__SPACE;
+    rxscan__chars['\r'] |= RXSCAN__SPACE;
+}
+
+/*
+ * Returns the scanner kind for a given pattern, or CLERI_RXSCAN_NONE if the
+ * pattern has no native scanner.
+ */
+cleri_rxscan_t cleri__rxscan_kind(const char * pattern)
+{
+    size_t i, n = sizeof(rxscan__patterns) / sizeof(rxscan__patterns[0]);
+
+    for (i = 0; i < n; ++i)
+    {
+        if (strcmp(pattern, rxscan__patterns[i].pattern) == 0)
+        {
+            if (!rxscan__chars['0'])
+            {
+                rxscan__init_chars();
+            }
+            return rxscan__patterns[i].kind;
+        }
+    }
+    return CLERI_RXSCAN_NONE;
+}
+
+/*
+ * Lookahead for numbers: (?![0-9A-Za-z_\.])
+ */
+static inline int rxscan__number_end(const char * pt)
+{
+    return !rxscan__is_word(*pt) && *pt != '.';
+}
+
+static ssize_t rxscan__name(const char * str)
+{
+    const char * pt = str;
+    if (!rxscan__is(*pt, RXSCAN__ALPHA))
+    {
+        return -1;
+    }
+    for (++pt; rxscan__is_word(*pt); ++pt);
+    return pt - str > RXSCAN__NAME_MAX ? -1 : pt - str;
+}
+
+static ssize_t rxscan__int(const char * str)
+{
+    const char * pt = str, * start;
+
+    if (*pt == '-' || *pt == '+')
+    {
+        ++pt;
+    }
+
+    if (*pt == '0' && (pt[1] == 'b' || pt[1] == 'o' || pt[1] == 'x'))
+    {
+        start = pt + 2;
+        switch (pt[1])
+        {
+        case 'b':
+            for (pt = start; *pt == '0' || *pt == '1'; ++pt);
+            break;
+        case 'o':
+            for (pt = start; *pt >= '0' && *pt <= '8'; ++pt);
+            break;
+        case 'x':
+            for (pt = start; rxscan__is(*pt, RXSCAN__HEX); ++pt);
+            break;
+        }
+        /* a decimal match can not succeed after `0b`, `0o` or `0x` */
+        return pt > start && rxscan__number_end(pt) ? pt - str : -1;
+    }
+
+    for (start = pt; rxscan__is(*pt, RXSCAN__DIGIT); ++pt);
+    return pt > start && rxscan__number_end(pt) ? pt - str : -1;
+}
+
+static ssize_t rxscan__float(const char * str)
+{
+    const char * pt = str, * start;
+
+    if (*pt == '-' || *pt == '+')
+    {
+        ++pt;
+    }
+
+    if ((pt[0] == 'i' && pt[1] == 'n' && pt[2] == 'f') ||
+        (pt[0] == 'n' && pt[1] == 'a' && pt[2] == 'n'))
+    {
+        pt += 3;
+        return rxscan__number_end(pt) ? pt - str : -1;
+    }
+
+    for (; rxscan__is(*pt, RXSCAN__DIGIT); ++pt);
+
+    if (*pt != '.')
+    {
+        return -1;
+    }
+
+    for (start = ++pt; rxscan__is(*pt, RXSCAN__DIGIT); ++pt);
+
+    if (pt == start)
+    {
+        return -1;
+    }
+
+    if (*pt == 'e' && (pt[1] == '+' || pt[1] == '-') &&
+        rxscan__is(pt[2], RXSCAN__DIGIT))
+    {
+        for (pt += 3; rxscan__is(*pt, RXSCAN__DIGIT); ++pt);
+    }
+
+    return rxscan__number_end(pt) ? pt - str : -1;
+}
+
+static ssize_t rxscan__string(const char * str)
+{
+    const char * pt = str, * end;
+    char quote = *str;
+
+    if (quote != '\'' && quote != '"')
+    {
+        return -1;
+    }
+
+    /* quotes are escaped by doubling them, like 'it''s' */
+    while (*pt == quote && (end = strchr(pt + 1, quote)) != NULL)
+    {
+        pt = end + 1;
+    }
+
+    return pt == str ? -1 : pt - str;
+}
+
+static ssize_t rxscan__regex(const char * str)
+{
+    const char * pt, * end = NULL;
+
+    if (*str != '/')
+    {
+        return -1;
+    }
+
+    /*
+     * Consume characters until the next character is a slash which is not
+     * preceded by a backslash. The `.` does not match a new line.
+     */
+    for (pt = str + 1;
+         *pt && *pt != '\n' && !(pt[1] == '/' && *pt != '\\');
+         ++pt);
+
+    if (*pt && *pt != '\n')
+    {
+        end = pt + 1;  /* closing slash */
+    }
+    else
+    {
+        /* backtrack, only an escaped slash can close the pattern */
+        while (--pt > str)
+        {
+            if (pt[1] == '/')
+            {
+                end = pt + 1;
+                break;
+            }
+            if (*pt == '/')
+            {
+                end = pt;
+                break;
+            }
+        }
+        if (end == NULL)
+        {
+            return -1;
+        }
+    }
+
+    for (++end; rxscan__is(*end, RXSCAN__LOWER); ++end);
+    return end - str;
+}
+
+static ssize_t rxscan__preopr(const char * str)
+{
+    const char * pt = str, * tmp;
+
+    while (1)
+    {
+        for (tmp = pt; rxscan__is(*tmp, RXSCAN__SPACE); ++tmp);
+        if (*tmp != '~')
+        {
+            break;
+        }
+        pt = tmp + 1;
+    }
+
+    while (1)
+    {
+        for (tmp = pt; rxscan__is(*tmp, RXSCAN__SPACE); ++tmp);
+        if (*tmp != '!' && (
+                (*tmp != '-' && *tmp != '+') ||
+                tmp[1] == '\0' ||
+                rxscan__is(tmp[1], RXSCAN__DIGIT)))
+        {
+            break;
+        }
+        pt = tmp + 1;
+    }
+
+    return pt - str;
+}
+
+static ssize_t rxscan__template(const char * str)
+{
+    const char * pt = str;
+
+    while (*pt)
+    {
+        if (*pt == '`' || *pt == '{' || *pt == '}')
+        {
+            if (pt[1] != *pt)
+            {
+                break;
+            }
+            ++pt;
+        }
+        ++pt;
+    }
+
+    return pt == str ? -1 : pt - str;
+}
+
+/*
+ * Returns the length of the match or -1 if the string does not match.
+ */
+ssize_t cleri__rxscan(cleri_rxscan_t kind, const char * str)
+{
+    switch (kind)
+    {
+    case CLERI_RXSCAN_NAME:     return rxscan__name(str);
+    case CLERI_RXSCAN_INT:      return rxscan__int(str);
+    case CLERI_RXSCAN_FLOAT:    return rxscan__float(str);
+    case CLERI_RXSCAN_STRING:   return rxscan__string(str);
+    case CLERI_RXSCAN_REGEX:    return rxscan__regex(str);
+    case CLERI_RXSCAN_PREOPR:   return rxscan__preopr(str);
+    case CLERI_RXSCAN_TEMPLATE: return rxscan__template(str);
+    case CLERI_RXSCAN_NONE:
+    case CLERI_RXSCAN_END:
+        break;
+    }
+    return -1;
+}
+
+/*
+ * Same as cleri__rxscan() but uses the cache of the parser. Elements with
+ * the same pattern share the same cache, for example `name` and `var`.
+ */
+ssize_t cleri__rxscan_match(
+        cleri_parse_t * pr,
+        cleri_rxscan_t kind,
+        const char * str)
+{
+    uint16_t * res;
+    size_t pos = str - pr->str;
+    ssize_t n;
+
+    if (*str == '\0')
+    {
+        return cleri__rxscan(kind, str);
+    }
+
+    if (pr->rxcache == NULL)
+    {
+        size_t len = strlen(pr->str);
+        pr->rxcache_n = len < RXSCAN__CACHE_MAX ? len : RXSCAN__CACHE_MAX;
+        pr->rxcache = (uint16_t *) calloc(
+                pr->rxcache_n * (CLERI_RXSCAN_END - 1),
+                sizeof(uint16_t));
+        if (pr->rxcache == NULL)
+        {
+            pr->rxcache_n = 0;
+            return cleri__rxscan(kind, str);
+        }
+    }
+
+    if (pos >= pr->rxcache_n)
+    {
+        return cleri__rxscan(kind, str);
+    }
+
+    res = &pr->rxcache[pos * (CLERI_RXSCAN_END - 1) + kind - 1];
+
+    if (*res == 0)
+    {
+        n = cleri__rxscan(kind, str);
+        if (n < 0)
+        {
+            *res = RXSCAN__NOT_FOUND;
+        }
+        else if (n + 1 < RXSCAN__NOT_FOUND)
+        {
+            *res = (uint16_t) n + 1;
+        }
+        /* very long matches are not cached */
+        return n;
+    }
+
+    return *res == RXSCAN__NOT_FOUND ? -1 : (ssize_t) *res - 1;
+}
+
+/*
+ * Destroy the cache. (parsing NULL is allowed)
+ */
+void cleri__rxscan_free(uint16_t * rxcache)
+{
+    free(rxcache);
+}
@@ -21,13 +21,17 @@
 #include <ti/procedure.h>
 #include <ti/proto.h>
 #include <ti/qbind.h>
+#include <ti/pcache.h>
 #include <ti/qcache.h>
+#include <ti/rcache.h>
 #include <ti/regex.h>
 #include <ti/room.h>
 #include <ti/signals.h>
 #include <ti/store.h>
 #include <ti/sync.h>
+#include <ti/syncfull.h>
 #include <ti/things.h>
+#include <ti/tz.h>
 #include <ti/user.h>
 #include <ti/users.h>
 #include <ti/val.inline.h>
@@ -150,6 +154,7 @@ void ti_destroy(void)
     ti__stop();
 
     ti_qcache_destroy();
+    ti_rcache_destroy();
     ti_build_destroy();
     ti_archive_destroy();
     ti_args_destroy();
@@ -181,7 +186,9 @@ void ti_destroy(void)
     /* remove late */
     ti_thing_destroy_gc();
     ti_val_drop_common();
+    ti_regex_drop_common();
     ti_do_drop();
+    ti_tz_destroy();
 
     /* sanity check to see if all references are removed as expected; */
     assert(ti_vbool_no_ref());
@@ -243,6 +250,8 @@ int ti_init(void)
         ti.cfg->query_duration_warn = ti.cfg->query_duration_error;
 
     if (ti_qcache_create() ||
+        ti_rcache_create() ||
+        ti_regex_init() ||
         ti_do_init() ||
         ti_val_init_common() ||
         ti_thing_init_gc())
@@ -844,6 +853,9 @@ void ti_update_rel_id(void)
     for (vec_each(ti.nodes->vec, ti_node_t, node))
         if (node->id < this_node_id)
             ++ti.rel_id;
+
+    /* the tasks owned by this node might have changed */
+    ti_tasks_reschedule();
 }
 
 _Bool ti_ask_continue(const char * warn)
@@ -955,9 +967,10 @@ int ti_this_node_to_pk(msgpack_packer * pk)
     double uptime = util_time_diff(&ti.boottime, &timing);
     const char * platform = osarch_get_os();
     const char * architecture = osarch_get_arch();
+    const ti_syncfull_stats_t * syncstats = ti_syncfull_stats();
 
     return (
-        msgpack_pack_map(pk, 42) ||
+        msgpack_pack_map(pk, 54) ||
         /* 1 */
         mp_pack_str(pk, "node_id") ||
         msgpack_pack_uint32(pk, ti.node->id) ||
@@ -1092,7 +1105,46 @@ int ti_this_node_to_pk(msgpack_packer * pk)
         (ti.commits
                 ? msgpack_pack_uint32(pk, ti.commits->n)
                 : mp_pack_str(pk, "disabled")
-        )
+        ) ||
+        /* 43 */
+        mp_pack_str(pk, "cached_regex") ||
+        msgpack_pack_uint64(pk, ti_regex_cache_n()) ||
+        /* 44 */
+        mp_pack_str(pk, "regex_jit_stack_size") ||
+        (ti_regex_has_jit()
+                ? msgpack_pack_uint64(pk, ti.cfg->regex_jit_stack_size)
+                : mp_pack_str(pk, "disabled")
+        ) ||
+        /* 45 */
+        mp_pack_str(pk, "sync_compression") ||
+        mp_pack_bool(pk, ti.cfg->sync_compression) ||
+        /* 46 */
+        mp_pack_str(pk, "sync_parts_in_flight") ||
+        msgpack_pack_uint64(pk, syncstats->parts_in_flight) ||
+        /* 47 */
+        mp_pack_str(pk, "sync_bytes_compared") ||
+        msgpack_pack_uint64(pk, syncstats->bytes_compared) ||
+        /* 48 */
+        mp_pack_str(pk, "sync_bytes_sent") ||
+        msgpack_pack_uint64(pk, syncstats->bytes_sent) ||
+        /* 49 */
+        mp_pack_str(pk, "sync_bytes_received") ||
+        msgpack_pack_uint64(pk, syncstats->bytes_received) ||
+        /* 50 */
+        mp_pack_str(pk, "threshold_parse_thread") ||
+        msgpack_pack_uint64(pk, ti.cfg->threshold_parse_thread) ||
+        /* 51 */
+        mp_pack_str(pk, "pack_cache_size") ||
+        msgpack_pack_uint64(pk, ti.cfg->pack_cache_size) ||
+        /* 52 */
+        mp_pack_str(pk, "cached_things") ||
+        msgpack_pack_uint64(pk, ti_pcache_n()) ||
+        /* 53 */
+        mp_pack_str(pk, "procedure_cache_size") ||
+        msgpack_pack_uint64(pk, ti.cfg->procedure_cache_size) ||
+        /* 54 */
+        mp_pack_str(pk, "cached_procedure_results") ||
+        msgpack_pack_uint64(pk, ti_rcache_n())
     );
 }
 
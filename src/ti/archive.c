@@ -224,8 +224,13 @@ static int archive__remove_files(void)
     uint64_t scid = ti_nodes_scid();
     uint64_t lseid = ti.store->last_stored_change_id;
     uint64_t threshold = lseid < scid ? lseid : scid;
+    uint64_t stream_id = ti_backups_stream_id();
     _Bool found;
 
+    /* keep the changes which are not yet in all incremental backups */
+    if (stream_id < threshold)
+        threshold = stream_id;
+
     do
     {
         found = false;
@@ -414,6 +419,7 @@ int ti_archive_to_disk(void)
 {
     size_t n;
     uint64_t leid;
+    struct timespec start;
     ti_cpkg_t * last_cpkg = queue_last(archive->queue);
 
     if (!last_cpkg || (leid = last_cpkg->change_id) == ti.node->scid)
@@ -428,8 +434,10 @@ int ti_archive_to_disk(void)
     (void) ti_sleep(100);
 
     /* archive changes, even after full store for synchronizing `other` nodes */
+    (void) clock_gettime(TI_CLOCK_MONOTONIC, &start);
     if (archive__to_disk())
         return -1;
+    (void) ti_counters_upd_hist(&ti.counters->hist_archive, &start);
 
     ti.node->scid = leid;  /* last_cpkg cannot be used, it's cleared */
 
@@ -233,7 +233,7 @@ static size_t away__syncers(void)
                     syncer->first,
                     fa_change_id == UINT64_MAX ? fs_change_id + 1 : fa_change_id,
                     fs_change_id);
-                if (ti_syncfull_start(syncer->stream))
+                if (ti_syncfull_start(syncer->stream, syncer->proto))
                     log_critical(EX_MEMORY_S);
                 continue;
             }
@@ -727,7 +727,7 @@ _Bool ti_away_is_busy(void)
     );
 }
 
-int ti_away_syncer(ti_stream_t * stream, uint64_t first)
+int ti_away_syncer(ti_stream_t * stream, uint64_t first, uint8_t proto)
 {
     ti_syncer_t * syncer;
     ti_syncer_t ** empty_syncer = NULL;
@@ -737,6 +737,7 @@ int ti_away_syncer(ti_stream_t * stream, uint64_t first)
         if ((*syncr)->stream == stream)
         {
             (*syncr)->first = first;
+            (*syncr)->proto = proto;
             return 0;
         }
         if (!(*syncr)->stream)
@@ -750,10 +751,11 @@ int ti_away_syncer(ti_stream_t * stream, uint64_t first)
         syncer = *empty_syncer;
         syncer->stream = stream;
         syncer->first = first;
+        syncer->proto = proto;
         goto finish;
     }
 
-    syncer = ti_syncer_create(stream, first);
+    syncer = ti_syncer_create(stream, first, proto);
     if (!syncer)
         return -1;
 
@@ -41,7 +41,9 @@ ti_backup_t * ti_backup_create(
     backup->next_run = next_run;
     backup->repeat = repeat;
     backup->max_files = max_files;
+    backup->stream_id = 0;
     backup->scheduled = true;
+    backup->new_chain = false;
     backup->result_code = 0;
     backup->created_at = created_at;
     if (!backup->fn_template)
@@ -169,6 +171,12 @@ _Bool ti_backup_is_gcloud(ti_backup_t * backup)
             s[4] == '/';
 }
 
+_Bool ti_backup_is_incremental(ti_backup_t * backup)
+{
+    size_t n = strlen(backup->fn_template);
+    return n && backup->fn_template[n-1] == '/';
+}
+
 char * ti_backup_gcloud_task(ti_backup_t * backup)
 {
     struct tm * tm_info;
@@ -363,3 +371,23 @@ char * ti_backup_file_task(ti_backup_t * backup)
 
     return buf.data;
 }
+
+/*
+ * Incremental backups write to the same directory on each run, therefore the
+ * template placeholders are not replaced. Returns the directory.
+ */
+char * ti_backup_incremental_task(ti_backup_t * backup)
+{
+    char * path = strdup(backup->fn_template);
+
+    ti_val_drop((ti_val_t *) backup->work_fn);
+    backup->work_fn = ti_str_from_str(backup->fn_template);
+
+    if (!backup->work_fn)
+    {
+        free(path);
+        path = NULL;
+    }
+
+    return path;
+}
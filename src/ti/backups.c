@@ -5,6 +5,7 @@
 #include <ti.h>
 #include <ti/backup.h>
 #include <ti/backups.h>
+#include <ti/ibackup.h>
 #include <ti/raw.inline.h>
 #include <ti/val.inline.h>
 #include <util/buf.h>
@@ -58,6 +59,21 @@ fail0:
     return rc;
 }
 
+static int backups__dir_rm(ti_raw_t * fn)
+{
+    int rc;
+    char * path = strndup((const char *) fn->data, fn->n);
+    if (!path)
+        return -1;
+
+    rc = fx_rmdir(path);
+    if (rc)
+        log_error("cannot remove directory: `%s`", path);
+
+    free(path);
+    return rc;
+}
+
 static void backups__rm(uv_work_t * work)
 {
     ti_raw_t * gs_str = (ti_raw_t *) ti_val_borrow_gs_str();
@@ -67,6 +83,8 @@ static void backups__rm(uv_work_t * work)
     {
         if (ti_raw_startswith(fn, gs_str))
             (void) backups__gcd_rm(fn);
+        else if (fn->n && fn->data[fn->n-1] == '/')
+            (void) backups__dir_rm(fn);
         else
             (void) fx_unlink_n((const char *) fn->data, fn->n);
     }
@@ -273,6 +291,22 @@ done:
     uv_mutex_unlock(backups->lock);
 }
 
+static void backups__success(buf_t * buf)
+{
+    char buffer[64];
+    uint64_t now = util_now_usec();
+    struct tm * tm_info;
+    tm_info = gmtime((const time_t *) &now);
+
+    free(buf->data);
+    buf_init(buf);
+
+    buf_append_str(buf, "success - ");
+
+    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%SZ", tm_info);
+    buf_append_str(buf, buffer);
+}
+
 static void backups__run(uint64_t backup_id, const char * backup_task)
 {
     char buffer[512];
@@ -302,21 +336,44 @@ static void backups__run(uint64_t backup_id, const char * backup_task)
         log_debug("%.*s", (int) buf.len, buf.data);
 
         if (rc == 0)
-        {
-            uint64_t now = util_now_usec();
-            struct tm * tm_info;
-            tm_info = gmtime((const time_t *) &now);
+            backups__success(&buf);
+    }
+
+    ti_backups_upd_status(backup_id, rc, &buf);
+    free(buf.data);
+}
+
+static void backups__run_incremental(
+        uint64_t backup_id,
+        const char * path,
+        size_t max_snapshots,
+        _Bool new_chain)
+{
+    int rc;
+    uint64_t change_id = 0;
+    ti_backup_t * backup;
+    buf_t buf;
+    buf_init(&buf);
 
-            free(buf.data);
-            buf_init(&buf);
+    log_debug("incremental backup to `%s`", path);
 
-            buf_append_str(&buf, "success - ");
+    rc = ti_ibackup_run(path, max_snapshots, new_chain, &change_id, &buf);
+    if (rc == 0)
+        backups__success(&buf);
 
-            strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%SZ", tm_info);
-            buf_append_str(&buf, buffer);
-        }
+    uv_mutex_lock(backups->lock);
+
+    backup = omap_get(backups->omap, backup_id);
+    if (backup)
+    {
+        if (rc == 0)
+            backup->stream_id = change_id;
+        else if (new_chain)
+            backup->new_chain = true;  /* try again on the next run */
     }
 
+    uv_mutex_unlock(backups->lock);
+
     ti_backups_upd_status(backup_id, rc, &buf);
     free(buf.data);
 }
@@ -349,7 +406,7 @@ static int backups__store(void)
     for (omap_each(iter, ti_backup_t, backup))
     {
         result_msg = backup->result_msg ? backup->result_msg : empty;
-        if (msgpack_pack_array(&pk, 10) ||
+        if (msgpack_pack_array(&pk, 12) ||
             msgpack_pack_uint64(&pk, backup->id) ||
             msgpack_pack_uint64(&pk, backup->created_at) ||
             msgpack_pack_uint64(&pk, backup->next_run) ||
@@ -367,6 +424,10 @@ static int backups__store(void)
         for (queue_each(backup->files, ti_raw_t, fn))
             if (mp_pack_strn(&pk, fn->data, fn->n))
                 goto fail;
+
+        if (msgpack_pack_uint64(&pk, backup->stream_id) ||
+            mp_pack_bool(&pk, backup->new_chain))
+            goto fail;
     }
 
     log_debug("stored backup schedules to file: `%s`", backups->fn);
@@ -416,7 +477,8 @@ int ti_backups_restore(void)
     fx_mmap_t fmap;
     size_t i, ii;
     mp_obj_t obj, arr, mp_ver, mp_id, mp_ts, mp_repeat, mp_template,
-             mp_fn, mp_msg, mp_plan, mp_code, mp_created, mp_max_files;
+             mp_fn, mp_msg, mp_plan, mp_code, mp_created, mp_max_files,
+             mp_stream_id, mp_new_chain;
     mp_unp_t up;
     ti_backup_t * backup;
     uint64_t now = util_now_usec();
@@ -449,6 +511,9 @@ int ti_backups_restore(void)
         if (mp_next(&up, &obj) != MP_ARR)
             goto fail1;
 
+        mp_stream_id.via.u64 = 0;
+        mp_new_chain.via.bool_ = false;
+
         switch (obj.via.sz)
         {
         case 8:
@@ -476,6 +541,11 @@ int ti_backups_restore(void)
             set_changed = true;
             break;
         case 10:
+            /*
+             * TODO: (COMPAT) Before incremental backups, backups are stored
+             *       without the stream_id and new_chain values.
+             */
+        case 12:
             if (mp_next(&up, &mp_id) != MP_U64 ||
                 mp_next(&up, &mp_created) != MP_U64 ||
                 mp_next(&up, &mp_ts) != MP_U64 ||
@@ -507,6 +577,15 @@ int ti_backups_restore(void)
                 QUEUE_push(files_queue, raw_fn);
             }
 
+            if (obj.via.sz == 12 && (
+                    mp_next(&up, &mp_stream_id) != MP_U64 ||
+                    mp_next(&up, &mp_new_chain) != MP_BOOL))
+            {
+                queue_destroy(
+                        files_queue,
+                        (queue_destroy_cb) ti_val_unsafe_drop);
+                goto fail1;
+            }
             break;
         default:
             goto fail1;
@@ -529,6 +608,8 @@ int ti_backups_restore(void)
                     : NULL;
             backup->result_code = (int) mp_code.via.i64;
             backup->scheduled = mp_plan.via.bool_;
+            backup->stream_id = mp_stream_id.via.u64;
+            backup->new_chain = mp_new_chain.via.bool_;
             if (backup->repeat)
                 while (backup->next_run < now)
                     backup->next_run += backup->repeat;
@@ -567,6 +648,9 @@ int ti_backups_backup(void)
     ti_backup_t * backup;
     uint64_t now = util_now_usec();
     uint64_t backup_id = 0;  /* At least backup Id...*/
+    size_t max_files = 0;
+    _Bool is_incremental = false;
+    _Bool new_chain = false;
 
     do
     {
@@ -587,9 +671,15 @@ int ti_backups_backup(void)
         if (backup)
         {
             backup_id = backup->id;
+            is_incremental = ti_backup_is_incremental(backup);
             backup_task = ti_backup_is_gcloud(backup)
                     ? ti_backup_gcloud_task(backup)
+                    : is_incremental
+                    ? ti_backup_incremental_task(backup)
                     : ti_backup_file_task(backup);
+            max_files = backup->max_files;
+            new_chain = backup->new_chain;
+            backup->new_chain = false;
         }
 
         uv_mutex_unlock(backups->lock);
@@ -597,7 +687,14 @@ int ti_backups_backup(void)
         if (!backup_task)
             break;
 
-        backups__run(backup_id, backup_task);
+        if (is_incremental)
+            backups__run_incremental(
+                    backup_id,
+                    backup_task,
+                    max_files,
+                    new_chain);
+        else
+            backups__run(backup_id, backup_task);
         free(backup_task);
         ++backup_id;
 
@@ -647,6 +744,55 @@ size_t ti_backups_pending(void)
     return n;
 }
 
+/*
+ * Returns the lowest change id which is written to all scheduled incremental
+ * backups, or `UINT64_MAX` when archived changes are not required. Archive
+ * files with changes after this change id must be kept so the backups can
+ * continue without a new snapshot.
+ */
+uint64_t ti_backups_stream_id(void)
+{
+    uint64_t stream_id = UINT64_MAX;
+    omap_iter_t iter;
+
+    uv_mutex_lock(backups->lock);
+
+    iter = omap_iter(backups->omap);
+    for (omap_each(iter, ti_backup_t, backup))
+        if (backup->scheduled &&
+            backup->stream_id &&
+            backup->stream_id < stream_id)
+            stream_id = backup->stream_id;
+
+    uv_mutex_unlock(backups->lock);
+
+    return stream_id;
+}
+
+/*
+ * After a restore, incremental backups must start with a new snapshot since
+ * the changes in the backup no longer match the changes in ThingsDB.
+ */
+void ti_backups_new_chains(void)
+{
+    omap_iter_t iter;
+
+    uv_mutex_lock(backups->lock);
+
+    iter = omap_iter(backups->omap);
+    for (omap_each(iter, ti_backup_t, backup))
+    {
+        if (ti_backup_is_incremental(backup))
+        {
+            backup->new_chain = true;
+            backup->stream_id = 0;
+            backups->changed = true;
+        }
+    }
+
+    uv_mutex_unlock(backups->lock);
+}
+
 _Bool ti_backups_require_away(void)
 {
     return backups->changed || ti_backups_pending() > 0;
@@ -0,0 +1,366 @@
+/*
+ * ti/batch.c
+ */
+#include <assert.h>
+#include <doc.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ti.h>
+#include <ti/access.h>
+#include <ti/auth.h>
+#include <ti/batch.h>
+#include <ti/changes.h>
+#include <ti/proto.h>
+#include <ti/qcache.h>
+#include <ti/scope.h>
+#include <ti/query.h>
+#include <ti/query.inline.h>
+#include <ti/stream.h>
+#include <util/mpack.h>
+
+static ti_batch_t * batch__create(ti_query_t * query, uint32_t n)
+{
+    ti_batch_t * batch = calloc(1, sizeof(ti_batch_t) + n * sizeof(void *));
+    if (!batch)
+        return NULL;
+
+    batch->queries = vec_new(n);
+    if (!batch->queries)
+    {
+        free(batch);
+        return NULL;
+    }
+
+    batch->n = n;
+    batch->pending = n + 1;  /* one extra while the batch query runs */
+    batch->query = query;
+    return batch;
+}
+
+void ti_batch_destroy(ti_batch_t * batch)
+{
+    if (!batch)
+        return;
+
+    vec_destroy(batch->queries, (vec_destroy_cb) ti_query_destroy_or_return);
+
+    for (uint32_t i = 0; i < batch->n; ++i)
+        free(batch->results[i]);
+
+    free(batch);
+}
+
+static int batch__pack_err(msgpack_packer * pk, ex_t * e)
+{
+    /* equal to an error package, see ti_pkg_client_err() */
+    return -(
+        msgpack_pack_map(pk, 2) ||
+        mp_pack_str(pk, "error_code") ||
+        msgpack_pack_int8(pk, e->nr) ||
+        mp_pack_str(pk, "error_msg") ||
+        mp_pack_strn(pk, e->msg, e->n)
+    );
+}
+
+static void batch__send(ti_batch_t * batch)
+{
+    ti_query_t * query = batch->query;
+    ti_pkg_t * pkg;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+    size_t alloc_sz = 16;
+    ex_t e = {0};
+
+    for (uint32_t i = 0; i < batch->n; ++i)
+        alloc_sz += batch->results[i] ? batch->results[i]->n : 64;
+
+    if (mp_sbuffer_alloc_init(&buffer, alloc_sz, sizeof(ti_pkg_t)))
+    {
+        ex_set_mem(&e);
+        goto fail;
+    }
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    msgpack_pack_array(&pk, batch->n);
+
+    for (uint32_t i = 0; i < batch->n; ++i)
+    {
+        ti_data_t * data = batch->results[i];
+        if (data)
+        {
+            if (mp_pack_append(&pk, data->data, data->n))
+                goto fail_mem;
+            continue;
+        }
+
+        /* only when storing the result has failed */
+        ex_set_mem(&e);
+        if (batch__pack_err(&pk, &e))
+            goto fail_mem;
+        ex_clear(&e);
+    }
+
+    pkg = (ti_pkg_t *) buffer.data;
+    pkg_init(pkg, query->pkg_id, TI_PROTO_CLIENT_RES_DATA, buffer.size);
+
+    if (ti_stream_write_pkg(query->via.stream, pkg))
+    {
+        free(pkg);
+        log_critical(EX_MEMORY_S);
+    }
+
+    ti_query_destroy(query);
+    return;
+
+fail_mem:
+    msgpack_sbuffer_destroy(&buffer);
+    ex_set_mem(&e);
+fail:
+    ti_query_send_response(query, &e);
+}
+
+void ti_batch_done(ti_batch_t * batch)
+{
+    if (!--batch->pending)
+        batch__send(batch);
+}
+
+/*
+ * Takes ownership of `data`.
+ */
+void ti_batch_set_data(ti_batch_t * batch, uint16_t idx, ti_data_t * data)
+{
+    assert(idx < batch->n);
+    assert(batch->results[idx] == NULL);
+
+    batch->results[idx] = data;
+    ti_batch_done(batch);
+}
+
+void ti_batch_set_err(ti_batch_t * batch, uint16_t idx, ex_t * e)
+{
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+
+    assert(idx < batch->n);
+    assert(batch->results[idx] == NULL);
+
+    /* on failure, the result is packed as a memory error when sent */
+    if (mp_sbuffer_alloc_init(&buffer, 40 + e->n, sizeof(ti_data_t)) == 0)
+    {
+        msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+        if (batch__pack_err(&pk, e) == 0)
+        {
+            ti_data_init((ti_data_t *) buffer.data, buffer.size);
+            batch->results[idx] = (ti_data_t *) buffer.data;
+        }
+        else
+            msgpack_sbuffer_destroy(&buffer);
+    }
+    ti_batch_done(batch);
+}
+
+/*
+ * Prepare a single query from the batch. The query is added to the batch
+ * when successful, otherwise the error is stored as the result.
+ */
+static void batch__query(
+        ti_batch_t * batch,
+        ti_scope_t * scope,
+        uint16_t idx,
+        const char * data,
+        size_t n)
+{
+    ex_t e = {0};
+    mp_unp_t up;
+    mp_obj_t obj, mp_tp, mp_query;
+    ti_query_t * query = NULL, * bquery = batch->query;
+    ti_user_t * user = bquery->user;
+    vec_t * access_;
+
+    mp_unp_init(&up, data, n);
+
+    if (mp_next(&up, &obj) != MP_ARR || obj.via.sz < 2 ||
+        mp_next(&up, &mp_tp) != MP_U64)
+    {
+        ex_set(&e, EX_BAD_DATA,
+                "expecting each query in a `batch` request to be an array "
+                "with a request type as first value");
+        goto fail;
+    }
+
+    switch (mp_tp.via.u64)
+    {
+    case TI_PROTO_CLIENT_REQ_QUERY:
+        if (mp_next(&up, &mp_query) != MP_STR)
+        {
+            ex_set(&e, EX_TYPE_ERROR,
+                "expecting the code in a `query` request to be of type "
+                "`string`"DOC_SOCKET_QUERY);
+            goto fail;
+        }
+
+        query = ti_scope_is_collection(scope)
+            ? ti_qcache_get_query(mp_query.via.str.data, mp_query.via.str.n, 0)
+            : ti_query_create(0);
+        if (!query)
+        {
+            ex_set_mem(&e);
+            goto fail;
+        }
+
+        query->via.stream = ti_grab(bquery->via.stream);
+        query->user = ti_grab(user);
+        query->pkg_id = idx;
+
+        if (ti_query_apply_scope(query, scope, &e) ||
+            ti_query_unpack_args(query, &up, &e))
+            goto fail;
+
+        access_ = ti_query_access(query);
+        if (ti_access_check_err(access_, user, TI_AUTH_QUERY, &e) ||
+            ti_query_parse(
+                    query,
+                    mp_query.via.str.data,
+                    mp_query.via.str.n,
+                    &e))
+            goto fail;
+        break;
+
+    case TI_PROTO_CLIENT_REQ_RUN:
+        query = ti_query_create(0);
+        if (!query)
+        {
+            ex_set_mem(&e);
+            goto fail;
+        }
+
+        query->via.stream = ti_grab(bquery->via.stream);
+        query->user = ti_grab(user);
+
+        /* the request type is at the position of the scope in a request */
+        if (ti_query_unp_run(
+                query,
+                scope,
+                idx,
+                (const unsigned char *) data,
+                n,
+                &e))
+            goto fail;
+
+        access_ = ti_query_access(query);
+        if (ti_access_check_err(access_, user, TI_AUTH_RUN, &e))
+            goto fail;
+        break;
+
+    default:
+        ex_set(&e, EX_BAD_DATA,
+                "unsupported request type `%"PRIu64"` in a `batch` request; "
+                "expecting type %d (query) or %d (run)",
+                mp_tp.via.u64,
+                TI_PROTO_CLIENT_REQ_QUERY,
+                TI_PROTO_CLIENT_REQ_RUN);
+        goto fail;
+    }
+
+    if (ti_query_wse(query) &&
+        ti_access_check_err(access_, user, TI_AUTH_CHANGE, &e))
+        goto fail;
+
+    query->batch = batch;
+    VEC_push(batch->queries, query);  /* space is reserved */
+    return;
+
+fail:
+    ++ti.counters->queries_with_error;
+    ti_query_destroy_or_return(query);
+    ti_batch_set_err(batch, idx, &e);
+}
+
+/*
+ * Returns 0 when successful, in which case the response is sent to the
+ * stream when all queries are finished. On failure, the caller is
+ * responsible for sending the error.
+ */
+int ti_batch_query(
+        ti_stream_t * stream,
+        ti_user_t * user,
+        ti_scope_t * scope,
+        mp_unp_t * up,
+        uint16_t pkg_id,
+        ex_t * e)
+{
+    mp_obj_t obj;
+    ti_query_t * query;
+    ti_batch_t * batch;
+    _Bool wse = false;
+    const char * pt;
+
+    if (mp_next(up, &obj) != MP_ARR || obj.via.sz == 0)
+    {
+        ex_set(e, EX_TYPE_ERROR,
+            "expecting a `batch` request to contain an array with at least "
+            "one query as second value");
+        return e->nr;
+    }
+
+    if (obj.via.sz > TI_BATCH_MAX_QUERIES)
+    {
+        ex_set(e, EX_MAX_QUOTA,
+            "maximum number of queries in a `batch` request is %u",
+            TI_BATCH_MAX_QUERIES);
+        return e->nr;
+    }
+
+    query = ti_query_create(0);
+    if (!query)
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    query->via.stream = ti_grab(stream);
+    query->user = ti_grab(user);
+    query->pkg_id = pkg_id;
+
+    if (ti_query_apply_scope(query, scope, e))
+        goto fail;
+
+    batch = batch__create(query, obj.via.sz);
+    if (!batch)
+    {
+        ex_set_mem(e);
+        goto fail;
+    }
+
+    query->with_tp = TI_QUERY_WITH_BATCH;
+    query->with.batch = batch;
+
+    for (uint32_t i = 0; i < batch->n; ++i)
+    {
+        pt = up->pt;
+        if (mp_skip(up) <= 0)
+        {
+            ex_set(e, EX_BAD_DATA, "invalid `batch` request");
+            goto fail;
+        }
+        batch__query(batch, scope, (uint16_t) i, pt, (size_t) (up->pt - pt));
+    }
+
+    for (vec_each(batch->queries, ti_query_t, q))
+        wse |= ti_query_wse(q);
+
+    if (wse)
+    {
+        if (ti_changes_create_new_change(query, e))
+            goto fail;
+        return 0;
+    }
+
+    ti_query_run_batch(query);
+    return 0;
+
+fail:
+    ti_query_destroy(query);
+    return e->nr;
+}
@@ -280,6 +280,122 @@ static void cfg__cache_expiration_time(
     cfg->cache_expiration_time = (size_t) option->val->integer;
 }
 
+static void cfg__regex_jit_stack_size(
+        cfgparser_t * parser,
+        const char * cfg_file)
+{
+    const char * option_name = "regex_jit_stack_size";
+
+    cfgparser_option_t * option;
+    cfgparser_return_t rc;
+    rc = cfgparser_get_option(&option, parser, cfg__section, option_name);
+
+    if (rc != CFGPARSER_SUCCESS)
+        return;
+
+    if (    option->tp != CFGPARSER_TP_INTEGER ||
+            option->val->integer < 0)
+    {
+        log_warning(
+                "error reading `%s` in `%s` "
+                "(expecting an integer value greater than, or equal to 0), "
+                "using default value %zu",
+                option_name,
+                cfg_file,
+                cfg->regex_jit_stack_size);
+        return;
+    }
+
+    cfg->regex_jit_stack_size = (size_t) option->val->integer;
+}
+
+static void cfg__threshold_parse_thread(
+        cfgparser_t * parser,
+        const char * cfg_file)
+{
+    const char * option_name = "threshold_parse_thread";
+
+    cfgparser_option_t * option;
+    cfgparser_return_t rc;
+    rc = cfgparser_get_option(&option, parser, cfg__section, option_name);
+
+    if (rc != CFGPARSER_SUCCESS)
+        return;
+
+    if (    option->tp != CFGPARSER_TP_INTEGER ||
+            option->val->integer < 0)
+    {
+        log_warning(
+                "error reading `%s` in `%s` "
+                "(expecting an integer value greater than, or equal to 0), "
+                "using default value %zu",
+                option_name,
+                cfg_file,
+                cfg->threshold_parse_thread);
+        return;
+    }
+
+    cfg->threshold_parse_thread = (size_t) option->val->integer;
+}
+
+static void cfg__pack_cache_size(
+        cfgparser_t * parser,
+        const char * cfg_file)
+{
+    const char * option_name = "pack_cache_size";
+
+    cfgparser_option_t * option;
+    cfgparser_return_t rc;
+    rc = cfgparser_get_option(&option, parser, cfg__section, option_name);
+
+    if (rc != CFGPARSER_SUCCESS)
+        return;
+
+    if (    option->tp != CFGPARSER_TP_INTEGER ||
+            option->val->integer < 0)
+    {
+        log_warning(
+                "error reading `%s` in `%s` "
+                "(expecting an integer value greater than, or equal to 0), "
+                "using default value %zu",
+                option_name,
+                cfg_file,
+                cfg->pack_cache_size);
+        return;
+    }
+
+    cfg->pack_cache_size = (size_t) option->val->integer;
+}
+
+static void cfg__procedure_cache_size(
+        cfgparser_t * parser,
+        const char * cfg_file)
+{
+    const char * option_name = "procedure_cache_size";
+
+    cfgparser_option_t * option;
+    cfgparser_return_t rc;
+    rc = cfgparser_get_option(&option, parser, cfg__section, option_name);
+
+    if (rc != CFGPARSER_SUCCESS)
+        return;
+
+    if (    option->tp != CFGPARSER_TP_INTEGER ||
+            option->val->integer < 0)
+    {
+        log_warning(
+                "error reading `%s` in `%s` "
+                "(expecting an integer value greater than, or equal to 0), "
+                "using default value %zu",
+                option_name,
+                cfg_file,
+                cfg->procedure_cache_size);
+        return;
+    }
+
+    cfg->procedure_cache_size = (size_t) option->val->integer;
+}
+
 
 static void cfg__result_size_limit(cfgparser_t * parser, const char * cfg_file)
 {
@@ -401,6 +517,10 @@ int ti_cfg_create(void)
     cfg->result_size_limit = TI_DEFAULT_RESULT_DATA_LIMIT;
     cfg->threshold_query_cache = TI_DEFAULT_THRESHOLD_QUERY_CACHE;
     cfg->cache_expiration_time = TI_DEFAULT_CACHE_EXPIRATION_TIME;
+    cfg->regex_jit_stack_size = TI_DEFAULT_REGEX_JIT_STACK_SIZE;
+    cfg->threshold_parse_thread = TI_DEFAULT_THRESHOLD_PARSE_THREAD;
+    cfg->pack_cache_size = TI_DEFAULT_PACK_CACHE_SIZE;
+    cfg->procedure_cache_size = TI_DEFAULT_PROCEDURE_CACHE_SIZE;
     cfg->ip_support = AF_UNSPEC;
     cfg->bind_client_addr = strdup("127.0.0.1");
     cfg->bind_node_addr = strdup("127.0.0.1");
@@ -411,6 +531,7 @@ int ti_cfg_create(void)
             ? strdup("/usr/lib/thingsdb-modules")
             : fx_path_join(homedir, ".thingsdb-modules/");
     cfg->wait_for_modules = 0;
+    cfg->sync_compression = 0;
     cfg->python_interpreter = strdup("python");
     cfg->gcloud_key_file = NULL;
     cfg->pipe_client_name = NULL;
@@ -526,6 +647,7 @@ int ti_cfg_parse(const char * cfg_file)
         goto exit_parse;
 
     cfg__bool(parser, cfg_file, "wait_for_modules", &cfg->wait_for_modules);
+    cfg__bool(parser, cfg_file, "sync_compression", &cfg->sync_compression);
     cfg__port(parser, cfg_file, "listen_client_port", &cfg->client_port);
     cfg__port(parser, cfg_file, "listen_node_port", &cfg->node_port);
     cfg__port(parser, cfg_file, "http_status_port", &cfg->http_status_port);
@@ -538,6 +660,10 @@ int ti_cfg_parse(const char * cfg_file)
     cfg__result_size_limit(parser, cfg_file);
     cfg__threshold_query_cache(parser, cfg_file);
     cfg__cache_expiration_time(parser, cfg_file);
+    cfg__regex_jit_stack_size(parser, cfg_file);
+    cfg__threshold_parse_thread(parser, cfg_file);
+    cfg__pack_cache_size(parser, cfg_file);
+    cfg__procedure_cache_size(parser, cfg_file);
     cfg__duration(
             parser,
             cfg_file,
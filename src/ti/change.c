@@ -14,6 +14,7 @@
 #include <ti/ctask.h>
 #include <ti/node.h>
 #include <ti/proto.h>
+#include <ti/rcache.h>
 #include <ti/task.h>
 #include <ti/ttask.h>
 #include <ti/watch.h>
@@ -166,6 +167,7 @@ static int change__run_deprecated_v0(ti_change_t * change)
             return -1;
         }
         ti_incref(change->collection);
+        ti_rcache_changed(change->collection, change->id);
     }
 
     ti_changes_keep_dropped();
@@ -268,6 +270,7 @@ int ti_change_run(ti_change_t * change)
             return -1;
         }
         ti_incref(change->collection);
+        ti_rcache_changed(change->collection, change->id);
     }
 
     ti_changes_keep_dropped();
@@ -376,6 +379,12 @@ void ti__change_log_(const char * prefix, ti_change_t * change, int log_level)
                     ? "nil"
                     : change->via.query->with.vtask->closure->node->str);
             break;
+        case TI_QUERY_WITH_BATCH:
+            (void) fprintf(
+                    Logger.ostream,
+                    "<batch: %"PRIu32" queries>",
+                    change->via.query->with.batch->n);
+            break;
         }
         break;
     case TI_CHANGE_TP_CPKG:
@@ -8,6 +8,7 @@
 #include <ti.h>
 #include <ti/access.h>
 #include <ti/auth.h>
+#include <ti/batch.h>
 #include <ti/clients.h>
 #include <ti/fwd.h>
 #include <ti/node.h>
@@ -201,6 +202,40 @@ static inline int clients__check(ti_user_t * user, ex_t * e)
     return e->nr;
 }
 
+/*
+ * Called when a query is parsed, either directly or by a worker thread.
+ */
+static void clients__query_parsed(ti_query_t * query, ex_t * e)
+{
+    ti_pkg_t * resp;
+
+    if (e->nr == 0)
+    {
+        if (!ti_query_wse(query))
+        {
+            ti_query_run_parseres(query);
+            return;
+        }
+
+        if (ti_access_check_err(
+                ti_query_access(query),
+                query->user,
+                TI_AUTH_CHANGE,
+                e) == 0 &&
+            ti_changes_create_new_change(query, e) == 0)
+            return;
+    }
+
+    ++ti.counters->queries_with_error;
+    resp = ti_pkg_client_err(query->pkg_id, e);
+    if (!resp || ti_stream_write_pkg(query->via.stream, resp))
+    {
+        free(resp);
+        log_error(EX_MEMORY_S);
+    }
+    ti_query_destroy_or_return(query);
+}
+
 static void clients__on_query(ti_stream_t * stream, ti_pkg_t * pkg)
 {
     ex_t e = {0};
@@ -303,22 +338,18 @@ query:
     access_ = ti_query_access(query);
     assert(access_);
 
-    if (ti_access_check_err(access_, query->user, TI_AUTH_QUERY, &e) ||
-        ti_query_parse(query, mp_query.via.str.data, mp_query.via.str.n, &e))
+    if (ti_access_check_err(access_, query->user, TI_AUTH_QUERY, &e))
         goto finish;
 
-    if (ti_query_wse(query))
-    {
-        assert(scope.tp != TI_SCOPE_NODE);
-
-        if (ti_access_check_err(access_, query->user, TI_AUTH_CHANGE, &e) ||
-            ti_changes_create_new_change(query, &e))
-            goto finish;
-
-        return;
-    }
+    if (ti_query_parse_work(
+            query,
+            mp_query.via.str.data,
+            mp_query.via.str.n,
+            clients__query_parsed) == 0)
+        return;  /* parsing on a worker thread */
 
-    ti_query_run_parseres(query);
+    (void) ti_query_parse(query, mp_query.via.str.data, mp_query.via.str.n, &e);
+    clients__query_parsed(query, &e);
     return;
 
 finish:
@@ -554,6 +585,72 @@ finish:
     }
 }
 
+static void clients__on_batch(ti_stream_t * stream, ti_pkg_t * pkg)
+{
+    ex_t e = {0};
+    mp_unp_t up;
+    ti_pkg_t * resp = NULL;
+    ti_node_t * this_node = ti.node, * other_node = NULL;
+    ti_user_t * user = stream->via.user;
+    ti_scope_t scope;
+
+    mp_unp_init(&up, pkg->data, pkg->n);
+
+    if (clients__check(user, &e) || ti_scope_init_from_up(&scope, &up, &e))
+        goto finish;
+
+    if (scope.tp == TI_SCOPE_NODE)
+    {
+        if (scope.via.node_id != this_node->id)
+        {
+            other_node = ti_nodes_node_by_id(scope.via.node_id);
+            if (!other_node || other_node->status <= TI_NODE_STAT_BUILDING)
+            {
+                ex_set(&e, EX_LOOKUP_ERROR,
+                        TI_NODE_ID" is not able to handle this request",
+                        scope.via.node_id);
+                goto finish;
+            }
+        }
+    }
+    else if (this_node->status < TI_NODE_STAT_READY &&
+             this_node->status != TI_NODE_STAT_SHUTTING_DOWN)
+    {
+        other_node = ti_nodes_random_ready_node();
+        if (!other_node)
+        {
+            ti_nodes_set_not_ready_err(&e);
+            goto finish;
+        }
+    }
+
+    if (other_node)
+    {
+        if (clients__fwd(other_node, stream, pkg, TI_PROTO_NODE_REQ_BATCH))
+        {
+            ex_set_internal(&e);
+            goto finish;
+        }
+        /* the response to the client will be handled by a callback on the
+         * query forward request so we simply return;
+         */
+        return;
+    }
+
+    if (ti_batch_query(stream, user, &scope, &up, pkg->id, &e) == 0)
+        return;  /* the response is sent when all queries are finished */
+
+finish:
+    ++ti.counters->queries_with_error;
+    resp = ti_pkg_client_err(pkg->id, &e);
+
+    if (!resp || ti_stream_write_pkg(stream, resp))
+    {
+        free(resp);
+        log_error(EX_MEMORY_S);
+    }
+}
+
 void ti_clients_pkg_cb(ti_stream_t * stream, ti_pkg_t * pkg)
 {
     switch (pkg->tp)
@@ -582,6 +679,9 @@ void ti_clients_pkg_cb(ti_stream_t * stream, ti_pkg_t * pkg)
     case TI_PROTO_CLIENT_REQ_EMIT_PEER:
         clients__on_emit(stream, stream, pkg);
         break;
+    case TI_PROTO_CLIENT_REQ_BATCH:
+        clients__on_batch(stream, pkg);
+        break;
     case _TI_PROTO_CLIENT_DEP_35:  /* deprecated watch request */
     case _TI_PROTO_CLIENT_DEP_36:  /* deprecated watch request */
         clients__on_deprecated(stream, pkg);
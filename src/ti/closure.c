@@ -243,6 +243,7 @@ ti_closure_t * ti_closure_from_node(cleri_node_t * node, uint8_t flags)
     closure->flags = flags;
     closure->depth = 0;
     closure->future_count = 0;
+    closure->hist = NULL;
     closure->node = node;
     closure->stacked = NULL;
     closure->vars = closure__create_vars(closure);
@@ -268,6 +269,7 @@ ti_closure_t * ti_closure_from_strn(
     closure->tp = TI_VAL_CLOSURE;
     closure->depth = 0;
     closure->future_count = 0;
+    closure->hist = NULL;
     closure->node = closure__node_from_strn(syntax, str, n, e);
     closure->flags = syntax->flags & TI_QBIND_FLAG_WSE
             ? TI_CLOSURE_FLAG_WSE
@@ -296,6 +298,7 @@ void ti_closure_destroy(ti_closure_t * closure)
     }
 
     vec_destroy(closure->vars, (vec_destroy_cb) ti_prop_destroy);
+    hist_destroy(closure->hist);
     free(closure->stacked);
     free(closure);
 }
@@ -17,6 +17,7 @@
 #include <ti/name.h>
 #include <ti/name.h>
 #include <ti/names.h>
+#include <ti/pcache.h>
 #include <ti/procedure.h>
 #include <ti/raw.inline.h>
 #include <ti/room.h>
@@ -72,6 +73,12 @@ ti_collection_t * ti_collection_create(
     collection->vtasks = vec_new(4);
     collection->named_rooms = smap_create();
     collection->commits = NULL;
+    collection->hist_query = NULL;
+    collection->index = NULL;
+    collection->pcache = NULL;
+    collection->pcache_gen = 0;
+    collection->change_id = 0;
+    collection->import_id = 0;
 
     memcpy(&collection->guid, guid, sizeof(guid_t));
 
@@ -110,7 +117,10 @@ void ti_collection_destroy(ti_collection_t * collection)
     smap_destroy(collection->ano_types, NULL);
     ti_types_destroy(collection->types);
     ti_enums_destroy(collection->enums);
+    ptrmap_destroy(collection->index);
+    ti_pcache_destroy(collection->pcache);
     uv_mutex_destroy(collection->lock);
+    hist_destroy(collection->hist_query);
     free(collection->futures);
     free(collection->lock);
     free(collection);
@@ -242,7 +252,11 @@ int ti_collection_check_empty(ti_collection_t * collection, ex_t * e)
 {
     const char * pf = "collection not empty;";
 
-    if (collection->things->n != 1)
+    if (collection->import_id)
+        ex_set(e, EX_OPERATION,
+            "%s collection `%.*s` has an unfinished streaming import; "
+            "use `import(nil)` to abort the import", pf, TCCENM);
+    else if (collection->things->n != 1)
         ex_set(e, EX_OPERATION,
             "%s collection `%.*s` contains things", pf, TCCENM);
     else if (collection->types->imap->n)
@@ -457,11 +471,13 @@ typedef struct
 {
     ti_collection_t * collection;
     uint64_t ccid;
+    _Bool keep_import;      /* keep things of an unfinished import */
 } collection__gc_t;
 
 static int collection__gc_thing(ti_thing_t * thing, collection__gc_t * w)
 {
-    if (thing->flags & TI_THING_FLAG_SWEEP)
+    if ((thing->flags & TI_THING_FLAG_SWEEP) &&
+        !(w->keep_import && (thing->flags & TI_THING_FLAG_IMPORT)))
     {
         ti_gc_t * gc = ti_gc_create(w->ccid, thing);
 
@@ -515,6 +531,7 @@ int ti_collection_gc(ti_collection_t * collection, _Bool do_mark_things)
     collection__gc_t w = {
             .collection = collection,
             .ccid = ti.node ? ti.node->ccid : 0,
+            .keep_import = do_mark_things,
     };
 
     (void) clock_gettime(TI_CLOCK_MONOTONIC, &start);
@@ -807,6 +824,46 @@ ti_pkg_t * ti_collection_leave_rooms(
     return resp;
 }
 
+static int collection__import_finish_cb(ti_thing_t * thing, vec_t ** vec)
+{
+    if (thing->flags & TI_THING_FLAG_IMPORT)
+    {
+        thing->flags &= ~TI_THING_FLAG_IMPORT;
+
+        /* things without another reference are dropped after the walk; if
+         * this fails, the thing will be removed by the garbage collector */
+        if (thing->ref > 1)
+            ti_decref(thing);
+        else
+            (void) vec_push(vec, thing);
+    }
+    return 0;
+}
+
+/*
+ * Finish or abort a streaming import; this releases the references of things
+ * created by the import.
+ */
+void ti_collection_import_release(ti_collection_t * collection)
+{
+    vec_t * vec = vec_new(8);
+
+    collection->import_id = 0;
+
+    if (!vec)
+    {
+        log_critical(EX_MEMORY_S);
+        return;
+    }
+
+    (void) imap_walk(
+            collection->things,
+            (imap_cb) collection__import_finish_cb,
+            &vec);
+
+    vec_destroy(vec, (vec_destroy_cb) ti_val_unsafe_drop);
+}
+
 /*
  * When the return value (and thus e->nr) is EX_BAD_DATA or EX_SUCCESS, the
  * collection is changed and therefore the same changes must be applied to all
@@ -817,11 +874,12 @@ int ti_collection_unpack(
         mp_unp_t * up,
         ex_t * e)
 {
-    mp_obj_t obj, mp_schema, mp_version;
+    mp_obj_t obj, mp_schema, mp_version, mp_flags, mp_import_id;
     char * version = NULL;
-    size_t i;
+    size_t i, n;
+    uint64_t flags = TI_EXPORT_SEGMENT_FIRST|TI_EXPORT_SEGMENT_LAST;
 
-    if (mp_next(up, &obj) != MP_ARR || obj.via.sz == 0 ||
+    if (mp_next(up, &obj) != MP_ARR || obj.via.sz < 2 ||
         mp_next(up, &mp_schema) != MP_U64 ||
         mp_next(up, &mp_version) != MP_STR)
     {
@@ -832,8 +890,38 @@ int ti_collection_unpack(
         return e->nr;
     }
 
-    if (mp_schema.via.u64 != TI_EXPORT_SCHEMA_V1500)
+    switch (mp_schema.via.u64)
     {
+    case TI_EXPORT_SCHEMA_V1500:
+        n = obj.via.sz - 2;
+        break;
+    case TI_EXPORT_SCHEMA_V1930:
+        if (obj.via.sz < 4 ||
+            mp_next(up, &mp_flags) != MP_U64 ||
+            mp_next(up, &mp_import_id) != MP_U64 ||
+            mp_import_id.via.u64 == 0)
+        {
+            ex_set(e, EX_VALUE_ERROR,
+                    "no valid import data; invalid export segment");
+            return e->nr;
+        }
+        flags = mp_flags.via.u64;
+        n = obj.via.sz - 4;
+
+        /* segments must belong to the import started by the first segment;
+         * no changes are made when a segment is rejected */
+        if (!(flags & TI_EXPORT_SEGMENT_FIRST) &&
+            collection->import_id != mp_import_id.via.u64)
+        {
+            ex_set(e, EX_OPERATION,
+                    collection->import_id
+                    ? "export segment belongs to another streaming import"
+                    : "no streaming import is in progress; "
+                      "start with the first export segment");
+            return e->nr;
+        }
+        break;
+    default:
         ex_set(e, EX_VALUE_ERROR,
                 "export with unknown schema `%"PRIu64"`",
                 mp_schema.via.u64);
@@ -853,8 +941,16 @@ int ti_collection_unpack(
                 "export is created using ThingsDB version `%s` which is newer "
                 "than the running version `"TI_VERSION"`",
                 version);
+        goto done;
     }
-    else for (i = obj.via.sz-2; i--;)
+
+    /* the import starts only when the header is valid as a rejected first
+     * segment does not create a task */
+    if (mp_schema.via.u64 == TI_EXPORT_SCHEMA_V1930 &&
+        (flags & TI_EXPORT_SEGMENT_FIRST))
+        collection->import_id = mp_import_id.via.u64;
+
+    for (i = n; i--;)
     {
         if (ti_ctask_run(collection->root, up))
         {
@@ -865,10 +961,37 @@ int ti_collection_unpack(
         }
     }
 
+    /* finish a streaming import, also on failure as otherwise the things
+     * cannot be removed by the garbage collector */
+    if (mp_schema.via.u64 == TI_EXPORT_SCHEMA_V1930 &&
+        (flags & TI_EXPORT_SEGMENT_LAST))
+        ti_collection_import_release(collection);
+
+done:
     free(version);
     return e->nr;
 }
 
+/*
+ * Returns the segment flags of import data without moving the unpacker.
+ * Data which is not a segment of a streaming export, is both the first and
+ * the last segment.
+ */
+int ti_collection_import_flags(mp_unp_t * up)
+{
+    mp_unp_t peek = *up;
+    mp_obj_t obj, mp_schema, mp_flags;
+
+    return (
+        mp_next(&peek, &obj) == MP_ARR && obj.via.sz >= 4 &&
+        mp_next(&peek, &mp_schema) == MP_U64 &&
+        mp_schema.via.u64 == TI_EXPORT_SCHEMA_V1930 &&
+        mp_skip(&peek) == MP_STR &&
+        mp_next(&peek, &mp_flags) == MP_U64
+    ) ? (int) mp_flags.via.u64
+      : (int) (TI_EXPORT_SEGMENT_FIRST|TI_EXPORT_SEGMENT_LAST);
+}
+
 void ti_collection_tasks_clear(ti_collection_t * collection)
 {
     for (vec_each(collection->vtasks, ti_vtask_t, vtask))
@@ -892,3 +1015,15 @@ int ti_collection_load(
 
     return ti_collection_unpack(collection, &up, e);
 }
+
+/*
+ * Add a query duration to the collection histogram. The histogram is created
+ * on the first query; on an allocation error the duration is not recorded.
+ */
+void ti_collection_upd_hist(ti_collection_t * collection, double duration)
+{
+    if (!collection->hist_query &&
+        !(collection->hist_query = hist_create()))
+        return;
+    hist_add(collection->hist_query, duration);
+}
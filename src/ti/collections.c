@@ -66,8 +66,13 @@ void ti_collections_clear(void)
  */
 int ti_collections_gc(void)
 {
+    struct timespec start;
+    int rc;
+
+    (void) clock_gettime(TI_CLOCK_MONOTONIC, &start);
+
     /* garbage collect dropped collections */
-    int rc = ti_collections_gc_collect_dropped();
+    rc = ti_collections_gc_collect_dropped();
 
     /* collect all other stuff */
     for (vec_each(collections->vec, ti_collection_t, collection))
@@ -82,6 +87,7 @@ int ti_collections_gc(void)
         (void) sched_yield();
     }
 
+    (void) ti_counters_upd_hist(&ti.counters->hist_gc, &start);
     return rc;
 }
 
@@ -125,6 +131,10 @@ int ti_collections_gc_collect_dropped(void)
         /* clear existing tasks */
         ti_tasks_clear_dropped(&collection->vtasks);
 
+        /* things of an unfinished import must lose their reference */
+        if (collection->import_id)
+            ti_collection_import_release(collection);
+
         /* drop enumerators; this is required since we no longer mark the
          * enumerators when they contain things so they need to be dropped
          * before the garbage collector will remove them */
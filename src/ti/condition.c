@@ -9,6 +9,7 @@
 #include <ti/condition.h>
 #include <ti/method.h>
 #include <ti/nil.h>
+#include <ti/pcache.h>
 #include <ti/raw.inline.h>
 #include <ti/spec.t.h>
 #include <ti/val.inline.h>
@@ -618,11 +619,17 @@ int ti_condition_init_enum(ti_field_t * field, ti_member_t * member, ex_t * e)
     return 0;
 }
 
+/*
+ * The relation callbacks below change a related thing which does not
+ * necessarily have a task of its own; therefore the packed data of the
+ * thing is removed from the pack cache.
+ */
 static void condition__del_type_cb(
         ti_field_t * field,
         ti_thing_t * thing,
         ti_thing_t * UNUSED(relation))
 {
+    ti_pcache_drop(thing);
     ti_val_t ** vaddr = \
             (ti_val_t **) vec_get_addr(thing->items.vec, field->idx);
     ti_val_unsafe_gc_drop(*vaddr);
@@ -634,6 +641,7 @@ static void condition__add_type_cb(
         ti_thing_t * thing,
         ti_thing_t * relation)
 {
+    ti_pcache_drop(thing);
     ti_val_t ** vaddr = \
             (ti_val_t **) vec_get_addr(thing->items.vec, field->idx);
     ti_incref(relation);  /* must increment before drop (pr #357) */
@@ -646,6 +654,7 @@ static void condition__del_set_cb(
         ti_thing_t * thing,
         ti_thing_t * relation)
 {
+    ti_pcache_drop(thing);
     ti_vset_t * vset = VEC_get(thing->items.vec, field->idx);
     ti_val_gc_drop(imap_pop(vset->imap, ti_thing_key(relation)));
 }
@@ -671,6 +680,7 @@ static void condition__del_same_set_cb(
     if (thing != relation)
     {
         ti_vset_t * vset = VEC_get(thing->items.vec, field->idx);
+        ti_pcache_drop(thing);
         ti_val_gc_drop(imap_pop(vset->imap, ti_thing_key(relation)));
     }
 }
@@ -680,6 +690,7 @@ static void condition__add_set_cb(
         ti_thing_t * thing,
         ti_thing_t * relation)
 {
+    ti_pcache_drop(thing);
     ti_vset_t * vset = VEC_get(thing->items.vec, field->idx);
 
     switch(imap_add(vset->imap, ti_thing_key(relation), relation))
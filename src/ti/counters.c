@@ -15,6 +15,9 @@ int ti_counters_create(void)
 {
     counters = &counters_;
 
+    if (uv_mutex_init(&counters->hist_lock))
+        return -1;
+
     ti_counters_reset();
     ti.counters = counters;
 
@@ -23,6 +26,8 @@ int ti_counters_create(void)
 
 void ti_counters_destroy(void)
 {
+    if (counters)
+        uv_mutex_destroy(&counters->hist_lock);
     counters = ti.counters = NULL;
 }
 
@@ -42,12 +47,27 @@ void ti_counters_reset(void)
     counters->changes_unaligned = 0;
     counters->largest_result_size = 0;
     counters->queries_from_cache = 0;
+    counters->regex_cache_hits = 0;
+    counters->regex_jit_matches = 0;
+    counters->pack_cache_hits = 0;
+    counters->pack_cache_misses = 0;
+    counters->procedure_cache_hits = 0;
+    counters->procedure_cache_misses = 0;
     ti_counters_zero_garbage_collected();
     ti_counters_zero_wasted_cache();
     counters->longest_query_duration = 0.0;
     counters->longest_change_duration = 0.0;
     counters->total_query_duration = 0.0;
     counters->total_change_duration = 0.0;
+    hist_reset(&counters->hist_query);
+    hist_reset(&counters->hist_change);
+    hist_reset(&counters->hist_quorum);
+
+    uv_mutex_lock(&counters->hist_lock);
+    hist_reset(&counters->hist_archive);
+    hist_reset(&counters->hist_store);
+    hist_reset(&counters->hist_gc);
+    uv_mutex_unlock(&counters->hist_lock);
 }
 
 /*
@@ -70,6 +90,7 @@ double ti_counters_upd_commit_change(struct timespec * start)
         counters->longest_change_duration = duration;
 
     counters->total_change_duration += duration;
+    hist_add(&counters->hist_change, duration);
     return duration;
 }
 
@@ -93,13 +114,34 @@ double ti_counters_upd_success_query(struct timespec * start)
         counters->longest_query_duration = duration;
 
     counters->total_query_duration += duration;
+    hist_add(&counters->hist_query, duration);
+    return duration;
+}
+
+/*
+ * Add the time since `start` to a histogram and returns the duration. This
+ * function may be called from the `away` thread, the histograms for store,
+ * garbage collection and archiving must be read while holding `hist_lock`.
+ */
+double ti_counters_upd_hist(hist_t * hist, struct timespec * start)
+{
+    struct timespec timing;
+    double duration;
+
+    (void) clock_gettime(TI_CLOCK_MONOTONIC, &timing);
+
+    duration = util_time_diff(start, &timing);
+
+    uv_mutex_lock(&counters->hist_lock);
+    hist_add(hist, duration);
+    uv_mutex_unlock(&counters->hist_lock);
     return duration;
 }
 
 int ti_counters_to_pk(msgpack_packer * pk)
 {
     return -(
-        msgpack_pack_map(pk, 20) ||
+        msgpack_pack_map(pk, 26) ||
 
         mp_pack_str(pk, "queries_success") ||
         msgpack_pack_uint64(pk, counters->queries_success) ||
@@ -143,6 +185,24 @@ int ti_counters_to_pk(msgpack_packer * pk)
         mp_pack_str(pk, "wasted_cache") ||
         msgpack_pack_uint64(pk, ti_counters_wasted_cache()) ||
 
+        mp_pack_str(pk, "regex_cache_hits") ||
+        msgpack_pack_uint64(pk, counters->regex_cache_hits) ||
+
+        mp_pack_str(pk, "regex_jit_matches") ||
+        msgpack_pack_uint64(pk, counters->regex_jit_matches) ||
+
+        mp_pack_str(pk, "pack_cache_hits") ||
+        msgpack_pack_uint64(pk, counters->pack_cache_hits) ||
+
+        mp_pack_str(pk, "pack_cache_misses") ||
+        msgpack_pack_uint64(pk, counters->pack_cache_misses) ||
+
+        mp_pack_str(pk, "procedure_cache_hits") ||
+        msgpack_pack_uint64(pk, counters->procedure_cache_hits) ||
+
+        mp_pack_str(pk, "procedure_cache_misses") ||
+        msgpack_pack_uint64(pk, counters->procedure_cache_misses) ||
+
         mp_pack_str(pk, "longest_query_duration") ||
         msgpack_pack_double(pk, counters->longest_query_duration) ||
 
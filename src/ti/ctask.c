@@ -15,6 +15,7 @@
 #include <ti/method.h>
 #include <ti/name.h>
 #include <ti/names.h>
+#include <ti/pcache.h>
 #include <ti/procedure.h>
 #include <ti/procedures.h>
 #include <ti/prop.h>
@@ -22,6 +23,7 @@
 #include <ti/raw.inline.h>
 #include <ti/task.t.h>
 #include <ti/thing.inline.h>
+#include <ti/things.h>
 #include <ti/vtask.h>
 #include <ti/vtask.inline.h>
 #include <ti/types.inline.h>
@@ -612,7 +614,7 @@ static int ctask__set_enum_data(ti_thing_t * thing, mp_unp_t * up)
 
 static int ctask__import(ti_thing_t * thing, mp_unp_t * up)
 {
-    int rc = 0;
+    int rc = 0, flags;
     ex_t e = {0};
     mp_obj_t obj, mp_import_tasks;
     ti_collection_t * collection = thing->collection;
@@ -628,18 +630,201 @@ static int ctask__import(ti_thing_t * thing, mp_unp_t * up)
         return -1;
     }
 
+    flags = ti_collection_import_flags(up);
+
     if (ti_collection_unpack(collection, up, &e))
     {
         log_error("%s", e.msg);  /* not critical for sure */
         rc = -1;
     }
 
-    if (!mp_import_tasks.via.bool_)
+    if ((flags & TI_EXPORT_SEGMENT_LAST) && !mp_import_tasks.via.bool_)
         ti_collection_tasks_clear(collection);
 
     return rc;
 }
 
+/*
+ * Returns 0 on success
+ * - for example: {id: type_id, ...}
+ *
+ * Creates empty things for a segment of a streaming import. For non-typed
+ * things the specification is stored in the upper 16 bits of the type id.
+ * Instances get `nil` values until their data is imported.
+ */
+static int ctask__import_things(ti_thing_t * thing, mp_unp_t * up)
+{
+    size_t i;
+    uint16_t type_id;
+    ti_type_t * type;
+    ti_thing_t * t;
+    mp_obj_t obj, mp_id, mp_type_id;
+    ti_collection_t * collection = thing->collection;
+
+    if (mp_next(up, &obj) != MP_MAP)
+        goto invalid;
+
+    for (i = obj.via.sz; i--;)
+    {
+        if (mp_next(up, &mp_id) != MP_U64 || mp_id.via.u64 == 0 ||
+            mp_next(up, &mp_type_id) != MP_U64)
+            goto invalid;
+
+        type_id = (uint16_t) mp_type_id.via.u64;
+        if (type_id == TI_SPEC_OBJECT)
+        {
+            t = ti_things_create_thing_o(
+                    mp_id.via.u64,
+                    (uint16_t) (mp_type_id.via.u64 >> 16),
+                    0,
+                    collection);
+        }
+        else
+        {
+            type = ti_types_by_id(collection->types, type_id);
+            if (!type)
+            {
+                log_critical(
+                        "task `import_things` for "TI_COLLECTION_ID": "
+                        "cannot find type with id %u",
+                        collection->id, type_id);
+                return -1;
+            }
+
+            t = ti_things_create_thing_t(mp_id.via.u64, type, collection);
+            if (t)
+                for (vec_each(type->fields, ti_field_t, field))
+                    VEC_push(t->items.vec, ti_nil_get());
+        }
+
+        if (!t)
+        {
+            log_critical(
+                    "task `import_things` for "TI_COLLECTION_ID": "
+                    "cannot create "TI_THING_ID,
+                    collection->id, mp_id.via.u64);
+            return -1;
+        }
+
+        /* the reference is kept until the import is finished */
+        t->flags |= TI_THING_FLAG_IMPORT;
+        ti_collection_update_next_free_id(collection, mp_id.via.u64);
+    }
+    return 0;
+
+invalid:
+    log_critical(
+            "task `import_things` for "TI_COLLECTION_ID": invalid format",
+            collection->id);
+    return -1;
+}
+
+/*
+ * Returns 0 on success
+ * - for example: {id: {prop: value, ...}, id: [value, ...], ...}
+ *
+ * Imports the data for things created by an `import_things` task or for the
+ * collection root; the data must not be imported more than once.
+ */
+static int ctask__import_data(ti_thing_t * thing, mp_unp_t * up)
+{
+    size_t i;
+    ex_t e = {0};
+    ti_val_t * val;
+    ti_thing_t * t;
+    mp_obj_t obj, mp_id, mp_data;
+    ti_collection_t * collection = thing->collection;
+    ti_vup_t vup = {
+            .isclient = false,
+            .collection = collection,
+            .up = up,
+    };
+
+    if (mp_next(up, &obj) != MP_MAP)
+        goto invalid;
+
+    for (i = obj.via.sz; i--;)
+    {
+        if (mp_next(up, &mp_id) != MP_U64)
+            goto invalid;
+
+        t = ti_collection_thing_by_id(collection, mp_id.via.u64);
+        if (!t || (t == collection->root
+                ? ti_thing_n(t) != 0
+                : (~t->flags & TI_THING_FLAG_IMPORT) ||
+                  (ti_thing_is_object(t) && ti_thing_n(t) != 0)))
+        {
+            log_critical(
+                    "task `import_data` for "TI_COLLECTION_ID": "
+                    "no data can be imported for "TI_THING_ID,
+                    collection->id, mp_id.via.u64);
+            return -1;
+        }
+
+        if (ti_thing_is_object(t))
+        {
+            if (mp_next(up, &mp_data) != MP_MAP)
+                goto invalid;
+
+            if (ti_thing_props_from_vup(t, &vup, mp_data.via.sz, &e))
+                goto failed;
+
+            continue;
+        }
+
+        if (mp_next(up, &mp_data) != MP_ARR ||
+            mp_data.via.sz != t->via.type->fields->n)
+            goto invalid;
+
+        for (vec_each(t->via.type->fields, ti_field_t, field))
+        {
+            val = ti_val_from_vup_e(&vup, &e);
+            if (!val || ti_field_make_assignable(field, &val, t, &e))
+            {
+                ti_val_drop(val);
+                goto failed;
+            }
+            ti_val_unsafe_drop(vec_set(t->items.vec, val, field->idx));
+        }
+    }
+    return 0;
+
+invalid:
+    log_critical(
+            "task `import_data` for "TI_COLLECTION_ID": invalid format",
+            collection->id);
+    return -1;
+
+failed:
+    log_critical(
+            "task `import_data` for "TI_COLLECTION_ID": %s",
+            collection->id, e.msg);
+    return -1;
+}
+
+/*
+ * Returns 0 on success
+ * - for example: import_id
+ */
+static int ctask__import_abort(ti_thing_t * thing, mp_unp_t * up)
+{
+    mp_obj_t mp_import_id;
+    ti_collection_t * collection = thing->collection;
+
+    if (mp_next(up, &mp_import_id) != MP_U64 ||
+        mp_import_id.via.u64 != collection->import_id)
+    {
+        log_critical(
+                "task `import_abort` for "TI_COLLECTION_ID": "
+                "no matching streaming import",
+                collection->id);
+        return -1;
+    }
+
+    ti_collection_import_release(collection);
+    return 0;
+}
+
 static int ctask__replace_root(ti_thing_t * thing, mp_unp_t * up)
 {
     _Bool changed;
@@ -2519,7 +2704,7 @@ static int ctask__vtask_new(ti_thing_t * thing, mp_unp_t * up)
         goto fail0;
 
     ti_collection_update_next_free_id(collection, vtask->id);
-    (void) ti_tasks_append(&collection->vtasks, vtask);
+    (void) ti_tasks_append(&collection->vtasks, vtask, collection);
     free(varr);
     ti_decref(closure);
     return 0;
@@ -2627,7 +2812,7 @@ static int ctask__vtask_finish(ti_thing_t * thing, mp_unp_t * up)
         goto fail0;
 
     vtask->run_at = mp_run_at.via.u64;
-    ti_tasks_vtask_finish(vtask);
+    ti_tasks_vtask_finish(vtask, collection);
 
     ti_val_drop((ti_val_t *) vtask->verr);
     vtask->verr = (ti_verror_t *) val;
@@ -3047,6 +3232,48 @@ static int ctask__rename_procedure(ti_thing_t * thing, mp_unp_t * up)
             mp_name.via.str.n);
 }
 
+/*
+ * Returns 0 on success
+ * - for example: {'name':name, 'ttl':ttl}
+ */
+static int ctask__set_procedure_cache(ti_thing_t * thing, mp_unp_t * up)
+{
+    ti_collection_t * collection = thing->collection;
+    ti_procedure_t * procedure;
+    mp_obj_t obj, mp_name, mp_ttl;
+
+    if (mp_next(up, &obj) != MP_MAP || obj.via.sz != 2 ||
+        mp_skip(up) != MP_STR ||
+        mp_next(up, &mp_name) != MP_STR ||
+        mp_skip(up) != MP_STR ||
+        mp_next(up, &mp_ttl) != MP_U64)
+    {
+        log_critical(
+                "task `set_procedure_cache` for "TI_COLLECTION_ID": "
+                "invalid format",
+                collection->id);
+        return -1;
+    }
+
+    procedure = ti_procedures_by_strn(
+            collection->procedures,
+            mp_name.via.str.data,
+            mp_name.via.str.n);
+
+    if (!procedure)
+    {
+        log_critical(
+                "task `set_procedure_cache` cannot find `%.*s` in "
+                TI_COLLECTION_ID,
+                mp_name.via.str.n, mp_name.via.str.data,
+                collection->id);
+        return -1;
+    }
+
+    ti_procedure_set_cache_ttl(procedure, (uint32_t) mp_ttl.via.u64);
+    return 0;
+}
+
 /*
  * Returns 0 on success
  * - for example: {'id':id, 'name':name}
@@ -3378,6 +3605,9 @@ fail:
 int ti_ctask_run(ti_thing_t * thing, mp_unp_t * up)
 {
     mp_obj_t obj, mp_task;
+
+    ti_pcache_changed(thing);
+
     if (mp_next(up, &obj) != MP_ARR || obj.via.sz != 2 ||
         mp_next(up, &mp_task) != MP_U64)
     {
@@ -3480,6 +3710,11 @@ int ti_ctask_run(ti_thing_t * thing, mp_unp_t * up)
     case TI_TASK_DEL_HISTORY:       break;
     case TI_TASK_COMMIT:            return ctask__commit(thing, up);
     case TI_TASK_MOD_TYPE_IDX:      return ctask__mod_type_idx(thing, up);
+    case TI_TASK_SET_PROCEDURE_CACHE:
+        return ctask__set_procedure_cache(thing, up);
+    case TI_TASK_IMPORT_THINGS:     return ctask__import_things(thing, up);
+    case TI_TASK_IMPORT_DATA:       return ctask__import_data(thing, up);
+    case TI_TASK_IMPORT_ABORT:      return ctask__import_abort(thing, up);
     }
 
     log_critical("unknown collection task: %"PRIu64, mp_task.via.u64);
@@ -10,6 +10,7 @@
 #include <string.h>
 #include <time.h>
 #include <ctype.h>
+#include <util/tzif.h>
 
 #define DATETIME__BUF_SZ 80
 static char datetime__buf[DATETIME__BUF_SZ];
@@ -102,18 +103,10 @@ ti_datetime_t * ti_datetime_copy(ti_datetime_t * dt)
 int ti_datetime_time(ti_datetime_t * dt, struct tm * tm)
 {
     if (dt->tz)
-    {
-        ti_tz_set(dt->tz);
-        tzset();
-        return -(localtime_r(&dt->ts, tm) != tm);
-    }
+        return ti_tz_localtime(dt->tz, dt->ts, tm);
 
     if (dt->offset)
-    {
-        ti_tz_set_offset(dt->offset);
-        tzset();
-        return -(localtime_r(&dt->ts, tm) != tm);
-    }
+        return tzif_gmtime(dt->ts, dt->offset * 60, tm);
 
     return -(gmtime_r(&dt->ts, tm) != tm);
 }
@@ -213,15 +206,13 @@ static ti_datetime_t * datetime__from_strn(
     switch (fmt[n-1])
     {
     case 'Z':
-        ti_tz_set_utc();
-        ts = mktime(&tm);
+        ts = tzif_timegm(&tm);
         offset = 0;
         tz = ti_tz_utc();
         break;
     case 'z':
         {
-            ti_tz_set_utc();
-            ts = mktime(&tm);
+            ts = tzif_timegm(&tm);
             n = str->n;
             while (n--)
                 if (buf[n] == '+' || buf[n] == '-')
@@ -240,8 +231,7 @@ static ti_datetime_t * datetime__from_strn(
         }
         break;
     default:
-        ti_tz_set(tz);
-        ts = mktime(&tm);
+        ts = ti_tz_mktime(tz, &tm);
         offset = tm.tm_gmtoff / 60;
     }
 
@@ -507,16 +497,14 @@ ti_datetime_t * ti_datetime_from_tm_tz(struct tm * tm, ti_tz_t * tz, ex_t * e)
     if (tz)
     {
         /* get offset after calculating time stamp */
-        ti_tz_set(tz);
-        ts = mktime(tm);
+        ts = ti_tz_mktime(tz, tm);
         offset = tm->tm_gmtoff / 60;
     }
     else
     {
         /* get offset before calculating time stamp */
         offset = tm->tm_gmtoff;
-        ti_tz_set_utc();
-        ts = mktime(tm) - offset;
+        ts = tzif_timegm(tm) - offset;
         offset /= 60;
     }
 
@@ -570,8 +558,7 @@ ti_datetime_t * ti_datetime_from_tm_tzinfo(
         if (e->nr)
             return NULL;
 
-        ti_tz_set_utc();
-        ts = mktime(tm) - offset;
+        ts = tzif_timegm(tm) - offset;
         offset /= 60;
         tz = NULL;
     }
@@ -584,8 +571,7 @@ ti_datetime_t * ti_datetime_from_tm_tzinfo(
             return NULL;
         }
 
-        ti_tz_set(tz);
-        ts = mktime(tm);
+        ts = ti_tz_mktime(tz, tm);
         offset = tm->tm_gmtoff / 60;
     }
 
@@ -671,7 +657,9 @@ int ti_datetime_move(
          */
         tm.tm_isdst = -1;
 
-        dt->ts = mktime(&tm);
+        dt->ts = dt->tz
+            ? ti_tz_mktime(dt->tz, &tm)
+            : tzif_timegm(&tm) - dt->offset * 60;
         return 0;
     }
     else
@@ -30,6 +30,7 @@
 #include <ti/opr/sr.h>
 #include <ti/opr/xor.h>
 #include <ti/preopr.h>
+#include <ti/profile.h>
 #include <ti/regex.h>
 #include <ti/task.h>
 #include <ti/template.h>
@@ -37,6 +38,7 @@
 #include <ti/vfloat.h>
 #include <ti/vint.h>
 #include <util/strx.h>
+#include <util/util.h>
 
 static inline int do__no_node_scope(ti_query_t * query)
 {
@@ -520,10 +522,20 @@ static int do__function_call(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         ti_procedure_t * procedure = do__get_procedure(query, fname);
         if (procedure)
         {
-            query->rval = (ti_val_t *) procedure->closure;
+            struct timespec start;
+            ti_closure_t * closure = procedure->closure;
+
+            /* take a reference as the procedure might be removed */
+            ti_incref(closure);
+            query->rval = (ti_val_t *) closure;
             ti_incref(query->rval);
 
-            return fn_call(query, args, e);
+            clock_gettime(TI_CLOCK_MONOTONIC, &start);
+            (void) fn_call(query, args, e);
+            ti_closure_upd_profile(closure, &start);
+
+            ti_val_unsafe_drop((ti_val_t *) closure);
+            return e->nr;
         }
     }
 
@@ -574,10 +586,11 @@ static int do__function_call(ti_query_t * query, cleri_node_t * nd, ex_t * e)
     return e->nr;
 }
 
-static inline int do__function(ti_query_t * query, cleri_node_t * nd, ex_t * e)
+static inline int do__function_nd(
+        ti_query_t * query,
+        cleri_node_t * nd,
+        ex_t * e)
 {
-    assert(e->nr == 0);
-    assert(nd->children->next->cl_obj->gid == CLERI_GID_FUNCTION);
     /*
      * "Node -> data" is set for all build-in functions so they are preferred
      * over other functions/type/enum/procedures/modules/variable.
@@ -592,6 +605,51 @@ static inline int do__function(ti_query_t * query, cleri_node_t * nd, ex_t * e)
             : do__function_call(query, nd, e);
 }
 
+/*
+ * Called instead of do__function_nd() while running inside `profile(..)`.
+ * The elapsed time includes the time spend in nested function calls.
+ */
+static int do__function_profile(
+        ti_query_t * query,
+        cleri_node_t * nd,
+        ex_t * e)
+{
+    struct timespec start, end;
+    ti_profile_t * parent = query->profile;
+    ti_profile_t * profile = ti_profile_child(
+            parent,
+            nd->children->str,
+            nd->children->len);
+
+    if (!profile)
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    query->profile = profile;
+    clock_gettime(TI_CLOCK_MONOTONIC, &start);
+
+    (void) do__function_nd(query, nd, e);
+
+    clock_gettime(TI_CLOCK_MONOTONIC, &end);
+    query->profile = parent;
+
+    ++profile->calls;
+    profile->time += util_time_diff(&start, &end);
+    return e->nr;
+}
+
+static inline int do__function(ti_query_t * query, cleri_node_t * nd, ex_t * e)
+{
+    assert(e->nr == 0);
+    assert(nd->children->next->cl_obj->gid == CLERI_GID_FUNCTION);
+
+    return query->profile
+            ? do__function_profile(query, nd, e)
+            : do__function_nd(query, nd, e);
+}
+
 int ti_do_block(ti_query_t * query, cleri_node_t * nd, ex_t * e)
 {
     /* first child, not empty */
@@ -1762,7 +1820,7 @@ static int do__var_assign(ti_query_t * query, cleri_node_t * nd, ex_t * e)
         }
 
         /* update value `a` with value `b` but store the value in `b` */
-        if (ti_opr_a_to_b(prop->val, tokens_nd, &query->rval, e))
+        if (ti_opr_var_a_to_b(&prop->val, tokens_nd, &query->rval, e))
             return e->nr;
 
         /* switch `a` with `b` as the new value is set to `b` */
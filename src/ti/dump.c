@@ -1,8 +1,12 @@
+#include <assert.h>
+#include <string.h>
 #include <ti/dump.h>
 #include <ti/enum.h>
 #include <ti/enums.h>
 #include <ti/field.h>
+#include <ti/item.t.h>
 #include <ti/procedure.h>
+#include <ti/prop.h>
 #include <ti/thing.h>
 #include <ti/type.h>
 #include <ti/val.h>
@@ -400,3 +404,302 @@ ti_raw_t * ti_dump_collection(ti_collection_t * collection)
     return raw;
 }
 
+
+/* room in front of a segment with things for the segment header */
+#define DUMP__SEGMENT_HEAD 64
+
+typedef struct
+{
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+    ti_thing_t * root;
+    size_t size;
+    uint32_t n;
+    uint64_t thing_id;
+} dump__segment_t;
+
+static int dump__thing_type_cb(ti_thing_t * thing, dump__segment_t * w)
+{
+    uint32_t value = thing->type_id;
+
+    if (thing == w->root)
+        return 0;  /* the root is created by the first segment */
+
+    /* equal to the store, the specification is packed with the type Id */
+    if (thing->type_id == TI_SPEC_OBJECT)
+        value += (uint32_t) thing->via.spec << 16;
+
+    if (msgpack_pack_uint64(&w->pk, thing->id) ||
+        msgpack_pack_uint32(&w->pk, value))
+        return -1;
+
+    ++w->n;
+    w->thing_id = thing->id;
+    return w->buffer.size >= w->size;
+}
+
+static int dump__thing_item_cb(ti_item_t * item, msgpack_packer * pk)
+{
+    return -(
+        mp_pack_strn(pk, item->key->data, item->key->n) ||
+        ti_val_to_store_pk(item->val, pk)
+    );
+}
+
+static int dump__thing_data_cb(ti_thing_t * thing, dump__segment_t * w)
+{
+    msgpack_packer * pk = &w->pk;
+
+    if (msgpack_pack_uint64(pk, thing->id))
+        return -1;
+
+    if (ti_thing_is_object(thing))
+    {
+        if (msgpack_pack_map(pk, ti_thing_n(thing)))
+            return -1;
+
+        if (ti_thing_is_dict(thing))
+        {
+            if (smap_values(
+                    thing->items.smap,
+                    (smap_val_cb) dump__thing_item_cb,
+                    pk))
+                return -1;
+        }
+        else for (vec_each(thing->items.vec, ti_prop_t, prop))
+            if (mp_pack_strn(pk, prop->name->str, prop->name->n) ||
+                ti_val_to_store_pk(prop->val, pk))
+                return -1;
+    }
+    else
+    {
+        if (msgpack_pack_array(pk, ti_thing_n(thing)))
+            return -1;
+
+        for (vec_each(thing->items.vec, ti_val_t, val))
+            if (ti_val_to_store_pk(val, pk))
+                return -1;
+    }
+
+    ++w->n;
+    w->thing_id = thing->id;
+    return w->buffer.size >= w->size;
+}
+
+/*
+ * The data of the root is exported with the data of all other things so
+ * the first segment only replaces the root with an empty thing.
+ */
+static int dump__write_empty_root(ti_thing_t * root, msgpack_packer * pk)
+{
+    return (
+        msgpack_pack_array(pk, 2) ||
+
+        msgpack_pack_uint8(pk, TI_TASK_REPLACE_ROOT) ||
+        msgpack_pack_map(pk, 1) ||
+        mp_pack_strn(pk, TI_KIND_S_OBJECT, 1) ||
+        msgpack_pack_array(pk, 3) ||
+        msgpack_pack_uint16(pk, root->via.spec) ||
+        msgpack_pack_uint64(pk, root->id) ||
+        msgpack_pack_map(pk, 0)
+    );
+}
+
+static inline int dump__segment_init(
+        msgpack_packer * pk,
+        size_t n,
+        uint8_t flags,
+        uint64_t import_id)
+{
+    return (
+        msgpack_pack_array(pk, 4 + n) ||
+        msgpack_pack_uint16(pk, TI_EXPORT_SCHEMA_V1930) ||
+        mp_pack_str(pk, TI_VERSION) ||
+        msgpack_pack_uint8(pk, flags) ||
+        msgpack_pack_uint64(pk, import_id)
+    );
+}
+
+static ti_raw_t * dump__segment_done(msgpack_sbuffer * buffer)
+{
+    ti_raw_t * raw = (ti_raw_t *) buffer->data;
+    ti_raw_init(raw, TI_VAL_BYTES, buffer->size);
+    return raw;
+}
+
+static ti_raw_t * dump__segment_head(
+        ti_collection_t * collection,
+        ti_dump_cursor_t * cursor)
+{
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+    size_t n = (
+        collection->enums->smap->n +
+        collection->types->smap->n * 2 +
+        collection->vtasks->n + 1
+    );
+
+    if (mp_sbuffer_alloc_init(&buffer, 8192, sizeof(ti_raw_t)))
+        return NULL;
+
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    if (dump__segment_init(
+                &pk, n, TI_EXPORT_SEGMENT_FIRST, cursor->import_id) ||
+        dump__write_new_enums(collection->enums, &pk) ||
+        dump__write_types(collection->types, &pk) ||
+        dump__write_tasks(collection->vtasks, &pk) ||
+        dump__write_empty_root(collection->root, &pk))
+    {
+        msgpack_sbuffer_destroy(&buffer);
+        return NULL;
+    }
+
+    cursor->phase = TI_DUMP_PHASE_THINGS;
+    cursor->thing_id = 0;
+    return dump__segment_done(&buffer);
+}
+
+static ti_raw_t * dump__segment_walk(
+        ti_collection_t * collection,
+        ti_dump_cursor_t * cursor,
+        size_t size,
+        ti_task_enum task,
+        imap_cb cb)
+{
+    int rc;
+    msgpack_packer pk;
+    msgpack_sbuffer head;
+    size_t pre = sizeof(ti_raw_t) + DUMP__SEGMENT_HEAD;
+    dump__segment_t w = {
+            .root = collection->root,
+            .size = pre + size,
+            .thing_id = cursor->thing_id,
+    };
+
+    if (mp_sbuffer_alloc_init(&w.buffer, pre + size, pre))
+        return NULL;
+
+    msgpack_packer_init(&w.pk, &w.buffer, msgpack_sbuffer_write);
+
+    /* walking stops when the segment size is reached */
+    rc = imap_walk_after(collection->things, cursor->thing_id, cb, &w);
+    if (rc < 0)
+        goto fail0;
+
+    if (mp_sbuffer_alloc_init(&head, DUMP__SEGMENT_HEAD, 0))
+        goto fail0;
+
+    msgpack_packer_init(&pk, &head, msgpack_sbuffer_write);
+
+    if (dump__segment_init(&pk, 1, 0, cursor->import_id) ||
+        msgpack_pack_array(&pk, 2) ||
+        msgpack_pack_uint8(&pk, task) ||
+        msgpack_pack_map(&pk, w.n) ||
+        head.size > DUMP__SEGMENT_HEAD)
+        goto fail1;
+
+    /* move the things right after the segment header */
+    memcpy(w.buffer.data + sizeof(ti_raw_t), head.data, head.size);
+    memmove(w.buffer.data + sizeof(ti_raw_t) + head.size,
+            w.buffer.data + pre,
+            w.buffer.size - pre);
+    w.buffer.size -= DUMP__SEGMENT_HEAD - head.size;
+    msgpack_sbuffer_destroy(&head);
+
+    if (rc)
+        cursor->thing_id = w.thing_id;
+    else
+    {
+        ++cursor->phase;
+        cursor->thing_id = 0;
+    }
+    return dump__segment_done(&w.buffer);
+
+fail1:
+    msgpack_sbuffer_destroy(&head);
+fail0:
+    msgpack_sbuffer_destroy(&w.buffer);
+    return NULL;
+}
+
+static ti_raw_t * dump__segment_tail(
+        ti_collection_t * collection,
+        ti_dump_cursor_t * cursor)
+{
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+    size_t n = (
+        collection->enums->smap->n +
+        collection->procedures->n +
+        collection->named_rooms->n
+    );
+
+    for (vec_each(collection->vtasks, ti_vtask_t, vtask))
+        if (vtask->args->n)
+            n += 1;
+
+    smap_values(collection->types->smap, (smap_val_cb) dump__rel_count_cb, &n);
+
+    if (mp_sbuffer_alloc_init(&buffer, 65536, sizeof(ti_raw_t)))
+        return NULL;
+
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    if (dump__segment_init(
+                &pk, n, TI_EXPORT_SEGMENT_LAST, cursor->import_id) ||
+        dump__write_enums_data(collection->enums, &pk) ||
+        dump__write_tasks_args(collection->vtasks, &pk) ||
+        dump__write_relations(collection->types, &pk) ||
+        dump__write_procedures(collection->procedures, &pk) ||
+        dump__write_named_rooms(collection->named_rooms, &pk))
+    {
+        msgpack_sbuffer_destroy(&buffer);
+        return NULL;
+    }
+
+    cursor->phase = TI_DUMP_PHASE_DONE;
+    cursor->thing_id = 0;
+    return dump__segment_done(&buffer);
+}
+
+/*
+ * Export a single segment of a streaming export and move the cursor to the
+ * next segment. Segments with things stop after reaching the given size, each
+ * segment is imported as a separate change so memory stays bounded, also for
+ * large collections.
+ *
+ * Like ti_dump_collection(), this function must not be called when things
+ * can be marked as new. Returns NULL in case of an allocation error.
+ */
+ti_raw_t * ti_dump_segment(
+        ti_collection_t * collection,
+        ti_dump_cursor_t * cursor,
+        size_t size)
+{
+    switch (cursor->phase)
+    {
+    case TI_DUMP_PHASE_HEAD:
+        return dump__segment_head(collection, cursor);
+    case TI_DUMP_PHASE_THINGS:
+        return dump__segment_walk(
+                collection,
+                cursor,
+                size,
+                TI_TASK_IMPORT_THINGS,
+                (imap_cb) dump__thing_type_cb);
+    case TI_DUMP_PHASE_DATA:
+        return dump__segment_walk(
+                collection,
+                cursor,
+                size,
+                TI_TASK_IMPORT_DATA,
+                (imap_cb) dump__thing_data_cb);
+    case TI_DUMP_PHASE_TAIL:
+        return dump__segment_tail(collection, cursor);
+    case TI_DUMP_PHASE_DONE:
+        break;
+    }
+    assert(0);
+    return NULL;
+}
@@ -130,6 +130,9 @@ void ti_evars_cfg_parse(void)
     evars__bool(
             "THINGSDB_WAIT_FOR_MODULES",
             &ti.cfg->wait_for_modules);
+    evars__bool(
+            "THINGSDB_SYNC_COMPRESSION",
+            &ti.cfg->sync_compression);
     evars__str(
             "THINGSDB_PYTHON_INTERPRETER",
             &ti.cfg->python_interpreter);
@@ -148,6 +151,18 @@ void ti_evars_cfg_parse(void)
     evars__sizet(
             "THINGSDB_CACHE_EXPIRATION_TIME",
             &ti.cfg->cache_expiration_time);
+    evars__sizet(
+            "THINGSDB_REGEX_JIT_STACK_SIZE",
+            &ti.cfg->regex_jit_stack_size);
+    evars__sizet(
+            "THINGSDB_THRESHOLD_PARSE_THREAD",
+            &ti.cfg->threshold_parse_thread);
+    evars__sizet(
+            "THINGSDB_PACK_CACHE_SIZE",
+            &ti.cfg->pack_cache_size);
+    evars__sizet(
+            "THINGSDB_PROCEDURE_CACHE_SIZE",
+            &ti.cfg->procedure_cache_size);
     evars__u16(
             "THINGSDB_HTTP_STATUS_PORT",
             &ti.cfg->http_status_port);
@@ -649,7 +649,12 @@ static int export__procedure_cb(ti_procedure_t * procedure, ti_fmt_t * fmt)
                 procedure->name->n) ||
         buf_append_str(&fmt->buf, "', ") ||
         ti_fmt_nd(fmt, procedure->closure->node) ||
-        buf_append_str(&fmt->buf, ");\n")
+        buf_append_str(&fmt->buf, ");\n") ||
+        (procedure->cache_ttl && buf_append_fmt(
+                &fmt->buf,
+                "set_procedure_cache('%s', %"PRIu32");\n",
+                procedure->name->str,
+                procedure->cache_ttl))
     );
 }
 
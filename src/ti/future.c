@@ -102,7 +102,7 @@ void ti_future_cancel(ti_future_t * future)
 void ti_future_stop(ti_future_t * future)
 {
     if (future->module != ti_async_get_module())
-        (void) omap_rm(future->module->futures, future->pid);
+        (void) ti_module_pop_future(future->module, future->pid);
 
     ti_future_cancel(future);
 }
@@ -0,0 +1,854 @@
+/*
+ * ti/ibackup.c
+ *
+ * Incremental backups are written to a directory with the following layout:
+ *
+ *   <path>/snapshots/<change_id>/          copy of the store at `change_id`
+ *   <path>/changes/<first>_<last>.mp       archived changes
+ *
+ * Change files use the same format as the files in the archive. A new
+ * snapshot is only required when the changes in the backup cannot be
+ * continued with the changes in the archive. Change files which are already
+ * in the backup are never written again and files in a new snapshot which are
+ * equal to the previous snapshot are hard linked.
+ */
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <ti.h>
+#include <ti/archfile.h>
+#include <ti/archive.h>
+#include <ti/cpkg.h>
+#include <ti/cpkg.inline.h>
+#include <ti/ibackup.h>
+#include <ti/store.h>
+#include <unistd.h>
+#include <util/fx.h>
+#include <util/logger.h>
+#include <util/mpack.h>
+#include <util/vec.h>
+
+/*
+ * Snapshot directory length (16 hex digits, exclusive terminator character).
+ */
+#define IBACKUP__SNAPSHOT_LEN 16
+
+static const char * ibackup__snapshots_path = "snapshots/";
+static const char * ibackup__changes_path = "changes/";
+
+typedef struct
+{
+    char * snapshots_path;
+    char * changes_path;
+    vec_t * snapshots;      /* uint64_t, ordered */
+    vec_t * changes;        /* ti_archfile_t */
+} ibackup__chain_t;
+
+static _Bool ibackup__is_snapshot_fn(const char * fn)
+{
+    if (strlen(fn) != IBACKUP__SNAPSHOT_LEN)
+        return false;
+
+    for (; *fn; ++fn)
+        if (!isxdigit(*fn))
+            return false;
+
+    return true;
+}
+
+static int ibackup__mkdir(const char * path)
+{
+    if (!fx_is_dir(path) && mkdir(path, FX_DEFAULT_DIR_ACCESS))
+    {
+        log_errno_file("cannot create directory", errno, path);
+        return -1;
+    }
+    return 0;
+}
+
+static int ibackup__load_snapshots(ibackup__chain_t * chain)
+{
+    struct dirent ** file_list;
+    int n, total, rc = 0;
+    uint64_t * snapshot_id;
+
+    total = scandir(chain->snapshots_path, &file_list, NULL, alphasort);
+    if (total < 0)
+    {
+        log_errno_file("cannot scan directory", errno, chain->snapshots_path);
+        return -1;
+    }
+
+    for (n = 0; n < total; n++)
+    {
+        if (!ibackup__is_snapshot_fn(file_list[n]->d_name))
+            continue;
+
+        snapshot_id = malloc(sizeof(uint64_t));
+        if (!snapshot_id || vec_push(&chain->snapshots, snapshot_id))
+        {
+            free(snapshot_id);
+            rc = -1;
+            continue;
+        }
+        *snapshot_id = strtoull(file_list[n]->d_name, NULL, 16);
+    }
+
+    while (total--)
+        free(file_list[total]);
+
+    free(file_list);
+    return rc;
+}
+
+static int ibackup__load_changes(ibackup__chain_t * chain)
+{
+    struct dirent ** file_list;
+    int n, total, rc = 0;
+    ti_archfile_t * archfile;
+
+    total = scandir(chain->changes_path, &file_list, NULL, alphasort);
+    if (total < 0)
+    {
+        log_errno_file("cannot scan directory", errno, chain->changes_path);
+        return -1;
+    }
+
+    for (n = 0; n < total; n++)
+    {
+        const char * fn = file_list[n]->d_name;
+        if (!ti_archfile_is_valid_fn(fn))
+            continue;
+
+        /* we are sure this fits since the filename is checked */
+        archfile = ti_archfile_from_change_ids(
+                chain->changes_path,
+                strtoull(fn, NULL, 16),
+                strtoull(fn + 16 + 1, NULL, 16));
+
+        if (!archfile || vec_push(&chain->changes, archfile))
+        {
+            ti_archfile_destroy(archfile);
+            rc = -1;
+        }
+    }
+
+    while (total--)
+        free(file_list[total]);
+
+    free(file_list);
+    return rc;
+}
+
+static void ibackup__chain_clear(ibackup__chain_t * chain)
+{
+    vec_destroy(chain->snapshots, free);
+    vec_destroy(chain->changes, (vec_destroy_cb) ti_archfile_destroy);
+    free(chain->snapshots_path);
+    free(chain->changes_path);
+}
+
+static int ibackup__chain_init(
+        ibackup__chain_t * chain,
+        const char * path,
+        _Bool create)
+{
+    chain->snapshots = vec_new(0);
+    chain->changes = vec_new(0);
+    chain->snapshots_path = fx_path_join(path, ibackup__snapshots_path);
+    chain->changes_path = fx_path_join(path, ibackup__changes_path);
+
+    if (!chain->snapshots ||
+        !chain->changes ||
+        !chain->snapshots_path ||
+        !chain->changes_path)
+        return -1;
+
+    if (create && (
+            ibackup__mkdir(path) ||
+            ibackup__mkdir(chain->snapshots_path) ||
+            ibackup__mkdir(chain->changes_path)))
+        return -1;
+
+    return ibackup__load_snapshots(chain) || ibackup__load_changes(chain);
+}
+
+static int ibackup__chain_reset(ibackup__chain_t * chain)
+{
+    vec_clear_cb(chain->snapshots, free);
+    vec_clear_cb(chain->changes, (vec_destroy_cb) ti_archfile_destroy);
+
+    (void) fx_rmdir(chain->snapshots_path);
+    (void) fx_rmdir(chain->changes_path);
+
+    return (
+        ibackup__mkdir(chain->snapshots_path) ||
+        ibackup__mkdir(chain->changes_path)
+    );
+}
+
+/*
+ * Returns the last change id which is available in the backup.
+ */
+static uint64_t ibackup__chain_last(ibackup__chain_t * chain)
+{
+    uint64_t * snapshot_id = vec_last(chain->snapshots);
+    uint64_t last = snapshot_id ? *snapshot_id : 0;
+
+    for (vec_each(chain->changes, ti_archfile_t, archfile))
+        if (archfile->last > last)
+            last = archfile->last;
+
+    return last;
+}
+
+static ti_archfile_t * ibackup__find(vec_t * archfiles, uint64_t change_id)
+{
+    for (vec_each(archfiles, ti_archfile_t, archfile))
+        if (archfile->first <= change_id && archfile->last >= change_id)
+            return archfile;
+    return NULL;
+}
+
+/*
+ * Returns the first change id after `from` and until `until` (inclusive)
+ * which cannot be found in the given archive files, or `0` when all changes
+ * are found.
+ */
+static uint64_t ibackup__missing(
+        vec_t * archfiles,
+        uint64_t from,
+        uint64_t until)
+{
+    ti_archfile_t * archfile;
+    uint64_t change_id = from + 1;
+
+    while (change_id <= until)
+    {
+        archfile = ibackup__find(archfiles, change_id);
+        if (!archfile)
+            return change_id;
+        change_id = archfile->last + 1;
+    }
+    return 0;
+}
+
+/*
+ * Copy directory `src` to `dst`. Files in `src` which are equal to the file
+ * with the same relative path in `prev` are hard linked (`prev` may be NULL).
+ */
+static int ibackup__copy_dir(
+        const char * src,
+        const char * dst,
+        const char * prev)
+{
+    int rc = 0;
+    struct dirent * p;
+    DIR * d = opendir(src);
+    if (!d)
+    {
+        log_errno_file("cannot open directory", errno, src);
+        return -1;
+    }
+
+    if (mkdir(dst, FX_DEFAULT_DIR_ACCESS))
+    {
+        log_errno_file("cannot create directory", errno, dst);
+        closedir(d);
+        return -1;
+    }
+
+    while (!rc && (p = readdir(d)))
+    {
+        char * src_fn, * dst_fn, * prev_fn = NULL;
+
+        if (!strcmp(p->d_name, ".") || !strcmp(p->d_name, ".."))
+            continue;
+
+        src_fn = fx_path_join(src, p->d_name);
+        dst_fn = fx_path_join(dst, p->d_name);
+        if (prev)
+            prev_fn = fx_path_join(prev, p->d_name);
+
+        if (!src_fn || !dst_fn || (prev && !prev_fn))
+            rc = -1;
+        else if (fx_is_dir(src_fn))
+            rc = ibackup__copy_dir(
+                    src_fn,
+                    dst_fn,
+                    prev_fn && fx_is_dir(prev_fn) ? prev_fn : NULL);
+        else if (!prev_fn ||
+                 !fx_equal(src_fn, prev_fn) ||
+                 link(prev_fn, dst_fn))
+            rc = fx_copy(src_fn, dst_fn);
+
+        free(src_fn);
+        free(dst_fn);
+        free(prev_fn);
+    }
+
+    closedir(d);
+    return rc;
+}
+
+static char * ibackup__snapshot_path(
+        ibackup__chain_t * chain,
+        uint64_t snapshot_id,
+        const char * ext)
+{
+    char name[IBACKUP__SNAPSHOT_LEN + 8];
+    (void) snprintf(name, sizeof(name), "%016"PRIx64"%s", snapshot_id, ext);
+    return fx_path_join(chain->snapshots_path, name);
+}
+
+/*
+ * Create a new snapshot from the store. The store must be continued by the
+ * changes in the archive, if this is not the case, a new full store is
+ * created first.
+ */
+static int ibackup__snapshot(
+        ibackup__chain_t * chain,
+        uint64_t scid,
+        buf_t * buf)
+{
+    int rc = -1;
+    uint64_t snapshot_id, missing, * prev_id, * id;
+    char * snapshot_path = NULL, * tmp_path = NULL, * prev_path = NULL;
+
+    if (!fx_is_dir(ti.store->store_path) || ibackup__missing(
+            ti.archive->archfiles,
+            ti.store->last_stored_change_id,
+            scid))
+    {
+        if (ti_store_store())
+        {
+            buf_append_str(buf, "failed to store ThingsDB for a new snapshot");
+            return -1;
+        }
+    }
+
+    snapshot_id = ti.store->last_stored_change_id;
+    missing = ibackup__missing(ti.archive->archfiles, snapshot_id, scid);
+    if (missing)
+    {
+        buf_append_fmt(
+                buf,
+                "archive is missing "TI_CHANGE_ID" for a new snapshot",
+                missing);
+        return -1;
+    }
+
+    prev_id = vec_last(chain->snapshots);
+    if (prev_id && *prev_id >= snapshot_id)
+        return 0;  /* snapshot is already in the backup */
+
+    id = malloc(sizeof(uint64_t));
+    snapshot_path = ibackup__snapshot_path(chain, snapshot_id, "");
+    tmp_path = ibackup__snapshot_path(chain, snapshot_id, ".tmp");
+    if (prev_id)
+        prev_path = ibackup__snapshot_path(chain, *prev_id, "");
+
+    if (!id || !snapshot_path || !tmp_path || (prev_id && !prev_path))
+    {
+        buf_append_fmt(buf, EX_MEMORY_S);
+        goto fail;
+    }
+
+    if (fx_is_dir(tmp_path))
+        (void) fx_rmdir(tmp_path);
+
+    if (ibackup__copy_dir(ti.store->store_path, tmp_path, prev_path) ||
+        rename(tmp_path, snapshot_path))
+    {
+        buf_append_fmt(buf, "failed to write snapshot `%s`", snapshot_path);
+        (void) fx_rmdir(tmp_path);
+        goto fail;
+    }
+
+    *id = snapshot_id;
+    if (vec_push(&chain->snapshots, id))
+    {
+        buf_append_fmt(buf, EX_MEMORY_S);
+        goto fail;
+    }
+
+    log_info("created snapshot at "TI_CHANGE_ID" in `%s`",
+            snapshot_id, snapshot_path);
+
+    id = NULL;  /* moved to the chain */
+    rc = 0;
+
+fail:
+    free(id);
+    free(snapshot_path);
+    free(tmp_path);
+    free(prev_path);
+    return rc;
+}
+
+/*
+ * Copy all archived changes after `*last` which are not yet in the backup.
+ * Argument `last` will be set to the last change id in the backup.
+ */
+static int ibackup__copy_changes(
+        ibackup__chain_t * chain,
+        uint64_t * last,
+        buf_t * buf)
+{
+    const uint64_t after = *last;
+    ti_archfile_t * dst;
+    buf_t tmp_fn;
+
+    for (vec_each(ti.archive->archfiles, ti_archfile_t, archfile))
+    {
+        if (archfile->last <= after)
+            continue;
+
+        dst = ti_archfile_from_change_ids(
+                chain->changes_path,
+                archfile->first,
+                archfile->last);
+        if (!dst)
+            goto fail0;
+
+        if (fx_file_exist(dst->fn))
+        {
+            /* these changes are already in the backup */
+            ti_archfile_destroy(dst);
+            continue;
+        }
+
+        buf_init(&tmp_fn);
+        if (buf_append_fmt(&tmp_fn, "%s.tmp", dst->fn) ||
+            buf_write(&tmp_fn, '\0'))
+        {
+            free(tmp_fn.data);
+            ti_archfile_destroy(dst);
+            goto fail0;
+        }
+
+        if (fx_copy(archfile->fn, tmp_fn.data) ||
+            rename(tmp_fn.data, dst->fn))
+        {
+            buf_append_fmt(buf, "failed to write changes to `%s`", dst->fn);
+            (void) unlink(tmp_fn.data);
+            free(tmp_fn.data);
+            ti_archfile_destroy(dst);
+            return -1;
+        }
+
+        free(tmp_fn.data);
+
+        if (vec_push(&chain->changes, dst))
+        {
+            ti_archfile_destroy(dst);
+            goto fail0;
+        }
+
+        if (archfile->last > *last)
+            *last = archfile->last;
+    }
+    return 0;
+
+fail0:
+    buf_append_fmt(buf, EX_MEMORY_S);
+    return -1;
+}
+
+/*
+ * Remove the oldest snapshots until at most `max_snapshots` are left and
+ * remove all changes which are no longer required by any snapshot.
+ */
+static void ibackup__cleanup(ibackup__chain_t * chain, size_t max_snapshots)
+{
+    uint64_t * snapshot_id;
+    _Bool found;
+
+    while (chain->snapshots->n > max_snapshots)
+    {
+        char * snapshot_path;
+        snapshot_id = vec_remove(chain->snapshots, 0);
+        snapshot_path = ibackup__snapshot_path(chain, *snapshot_id, "");
+
+        if (snapshot_path)
+        {
+            log_info("removing snapshot: `%s`", snapshot_path);
+            if (fx_rmdir(snapshot_path))
+                log_error("unable to remove snapshot: `%s`", snapshot_path);
+        }
+
+        free(snapshot_path);
+        free(snapshot_id);
+    }
+
+    snapshot_id = vec_first(chain->snapshots);
+    if (!snapshot_id)
+        return;
+
+    do
+    {
+        found = false;
+        size_t idx = 0;
+        for (vec_each(chain->changes, ti_archfile_t, archfile), ++idx)
+        {
+            if (archfile->last <= *snapshot_id)
+            {
+                log_debug("removing changes: `%s`", archfile->fn);
+                if (unlink(archfile->fn))
+                    log_error("unable to remove changes: `%s`", archfile->fn);
+
+                (void) vec_swap_remove(chain->changes, idx);
+                ti_archfile_destroy(archfile);
+
+                found = true;
+                break;
+            }
+        }
+    }
+    while (found);
+}
+
+/*
+ * Runs from the `away->work` thread while holding the changes lock.
+ *
+ * Writes a new snapshot (only when required) and all archived changes which
+ * are not yet in the backup. On success, `change_id` is set to the last
+ * change id in the backup. On failure, the reason is written to `buf`.
+ */
+int ti_ibackup_run(
+        const char * path,
+        size_t max_snapshots,
+        _Bool new_chain,
+        uint64_t * change_id,
+        buf_t * buf)
+{
+    int rc = -1;
+    ibackup__chain_t chain;
+    uint64_t last, scid = ti.node->scid;
+
+    if (ibackup__chain_init(&chain, path, true))
+    {
+        buf_append_fmt(buf, "failed to read incremental backup `%s`", path);
+        goto done;
+    }
+
+    last = ibackup__chain_last(&chain);
+
+    /*
+     * After a restore, the changes in the backup might not be equal to the
+     * changes in ThingsDB, even when they share the same change id.
+     */
+    if ((new_chain || last > scid) &&
+        (chain.snapshots->n || chain.changes->n))
+    {
+        log_warning(
+                "starting a new chain for incremental backup `%s`; "
+                "existing snapshots and changes will be removed",
+                path);
+
+        if (ibackup__chain_reset(&chain))
+        {
+            buf_append_fmt(buf, "failed to reset incremental backup `%s`",
+                    path);
+            goto done;
+        }
+        last = 0;
+    }
+
+    if (!chain.snapshots->n ||
+        ibackup__missing(ti.archive->archfiles, last, scid))
+    {
+        if (ibackup__snapshot(&chain, scid, buf))
+            goto done;
+
+        last = ibackup__chain_last(&chain);
+    }
+
+    if (ibackup__copy_changes(&chain, &last, buf))
+        goto done;
+
+    ibackup__cleanup(&chain, max_snapshots);
+
+    *change_id = last;
+    rc = 0;
+
+done:
+    ibackup__chain_clear(&chain);
+    return rc;
+}
+
+static int ibackup__plan(
+        ibackup__chain_t * chain,
+        const char * path,
+        uint64_t * change_id,
+        uint64_t * snapshot_id,
+        ex_t * e)
+{
+    _Bool found = false;
+    uint64_t last, missing;
+
+    if (ibackup__chain_init(chain, path, false))
+    {
+        ex_set(e, EX_BAD_DATA, "cannot read incremental backup `%s`", path);
+        return e->nr;
+    }
+
+    if (!chain->snapshots->n)
+    {
+        ex_set(e, EX_BAD_DATA,
+                "no snapshot found in incremental backup `%s`", path);
+        return e->nr;
+    }
+
+    last = ibackup__chain_last(chain);
+
+    if (!*change_id)
+        *change_id = last;
+    else if (*change_id > last)
+    {
+        ex_set(e, EX_VALUE_ERROR,
+                "cannot restore to "TI_CHANGE_ID" since the last change in "
+                "incremental backup `%s` is "TI_CHANGE_ID,
+                *change_id, path, last);
+        return e->nr;
+    }
+
+    for (vec_each(chain->snapshots, uint64_t, id))
+    {
+        if (*id > *change_id)
+            break;
+        *snapshot_id = *id;
+        found = true;
+    }
+
+    if (!found)
+    {
+        ex_set(e, EX_VALUE_ERROR,
+                "cannot restore to "TI_CHANGE_ID" since the first snapshot "
+                "in incremental backup `%s` is taken at "TI_CHANGE_ID,
+                *change_id, path,
+                *((uint64_t *) vec_first(chain->snapshots)));
+        return e->nr;
+    }
+
+    missing = ibackup__missing(chain->changes, *snapshot_id, *change_id);
+    if (missing)
+        ex_set(e, EX_BAD_DATA,
+                "incremental backup `%s` is missing "TI_CHANGE_ID,
+                path, missing);
+
+    return e->nr;
+}
+
+int ti_ibackup_restore_chk(
+        const char * fn,
+        size_t n,
+        uint64_t change_id,
+        ex_t * e)
+{
+    ibackup__chain_t chain;
+    uint64_t snapshot_id;
+    char * path = strndup(fn, n);
+    if (!path)
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    (void) ibackup__plan(&chain, path, &change_id, &snapshot_id, e);
+
+    ibackup__chain_clear(&chain);
+    free(path);
+    return e->nr;
+}
+
+static int ibackup__pkg_change_id(mp_obj_t * mp_pkg, uint64_t * change_id)
+{
+    ti_cpkg_t * cpkg;
+
+    if (mp_pkg->tp != MP_BIN || mp_pkg->via.bin.n < sizeof(ti_pkg_t))
+        return -1;
+
+    cpkg = ti_cpkg_from_pkg((ti_pkg_t *) mp_pkg->via.bin.data);
+    if (!cpkg)  /* ti_cpkg_from_pkg() is a log function */
+        return -1;
+
+    *change_id = cpkg->change_id;
+    ti_cpkg_drop(cpkg);
+    return 0;
+}
+
+/*
+ * Write all changes from change file `src` up to and including `change_id`
+ * to change file `dst`.
+ */
+static int ibackup__write_until(
+        const char * src,
+        const char * dst,
+        uint64_t change_id)
+{
+    int rc = -1;
+    size_t i, n = 0;
+    uint64_t pkg_change_id;
+    mp_unp_t up;
+    mp_obj_t obj, mp_pkg;
+    fx_mmap_t fmap;
+    msgpack_packer pk;
+    FILE * f;
+
+    fx_mmap_init(&fmap, src);
+    if (fx_mmap_open(&fmap))  /* fx_mmap_open() is a log function */
+        return -1;
+
+    /* changes are ordered, count the changes we need to write */
+    mp_unp_init(&up, fmap.data, fmap.n);
+
+    if (mp_next(&up, &obj) != MP_ARR)
+        goto close;
+
+    for (i = obj.via.sz; i--; ++n)
+    {
+        if (mp_next(&up, &mp_pkg) <= 0 ||
+            ibackup__pkg_change_id(&mp_pkg, &pkg_change_id))
+        {
+            log_error("invalid change file: `%s`", src);
+            goto close;
+        }
+        if (pkg_change_id > change_id)
+            break;
+    }
+
+    f = fopen(dst, "w");
+    if (!f)
+    {
+        log_errno_file("cannot open file", errno, dst);
+        goto close;
+    }
+
+    msgpack_packer_init(&pk, f, msgpack_fbuffer_write);
+
+    mp_unp_init(&up, fmap.data, fmap.n);
+    (void) mp_next(&up, &obj);
+
+    if (msgpack_pack_array(&pk, n))
+        goto fail;
+
+    for (i = n; i--;)
+    {
+        (void) mp_next(&up, &mp_pkg);
+        if (mp_pack_bin(&pk, mp_pkg.via.bin.data, mp_pkg.via.bin.n))
+            goto fail;
+    }
+
+    rc = 0;
+
+fail:
+    if (fclose(f))
+    {
+        log_errno_file("cannot close file", errno, dst);
+        rc = -1;
+    }
+    if (rc)
+        (void) unlink(dst);
+close:
+    if (fx_mmap_close(&fmap))
+        rc = -1;
+    return rc;
+}
+
+static int ibackup__restore_changes(
+        ti_archfile_t * archfile,
+        uint64_t change_id)
+{
+    int rc;
+    ti_archfile_t * dst = ti_archfile_from_change_ids(
+            ti.archive->path,
+            archfile->first,
+            archfile->last < change_id ? archfile->last : change_id);
+    if (!dst)
+        return -1;
+
+    rc = archfile->last <= change_id
+            ? fx_copy(archfile->fn, dst->fn)
+            : ibackup__write_until(archfile->fn, dst->fn, change_id);
+
+    ti_archfile_destroy(dst);
+    return rc;
+}
+
+/*
+ * Restore the store and archive from an incremental backup up to and
+ * including `change_id`, or the last change in the backup when `change_id`
+ * is `0`. The store and archive directories must have been removed.
+ */
+int ti_ibackup_restore(
+        const char * fn,
+        size_t n,
+        uint64_t change_id,
+        ex_t * e)
+{
+    ibackup__chain_t chain;
+    uint64_t snapshot_id;
+    char * snapshot_path = NULL;
+    char * path = strndup(fn, n);
+    if (!path)
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    if (ibackup__plan(&chain, path, &change_id, &snapshot_id, e))
+        goto done;
+
+    snapshot_path = ibackup__snapshot_path(&chain, snapshot_id, "");
+    if (!snapshot_path)
+    {
+        ex_set_mem(e);
+        goto done;
+    }
+
+    if (ibackup__copy_dir(snapshot_path, ti.store->store_path, NULL))
+    {
+        ex_set(e, EX_OPERATION,
+                "restore failed: cannot copy snapshot `%s`", snapshot_path);
+        goto done;
+    }
+
+    if (ti_archive_init())
+    {
+        ex_set(e, EX_OPERATION,
+                "restore failed: cannot create the archive directory");
+        goto done;
+    }
+
+    for (vec_each(chain.changes, ti_archfile_t, archfile))
+    {
+        if (archfile->last <= snapshot_id || archfile->first > change_id)
+            continue;
+
+        if (ibackup__restore_changes(archfile, change_id))
+        {
+            ex_set(e, EX_OPERATION,
+                    "restore failed: cannot restore changes from `%s`",
+                    archfile->fn);
+            goto done;
+        }
+    }
+
+    log_info(
+            "restored incremental backup `%s` up to "TI_CHANGE_ID" "
+            "using the snapshot at "TI_CHANGE_ID,
+            path, change_id, snapshot_id);
+
+done:
+    free(snapshot_path);
+    ibackup__chain_clear(&chain);
+    free(path);
+    return e->nr;
+}
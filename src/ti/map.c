@@ -3,35 +3,40 @@
  */
 #include <assert.h>
 #include <stdlib.h>
+#include <ti/field.h>
 #include <ti/map.h>
-#include <ti/field.t.h>
 #include <ti/mapping.h>
 
-ti_map_t * ti_map_new(vec_t * mappings)
+/*
+ * Returns a new map with a mapping for all the fields of the `to` type which
+ * are found and compatible on the `from` type.
+ * The return is NULL when a memory allocation has occurred.
+ */
+ti_map_t * ti_map_new(ti_type_t * t_type, ti_type_t * f_type)
 {
-    ti_map_t * map = malloc(sizeof(ti_map_t));
+    ti_field_t * f_field;
+    ti_map_t * map = malloc(
+            sizeof(ti_map_t) + t_type->fields->n * sizeof(ti_mapping_t));
     if (!map)
         return NULL;
 
-    map->mappings = mappings;
+    map->n = 0;
     map->can_skip = false;
-    for (vec_each(mappings, ti_mapping_t, mapping))
+
+    for (vec_each(t_type->fields, ti_field_t, t_field))
     {
-        if (mapping->t_field->flags & (
-                TI_FIELD_FLAG_SKIP_NIL|TI_FIELD_FLAG_SKIP_FALSE))
-        {
-            map->can_skip = true;
-            break;
-        }
+        f_field = ti_field_by_name(f_type, t_field->name);
+        if (!f_field || !ti_field_maps_to_field(t_field, f_field))
+            continue;
+
+        ti_mapping_init(map->mappings + map->n, t_field, f_field);
+        map->can_skip |= !!map->mappings[map->n].skip;
+        ++map->n;
     }
     return map;
 }
 
 void ti_map_destroy(ti_map_t * map)
 {
-    if (map)
-        vec_destroy(map->mappings, free);
     free(map);
 }
-
-
@@ -2,16 +2,19 @@
  * ti/mapping.c
  */
 #include <assert.h>
-#include <stdlib.h>
+#include <ti/field.h>
 #include <ti/mapping.h>
 
-ti_mapping_t * ti_mapping_new(ti_field_t * t_field, ti_field_t * f_field)
+void ti_mapping_init(
+        ti_mapping_t * mapping,
+        ti_field_t * t_field,
+        ti_field_t * f_field)
 {
-    ti_mapping_t * mapping = malloc(sizeof(ti_mapping_t));
-    if (!mapping)
-        return NULL;
+    assert(t_field->name == f_field->name);
 
     mapping->t_field = t_field;
-    mapping->f_field = f_field;
-    return mapping;
+    mapping->name = f_field->name;
+    mapping->f_idx = f_field->idx;
+    mapping->skip = t_field->flags & (
+            TI_FIELD_FLAG_SKIP_NIL|TI_FIELD_FLAG_SKIP_FALSE);
 }
@@ -0,0 +1,284 @@
+/*
+ * ti/metrics.c
+ *
+ * Latency metrics in the Prometheus text format. Each histogram is exposed
+ * as a summary with a few fixed quantiles.
+ */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <ti.h>
+#include <ti/collections.h>
+#include <ti/metrics.h>
+#include <ti/procedure.h>
+#include <util/hist.h>
+#include <util/smap.h>
+
+typedef struct
+{
+    buf_t * buf;
+    buf_t * labels;
+    const char * scope;
+    size_t scope_n;
+} metrics__procedure_t;
+
+static const double metrics__quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+#define METRICS__QUANTILES_N \
+    (sizeof(metrics__quantiles) / sizeof(metrics__quantiles[0]))
+
+static int metrics__help(buf_t * buf, const char * name, const char * help)
+{
+    return buf_append_fmt(
+            buf,
+            "# HELP %s %s\n"
+            "# TYPE %s summary\n",
+            name, help, name);
+}
+
+/*
+ * Labels must be formatted like `name="value"` and may be an empty string.
+ */
+static int metrics__summary(
+        buf_t * buf,
+        const char * name,
+        const char * labels,
+        hist_t * hist)
+{
+    const char * sep = *labels ? "," : "";
+
+    for (size_t i = 0; i < METRICS__QUANTILES_N; ++i)
+    {
+        double q = metrics__quantiles[i];
+        if (buf_append_fmt(
+                buf,
+                "%s{%s%squantile=\"%g\"} %.9g\n",
+                name, labels, sep, q, hist_quantile(hist, q)))
+            return -1;
+    }
+
+    return *labels
+        ? buf_append_fmt(
+                buf,
+                "%s_sum{%s} %.9g\n"
+                "%s_count{%s} %"PRIu64"\n",
+                name, labels, hist->sum,
+                name, labels, hist->count)
+        : buf_append_fmt(
+                buf,
+                "%s_sum %.9g\n"
+                "%s_count %"PRIu64"\n",
+                name, hist->sum,
+                name, hist->count);
+}
+
+static int metrics__node(buf_t * buf)
+{
+    ti_counters_t * counters = ti.counters;
+    int rc = 0;
+    struct
+    {
+        const char * name;
+        const char * help;
+        hist_t * hist;
+    } node_metrics[] = {
+        {
+            .name="thingsdb_query_duration_seconds",
+            .help="Duration of successful queries.",
+            .hist=&counters->hist_query,
+        },
+        {
+            .name="thingsdb_change_duration_seconds",
+            .help="Duration from receiving until committing a change.",
+            .hist=&counters->hist_change,
+        },
+        {
+            .name="thingsdb_quorum_duration_seconds",
+            .help="Duration of a quorum round for a change id.",
+            .hist=&counters->hist_quorum,
+        },
+        {
+            .name="thingsdb_archive_duration_seconds",
+            .help="Duration of writing archived changes to disk.",
+            .hist=&counters->hist_archive,
+        },
+        {
+            .name="thingsdb_store_duration_seconds",
+            .help="Duration of a full store to disk.",
+            .hist=&counters->hist_store,
+        },
+        {
+            .name="thingsdb_gc_duration_seconds",
+            .help="Duration of garbage collection for all collections.",
+            .hist=&counters->hist_gc,
+        },
+    };
+
+    /* some of the histograms are written by the `away` thread */
+    uv_mutex_lock(&counters->hist_lock);
+
+    for (size_t i = 0; i < sizeof(node_metrics) / sizeof(node_metrics[0]); ++i)
+    {
+        if (metrics__help(buf, node_metrics[i].name, node_metrics[i].help) ||
+            metrics__summary(
+                buf,
+                node_metrics[i].name,
+                "",
+                node_metrics[i].hist))
+        {
+            rc = -1;
+            break;
+        }
+    }
+
+    uv_mutex_unlock(&counters->hist_lock);
+    return rc;
+}
+
+/*
+ * Append a label value; backslash, double-quote and line feed characters
+ * must be escaped in the Prometheus text format.
+ */
+static int metrics__label_val(buf_t * buf, const char * s, size_t n)
+{
+    for (; n--; ++s)
+    {
+        switch (*s)
+        {
+        case '\\':
+            if (buf_append(buf, "\\\\", 2))
+                return -1;
+            continue;
+        case '"':
+            if (buf_append(buf, "\\\"", 2))
+                return -1;
+            continue;
+        case '\n':
+            if (buf_append(buf, "\\n", 2))
+                return -1;
+            continue;
+        }
+        if (buf_write(buf, *s))
+            return -1;
+    }
+    return 0;
+}
+
+static int metrics__collections(buf_t * buf)
+{
+    const char * name = "thingsdb_collection_query_duration_seconds";
+    buf_t labels;
+    int rc = 0;
+
+    if (metrics__help(buf, name, "Duration of successful queries "
+                                 "per collection."))
+        return -1;
+
+    buf_init(&labels);
+
+    for (vec_each(ti.collections->vec, ti_collection_t, collection))
+    {
+        if (!collection->hist_query)
+            continue;
+
+        labels.len = 0;
+
+        if (buf_append_str(&labels, "collection=\"") ||
+            metrics__label_val(
+                    &labels,
+                    (const char *) collection->name->data,
+                    collection->name->n) ||
+            buf_append(&labels, "\"", 2) ||  /* including the terminator */
+            metrics__summary(buf, name, labels.data, collection->hist_query))
+        {
+            rc = -1;
+            break;
+        }
+    }
+
+    free(labels.data);
+    return rc;
+}
+
+static int metrics__procedure_cb(
+        ti_procedure_t * procedure,
+        metrics__procedure_t * w)
+{
+    buf_t * labels = w->labels;
+    hist_t * hist = procedure->closure->hist;
+
+    if (!hist)
+        return 0;  /* never called */
+
+    labels->len = 0;
+
+    return (
+        buf_append_str(labels, "scope=\"") ||
+        metrics__label_val(labels, w->scope, w->scope_n) ||
+        buf_append_str(labels, "\",procedure=\"") ||
+        metrics__label_val(
+                labels,
+                procedure->name->str,
+                procedure->name->n) ||
+        buf_append(labels, "\"", 2) ||  /* including the terminator */
+        metrics__summary(
+                w->buf,
+                "thingsdb_procedure_duration_seconds",
+                labels->data,
+                hist)
+    );
+}
+
+static int metrics__procedures(buf_t * buf)
+{
+    int rc;
+    buf_t labels;
+    metrics__procedure_t w = {
+            .buf = buf,
+            .labels = &labels,
+            .scope = "@thingsdb",
+            .scope_n = 9,
+    };
+
+    if (metrics__help(
+            buf,
+            "thingsdb_procedure_duration_seconds",
+            "Duration of procedure calls."))
+        return -1;
+
+    buf_init(&labels);
+
+    rc = smap_values(
+            ti.procedures,
+            (smap_val_cb) metrics__procedure_cb,
+            &w);
+
+    for (vec_each(ti.collections->vec, ti_collection_t, collection))
+    {
+        if (rc)
+            break;
+
+        w.scope = (const char *) collection->scope->data;
+        w.scope_n = collection->scope->n;
+
+        rc = smap_values(
+                collection->procedures,
+                (smap_val_cb) metrics__procedure_cb,
+                &w);
+    }
+
+    free(labels.data);
+    return rc ? -1 : 0;
+}
+
+/*
+ * Append all metrics to `buf`. Returns 0 on success or -1 in case of an
+ * allocation error.
+ */
+int ti_metrics_to_buf(buf_t * buf)
+{
+    return (
+        metrics__node(buf) ||
+        metrics__collections(buf) ||
+        metrics__procedures(buf)
+    );
+}
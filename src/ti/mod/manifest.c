@@ -65,6 +65,8 @@ typedef enum
     MF__X_ARGMAP_ARR,
     MF__REQUIREMENTS,
     MF__REQUIREMENTS_ARR,
+    MF__WORKERS,
+    MF__SHM_SIZE,
 } manifest__ctx_mode_t;
 
 typedef struct
@@ -76,6 +78,117 @@ typedef struct
     void * data;                /* pointer to anything */
 } manifest__ctx_t;
 
+typedef struct
+{
+    msgpack_packer pk;
+    size_t deep;
+    size_t buf_n[YAJL_MAX_DEPTH];
+    uint32_t count[YAJL_MAX_DEPTH];
+} mpjson_convert_t;
+
+static int reformat_null(void * ctx)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    ++c->count[c->deep];
+    return 0 == msgpack_pack_nil(&c->pk);
+}
+
+static int reformat_boolean(void * ctx, int boolean)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    ++c->count[c->deep];
+    return 0 == mp_pack_bool(&c->pk, boolean);
+}
+
+static int reformat_integer(void * ctx, long long i)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    ++c->count[c->deep];
+    return 0 == msgpack_pack_int64(&c->pk, i);
+}
+
+static int reformat_double(void * ctx, double d)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    ++c->count[c->deep];
+    return 0 == msgpack_pack_double(&c->pk, d);
+}
+
+static int reformat_string(void * ctx, const unsigned char * s, size_t n)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    ++c->count[c->deep];
+    return 0 == mp_pack_strn(&c->pk, s, n);
+}
+
+static int reformat_start_map(void * ctx)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    msgpack_sbuffer * buffer = c->pk.data;
+
+    ++c->count[c->deep];
+    if (++c->deep >= YAJL_MAX_DEPTH)
+        return 0;  /* error */
+
+    c->count[c->deep] = 0;
+    c->buf_n[c->deep] = buffer->size+1;
+
+    return 0 == msgpack_pack_map(&c->pk, 0x10000UL);
+}
+
+static int reformat_map_key(void * ctx, const unsigned char * s, size_t n)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    return 0 == mp_pack_strn(&c->pk, s, n);
+}
+
+static int reformat_end_map(void * ctx)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    msgpack_sbuffer * buffer = c->pk.data;
+
+    _msgpack_store32(buffer->data + c->buf_n[c->deep], c->count[c->deep]);
+    --c->deep;
+
+    return 1;  /* success */
+}
+
+static int reformat_start_array(void * ctx)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    msgpack_sbuffer * buffer = c->pk.data;
+
+    ++c->count[c->deep];
+    if (++c->deep >= YAJL_MAX_DEPTH)
+        return 0;  /* error */
+
+    c->count[c->deep] = 0;
+    c->buf_n[c->deep] = buffer->size+1;
+
+    return 0 == msgpack_pack_array(&c->pk, 0x10000L);
+}
+
+static int reformat_end_array(void * ctx)
+{
+    mpjson_convert_t * c = (mpjson_convert_t *) ctx;
+    msgpack_sbuffer * buffer = c->pk.data;
+
+    _msgpack_store32(buffer->data + c->buf_n[c->deep], c->count[c->deep]);
+    --c->deep;
+
+    return 1;  /* success */
+}
+
+static void take_buffer(
+        msgpack_sbuffer * buffer,
+        char ** dst,
+        size_t * dst_n)
+{
+    *dst = buffer->data;
+    *dst_n = buffer->size;
+    memset(buffer, 0, sizeof(msgpack_sbuffer));
+}
+
 typedef struct
 {
     mpjson_convert_t ctx;       /* pointer to unpack context */
@@ -157,6 +270,8 @@ static int manifest__set_main(
     {
         ctx->manifest->main = strndup((const char *) s, n);
         ctx->manifest->is_py = ti_module_file_is_py((const char *) s, n);
+        ctx->manifest->is_native =
+                ti_module_file_is_native((const char *) s, n);
     }
     return manifest__set_mode(ctx, mode);
 }
@@ -330,6 +445,14 @@ static ti_item_t * manifest__make_item(
     manifest__set_err(__ctx, "expecting a string as `requirements` item in "TI_MANIFEST", "__notv);
 
 
+#define manifest__err_workers(__ctx, __notv) \
+    manifest__set_err(__ctx, "expecting a `workers` value between 1 and %d in "TI_MANIFEST", "__notv, TI_MODULE_MAX_WORKERS);
+
+
+#define manifest__err_shm_size(__ctx, __notv) \
+    manifest__set_err(__ctx, "expecting a `shm_size` value between 1 and %d in "TI_MANIFEST", "__notv, TI_MODULE_MAX_SHM_SIZE);
+
+
 #define manifest__err_unexpected(__ctx) \
     manifest__set_err(__ctx, "unexpected error in "TI_MANIFEST);
 
@@ -373,6 +496,8 @@ static int manifest__json_null(void * data)
     case MF__X_ARGMAP_ARR:      return manifest__err_am_arr(ctx, TI_NNULL);
     case MF__REQUIREMENTS:      return manifest__err_reqm(ctx, TI_NNULL);
     case MF__REQUIREMENTS_ARR:  return manifest__err_reqm_arr(ctx, TI_NNULL);
+    case MF__WORKERS:           return manifest__err_workers(ctx, TI_NNULL);
+    case MF__SHM_SIZE:          return manifest__err_shm_size(ctx, TI_NNULL);
     default:                    return manifest__err_unexpected(ctx);
     }
 }
@@ -433,6 +558,8 @@ static int manifest__json_boolean(void * data, int boolean)
     case MF__X_ARGMAP_ARR:      return manifest__err_am_arr(ctx, TI_NBOOL);
     case MF__REQUIREMENTS:      return manifest__err_reqm(ctx, TI_NBOOL);
     case MF__REQUIREMENTS_ARR:  return manifest__err_reqm_arr(ctx, TI_NBOOL);
+    case MF__WORKERS:           return manifest__err_workers(ctx, TI_NBOOL);
+    case MF__SHM_SIZE:          return manifest__err_shm_size(ctx, TI_NBOOL);
     default:                    return manifest__err_unexpected(ctx);
     }
 }
@@ -509,6 +636,24 @@ static int manifest__json_integer(void * data, long long i)
     case MF__X_ARGMAP_ARR:      return manifest__err_am_arr(ctx, TI_NNUM);
     case MF__REQUIREMENTS:      return manifest__err_reqm(ctx, TI_NNUM);
     case MF__REQUIREMENTS_ARR:  return manifest__err_reqm_arr(ctx, TI_NNUM);
+    case MF__WORKERS:
+        if (i < 1 || i > TI_MODULE_MAX_WORKERS)
+            return manifest__set_err(
+                    ctx,
+                    "expecting a `workers` value between 1 and %d "
+                    "in "TI_MANIFEST", not %lld",
+                    TI_MODULE_MAX_WORKERS, i);
+        ctx->manifest->workers = (uint8_t) i;
+        return manifest__set_mode(ctx, MF__ROOT_MAP);
+    case MF__SHM_SIZE:
+        if (i < 1 || i > TI_MODULE_MAX_SHM_SIZE)
+            return manifest__set_err(
+                    ctx,
+                    "expecting a `shm_size` value between 1 and %d "
+                    "in "TI_MANIFEST", not %lld",
+                    TI_MODULE_MAX_SHM_SIZE, i);
+        ctx->manifest->shm_size = (uint16_t) i;
+        return manifest__set_mode(ctx, MF__ROOT_MAP);
     default:                    return manifest__err_unexpected(ctx);
     }
 }
@@ -583,6 +728,10 @@ static int manifest__json_double(void * data, double d)
     case MF__X_ARGMAP_ARR:      return manifest__err_am_arr(ctx, TI_NNUM);
     case MF__REQUIREMENTS:      return manifest__err_reqm(ctx, TI_NNUM);
     case MF__REQUIREMENTS_ARR:  return manifest__err_reqm_arr(ctx, TI_NNUM);
+    case MF__WORKERS:
+        return manifest__err_workers(ctx, "not an integer");
+    case MF__SHM_SIZE:
+        return manifest__err_shm_size(ctx, "not an integer");
     default:                    return manifest__err_unexpected(ctx);
     }
 }
@@ -738,6 +887,8 @@ static int manifest__json_string(
         reqm = strndup(str, n);
         return reqm && 0 == vec_push(&ctx->manifest->requirements, reqm);
     }
+    case MF__WORKERS:           return manifest__err_workers(ctx, TI_NSTR);
+    case MF__SHM_SIZE:          return manifest__err_shm_size(ctx, TI_NSTR);
     default:                    return manifest__err_unexpected(ctx);
     }
 }
@@ -790,6 +941,8 @@ static int manifest__json_start_map(void * data)
     case MF__X_ARGMAP_ARR:      return manifest__err_am_arr(ctx, TI_NOMAP);
     case MF__REQUIREMENTS:      return manifest__err_reqm(ctx, TI_NOMAP);
     case MF__REQUIREMENTS_ARR:  return manifest__err_reqm_arr(ctx, TI_NOMAP);
+    case MF__WORKERS:           return manifest__err_workers(ctx, TI_NOMAP);
+    case MF__SHM_SIZE:          return manifest__err_shm_size(ctx, TI_NOMAP);
     default:                    return manifest__err_unexpected(ctx);
     }
 }
@@ -817,6 +970,10 @@ static int manifest__json_map_key(
             return manifest__set_mode(ctx, MF__EXPOSES);
         if (manifest__key_equals(s, n, "requirements", 12))
             return manifest__set_mode(ctx, MF__REQUIREMENTS);
+        if (manifest__key_equals(s, n, "workers", 7))
+            return manifest__set_mode(ctx, MF__WORKERS);
+        if (manifest__key_equals(s, n, "shm_size", 8))
+            return manifest__set_mode(ctx, MF__SHM_SIZE);
 
         return manifest__set_err(
                 ctx, "unsupported key `%.*s` in "TI_MANIFEST,
@@ -984,6 +1141,8 @@ static int manifest__json_start_array(void * data)
         }
         return manifest__set_mode(ctx, MF__REQUIREMENTS_ARR);
     case MF__REQUIREMENTS_ARR:  return manifest__err_reqm_arr(ctx, NOARRAY);
+    case MF__WORKERS:           return manifest__err_workers(ctx, NOARRAY);
+    case MF__SHM_SIZE:          return manifest__err_shm_size(ctx, NOARRAY);
     default:                    return manifest__err_unexpected(ctx);
     }
 }
@@ -0,0 +1,413 @@
+/*
+ * ti/mod/native.c
+ *
+ * Native modules are shared libraries which are loaded in-process. A native
+ * module uses the same MessagePack requests and results as a module which
+ * runs as a process, but calls either run synchronously on the event loop
+ * thread, or on a worker thread from the libuv thread pool.
+ */
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ti.h>
+#include <ti/future.h>
+#include <ti/future.inline.h>
+#include <ti/mod/native.h>
+#include <ti/module.h>
+#include <ti/pkg.h>
+#include <ti/query.h>
+#include <ti/thing.inline.h>
+#include <ti/val.inline.h>
+#include <ti/verror.h>
+#include <util/logger.h>
+
+struct ti_abi_res_s
+{
+    char * data;        /* MessagePack result */
+    size_t n;
+    char * msg;         /* error message, NULL if no error is set */
+    int code;
+};
+
+typedef struct
+{
+    uv_work_t work;
+    ti_module_t * module;
+    ti_pkg_t * pkg;             /* request */
+    uint16_t pid;
+    ti_abi_res_t res;
+    ti_abi_out_t out;
+} native__work_t;
+
+static int native__set_result(ti_abi_res_t * res, const void * data, size_t n)
+{
+    if (res->data || res->msg)
+        return -1;  /* result or error is already set */
+
+    res->data = malloc(n);
+    if (!res->data)
+        return -1;
+
+    memcpy(res->data, data, n);
+    res->n = n;
+    return 0;
+}
+
+static int native__set_error(ti_abi_res_t * res, int code, const char * msg)
+{
+    if (res->data || res->msg)
+        return -1;  /* result or error is already set */
+
+    res->msg = strdup(msg ? msg : "");
+    if (!res->msg)
+        return -1;
+
+    res->code = code;
+    return 0;
+}
+
+static inline void native__out_init(ti_abi_out_t * out, ti_abi_res_t * res)
+{
+    memset(res, 0, sizeof(ti_abi_res_t));
+    out->res = res;
+    out->set_result = native__set_result;
+    out->set_error = native__set_error;
+}
+
+static inline void native__res_clear(ti_abi_res_t * res)
+{
+    free(res->data);
+    free(res->msg);
+}
+
+/*
+ * Convert an error from a native module to an exception. The same rules as
+ * for errors from modules which run as a process apply.
+ */
+static int native__res_err(ti_module_t * module, ti_abi_res_t * res, ex_t * e)
+{
+    size_t n = strlen(res->msg);
+
+    if (res->code < EX_MIN_ERR || res->code > EX_MAX_BUILD_IN_ERR)
+    {
+        ex_set(e, EX_BAD_DATA,
+            "invalid error code (%d) received from module `%s`",
+            res->code,
+            module->name->str);
+        return e->nr;
+    }
+
+    if (ti_verror_check_msg(res->msg, n, e))
+        return e->nr;
+
+    ex_setn(e, res->code, res->msg, n);
+    return e->nr;
+}
+
+static void native__close(ti_module_t * module)
+{
+    ti_mod_native_destroy(module->native);
+    module->native = NULL;
+    ti_module_on_exit(module, NULL);
+}
+
+int ti_mod_native_load(ti_module_t * module)
+{
+    void * handle;
+    ti_abi_init_t init;
+    const ti_abi_module_t * abi;
+    ti_mod_native_t * native;
+
+    handle = dlopen(module->file, RTLD_NOW|RTLD_LOCAL);
+    if (!handle)
+    {
+        ti_module_set_source_err(module, "%s", dlerror());
+        return TI_MODULE_STAT_SOURCE_ERR;
+    }
+
+    /* ISO C does not allow this cast, but POSIX requires it to work */
+    *(void **) (&init) = dlsym(handle, TI_ABI_INIT_SYMBOL);
+    if (!init)
+    {
+        ti_module_set_source_err(
+                module,
+                "missing function `"TI_ABI_INIT_SYMBOL"` in module `%s`",
+                module->name->str);
+        goto fail0;
+    }
+
+    abi = init();
+    if (!abi || !abi->call)
+    {
+        ti_module_set_source_err(
+                module,
+                "function `"TI_ABI_INIT_SYMBOL"` in module `%s` did not "
+                "return a module with a `call` function",
+                module->name->str);
+        goto fail0;
+    }
+
+    if (abi->abi_version != TI_ABI_VERSION)
+    {
+        ti_module_set_source_err(
+                module,
+                "module `%s` is build for ABI version %u while ThingsDB "
+                "requires ABI version %u",
+                module->name->str,
+                abi->abi_version,
+                TI_ABI_VERSION);
+        goto fail0;
+    }
+
+    native = malloc(sizeof(ti_mod_native_t));
+    if (!native)
+    {
+        (void) dlclose(handle);
+        return UV_EAI_MEMORY;
+    }
+
+    native->handle = handle;
+    native->abi = abi;
+    native->in_flight = 0;
+    native->unload = false;
+
+    module->native = native;
+    return TI_MODULE_STAT_RUNNING;
+
+fail0:
+    (void) dlclose(handle);
+    return TI_MODULE_STAT_SOURCE_ERR;
+}
+
+/*
+ * Returns 0 on success or TI_MODULE_STAT_CONFIGURATION_ERR when the module
+ * has rejected the configuration.
+ */
+int ti_mod_native_conf(ti_module_t * module)
+{
+    const ti_abi_module_t * abi = module->native->abi;
+    ti_pkg_t * pkg = module->conf_pkg;
+
+    if (!pkg || !abi->conf)
+    {
+        log_debug("no configuration found for module `%s`", module->name->str);
+        return 0;
+    }
+
+    if (abi->conf(pkg->data, pkg->n))
+    {
+        log_info("failed to configure module `%s`", module->name->str);
+        return TI_MODULE_STAT_CONFIGURATION_ERR;
+    }
+
+    log_info("module `%s` is successfully configured", module->name->str);
+    return 0;
+}
+
+/*
+ * Unload the native module. When calls are still running on a worker thread,
+ * the library is closed after the last call has finished.
+ */
+void ti_mod_native_unload(ti_module_t * module)
+{
+    module->native->unload = true;
+    if (!module->native->in_flight)
+        native__close(module);
+}
+
+void ti_mod_native_destroy(ti_mod_native_t * native)
+{
+    if (!native)
+        return;
+
+    assert(!native->in_flight);
+
+    if (native->abi->unload)
+        native->abi->unload();
+
+    if (dlclose(native->handle))
+        log_error("failed to close native module: %s", dlerror());
+
+    free(native);
+}
+
+static void native__work(uv_work_t * work)
+{
+    native__work_t * w = work->data;
+    w->module->native->abi->call(w->pkg->data, w->pkg->n, &w->out);
+}
+
+static void native__after_work(uv_work_t * work, int status)
+{
+    ex_t e = {0};
+    native__work_t * w = work->data;
+    ti_module_t * module = w->module;
+    ti_future_t * future = ti_module_pop_future(module, w->pid);
+
+    if (future)
+    {
+        ti_module_latency(module, &future->sent_at);
+
+        if (status)
+        {
+            ex_sets(&e, EX_OPERATION, uv_strerror(status));
+            ti_query_on_future_result(future, &e);
+        }
+        else if (w->res.msg)
+        {
+            (void) native__res_err(module, &w->res, &e);
+            ti_query_on_future_result(future, &e);
+        }
+        else if (w->res.data)
+            ti_module_on_res(future, w->res.data, w->res.n);
+        else
+        {
+            ex_set(&e, EX_BAD_DATA,
+                    "module `%s` did not set a result",
+                    module->name->str);
+            ti_query_on_future_result(future, &e);
+        }
+    }
+
+    if (!--module->native->in_flight && module->native->unload)
+        native__close(module);
+
+    native__res_clear(&w->res);
+    free(w->pkg);
+    ti_module_drop(module);
+    free(w);
+}
+
+/*
+ * Callback for futures of an asynchronous native module. The request is
+ * packed on the event loop thread and the module is called on a worker
+ * thread.
+ */
+void ti_mod_native_cb(ti_future_t * future)
+{
+    ex_t e = {0};
+    ti_module_t * module = future->module;
+    ti_thing_t * thing = VEC_get(future->args, 0);
+    native__work_t * w;
+    ti_future_t * prev;
+
+    if (module->status || !module->native || module->native->unload)
+    {
+        ex_set(&e, EX_OPERATION,
+                "module `%s` is not running (status: %s)",
+                module->name->str,
+                ti_module_status_str(module));
+        goto fail0;
+    }
+
+    w = malloc(sizeof(native__work_t));
+    if (!w)
+    {
+        ex_set_mem(&e);
+        goto fail0;
+    }
+
+    w->pkg = ti_module_req_pkg(thing, future->query, ti_future_deep(future));
+    if (!w->pkg)
+    {
+        ex_set_internal(&e);
+        goto fail1;
+    }
+
+    w->pid = future->pid = module->next_pid;
+    prev = omap_set(module->futures, future->pid, future);
+    if (!prev)
+    {
+        ex_set_mem(&e);
+        goto fail2;
+    }
+
+    if (prev != future)
+    {
+        /* both futures are for this module so `prev` has no worker */
+        ti_future_cancel(prev);
+    }
+
+    native__out_init(&w->out, &w->res);
+    w->module = module;
+    w->work.data = w;
+
+    if (uv_queue_work(ti.loop, &w->work, native__work, native__after_work))
+    {
+        (void) omap_rm(module->futures, future->pid);
+        ex_set_internal(&e);
+        goto fail2;
+    }
+
+    ti_incref(module);
+    ++module->native->in_flight;
+    ++module->next_pid;
+    clock_gettime(TI_CLOCK_MONOTONIC, &future->sent_at);
+
+    log_debug("executing future for module `%s`", module->name->str);
+    return;
+
+fail2:
+    free(w->pkg);
+fail1:
+    free(w);
+fail0:
+    ti_query_on_future_result(future, &e);
+}
+
+/*
+ * Call a synchronous native module on the event loop thread. The query
+ * value must be the thing with the request and will be replaced with the
+ * result of the module.
+ */
+int ti_mod_native_call(
+        ti_module_t * module,
+        ti_query_t * query,
+        uint8_t deep,
+        _Bool load,
+        ex_t * e)
+{
+    ti_abi_res_t res;
+    ti_abi_out_t out;
+    ti_val_t * val;
+    util_time_t start;
+    ti_pkg_t * pkg = ti_module_req_pkg(
+            (ti_thing_t *) query->rval,
+            query,
+            deep);
+
+    if (!pkg)
+    {
+        ex_set_internal(e);
+        return e->nr;
+    }
+
+    native__out_init(&out, &res);
+    clock_gettime(TI_CLOCK_MONOTONIC, &start);
+
+    module->native->abi->call(pkg->data, pkg->n, &out);
+
+    ti_module_latency(module, &start);
+    free(pkg);
+
+    if (res.msg)
+        (void) native__res_err(module, &res, e);
+    else if (!res.data)
+        ex_set(e, EX_BAD_DATA,
+                "module `%s` did not set a result",
+                module->name->str);
+    else if ((val = ti_module_res_val(
+                module,
+                query,
+                load,
+                res.data,
+                res.n,
+                e)))
+    {
+        ti_val_unsafe_drop(query->rval);
+        query->rval = val;
+    }
+
+    native__res_clear(&res);
+    return e->nr;
+}
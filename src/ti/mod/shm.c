@@ -0,0 +1,183 @@
+/*
+ * ti/mod/shm.c
+ *
+ * Shared memory between ThingsDB and a module process. Large requests and
+ * responses are written to a ring in the shared region while only a small
+ * package with the position and size is sent using the pipe, which also acts
+ * as the wake-up for the other side.
+ */
+#define _GNU_SOURCE
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ti/mod/shm.h>
+#include <unistd.h>
+#include <util/logger.h>
+
+static void shm__ring_init(ti_mod_ring_t * ring, uint64_t offset, uint64_t sz)
+{
+    ring->head = 0;
+    ring->tail = 0;
+    ring->offset = offset;
+    ring->size = sz;
+}
+
+/*
+ * Create a new shared region with a total `size` in bytes. The region is
+ * split in two rings of equal size, one for requests and one for responses.
+ */
+ti_mod_shm_t * ti_mod_shm_create(size_t size)
+{
+    uint64_t ring_sz;
+    ti_mod_shm_t * shm;
+
+    if (size <= TI_MOD_SHM_DATA_OFFSET)
+        return NULL;
+
+    /* keep the ring size a multiple of the cache line size */
+    ring_sz = ((size - TI_MOD_SHM_DATA_OFFSET) / 2) & ~((uint64_t) 63);
+    if (!ring_sz)
+        return NULL;
+
+    shm = malloc(sizeof(ti_mod_shm_t));
+    if (!shm)
+        return NULL;
+
+    shm->size = size;
+    shm->ring_size = ring_sz;
+    shm->req_offset = TI_MOD_SHM_DATA_OFFSET;
+    shm->res_offset = TI_MOD_SHM_DATA_OFFSET + ring_sz;
+    shm->req_head = 0;
+    shm->res_tail = 0;
+    shm->fd = memfd_create("thingsdb-module", MFD_CLOEXEC);
+    if (shm->fd == -1)
+    {
+        log_error("failed to create shared memory: `%s`", strerror(errno));
+        goto fail0;
+    }
+
+    if (ftruncate(shm->fd, (off_t) size) == -1)
+    {
+        log_error("failed to size shared memory: `%s`", strerror(errno));
+        goto fail1;
+    }
+
+    shm->hdr = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, shm->fd, 0);
+    if (shm->hdr == MAP_FAILED)
+    {
+        log_error("failed to map shared memory: `%s`", strerror(errno));
+        goto fail1;
+    }
+
+    shm->hdr->magic = TI_MOD_SHM_MAGIC;
+    shm->hdr->version = TI_MOD_SHM_VERSION;
+    shm->hdr->size = size;
+    shm__ring_init(&shm->hdr->req, shm->req_offset, ring_sz);
+    shm__ring_init(&shm->hdr->res, shm->res_offset, ring_sz);
+    return shm;
+
+fail1:
+    (void) close(shm->fd);
+fail0:
+    free(shm);
+    return NULL;
+}
+
+void ti_mod_shm_destroy(ti_mod_shm_t * shm)
+{
+    if (!shm)
+        return;
+    (void) munmap(shm->hdr, shm->size);
+    (void) close(shm->fd);
+    free(shm);
+}
+
+/*
+ * Write a request to the request ring. Returns 0 and sets `pos` on success,
+ * or -1 when the ring has not enough free space. In the latter case the
+ * request must be written to the pipe instead.
+ */
+int ti_mod_shm_write(
+        ti_mod_shm_t * shm,
+        const void * data,
+        size_t n,
+        uint64_t * pos)
+{
+    uint64_t size = shm->ring_size;
+    uint64_t head = shm->req_head;
+    uint64_t tail = __atomic_load_n(&shm->hdr->req.tail, __ATOMIC_ACQUIRE);
+    uint64_t offset = head % size;
+
+    /* the tail is written by the module and must be within the ring */
+    if (n > size || tail > head || head - tail > size)
+        return -1;
+
+    if (offset + n > size)
+    {
+        /* the record does not fit at the end; skip to the start */
+        head += size - offset;
+        offset = 0;
+    }
+
+    if (head + n - tail > size)
+        return -1;
+
+    memcpy((char *) shm->hdr + shm->req_offset + offset, data, n);
+    *pos = head;
+    shm->req_head = head + n;
+    __atomic_store_n(&shm->hdr->req.head, shm->req_head, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/*
+ * Undo the last request written with ti_mod_shm_write(). This must be used
+ * when the request cannot be sent to the module; the module never sees the
+ * request so the space can be used again.
+ */
+void ti_mod_shm_unwrite(ti_mod_shm_t * shm, uint64_t pos, size_t n)
+{
+    assert(shm->req_head == pos + n);
+    (void) n;
+    shm->req_head = pos;
+    __atomic_store_n(&shm->hdr->req.head, pos, __ATOMIC_RELEASE);
+}
+
+/*
+ * Returns a pointer to a response in the response ring, or NULL when the
+ * position and size do not point to the next written response. Responses
+ * must be sent by the module in the same order as they are written to the
+ * ring, as the ring space is released in order.
+ */
+const void * ti_mod_shm_read(ti_mod_shm_t * shm, uint64_t pos, size_t n)
+{
+    uint64_t size = shm->ring_size;
+    uint64_t head = __atomic_load_n(&shm->hdr->res.head, __ATOMIC_ACQUIRE);
+    uint64_t next = shm->res_tail;
+    uint64_t offset = next % size;
+
+    /* the head is written by the module and must be within the ring */
+    if (n > size || head < next || head - next > size)
+        return NULL;
+
+    if (offset + n > size)
+        next += size - offset;  /* the producer skipped to the start */
+
+    if (pos != next || pos > head || n > head - pos)
+        return NULL;
+
+    return (const char *) shm->hdr + shm->res_offset + (pos % size);
+}
+
+/*
+ * Release a response, this must be called once the response is handled.
+ * Only a response returned by ti_mod_shm_read() may be released, thus
+ * responses are always released in order.
+ */
+void ti_mod_shm_release(ti_mod_shm_t * shm, uint64_t pos, size_t n)
+{
+    assert(pos >= shm->res_tail);
+    shm->res_tail = pos + n;
+    __atomic_store_n(&shm->hdr->res.tail, shm->res_tail, __ATOMIC_RELEASE);
+}
@@ -10,6 +10,8 @@
 #include <ti/future.inline.h>
 #include <ti/mod/github.h>
 #include <ti/mod/manifest.h>
+#include <ti/mod/native.h>
+#include <ti/mod/shm.h>
 #include <ti/mod/work.h>
 #include <ti/mod/work.t.h>
 #include <ti/module.h>
@@ -30,6 +32,59 @@
 #define MODULE__TOO_MANY_RESTARTS 3
 
 
+/*
+ * Must be called when a future is removed from the module futures.
+ */
+static inline void module__future_release(ti_future_t * future)
+{
+    if (future->proc)
+    {
+        --future->proc->in_flight;
+        future->proc = NULL;
+    }
+}
+
+static void module__future_cancel(ti_future_t * future)
+{
+    module__future_release(future);
+    ti_future_cancel(future);
+}
+
+ti_future_t * ti_module_pop_future(ti_module_t * module, uint16_t pid)
+{
+    ti_future_t * future = omap_rm(module->futures, pid);
+    if (future)
+        module__future_release(future);
+    return future;
+}
+
+/*
+ * Returns the worker with the least number of requests in flight, or NULL
+ * when no worker is running and configured.
+ */
+static ti_proc_t * module__proc(ti_module_t * module)
+{
+    ti_proc_t * proc = NULL;
+
+    for (uint8_t i = 0; i < module->nprocs; ++i)
+    {
+        ti_proc_t * p = &module->procs[i];
+        if (p->process.pid &&
+            (~p->flags & TI_PROC_FLAG_WAIT_CONF) &&
+            (!proc || p->in_flight < proc->in_flight))
+            proc = p;
+    }
+    return proc;
+}
+
+static inline _Bool module__in_use(ti_module_t * module)
+{
+    for (uint8_t i = 0; i < module->nprocs; ++i)
+        if (module->procs[i].flags & TI_PROC_FLAG_IN_USE)
+            return true;
+    return false;
+}
+
 static void module__write_req_cb(uv_write_t * req, int status)
 {
     if (status)
@@ -38,7 +93,7 @@ static void module__write_req_cb(uv_write_t * req, int status)
         ti_future_t * future = req->data;
 
         /* remove the future from the module */
-        (void) omap_rm(future->module->futures, future->pid);
+        (void) ti_module_pop_future(future->module, future->pid);
 
         ex_sets(&e, EX_OPERATION, uv_strerror(status));
         ti_query_on_future_result(future, &e);
@@ -47,14 +102,62 @@ static void module__write_req_cb(uv_write_t * req, int status)
     free(req);
 }
 
-static int module__write_req(ti_future_t * future)
+/*
+ * Move a large request to the shared memory of the worker. On success, the
+ * package of the future is replaced with a small package which only contains
+ * the position and size of the request in the ring. When the ring is full,
+ * the original package is kept and written to the pipe.
+ *
+ * Returns `true` when the request is written to shared memory, in which case
+ * `pos` and `n` are set to the space used in the ring.
+ */
+static _Bool module__shm_req(
+        ti_future_t * future,
+        ti_proc_t * proc,
+        uint64_t * pos,
+        size_t * n)
+{
+    msgpack_sbuffer buffer;
+    msgpack_packer pk;
+    ti_pkg_t * pkg = future->pkg;
+
+    if (!proc->shm ||
+        pkg->n < TI_MOD_SHM_THRESHOLD ||
+        mp_sbuffer_alloc_init(&buffer, 32, sizeof(ti_pkg_t)))
+        return false;
+
+    if (ti_mod_shm_write(proc->shm, pkg->data, pkg->n, pos))
+    {
+        log_debug(
+                "shared memory for module `%s` is full; "
+                "write request using the pipe",
+                future->module->name->str);
+        msgpack_sbuffer_destroy(&buffer);
+        return false;
+    }
+
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+    msgpack_pack_array(&pk, 2);
+    msgpack_pack_uint64(&pk, *pos);
+    msgpack_pack_uint64(&pk, pkg->n);
+
+    *n = pkg->n;
+    future->pkg = (ti_pkg_t *) buffer.data;
+    pkg_init(future->pkg, pkg->id, TI_PROTO_MODULE_REQ_SHM, buffer.size);
+    free(pkg);
+    return true;
+}
+
+static int module__write_req(ti_future_t * future, ti_proc_t * proc)
 {
     int uv_err = 0;
     ti_module_t * module = future->module;
-    ti_proc_t * proc = &module->proc;
     uv_buf_t wrbuf;
     ti_future_t * prev;
     uv_write_t * req;
+    uint64_t shm_pos;
+    size_t shm_n;
+    _Bool shm;
 
     req = malloc(sizeof(uv_write_t));
     if (!req)
@@ -71,7 +174,9 @@ static int module__write_req(ti_future_t * future)
     }
 
     if (prev != future)
-        ti_future_cancel(prev);
+        module__future_cancel(prev);
+
+    shm = module__shm_req(future, proc, &shm_pos, &shm_n);
 
     wrbuf = uv_buf_init(
             (char *) future->pkg,
@@ -86,11 +191,18 @@ static int module__write_req(ti_future_t * future)
 
     if (uv_err)
     {
+        /* the module never reads the request, release the space in the ring */
+        if (shm)
+            ti_mod_shm_unwrite(proc->shm, shm_pos, shm_n);
         (void) omap_rm(module->futures, module->next_pid);
         free(req);
         return uv_err;
     }
 
+    future->proc = proc;
+    ++proc->in_flight;
+    clock_gettime(TI_CLOCK_MONOTONIC, &future->sent_at);
+
     ++module->next_pid;
     return 0;
 }
@@ -106,10 +218,9 @@ static void module__write_conf_cb(uv_write_t * req, int status)
     free(req);
 }
 
-static int module__write_conf(ti_module_t * module)
+static int module__write_conf(ti_module_t * module, ti_proc_t * proc)
 {
     int uv_err;
-    ti_proc_t * proc = &module->proc;
     uv_buf_t wrbuf;
     uv_write_t * req;
 
@@ -138,17 +249,50 @@ static int module__write_conf(ti_module_t * module)
     return 0;
 }
 
-static void module__cb(ti_future_t * future)
+/*
+ * Returns a request package for a module with the thing packed as data, or
+ * NULL when out of memory. The `deep` value must not include the thing
+ * itself.
+ */
+ti_pkg_t * ti_module_req_pkg(
+        ti_thing_t * thing,
+        ti_query_t * query,
+        uint8_t deep)
 {
-    int uv_err;
-    ti_thing_t * thing = VEC_get(future->args, 0);
+    ti_pkg_t * pkg;
     ti_vp_t vp = {
-            .query=future->query,   /* bug # #351 */
+            .query=query,   /* bug # #351 */
             .size_limit=ti.cfg->result_size_limit,
     };
     msgpack_sbuffer buffer;
     size_t alloc_sz = 1024;
 
+    if (mp_sbuffer_alloc_init(&buffer, alloc_sz, sizeof(ti_pkg_t)))
+        return NULL;
+    msgpack_packer_init(&vp.pk, &buffer, msgpack_sbuffer_write);
+
+    /*
+     * Add 1 to the `deep` value as we do not count the object itself towards
+     * the `deep` value.
+     * Future have fixed pack flags; thus always with ID's etc.
+     */
+    if (ti_thing_to_client_pk(thing, &vp, deep + 1, 0))
+    {
+        msgpack_sbuffer_destroy(&buffer);
+        return NULL;
+    }
+
+    pkg = (ti_pkg_t *) buffer.data;
+    pkg_init(pkg, 0, TI_PROTO_MODULE_REQ, buffer.size);
+    return pkg;
+}
+
+static void module__cb(ti_future_t * future)
+{
+    int uv_err;
+    ti_proc_t * proc;
+    ti_thing_t * thing = VEC_get(future->args, 0);
+
     assert(ti_val_is_thing((ti_val_t *) thing));
 
     if (future->module->status)
@@ -162,58 +306,43 @@ static void module__cb(ti_future_t * future)
         return;
     }
 
-    if (future->module->proc.process.pid == 0)
+    proc = module__proc(future->module);
+    if (!proc)
     {
         ex_t e;
-        ex_set(&e, EX_OPERATION, "missing process ID for module `%s`",
+        if (future->module->flags & TI_MODULE_FLAG_WAIT_CONF)
+            ex_set(&e, EX_OPERATION,
+                "module `%s` is not configured; "
+                "if you keep this error, then please check the module status",
                 future->module->name->str);
+        else
+            ex_set(&e, EX_OPERATION, "missing process ID for module `%s`",
+                    future->module->name->str);
         ti_query_on_future_result(future, &e);
         return;
     }
 
-    if (future->module->flags & TI_MODULE_FLAG_WAIT_CONF)
+    future->pkg = ti_module_req_pkg(
+            thing,
+            future->query,
+            ti_future_deep(future));
+    if (!future->pkg)
     {
         ex_t e;
-        ex_set(&e, EX_OPERATION,
-                "module `%s` is not configured; "
-                "if you keep this error, then please check the module status",
-                future->module->name->str);
+        ex_set_internal(&e);
         ti_query_on_future_result(future, &e);
         return;
     }
 
-    if (mp_sbuffer_alloc_init(&buffer, alloc_sz, sizeof(ti_pkg_t)))
-        goto mem_error0;
-    msgpack_packer_init(&vp.pk, &buffer, msgpack_sbuffer_write);
-
-    /*
-     * Add 1 to the `deep` value as we do not count the object itself towards
-     * the `deep` value.
-     * Future have fixed pack flags; thus always with ID's etc.
-     */
-    if (ti_thing_to_client_pk(thing, &vp, ti_future_deep(future) + 1, 0))
-        goto mem_error0;
-
-    future->pkg = (ti_pkg_t *) buffer.data;
-    pkg_init(future->pkg, 0, TI_PROTO_MODULE_REQ, buffer.size);
-
     log_debug("executing future for module `%s`", future->module->name->str);
 
-    uv_err = module__write_req(future);
+    uv_err = module__write_req(future, proc);
     if (uv_err)
     {
         ex_t e;
         ex_sets(&e, EX_OPERATION, uv_strerror(uv_err));
         ti_query_on_future_result(future, &e);
     }
-    return;
-
-mem_error0:
-    {
-        ex_t e;
-        ex_set_internal(&e);
-        ti_query_on_future_result(future, &e);
-    }
 }
 
 ti_pkg_t * ti_module_conf_pkg(ti_val_t * val, ti_query_t * query)
@@ -253,6 +382,14 @@ _Bool ti_module_file_is_py(const char * file, size_t n)
            file[n-1] == 'y';
 }
 
+_Bool ti_module_file_is_native(const char * file, size_t n)
+{
+    return n > 3 &&
+           file[n-3] == '.' &&
+           file[n-2] == 's' &&
+           file[n-1] == 'o';
+}
+
 static int module__validate_source(const char * file, size_t file_n, ex_t * e)
 {
     const char * pt = file;
@@ -342,6 +479,8 @@ ti_module_t* ti_module_create(
         module->source_type = TI_MODULE_SOURCE_FILE;
         module->source.file = module->orig;
         module->manifest.is_py = ti_module_file_is_py(source, source_n);
+        module->manifest.is_native =
+                ti_module_file_is_native(source, source_n);
     }
 
     /* The status might be changed for non-file based sources. */
@@ -386,6 +525,25 @@ fail0:
 int ti_module_set_file(ti_module_t * module, const char * file, size_t n)
 {
     char * str_file, ** args;
+    uint8_t nprocs = ti_module_is_native(module)
+            ? 0  /* native modules run in-process */
+            : module->manifest.workers ? module->manifest.workers : 1;
+
+    if (nprocs != module->nprocs)
+    {
+        ti_proc_t * procs = NULL;
+        if (nprocs)
+        {
+            procs = realloc(module->procs, sizeof(ti_proc_t) * nprocs);
+            if (!procs)
+                return -1;
+        }
+        else
+            free(module->procs);
+        module->procs = procs;
+        module->nprocs = nprocs;
+    }
+
     args = malloc(sizeof(char*) * (module->manifest.is_py ? 3 : 2));
     str_file = fx_path_join_strn(module->path, strlen(module->path), file, n);
 
@@ -416,20 +574,26 @@ int ti_module_set_file(ti_module_t * module, const char * file, size_t n)
         module->args[1] = NULL;
     }
 
-    ti_proc_init(&module->proc, module);
+    for (uint8_t i = 0; i < module->nprocs; ++i)
+        ti_proc_init(&module->procs[i], module);
+
+    module->cb = ti_module_is_native(module)
+            ? (ti_module_cb) &ti_mod_native_cb
+            : (ti_module_cb) &module__cb;
     return 0;
 }
 
-static void module__conf(ti_module_t * module)
+static void module__conf(ti_module_t * module, ti_proc_t * proc)
 {
     if (!module->conf_pkg)
     {
         module->flags &= ~TI_MODULE_FLAG_WAIT_CONF;
+        proc->flags &= ~TI_PROC_FLAG_WAIT_CONF;
         log_debug("no configuration found for module `%s`", module->name->str);
         return;
     }
 
-    module->status = module__write_conf(module);
+    module->status = module__write_conf(module, proc);
 
     if (module->status == TI_MODULE_STAT_RUNNING)
         log_info("wrote configuration to module `%s`", module->name->str);
@@ -764,6 +928,50 @@ fail:
     log_error("failed install module: `%s`", module->name->str);
 }
 
+/*
+ * Start a single worker, used for additional workers and to restart a worker
+ * which has exited while other workers are still running.
+ */
+static void module__load_worker(ti_module_t * module, ti_proc_t * proc)
+{
+    int rc = ti_proc_load(proc);
+    if (rc)
+    {
+        log_error(
+                "failed to start worker %u for module `%s` (%s): %s",
+                (unsigned int) (proc - module->procs),
+                module->name->str,
+                module->file,
+                rc < 0
+                    ? uv_strerror(rc)
+                    : "the Python interpreter is not found");
+        return;
+    }
+    module__conf(module, proc);
+}
+
+static void module__load_native(ti_module_t * module)
+{
+    module->status = ti_mod_native_load(module);
+    if (module->status != TI_MODULE_STAT_RUNNING)
+    {
+        log_error(
+                "failed to load native module `%s` (%s): %s",
+                module->name->str,
+                module->file,
+                ti_module_status_str(module));
+        return;
+    }
+
+    log_info(
+            "loaded native module `%s` (%s)",
+            module->name->str,
+            module->file);
+
+    module->flags |= TI_MODULE_FLAG_IN_USE;
+    module->status = ti_mod_native_conf(module);
+}
+
 void ti_module_load(ti_module_t * module)
 {
     static const module__install_t module__gh_install = {
@@ -773,9 +981,7 @@ void ti_module_load(ti_module_t * module)
 
     if (module->flags & TI_MODULE_FLAG_IN_USE)
     {
-        log_debug(
-                "module `%s` already loaded (PID %d)",
-                module->name->str, module->proc.process.pid);
+        log_debug("module `%s` already loaded", module->name->str);
         return;
     }
 
@@ -820,16 +1026,27 @@ void ti_module_load(ti_module_t * module)
         return;
     }
 
+    if (ti_module_is_native(module))
+    {
+        module__load_native(module);
+        return;
+    }
+
     module->flags |= TI_MODULE_FLAG_WAIT_CONF;
-    module->status = ti_proc_load(&module->proc);
+    module->status = ti_proc_load(&module->procs[0]);
 
     if (module->status == TI_MODULE_STAT_RUNNING)
     {
         log_info(
-                "loaded module `%s` (%s)",
+                "loaded module `%s` (%s) with %u worker%s",
                 module->name->str,
-                module->file);
-        module__conf(module);
+                module->file,
+                module->nprocs,
+                module->nprocs == 1 ? "" : "s");
+        module__conf(module, &module->procs[0]);
+
+        for (uint8_t i = 1; i < module->nprocs; ++i)
+            module__load_worker(module, &module->procs[i]);
     }
     else
     {
@@ -1028,16 +1245,96 @@ int ti_module_deploy(ti_module_t * module, const void * data, size_t n)
 
 void ti_module_update_conf(ti_module_t * module)
 {
-    if (module->flags & TI_MODULE_FLAG_IN_USE)
-        module__conf(module);
+    if (module->native)
+    {
+        if (!module->native->unload)
+            module->status = ti_mod_native_conf(module);
+    }
+    else if (module->flags & TI_MODULE_FLAG_IN_USE)
+    {
+        for (uint8_t i = 0; i < module->nprocs; ++i)
+            if (module->procs[i].flags & TI_PROC_FLAG_IN_USE)
+                module__conf(module, &module->procs[i]);
+    }
     else
         ti_module_load(module);
 }
 
-void ti_module_on_exit(ti_module_t * module)
+/*
+ * Cancel the futures which are waiting for a response from the given worker.
+ */
+static void module__cancel_proc_futures(ti_module_t * module, ti_proc_t * proc)
 {
-    /* First cancel all open futures */
-    ti_module_cancel_futures(module);
+    vec_t * vec;
+    omap_iter_t iter;
+
+    if (module->nprocs == 1)
+    {
+        ti_module_cancel_futures(module);
+        return;
+    }
+
+    vec = vec_new(proc->in_flight);
+    if (!vec)
+    {
+        log_error(EX_MEMORY_S);
+        ti_module_cancel_futures(module);
+        return;
+    }
+
+    iter = omap_iter(module->futures);
+    for (omap_each(iter, ti_future_t, future))
+        if (future->proc == proc && vec_push(&vec, future))
+            log_error(EX_MEMORY_S);
+
+    for (vec_each(vec, ti_future_t, future))
+    {
+        (void) ti_module_pop_future(module, future->pid);
+        ti_future_cancel(future);
+    }
+
+    vec_destroy(vec, NULL);
+}
+
+/*
+ * Called when a worker has exited, or with `proc` set to NULL when a native
+ * module is unloaded.
+ */
+void ti_module_on_exit(ti_module_t * module, ti_proc_t * proc)
+{
+    if (!proc)
+        ti_module_cancel_futures(module);
+    else
+    {
+        /* First cancel all open futures for this worker */
+        module__cancel_proc_futures(module, proc);
+        proc->flags = 0;
+    }
+
+    if (proc && module__in_use(module))
+    {
+        /* Other workers are still running */
+        if (module->status != TI_MODULE_STAT_RUNNING ||
+            (module->flags & (
+                TI_MODULE_FLAG_DESTROY|
+                TI_MODULE_FLAG_RESTARTING)) ||
+            ti_flag_test(TI_FLAG_SIGNAL))
+            return;  /* wait for the other workers to exit */
+
+        /* Unexpected exit of a single worker, try to restart the worker */
+        if (++proc->restarts > MODULE__TOO_MANY_RESTARTS)
+        {
+            log_error(
+                    "worker %u for module `%s` has been restarted too many "
+                    "(>%d) times",
+                    (unsigned int) (proc - module->procs),
+                    module->name->str,
+                    MODULE__TOO_MANY_RESTARTS);
+            return;
+        }
+        module__load_worker(module, proc);
+        return;
+    }
 
     module->flags &= ~TI_MODULE_FLAG_IN_USE;
 
@@ -1059,6 +1356,8 @@ void ti_module_on_exit(ti_module_t * module)
     {
         /* Catch a restart before the stopping status */
         module->restarts = 0;
+        for (uint8_t i = 0; i < module->nprocs; ++i)
+            module->procs[i].restarts = 0;
         module->flags &= ~TI_MODULE_FLAG_RESTARTING;
         goto restart;
     }
@@ -1097,20 +1396,42 @@ restart:
 
 int ti_module_stop(ti_module_t * module)
 {
-    int rc, pid = module->proc.process.pid;
-    if (!pid)
+    int rc = 0;
+    _Bool stopping = false;
+
+    if (module->native)
+    {
+        if (!module->native->unload)
+        {
+            module->status = TI_MODULE_STAT_STOPPING;
+            ti_mod_native_unload(module);
+        }
         return 0;
-    rc = uv_kill(pid, SIGTERM);
-    if (rc)
+    }
+
+    for (uint8_t i = 0; i < module->nprocs; ++i)
     {
-        log_error(
-                "failed to stop module `%s` (%s)",
-                module->name->str,
-                uv_strerror(rc));
-        module->status = rc;
+        int err, pid = module->procs[i].process.pid;
+        if (!pid)
+            continue;
+
+        err = uv_kill(pid, SIGTERM);
+        if (err)
+        {
+            log_error(
+                    "failed to stop module `%s` (%s)",
+                    module->name->str,
+                    uv_strerror(err));
+            rc = err;
+        }
+        else
+            stopping = true;
     }
-    else
+
+    if (stopping)
         module->status = TI_MODULE_STAT_STOPPING;
+    else if (rc)
+        module->status = rc;
     return rc;
 }
 
@@ -1150,39 +1471,62 @@ void ti_module_del(ti_module_t * module, _Bool delete_files)
 
 void ti_module_cancel_futures(ti_module_t * module)
 {
-    omap_clear(module->futures, (omap_destroy_cb) ti_future_cancel);
+    omap_clear(module->futures, (omap_destroy_cb) module__future_cancel);
 }
 
-static void module__on_res(ti_future_t * future, ti_pkg_t * pkg)
+/*
+ * Returns a value from a MessagePack result of a module. When `load` is
+ * `false`, the result is kept as MessagePack data.
+ */
+ti_val_t * ti_module_res_val(
+        ti_module_t * module,
+        ti_query_t * query,
+        _Bool load,
+        const void * data,
+        size_t n,
+        ex_t * e)
 {
-    ex_t e = {0};
     ti_val_t * val;
 
-    if (ti_future_should_load(future))
+    if (load)
     {
         mp_unp_t up;
         ti_vup_t vup = {
                 .isclient = true,
-                .collection = future->query->collection,
+                .collection = query->collection,
                 .up = &up,
         };
-        mp_unp_init(&up, pkg->data, pkg->n);
-        val = ti_val_from_vup_e(&vup, &e);
+        mp_unp_init(&up, data, n);
+        val = ti_val_from_vup_e(&vup, e);
     }
-    else if (!mp_is_valid(pkg->data, pkg->n))
+    else if (!mp_is_valid(data, n))
     {
-        ex_set(&e, EX_BAD_DATA,
+        ex_set(e, EX_BAD_DATA,
                 "got invalid or corrupt MsgPack data from module: `%s`",
-                future->module->name->str);
-        val = NULL;
+                module->name->str);
+        return NULL;
     }
     else
-        val = (ti_val_t *) ti_mp_create(pkg->data, pkg->n);
+        val = (ti_val_t *) ti_mp_create(data, n);
+
+    if (!val && e->nr == 0)
+        ex_set_mem(e);
+    return val;
+}
+
+void ti_module_on_res(ti_future_t * future, const void * data, size_t n)
+{
+    ex_t e = {0};
+    ti_val_t * val = ti_module_res_val(
+            future->module,
+            future->query,
+            ti_future_should_load(future),
+            data,
+            n,
+            &e);
 
     if (!val)
     {
-        if (e.nr == 0)
-            ex_set_mem(&e);
         ti_query_on_future_result(future, &e);
         return;
     }
@@ -1244,8 +1588,52 @@ done:
     ti_query_on_future_result(future, &e);
 }
 
-void ti_module_on_pkg(ti_module_t * module, ti_pkg_t * pkg)
+void ti_module_latency(ti_module_t * module, util_time_t * sent_at)
 {
+    util_time_t now;
+    double latency;
+
+    clock_gettime(TI_CLOCK_MONOTONIC, &now);
+    latency = util_time_diff(sent_at, &now);
+
+    ++module->calls;
+    module->latency_sum += latency;
+    if (latency > module->latency_max)
+        module->latency_max = latency;
+}
+
+/*
+ * Returns a pointer to the response in shared memory, or NULL when the
+ * package does not point to a valid response. The position and size must be
+ * released using ti_mod_shm_release(), even when the future is gone.
+ */
+static const void * module__shm_res(
+        ti_proc_t * proc,
+        ti_pkg_t * pkg,
+        uint64_t * pos,
+        size_t * n)
+{
+    mp_unp_t up;
+    mp_obj_t obj, mp_pos, mp_n;
+
+    if (!proc->shm)
+        return NULL;
+
+    mp_unp_init(&up, pkg->data, pkg->n);
+
+    if (mp_next(&up, &obj) != MP_ARR || obj.via.sz != 2 ||
+        mp_next(&up, &mp_pos) != MP_U64 ||
+        mp_next(&up, &mp_n) != MP_U64)
+        return NULL;
+
+    *pos = mp_pos.via.u64;
+    *n = (size_t) mp_n.via.u64;
+    return ti_mod_shm_read(proc->shm, *pos, *n);
+}
+
+void ti_module_on_pkg(ti_proc_t * proc, ti_pkg_t * pkg)
+{
+    ti_module_t * module = proc->module;
     ti_future_t * future;
 
     switch(pkg->tp)
@@ -1254,11 +1642,47 @@ void ti_module_on_pkg(ti_module_t * module, ti_pkg_t * pkg)
         log_info("module `%s` is successfully configured", module->name->str);
         module->status &= ~TI_MODULE_STAT_CONFIGURATION_ERR;
         module->flags &= ~TI_MODULE_FLAG_WAIT_CONF;
+        proc->flags &= ~TI_PROC_FLAG_WAIT_CONF;
         return;
     case TI_PROTO_MODULE_CONF_ERR:
         log_info("failed to configure module `%s`", module->name->str);
         module->status = TI_MODULE_STAT_CONFIGURATION_ERR;
         module->flags &= ~TI_MODULE_FLAG_WAIT_CONF;
+        proc->flags &= ~TI_PROC_FLAG_WAIT_CONF;
+        return;
+    }
+
+    if (pkg->tp == TI_PROTO_MODULE_RES_SHM)
+    {
+        uint64_t pos = 0;
+        size_t n = 0;
+        const void * data = module__shm_res(proc, pkg, &pos, &n);
+
+        future = omap_rm(module->futures, pkg->id);
+        if (future)
+        {
+            ti_module_latency(module, &future->sent_at);
+            module__future_release(future);
+
+            if (data)
+                ti_module_on_res(future, data, n);
+            else
+            {
+                ex_t e;
+                ex_set(&e, EX_BAD_DATA,
+                        "invalid shared memory response from module `%s`",
+                        module->name->str);
+                ti_query_on_future_result(future, &e);
+            }
+        }
+        else
+            log_error(
+                    "got a response for future id %u but a future with this "
+                    "id does not exist; maybe the future has been cancelled?",
+                    pkg->id);
+
+        if (data)
+            ti_mod_shm_release(proc->shm, pos, n);
         return;
     }
 
@@ -1272,10 +1696,13 @@ void ti_module_on_pkg(ti_module_t * module, ti_pkg_t * pkg)
         return;
     }
 
+    ti_module_latency(module, &future->sent_at);
+    module__future_release(future);
+
     switch(pkg->tp)
     {
     case TI_PROTO_MODULE_RES:
-        module__on_res(future, pkg);
+        ti_module_on_res(future, pkg->data, pkg->n);
         return;
     case TI_PROTO_MODULE_ERR:
         module__on_err(future, pkg);
@@ -1332,7 +1759,7 @@ static int module__info_to_vp(ti_module_t * module, ti_vp_t * vp, int flags)
     size_t sz = 4 + \
             !!(module->file) + \
             !!(flags & TI_MODULE_FLAG_WITH_CONF) + \
-            !!(flags & TI_MODULE_FLAG_WITH_TASKS) + \
+            (flags & TI_MODULE_FLAG_WITH_TASKS ? 5 : 0) + \
             !!(flags & TI_MODULE_FLAG_WITH_RESTARTS) + \
             ((module->source_type == TI_MODULE_SOURCE_GITHUB) ? 4 : 0) + \
             !!(manifest->version) + \
@@ -1371,7 +1798,18 @@ static int module__info_to_vp(ti_module_t * module, ti_vp_t * vp, int flags)
 
         ((flags & TI_MODULE_FLAG_WITH_TASKS) && (
                 mp_pack_str(pk, "tasks") ||
-                msgpack_pack_uint64(pk, module->futures->n))) ||
+                msgpack_pack_uint64(pk, module->futures->n) ||
+
+                mp_pack_str(pk, "calls") ||
+                msgpack_pack_uint64(pk, module->calls) ||
+
+                mp_pack_str(pk, "average_latency") ||
+                msgpack_pack_double(pk, module->calls
+                        ? module->latency_sum / module->calls
+                        : 0.0) ||
+
+                mp_pack_str(pk, "max_latency") ||
+                msgpack_pack_double(pk, module->latency_max))) ||
 
         ((flags & TI_MODULE_FLAG_WITH_RESTARTS) && (
                 mp_pack_str(pk, "restarts") ||
@@ -1426,6 +1864,26 @@ static int module__info_to_vp(ti_module_t * module, ti_vp_t * vp, int flags)
                     return -1;
     }
 
+    if (flags & TI_MODULE_FLAG_WITH_TASKS)
+    {
+        if (mp_pack_str(pk, "workers") ||
+            msgpack_pack_array(pk, module->nprocs))
+            return -1;
+
+        for (uint8_t i = 0; i < module->nprocs; ++i)
+        {
+            ti_proc_t * proc = &module->procs[i];
+            if (msgpack_pack_map(pk, 3) ||
+                mp_pack_str(pk, "pid") ||
+                msgpack_pack_int(pk, proc->process.pid) ||
+                mp_pack_str(pk, "tasks") ||
+                msgpack_pack_uint32(pk, proc->in_flight) ||
+                mp_pack_str(pk, "restarts") ||
+                msgpack_pack_uint16(pk, proc->restarts))
+                return -1;
+        }
+    }
+
     if (manifest->exposes)
     {
         char namebuf[TI_NAME_MAX];
@@ -1618,6 +2076,32 @@ int ti_module_call(
                 module->manifest.defaults))
         goto fail0;
 
+    if (ti_mod_native_is_sync(module))
+    {
+        /* synchronous native modules return the result without a future */
+        if (nargs > 1)
+        {
+            ex_set(e, EX_NUM_ARGUMENTS,
+                    "native module `%s` is synchronous and takes 1 argument "
+                    "but %d were given"DOC_MODULES,
+                    module->name->str, nargs);
+            goto fail0;
+        }
+
+        if (module->status)
+        {
+            ex_set(e, EX_OPERATION,
+                    "module `%s` is not running (status: %s)",
+                    module->name->str,
+                    ti_module_status_str(module));
+            goto fail0;
+        }
+
+        (void) ti_mod_native_call(module, query, deep, load, e);
+        ti_module_drop(module);
+        return e->nr;
+    }
+
     future = ti_future_create(query, module, nargs, deep, load);
     if (!future)
         goto fail0;
@@ -1675,7 +2159,7 @@ void ti_module_destroy(ti_module_t * module)
         return;
     }
 
-    omap_destroy(module->futures, (omap_destroy_cb) ti_future_cancel);
+    omap_destroy(module->futures, (omap_destroy_cb) module__future_cancel);
 
     if ((module->source_type != TI_MODULE_SOURCE_FILE) &&
         (module->flags & TI_MODULE_FLAG_DEL_FILES) &&
@@ -1687,6 +2171,8 @@ void ti_module_destroy(ti_module_t * module)
     free(module->path);
     free(module->file);
     free(module->args);
+    free(module->procs);
+    ti_mod_native_destroy(module->native);
     free(module->conf_pkg);
     free(module->scope_id);
 
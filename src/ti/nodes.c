@@ -9,6 +9,7 @@
 #include <ti/archive.h>
 #include <ti/args.h>
 #include <ti/auth.h>
+#include <ti/batch.h>
 #include <ti/away.h>
 #include <ti/collection.inline.h>
 #include <ti/fwd.h>
@@ -650,6 +651,84 @@ finish:
     }
 }
 
+static void nodes__on_req_batch(ti_stream_t * stream, ti_pkg_t * pkg)
+{
+    ex_t e = {0};
+    ti_user_t * user;
+    mp_unp_t up;
+    ti_pkg_t * resp = NULL;
+    ti_node_t * other_node = stream->via.node;
+    ti_node_t * this_node = ti.node;
+    mp_obj_t obj, mp_user_id, mp_orig;
+    ti_scope_t scope;
+
+    if (!other_node)
+    {
+        ex_set(&e, EX_AUTH_ERROR,
+                "got `%s` from an unauthorized connection",
+                ti_proto_str(pkg->tp));
+        goto finish;
+    }
+
+    if (this_node->status <= TI_NODE_STAT_BUILDING)
+    {
+        ex_set(&e, EX_NODE_ERROR,
+                TI_NODE_ID" is not ready to handle batch requests",
+                this_node->id);
+        goto finish;
+    }
+
+    mp_unp_init(&up, pkg->data, pkg->n);
+
+    if (mp_next(&up, &obj) != MP_ARR || obj.via.sz != 2 ||
+        mp_next(&up, &mp_user_id) != MP_U64 ||
+        mp_next(&up, &mp_orig) != MP_BIN)
+    {
+        ex_set(&e, EX_BAD_DATA,
+                "invalid batch request from "TI_NODE_ID" to "TI_NODE_ID,
+                other_node->id, this_node->id);
+        goto finish;
+    }
+
+    mp_unp_init(&up, mp_orig.via.bin.data, mp_orig.via.bin.n);
+
+    if (ti_scope_init_from_up(&scope, &up, &e))
+        goto finish;
+
+    if (scope.tp != TI_SCOPE_NODE &&
+        (this_node->status & (
+                TI_NODE_STAT_READY |
+                TI_NODE_STAT_AWAY_SOON |
+                TI_NODE_STAT_SHUTTING_DOWN)) == 0)
+    {
+        ex_set(&e, EX_NODE_ERROR,
+                TI_NODE_ID" is not ready to handle batch requests",
+                this_node->id);
+        goto finish;
+    }
+
+    user = ti_users_get_by_id(mp_user_id.via.u64);
+    if (!user)
+    {
+        ex_set(&e, EX_LOOKUP_ERROR,
+                "cannot find "TI_USER_ID" which is used by a batch from "
+                TI_NODE_ID" to "TI_NODE_ID,
+                mp_user_id.via.u64, other_node->id, this_node->id);
+        goto finish;
+    }
+
+    if (ti_batch_query(stream, user, &scope, &up, pkg->id, &e) == 0)
+        return;  /* the response is sent when all queries are finished */
+
+finish:
+    resp = ti_pkg_client_err(pkg->id, &e);
+    if (!resp || ti_stream_write_pkg(stream, resp))
+    {
+        free(resp);
+        log_error(EX_MEMORY_S);
+    }
+}
+
 static void nodes__on_req_run(ti_stream_t * stream, ti_pkg_t * pkg)
 {
     ex_t e = {0};
@@ -799,7 +878,8 @@ static void nodes__on_req_sync(ti_stream_t * stream, ti_pkg_t * pkg)
     ti_pkg_t * resp = NULL;
     ti_node_t * other_node = stream->via.node;
     mp_unp_t up;
-    mp_obj_t mp_start;
+    mp_obj_t mp_start, mp_proto;
+    uint8_t proto;
 
     if (!other_node)
     {
@@ -833,7 +913,13 @@ static void nodes__on_req_sync(ti_stream_t * stream, ti_pkg_t * pkg)
         goto finish;
     }
 
-    if (ti_away_syncer(stream, mp_start.via.u64))
+    /* the protocol version is not sent by older nodes */
+    proto = (
+        mp_next(&up, &mp_proto) == MP_U64 &&
+        mp_proto.via.u64 <= UINT8_MAX
+    ) ? (uint8_t) mp_proto.via.u64 : 0;
+
+    if (ti_away_syncer(stream, mp_start.via.u64, proto))
     {
         ex_set_mem(&e);
         goto finish;
@@ -1652,7 +1738,6 @@ ti_node_t * ti_nodes_new_node(
 
     /* update relative node id */
     ti_update_rel_id();
-    ti_tasks_reset_lowest_run_at();
 
     return node;
 }
@@ -1870,6 +1955,9 @@ void ti_nodes_pkg_cb(ti_stream_t * stream, ti_pkg_t * pkg)
     case TI_PROTO_NODE_REQ_RUN:
         nodes__on_req_run(stream, pkg);
         break;
+    case TI_PROTO_NODE_REQ_BATCH:
+        nodes__on_req_batch(stream, pkg);
+        break;
     case TI_PROTO_NODE_REQ_CONNECT:
         nodes__on_req_connect(stream, pkg);
         break;
@@ -1903,6 +1991,12 @@ void ti_nodes_pkg_cb(ti_stream_t * stream, ti_pkg_t * pkg)
     case TI_PROTO_NODE_REQ_SYNCEDONE:
         nodes__on_req_syncedone(stream, pkg);
         break;
+    case TI_PROTO_NODE_REQ_SYNCFDIGEST:
+        nodes__on_req_syncpart(stream, pkg, ti_syncfull_on_digest);
+        break;
+    case TI_PROTO_NODE_REQ_SYNCFDPART:
+        nodes__on_req_syncpart(stream, pkg, ti_syncfull_on_dpart);
+        break;
     case TI_PROTO_NODE_RES_CONNECT:
     case TI_PROTO_NODE_RES_ACCEPT:
     case TI_PROTO_NODE_RES_SETUP:
@@ -1913,6 +2007,8 @@ void ti_nodes_pkg_cb(ti_stream_t * stream, ti_pkg_t * pkg)
     case TI_PROTO_NODE_RES_SYNCADONE:
     case TI_PROTO_NODE_RES_SYNCEPART:
     case TI_PROTO_NODE_RES_SYNCEDONE:
+    case TI_PROTO_NODE_RES_SYNCFDIGEST:
+    case TI_PROTO_NODE_RES_SYNCFDPART:
     case TI_PROTO_NODE_ERR_RES:
     case TI_PROTO_NODE_ERR_REJECT:
     case TI_PROTO_NODE_ERR_COLLISION:
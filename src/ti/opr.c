@@ -44,6 +44,21 @@ int ti_opr_a_to_b(ti_val_t * a, cleri_node_t * nd, ti_val_t ** b, ex_t * e)
     return e->nr;
 }
 
+/*
+ * Like ti_opr_a_to_b() but for a variable `a` which might be updated in place.
+ * This makes building a string using `+=` take amortized linear time.
+ */
+int ti_opr_var_a_to_b(
+        ti_val_t ** a,
+        cleri_node_t * nd,
+        ti_val_t ** b,
+        ex_t * e)
+{
+    return *nd->str == '+'
+            ? opr__add_var(a, b, e)
+            : ti_opr_a_to_b(*a, nd, b, e);
+}
+
 _Bool ti__opr_eq_(ti_val_t * a, ti_val_t * b)
 {
     ti_opr_perm_t perm = TI_OPR_PERM(a, b);
@@ -0,0 +1,206 @@
+/*
+ * ti/pcache.c
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <ti.h>
+#include <ti/collection.h>
+#include <ti/counters.h>
+#include <ti/pcache.h>
+#include <ti/thing.h>
+#include <util/ptrmap.h>
+
+/*
+ * Packed data larger than a 1/16th of the cache size is never cached, as a
+ * few of such things would otherwise push all other things out of the cache.
+ */
+#define PCACHE__MAX_ITEM_DIV 16
+
+static inline void pcache__unlink(
+        ti_pcache_t * pcache,
+        ti_pcache_item_t * item)
+{
+    if (item->prev)
+        item->prev->next = item->next;
+    else
+        pcache->head = item->next;
+
+    if (item->next)
+        item->next->prev = item->prev;
+    else
+        pcache->tail = item->prev;
+}
+
+static inline void pcache__push(
+        ti_pcache_t * pcache,
+        ti_pcache_item_t * item)
+{
+    item->prev = NULL;
+    item->next = pcache->head;
+    if (pcache->head)
+        pcache->head->prev = item;
+    else
+        pcache->tail = item;
+    pcache->head = item;
+}
+
+static void pcache__remove(ti_pcache_t * pcache, ti_pcache_item_t * item)
+{
+    (void) ptrmap_pop(pcache->items, item->thing, NULL);
+    pcache__unlink(pcache, item);
+    pcache->size -= item->n;
+    item->thing->flags &= ~TI_THING_FLAG_PACKED;
+    free(item);
+}
+
+static ti_pcache_t * pcache__create(void)
+{
+    ti_pcache_t * pcache = calloc(1, sizeof(ti_pcache_t));
+    if (!pcache)
+        return NULL;
+
+    pcache->items = ptrmap_create();
+    if (!pcache->items)
+    {
+        free(pcache);
+        return NULL;
+    }
+    return pcache;
+}
+
+/*
+ * Called when the collection is destroyed; at this point all things are
+ * destroyed and have removed their packed data from the cache.
+ */
+void ti_pcache_destroy(ti_pcache_t * pcache)
+{
+    ti_pcache_item_t * item;
+
+    if (!pcache)
+        return;
+
+    while ((item = pcache->head))
+    {
+        pcache->head = item->next;
+        free(item);
+    }
+
+    ptrmap_destroy(pcache->items);
+    free(pcache);
+}
+
+/*
+ * Returns 0 when the packed data is written from cache, 1 when the thing is
+ * not in the cache (or the cache is disabled) and -1 in case of an error.
+ */
+int ti_pcache_get(ti_thing_t * thing, ti_vp_t * vp, int flags)
+{
+    ti_pcache_item_t * item;
+    ti_pcache_t * pcache = thing->collection->pcache;
+    msgpack_sbuffer * buffer = vp->pk.data;
+
+    if (!ti.cfg->pack_cache_size)
+        return 1;
+
+    item = (thing->flags & TI_THING_FLAG_PACKED)
+            ? ptrmap_get(pcache->items, thing, NULL)
+            : NULL;
+
+    if (!item ||
+        item->flags != flags ||
+        item->gen != thing->collection->pcache_gen)
+    {
+        if (item)
+            pcache__remove(pcache, item);
+        ++ti.counters->pack_cache_misses;
+        return 1;
+    }
+
+    ++ti.counters->pack_cache_hits;
+
+    if (item != pcache->head)
+    {
+        pcache__unlink(pcache, item);
+        pcache__push(pcache, item);
+    }
+
+    /* the caller is responsible for setting the correct error */
+    if (buffer->size + item->n > vp->size_limit)
+        return -1;
+
+    return msgpack_sbuffer_write(buffer, item->data, item->n);
+}
+
+/*
+ * Store packed data for a thing; the cache must be enabled and the data
+ * must be packed with a `deep` value of 1. Failures are ignored as the
+ * thing will simply be packed again on the next request.
+ */
+void ti_pcache_set(
+        ti_thing_t * thing,
+        int flags,
+        const char * data,
+        size_t n)
+{
+    ti_pcache_item_t * item;
+    ti_collection_t * collection = thing->collection;
+    size_t cache_size = ti.cfg->pack_cache_size;
+
+    if (n > cache_size / PCACHE__MAX_ITEM_DIV)
+        return;
+
+    if (!collection->pcache && !(collection->pcache = pcache__create()))
+        return;
+
+    ti_pcache_drop(thing);
+
+    item = malloc(sizeof(ti_pcache_item_t) + n);
+    if (!item)
+        return;
+
+    if (ptrmap_set(collection->pcache->items, thing, NULL, item))
+    {
+        free(item);
+        return;
+    }
+
+    item->thing = thing;
+    item->gen = collection->pcache_gen;
+    item->flags = flags;
+    item->n = n;
+    memcpy(item->data, data, n);
+
+    thing->flags |= TI_THING_FLAG_PACKED;
+    collection->pcache->size += n;
+    pcache__push(collection->pcache, item);
+
+    while (collection->pcache->size > cache_size)
+        pcache__remove(collection->pcache, collection->pcache->tail);
+}
+
+void ti_pcache__drop(ti_thing_t * thing)
+{
+    ti_pcache_t * pcache = thing->collection->pcache;
+    ti_pcache_item_t * item = ptrmap_get(pcache->items, thing, NULL);
+    if (item)
+        pcache__remove(pcache, item);
+    else
+        thing->flags &= ~TI_THING_FLAG_PACKED;
+}
+
+/*
+ * Returns the number of cached things in all collections. The lock is
+ * required as the garbage collector might remove things in away-mode.
+ */
+size_t ti_pcache_n(void)
+{
+    size_t n = 0;
+    for (vec_each(ti.collections->vec, ti_collection_t, collection))
+    {
+        uv_mutex_lock(collection->lock);
+        if (collection->pcache)
+            n += collection->pcache->items->n;
+        uv_mutex_unlock(collection->lock);
+    }
+    return n;
+}
@@ -1,6 +1,7 @@
 /*
  * ti/proc.c
  */
+#include <ti/mod/shm.h>
 #include <ti/module.t.h>
 #include <ti/proc.h>
 #include <ti.h>
@@ -88,7 +89,7 @@ void proc__on_data(uv_stream_t * uvstream, ssize_t n, const uv_buf_t * uv_buf)
         return;
     }
 
-    ti_module_on_pkg(proc->module, pkg);
+    ti_module_on_pkg(proc, pkg);
 
     buf->len -= total_sz;
     if (buf->len > 0)
@@ -107,7 +108,10 @@ static void proc__on_child_stdout_close(uv_handle_t * handle)
     free(proc->buf.data);
     buf_init(&proc->buf);
 
-    ti_module_on_exit(proc->module);
+    ti_mod_shm_destroy(proc->shm);
+    proc->shm = NULL;
+
+    ti_module_on_exit(proc->module, proc);
 }
 
 static void proc__on_child_stdin_close(uv_handle_t * handle)
@@ -165,6 +169,10 @@ void ti_proc_init(ti_proc_t * proc, ti_module_t * module)
     proc->child_stdio[2].flags = UV_INHERIT_FD;
     proc->child_stdio[2].data.fd = 2;
 
+    /* only used when the module is loaded with shared memory */
+    proc->child_stdio[3].flags = UV_INHERIT_FD;
+    proc->child_stdio[3].data.fd = -1;
+
     proc->options.file = module->manifest.is_py
             ? ti.cfg->python_interpreter
             : module->file;
@@ -196,6 +204,28 @@ int ti_proc_load(ti_proc_t * proc)
     else if (!fx_file_exist(proc->options.file))
         return UV_ENOENT;  /* no such file or directory */
 
+    proc->options.stdio_count = 3;
+
+    if (proc->module->manifest.shm_size)
+    {
+        /*
+         * The module has requested shared memory; when it cannot be created
+         * the module still works using the pipe only.
+         */
+        proc->shm = ti_mod_shm_create(
+                (size_t) proc->module->manifest.shm_size * 1024 * 1024);
+        if (proc->shm)
+        {
+            proc->child_stdio[TI_MOD_SHM_FD].data.fd = proc->shm->fd;
+            proc->options.stdio_count = TI_MOD_SHM_FD + 1;
+        }
+        else
+            log_warning(
+                    "failed to create shared memory for module `%s`; "
+                    "continue without shared memory",
+                    proc->module->name->str);
+    }
+
     rc = uv_pipe_init(ti.loop, &proc->child_stdin, 1);
     if (rc)
         goto fail0;
@@ -217,6 +247,7 @@ int ti_proc_load(ti_proc_t * proc)
 
     proc->module->status = TI_MODULE_STAT_RUNNING;
     proc->module->flags |= TI_MODULE_FLAG_IN_USE;
+    proc->flags |= TI_PROC_FLAG_IN_USE|TI_PROC_FLAG_WAIT_CONF;
     return 0;
 
 fail4:
@@ -232,6 +263,8 @@ fail2:
 fail1:
     uv_close((uv_handle_t *) &proc->child_stdin, NULL);
 fail0:
+    ti_mod_shm_destroy(proc->shm);
+    proc->shm = NULL;
     return rc;
 }
 
@@ -12,6 +12,7 @@
 #include <ti/nil.h>
 #include <ti/procedure.h>
 #include <ti/prop.h>
+#include <ti/rcache.h>
 #include <ti/raw.inline.h>
 #include <ti/val.inline.h>
 #include <tiinc.h>
@@ -37,6 +38,7 @@ ti_procedure_t * ti_procedure_create(
     procedure->def = NULL;
     procedure->closure = closure;
     procedure->created_at = created_at;
+    procedure->cache_ttl = 0;
 
     ti_incref(closure);
 
@@ -53,6 +55,7 @@ void ti_procedure_mod(
         ti_closure_t * closure,
         uint64_t created_at)
 {
+    ti_rcache_drop_procedure(procedure);
     ti_val_unsafe_drop((ti_val_t *) procedure->closure);
     ti_val_drop((ti_val_t *) procedure->doc);
     ti_val_drop((ti_val_t *) procedure->def);
@@ -62,11 +65,19 @@ void ti_procedure_mod(
     procedure->created_at = created_at;
 }
 
+void ti_procedure_set_cache_ttl(ti_procedure_t * procedure, uint32_t ttl)
+{
+    /* cached results are stored with an expiration time for the old TTL */
+    ti_rcache_drop_procedure(procedure);
+    procedure->cache_ttl = ttl;
+}
+
 void ti_procedure_destroy(ti_procedure_t * procedure)
 {
     if (!procedure)
         return;
 
+    ti_rcache_drop_procedure(procedure);
     ti_name_drop(procedure->name);
     ti_val_unsafe_drop((ti_val_t *) procedure->closure);
     ti_val_drop((ti_val_t *) procedure->doc);
@@ -92,6 +103,31 @@ ti_raw_t * ti_procedure_def(ti_procedure_t * procedure)
     return procedure->def;
 }
 
+static int procedure__profile_to_pk(hist_t * hist, msgpack_packer * pk)
+{
+    uint64_t calls = hist ? hist->count : 0;
+    double time = hist ? hist->sum : 0.0;
+
+    return (
+        msgpack_pack_map(pk, 5) ||
+
+        mp_pack_str(pk, "calls") ||
+        msgpack_pack_uint64(pk, calls) ||
+
+        mp_pack_str(pk, "time") ||
+        msgpack_pack_double(pk, time) ||
+
+        mp_pack_str(pk, "average") ||
+        msgpack_pack_double(pk, calls ? time / calls : 0.0) ||
+
+        mp_pack_str(pk, "p99") ||
+        msgpack_pack_double(pk, hist ? hist_quantile(hist, 0.99) : 0.0) ||
+
+        mp_pack_str(pk, "p999") ||
+        msgpack_pack_double(pk, hist ? hist_quantile(hist, 0.999) : 0.0)
+    );
+}
+
 int ti_procedure_info_to_pk(
         ti_procedure_t * procedure,
         msgpack_packer * pk,
@@ -100,7 +136,7 @@ int ti_procedure_info_to_pk(
     ti_raw_t * doc = ti_procedure_doc(procedure);
     ti_raw_t * def;
 
-    if (msgpack_pack_map(pk, 5 + !!with_definition) ||
+    if (msgpack_pack_map(pk, 7 + !!with_definition) ||
 
         mp_pack_str(pk, "doc") ||
         mp_pack_strn(pk, doc->data, doc->n) ||
@@ -119,6 +155,12 @@ int ti_procedure_info_to_pk(
         mp_pack_str(pk, "with_side_effects") ||
         mp_pack_bool(pk, procedure->closure->flags & TI_CLOSURE_FLAG_WSE) ||
 
+        mp_pack_str(pk, "cache_ttl") ||
+        msgpack_pack_uint32(pk, procedure->cache_ttl) ||
+
+        mp_pack_str(pk, "profile") ||
+        procedure__profile_to_pk(procedure->closure->hist, pk) ||
+
         mp_pack_str(pk, "arguments") ||
         msgpack_pack_array(pk, procedure->closure->vars->n))
         return -1;
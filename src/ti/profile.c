@@ -0,0 +1,120 @@
+/*
+ * ti/profile.c
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <ti/profile.h>
+#include <ti/raw.inline.h>
+
+ti_profile_t * ti_profile_create(const char * name, size_t n)
+{
+    ti_profile_t * profile = malloc(sizeof(ti_profile_t) + n);
+    if (!profile)
+        return NULL;
+
+    profile->calls = 0;
+    profile->time = 0.0;
+    profile->parent = NULL;
+    profile->children = NULL;
+    profile->n = n;
+    memcpy(profile->name, name, n);
+    return profile;
+}
+
+void ti_profile_destroy(ti_profile_t * profile)
+{
+    if (!profile)
+        return;
+    vec_destroy(profile->children, (vec_destroy_cb) ti_profile_destroy);
+    free(profile);
+}
+
+/*
+ * Returns the child for a function name and creates the child if it does not
+ * exist. The number of different functions called from a single parent is
+ * small so a linear search is fine. Returns NULL in case of an allocation
+ * error.
+ */
+ti_profile_t * ti_profile_child(
+        ti_profile_t * profile,
+        const char * name,
+        size_t n)
+{
+    ti_profile_t * child;
+
+    if (profile->children)
+        for (vec_each(profile->children, ti_profile_t, c))
+            if (c->n == n && memcmp(c->name, name, n) == 0)
+                return c;
+
+    child = ti_profile_create(name, n);
+    if (!child)
+        return NULL;
+
+    if (vec_push_create(&profile->children, child))
+    {
+        ti_profile_destroy(child);
+        return NULL;
+    }
+
+    child->parent = profile;
+    return child;
+}
+
+static int profile__children_to_pk(ti_profile_t * profile, msgpack_packer * pk)
+{
+    if (!profile->children)
+        return msgpack_pack_array(pk, 0);
+
+    if (msgpack_pack_array(pk, profile->children->n))
+        return -1;
+
+    for (vec_each(profile->children, ti_profile_t, child))
+        if (ti_profile_to_pk(child, pk))
+            return -1;
+    return 0;
+}
+
+int ti_profile_to_pk(ti_profile_t * profile, msgpack_packer * pk)
+{
+    return (
+        msgpack_pack_map(pk, 4) ||
+
+        mp_pack_str(pk, "name") ||
+        mp_pack_strn(pk, profile->name, profile->n) ||
+
+        mp_pack_str(pk, "calls") ||
+        msgpack_pack_uint64(pk, profile->calls) ||
+
+        mp_pack_str(pk, "time") ||
+        msgpack_pack_double(pk, profile->time) ||
+
+        mp_pack_str(pk, "profile") ||
+        profile__children_to_pk(profile, pk)
+    );
+}
+
+/*
+ * Returns the children of the given profile as a list in MessagePack format.
+ */
+ti_val_t * ti_profile_as_mpval(ti_profile_t * profile)
+{
+    ti_raw_t * raw;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+
+    if (mp_sbuffer_alloc_init(&buffer, sizeof(ti_raw_t), sizeof(ti_raw_t)))
+        return NULL;
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    if (profile__children_to_pk(profile, &pk))
+    {
+        msgpack_sbuffer_destroy(&buffer);
+        return NULL;
+    }
+
+    raw = (ti_raw_t *) buffer.data;
+    ti_raw_init(raw, TI_VAL_MPDATA, buffer.size);
+
+    return (ti_val_t *) raw;
+}
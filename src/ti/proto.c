@@ -30,6 +30,7 @@ const char * ti_proto_str(ti_proto_enum_t tp)
     case TI_PROTO_CLIENT_REQ_LEAVE:         return "CLIENT_REQ_LEAVE";
     case TI_PROTO_CLIENT_REQ_EMIT:          return "CLIENT_REQ_EMIT";
     case TI_PROTO_CLIENT_REQ_EMIT_PEER:     return "CLIENT_REQ_EMIT_PEER";
+    case TI_PROTO_CLIENT_REQ_BATCH:         return "CLIENT_REQ_BATCH";
 
     case TI_PROTO_MODULE_CONF:              return "MODULE_CONF";
     case TI_PROTO_MODULE_CONF_OK:           return "MODULE_CONF_OK";
@@ -37,6 +38,8 @@ const char * ti_proto_str(ti_proto_enum_t tp)
     case TI_PROTO_MODULE_REQ:               return "MODULE_REQ";
     case TI_PROTO_MODULE_RES:               return "MODULE_RES";
     case TI_PROTO_MODULE_ERR:               return "MODULE_ERR";
+    case TI_PROTO_MODULE_REQ_SHM:           return "MODULE_REQ_SHM";
+    case TI_PROTO_MODULE_RES_SHM:           return "MODULE_RES_SHM";
 
     case TI_PROTO_NODE_CHANGE:              return "NODE_CHANGE";
     case TI_PROTO_NODE_INFO:                return "NODE_INFO";
@@ -47,6 +50,7 @@ const char * ti_proto_str(ti_proto_enum_t tp)
 
     case TI_PROTO_NODE_REQ_QUERY:           return "NODE_REQ_QUERY";
     case TI_PROTO_NODE_REQ_RUN:             return "NODE_REQ_RUN";
+    case TI_PROTO_NODE_REQ_BATCH:           return "NODE_REQ_BATCH";
 
     case TI_PROTO_NODE_REQ_CONNECT:         return "NODE_REQ_CONNECT";
     case TI_PROTO_NODE_REQ_CHANGE_ID:       return "NODE_REQ_CHANGE_ID";
@@ -59,6 +63,8 @@ const char * ti_proto_str(ti_proto_enum_t tp)
     case TI_PROTO_NODE_REQ_SYNCADONE:       return "NODE_REQ_SYNCADONE";
     case TI_PROTO_NODE_REQ_SYNCEPART:       return "NODE_REQ_SYNCEPART";
     case TI_PROTO_NODE_REQ_SYNCEDONE:       return "NODE_REQ_SYNCEDONE";
+    case TI_PROTO_NODE_REQ_SYNCFDIGEST:     return "NODE_REQ_SYNCFDIGEST";
+    case TI_PROTO_NODE_REQ_SYNCFDPART:      return "NODE_REQ_SYNCFDPART";
 
     case TI_PROTO_NODE_RES_CONNECT:         return "NODE_RES_CONNECT";
     case TI_PROTO_NODE_RES_ACCEPT:          return "NODE_RES_ACCEPT";
@@ -70,6 +76,8 @@ const char * ti_proto_str(ti_proto_enum_t tp)
     case TI_PROTO_NODE_RES_SYNCADONE:       return "NODE_RES_SYNCADONE";
     case TI_PROTO_NODE_RES_SYNCEPART:       return "NODE_RES_SYNCEPART";
     case TI_PROTO_NODE_RES_SYNCEDONE:       return "NODE_RES_SYNCEDONE";
+    case TI_PROTO_NODE_RES_SYNCFDIGEST:     return "NODE_RES_SYNCFDIGEST";
+    case TI_PROTO_NODE_RES_SYNCFDPART:      return "NODE_RES_SYNCFDPART";
 
     case TI_PROTO_NODE_ERR:                 return "NODE_ERR";
     case TI_PROTO_NODE_ERR_RES:             return "NODE_ERR_RES";
@@ -27,6 +27,7 @@
 #include <ti/fn/fnbase64encode.h>
 #include <ti/fn/fnbitcount.h>
 #include <ti/fn/fnbool.h>
+#include <ti/fn/fnbulkload.h>
 #include <ti/fn/fnbytes.h>
 #include <ti/fn/fncall.h>
 #include <ti/fn/fncancel.h>
@@ -59,6 +60,7 @@
 #include <ti/fn/fndeltype.h>
 #include <ti/fn/fndeluser.h>
 #include <ti/fn/fndeploymodule.h>
+#include <ti/fn/fndifference.h>
 #include <ti/fn/fndoc.h>
 #include <ti/fn/fndup.h>
 #include <ti/fn/fneach.h>
@@ -105,6 +107,7 @@
 #include <ti/fn/fnimport.h>
 #include <ti/fn/fnindexof.h>
 #include <ti/fn/fnint.h>
+#include <ti/fn/fnintersection.h>
 #include <ti/fn/fnisarray.h>
 #include <ti/fn/fnisascii.h>
 #include <ti/fn/fnisbool.h>
@@ -185,6 +188,7 @@
 #include <ti/fn/fnproceduredoc.h>
 #include <ti/fn/fnprocedureinfo.h>
 #include <ti/fn/fnproceduresinfo.h>
+#include <ti/fn/fnprofile.h>
 #include <ti/fn/fnpush.h>
 #include <ti/fn/fnraise.h>
 #include <ti/fn/fnrand.h>
@@ -228,6 +232,7 @@
 #include <ti/fn/fnsetname.h>
 #include <ti/fn/fnsetowner.h>
 #include <ti/fn/fnsetpassword.h>
+#include <ti/fn/fnsetprocedurecache.h>
 #include <ti/fn/fnsettimezone.h>
 #include <ti/fn/fnsettype.h>
 #include <ti/fn/fnshift.h>
@@ -309,11 +314,11 @@ static void qbind__statement(ti_qbind_t * qbind, cleri_node_t * nd);
  */
 enum
 {
-    TOTAL_KEYWORDS = 284,
+    TOTAL_KEYWORDS = 289,
     MIN_WORD_LENGTH = 2,
-    MAX_WORD_LENGTH = 17,
+    MAX_WORD_LENGTH = 19,
     MIN_HASH_VALUE = 24,
-    MAX_HASH_VALUE = 776
+    MAX_HASH_VALUE = 828
 };
 
 /*
@@ -358,6 +363,12 @@ static inline unsigned int qbind__hash(
     switch (hval)
     {
         default:
+            hval += asso_values[(unsigned char)s[18]];
+            /*fall through*/
+        case 18:
+            hval += asso_values[(unsigned char)s[17]];
+            /*fall through*/
+        case 17:
             hval += asso_values[(unsigned char)s[16]];
             /*fall through*/
         case 16:
@@ -513,6 +524,7 @@ qbind__fmap_t qbind__fn_mapping[TOTAL_KEYWORDS] = {
     {.name="base64_encode",     .fn=do__f_base64_encode,        ROOT_NE},
     {.name="bit_count",         .fn=do__f_bit_count,            CHAIN_NE},
     {.name="bool",              .fn=do__f_bool,                 ROOT_NE},
+    {.name="bulk_load",         .fn=do__f_bulk_load,            ROOT_NE},
     {.name="bytes",             .fn=do__f_bytes,                ROOT_NE},
     {.name="call",              .fn=do__f_call,                 XCHAIN_NE},
     {.name="cancel",            .fn=do__f_cancel,               CHAIN_BE},
@@ -546,6 +558,7 @@ qbind__fmap_t qbind__fn_mapping[TOTAL_KEYWORDS] = {
     {.name="del_type",          .fn=do__f_del_type,             ROOT_CE},
     {.name="del_user",          .fn=do__f_del_user,             ROOT_TE},
     {.name="deploy_module",     .fn=do__f_deploy_module,        ROOT_TE},
+    {.name="difference",        .fn=do__f_difference,           CHAIN_NE},
     {.name="doc",               .fn=do__f_doc,                  CHAIN_NE},
     {.name="dup",               .fn=do__f_dup,                  CHAIN_NE},
     {.name="each",              .fn=do__f_each,                 CHAIN_NE},
@@ -592,6 +605,7 @@ qbind__fmap_t qbind__fn_mapping[TOTAL_KEYWORDS] = {
     {.name="import",            .fn=do__f_import,               ROOT_CE},
     {.name="index_of",          .fn=do__f_index_of,             CHAIN_NE},
     {.name="int",               .fn=do__f_int,                  ROOT_NE},
+    {.name="intersection",      .fn=do__f_intersection,         CHAIN_NE},
     {.name="is_array",          .fn=do__f_is_array,             ROOT_NE},
     {.name="is_ascii",          .fn=do__f_is_ascii,             ROOT_NE},
     {.name="is_bool",           .fn=do__f_is_bool,              ROOT_NE},
@@ -678,6 +692,7 @@ qbind__fmap_t qbind__fn_mapping[TOTAL_KEYWORDS] = {
     {.name="procedure_doc",     .fn=do__f_procedure_doc,        ROOT_NE},
     {.name="procedure_info",    .fn=do__f_procedure_info,       ROOT_NE},
     {.name="procedures_info",   .fn=do__f_procedures_info,      ROOT_NE},
+    {.name="profile",           .fn=do__f_profile,              ROOT_NE},
     {.name="push",              .fn=do__f_push,                 CHAIN_CE_XX},
     {.name="raise",             .fn=do__f_raise,                ROOT_NE},
     {.name="rand",              .fn=do__f_rand,                 ROOT_NE},
@@ -721,6 +736,7 @@ qbind__fmap_t qbind__fn_mapping[TOTAL_KEYWORDS] = {
     {.name="set_name",          .fn=do__f_set_name,             CHAIN_CE_X},
     {.name="set_owner",         .fn=do__f_set_owner,            CHAIN_BE},
     {.name="set_password",      .fn=do__f_set_password,         ROOT_TE},
+    {.name="set_procedure_cache", .fn=do__f_set_procedure_cache, ROOT_BE},
     {.name="set_time_zone",     .fn=do__f_set_time_zone,        ROOT_TE},
     {.name="set_type",          .fn=do__f_set_type,             ROOT_CE},
     {.name="shift",             .fn=do__f_shift,                CHAIN_CE_XX},
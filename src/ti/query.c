@@ -11,8 +11,10 @@
 #include <ti/access.h>
 #include <ti/api.h>
 #include <ti/auth.h>
+#include <ti/batch.h>
 #include <ti/change.h>
 #include <ti/closure.h>
+#include <ti/closure.inline.h>
 #include <ti/collection.inline.h>
 #include <ti/collections.h>
 #include <ti/data.h>
@@ -29,6 +31,7 @@
 #include <ti/qcache.h>
 #include <ti/query.h>
 #include <ti/query.inline.h>
+#include <ti/rcache.h>
 #include <ti/task.h>
 #include <ti/val.inline.h>
 #include <ti/varr.h>
@@ -46,6 +49,7 @@ ti_query_done_cb ti_query_done_map[] = {
         &ti_query_on_then_result,
         &ti_query_task_result,
         &ti_query_task_result,
+        &ti_query_send_response,
 };
 
 ti_query_run_cb ti_query_run_map[] = {
@@ -54,6 +58,7 @@ ti_query_run_cb ti_query_run_map[] = {
         &ti_query_run_future,
         &ti_query_run_task,
         &ti_query_run_task_finish,
+        &ti_query_run_batch,
 };
 
 /*
@@ -221,9 +226,14 @@ void ti_query_destroy(ti_query_t * query)
     case TI_QUERY_WITH_TASK_FINISH:
         ti_vtask_drop(query->with.vtask);
         break;
+    case TI_QUERY_WITH_BATCH:
+        ti_batch_destroy(query->with.batch);
+        break;
     }
 
+    vec_destroy(query->vtasks, (vec_destroy_cb) ti_vtask_drop);
     ti_collection_drop(query->collection);
+    free(query->rcache_key);
 
     /*
      * Garbage collection at least after cleaning the return value, otherwise
@@ -475,6 +485,13 @@ int ti_query_unp_run(
     for (vec_each(procedure->closure->vars, ti_prop_t, _))
         VEC_push(query->immutable_cache, ti_nil_get());
 
+    /* the arguments are the last value in the request */
+    query->rcache_key = ti_rcache_key_create(
+            query,
+            procedure,
+            up.pt,
+            up.end - up.pt);
+
     mp_next(&up, &obj);
 
     switch (obj.tp)
@@ -548,26 +565,16 @@ static int query__syntax_err(ti_query_t * query, ex_t * e)
     return e->nr;
 }
 
-int ti_query_parse(ti_query_t * query, const char * str, size_t n, ex_t * e)
+/*
+ * Finish parsing a query; takes ownership of the query string.
+ */
+static int query__parsed(
+        ti_query_t * query,
+        char * querystr,
+        cleri_parse_t * parseres,
+        ex_t * e)
 {
-    char * querystr;
-    assert(e->nr == 0);
-    if (query->with.parseres)  /* already parsed and investigated */
-        return query->with.parseres->is_valid
-                ? e->nr
-                : query__syntax_err(query, e);
-
-    querystr = strndup(str, n);
-    if (!querystr)
-    {
-        ex_set_mem(e);
-        goto failed;
-    }
-
-    query->with.parseres = cleri_parse2(
-            ti.langdef,
-            querystr,
-            TI_CLERI_PARSE_FLAGS);
+    query->with.parseres = parseres;
 
     if (!query->with.parseres)
     {
@@ -600,6 +607,109 @@ failed:
     return e->nr;
 }
 
+int ti_query_parse(ti_query_t * query, const char * str, size_t n, ex_t * e)
+{
+    char * querystr;
+    assert(e->nr == 0);
+    if (query->with.parseres)  /* already parsed and investigated */
+        return query->with.parseres->is_valid
+                ? e->nr
+                : query__syntax_err(query, e);
+
+    querystr = strndup(str, n);
+    if (!querystr)
+    {
+        ex_set_mem(e);
+        return e->nr;
+    }
+
+    return query__parsed(
+            query,
+            querystr,
+            cleri_parse2(ti.langdef, querystr, TI_CLERI_PARSE_FLAGS),
+            e);
+}
+
+typedef struct
+{
+    uv_work_t work;
+    ti_query_t * query;
+    char * querystr;
+    cleri_parse_t * parseres;
+    ti_query_done_cb cb;
+} query__parse_t;
+
+static void query__parse_work(uv_work_t * work)
+{
+    query__parse_t * w = work->data;
+    w->parseres = cleri_parse2(ti.langdef, w->querystr, TI_CLERI_PARSE_FLAGS);
+}
+
+static void query__parse_after(uv_work_t * work, int status)
+{
+    ex_t e = {0};
+    query__parse_t * w = work->data;
+
+    if (status)
+    {
+        cleri_parse_free(w->parseres);
+        free(w->querystr);
+        ex_set_internal(&e);
+    }
+    else
+        (void) query__parsed(w->query, w->querystr, w->parseres, &e);
+
+    w->cb(w->query, &e);
+    free(w);
+}
+
+/*
+ * Parse a query on a worker thread. Parsing does not touch any shared state,
+ * only investigating the parse result does and this is done on the event
+ * loop thread before the callback is called with the result.
+ *
+ * Returns 0 when parsing has started or -1 when the query should be parsed
+ * using ti_query_parse(). This is the case for small queries for which the
+ * overhead of a worker thread is larger than the parse time, and for queries
+ * which are already parsed by using the query cache.
+ */
+int ti_query_parse_work(
+        ti_query_t * query,
+        const char * str,
+        size_t n,
+        ti_query_done_cb cb)
+{
+    query__parse_t * w;
+    size_t threshold = ti.cfg->threshold_parse_thread;
+
+    if (!threshold || n < threshold || query->with.parseres)
+        return -1;
+
+    w = malloc(sizeof(query__parse_t));
+    if (!w)
+        return -1;
+
+    w->querystr = strndup(str, n);
+    if (!w->querystr)
+        goto fail0;
+
+    w->work.data = w;
+    w->query = query;
+    w->parseres = NULL;
+    w->cb = cb;
+
+    if (uv_queue_work(ti.loop, &w->work, query__parse_work, query__parse_after))
+        goto fail1;
+
+    return 0;
+
+fail1:
+    free(w->querystr);
+fail0:
+    free(w);
+    return -1;
+}
+
 void ti_query_warn_log(ti_query_t * query, const char * msg)
 {
     switch ((ti_query_with_enum) query->with_tp)
@@ -625,6 +735,9 @@ void ti_query_warn_log(ti_query_t * query, const char * msg)
                 msg,
                 query->with.vtask->closure->node->str);
         return;
+    case TI_QUERY_WITH_BATCH:
+        log_warning("%s; source: batch", msg);
+        return;
     }
     log_warning("%s", msg);
 }
@@ -657,6 +770,12 @@ static void query__duration_log(
                 duration,
                 query->with.vtask->closure->node->str);
         return;
+    case TI_QUERY_WITH_BATCH:
+        log_with_level(log_level,
+                "batch of %"PRIu32" queries took %f seconds to process",
+                query->with.batch->n,
+                duration);
+        return;
     }
 }
 
@@ -726,10 +845,26 @@ void ti_query_on_then_result(ti_query_t * query, ex_t * e)
     }
 }
 
+/*
+ * Tasks in a batch which did not run (yet) are scheduled again.
+ */
+static void query__task_batch_release(ti_query_t * query)
+{
+    ti_vtask_t * vtask;
+    while ((vtask = vec_pop(query->vtasks)))
+    {
+        ti_tasks_vtask_finish(vtask, query->collection);
+        ti_vtask_unsafe_drop(vtask);
+    }
+}
+
 void ti_query_task_result(ti_query_t * query, ex_t * e)
 {
     ti_vtask_t * vtask = query->with.vtask;
 
+    if (query->vtasks)
+        query__task_batch_release(query);
+
     if (query->flags & TI_QUERY_FLAG_TASK_CHANGES)
     {
         if (e->nr)
@@ -969,7 +1104,9 @@ stop:
             if (task)
                 (void) ti_task_add_commit_add(task, query->commit);
         }
-        query__change_handle(query);  /* errors will be logged only */
+        /* the change of a batch is handled when all queries have run */
+        if (!query->batch)
+            query__change_handle(query);  /* errors will be logged only */
     }
     ti_query_done(query, &e, &ti_query_send_response);
 }
@@ -980,6 +1117,12 @@ void ti_query_run_procedure(ti_query_t * query)
 
     clock_gettime(TI_CLOCK_MONOTONIC, &query->time);
 
+    if (query->rcache_key && ti_rcache_hit(query->rcache_key))
+    {
+        ti_query_send_response(query, &e);
+        return;
+    }
+
 #ifndef NDEBUG
     log_debug("[DEBUG] run procedure: %s", query->with.closure->node->str);
 #endif
@@ -991,9 +1134,18 @@ void ti_query_run_procedure(ti_query_t * query)
             query->immutable_cache,
             &e);
 
-    if (query->change)
+    ti_closure_upd_profile(query->with.closure, &query->time);
+
+    if (query->change && !query->batch)
         query__change_handle(query);  /* errors will be logged only */
 
+    /* results which depend on futures are never cached */
+    if (query->rcache_key && (e.nr || query->futures.n))
+    {
+        free(query->rcache_key);
+        query->rcache_key = NULL;
+    }
+
     ti_query_done(query, &e, &ti_query_send_response);
 }
 
@@ -1049,7 +1201,7 @@ void query__task_finish(ti_query_t * query, const ex_t * e, _Bool set_err)
                         : ti_verror_ensure_from_e(e);
             }
 
-            ti_tasks_vtask_finish(vtask);
+            ti_tasks_vtask_finish(vtask, query->collection);
 
             if (ti_task_add_vtask_finish(task, vtask))
                 log_critical("failed to add task finish change");
@@ -1071,57 +1223,200 @@ void ti_query_run_task_finish(ti_query_t * query)
     ti_query_task_result(query, &e);
 }
 
-void ti_query_run_task(ti_query_t * query)
+static void query__task_call(ti_query_t * query, ex_t * e)
 {
-    ex_t e = {0};
     ti_vtask_t * vtask = query->with.vtask;
+    ti_closure_t * callback = vtask->closure;
+    uint32_t n = vtask->args ? vtask->args->n : 0;
 
-    if (vtask->run_at)
+    if (n)
     {
-        ti_closure_t * callback = vtask->closure;
-        uint32_t n = vtask->args ? vtask->args->n : 0;
-
-        clock_gettime(TI_CLOCK_MONOTONIC, &query->time);
-
-        if (n)
-        {
-            ti_val_unsafe_drop(vec_set(vtask->args, vtask, 0));
-            ti_incref(vtask);
-        }
-        ti_incref(callback);
+        ti_val_unsafe_drop(vec_set(vtask->args, vtask, 0));
+        ti_incref(vtask);
+    }
+    ti_incref(callback);
 
 #ifndef NDEBUG
-        log_debug(
-                "[DEBUG] run task: %s",
-                query->with.vtask->closure->node->str);
+    log_debug(
+            "[DEBUG] run task: %s",
+            query->with.vtask->closure->node->str);
 #endif
 
-        /* this can never set `e->nr` to EX_RETURN */
-        (void) ti_closure_call(callback, query, vtask->args, &e);
+    /* this can never set `e->nr` to EX_RETURN */
+    (void) ti_closure_call(callback, query, vtask->args, e);
+
+    /* vtask may be removed within the task by the .del() function so we
+     * need to verify if args still exist; */
+    if (n && vtask->args)
+        ti_val_unsafe_drop(vec_set(vtask->args, ti_nil_get(), 0));
+
+    /* equal reason as above, the task might be removed so we need a
+     * reference to the callback */
+    ti_closure_unsafe_drop(callback);
+}
+
+/*
+ * Pop the next task from a batch. Tasks which are deleted or cancelled since
+ * the batch was created are skipped.
+ */
+static ti_vtask_t * query__task_batch_pop(ti_query_t * query)
+{
+    ti_vtask_t * vtask;
+    while ((vtask = vec_pop(query->vtasks)))
+    {
+        if (vtask->id && vtask->run_at)
+            return vtask;
 
-        /* vtask may be removed within the task by the .del() function so we
-         * need to verify if args still exist; */
-        if (n && vtask->args)
-            ti_val_unsafe_drop(vec_set(vtask->args, ti_nil_get(), 0));
+        ti_tasks_vtask_finish(vtask, query->collection);
+        ti_vtask_unsafe_drop(vtask);
+    }
+    return NULL;
+}
 
-        /* equal reason as above, the task might be removed so we need a
-         * reference to the callback */
-        ti_closure_unsafe_drop(callback);
+/*
+ * Finish the current task in a batch and continue with the next task. All
+ * tasks in a batch share the same change, an error in one task is only
+ * stored on that task and does not affect the other tasks.
+ */
+static void query__task_batch_next(
+        ti_query_t * query,
+        ti_vtask_t * next,
+        _Bool run,
+        ex_t * e)
+{
+    ti_vtask_t * vtask = query->with.vtask;
 
-        if (query->change)
+    if (run)
+    {
+        if (e->nr)
         {
-            if (query->futures.n == 0)
-                query__task_finish(query, &e, true /* set the task error */);
+            /* futures will not run when the task has failed */
+            link_clear(&query->futures, (link_destroy_cb) ti_val_unsafe_drop);
 
-            query__change_handle(query);  /* errors will be logged only */
+            ++ti.counters->tasks_with_error;
+            log_debug("task failed: `%s`, %s: `%s`",
+                    vtask->closure
+                        ? vtask->closure->node->str
+                        : "task:nil",
+                    ex_str(e->nr),
+                    e->msg);
         }
+        else
+            ++ti.counters->queries_success;
+
+        query__task_finish(query, e, true /* set the task error */);
+        ex_clear(e);
+
+        ti_val_drop(query->rval);
+        query->rval = NULL;
     }
     else
-        vtask->flags |= TI_QUERY_FLAG_TASK_CHANGES;
+        ti_tasks_vtask_finish(vtask, query->collection);
+
+    ti_vtask_unsafe_drop(vtask);
+    query->with.vtask = next;
+
+    /* each task runs with the permissions of its own owner */
+    ti_user_drop(query->user);
+    query->user = next->user;
+    ti_incref(query->user);
+}
+
+void ti_query_run_task(ti_query_t * query)
+{
+    ex_t e = {0};
+    ti_vtask_t * vtask, * next;
+    _Bool run;
+
+    clock_gettime(TI_CLOCK_MONOTONIC, &query->time);
+
+    while (1)
+    {
+        vtask = query->with.vtask;
+        run = vtask->run_at != 0;
+
+        if (run)
+            query__task_call(query, &e);
+        else
+            vtask->flags |= TI_QUERY_FLAG_TASK_CHANGES;
+
+        if (!query->vtasks)
+            break;
+
+        if (query->futures.n && !e.nr)
+        {
+            /* the futures must finish this task, other tasks in the batch
+             * will run with a next change */
+            query__task_batch_release(query);
+            break;
+        }
+
+        next = query__task_batch_pop(query);
+        if (!next)
+            break;
+
+        query__task_batch_next(query, next, run, &e);
+    }
+
+    if (query->vtasks && !run)
+    {
+        /* the last task in the batch did not run, the change of the batch
+         * must still be handled but there is nothing left to finish */
+        ti_tasks_vtask_finish(vtask, query->collection);
+        query__change_handle(query);  /* errors will be logged only */
+        ti_query_destroy(query);
+        return;
+    }
+
+    if (run && query->change)
+    {
+        if (query->futures.n == 0)
+            query__task_finish(query, &e, true /* set the task error */);
+
+        query__change_handle(query);  /* errors will be logged only */
+    }
 
     ti_query_done(query, &e, &ti_query_task_result);
 }
 
+/*
+ * Run all queries in a batch, in order. Queries with side effects share the
+ * change of the batch query, this change is handled only once, after all the
+ * queries have run. The response is sent when all queries have a result.
+ */
+void ti_query_run_batch(ti_query_t * query)
+{
+    ti_batch_t * batch = query->with.batch;
+
+    clock_gettime(TI_CLOCK_MONOTONIC, &query->time);
+
+    for (vec_each(batch->queries, ti_query_t, q))
+    {
+        if (ti_query_wse(q))
+        {
+            assert(query->change);
+            q->change = ti_grab(query->change);
+        }
+        ti_query_run(q);
+    }
+
+    /* the queries are owned by the running queries */
+    batch->queries->n = 0;
+
+    if (query->change)
+        query__change_handle(query);  /* errors will be logged only */
+
+    ti_batch_done(batch);
+}
+
+static inline size_t query__alloc_size(ti_query_t * query)
+{
+    /* the return value is not set when the result is found in cache */
+    return query->rcache_key && query->rcache_key->item
+            ? query->rcache_key->item->n
+            : ti_val_alloc_size(query->rval);
+}
+
 static inline int query__pack_response(
         ti_query_t * query,
         msgpack_sbuffer * buffer,
@@ -1131,6 +1426,18 @@ static inline int query__pack_response(
             .query=query,
             .size_limit=ti.cfg->result_size_limit,
     };
+    size_t offset = buffer->size;
+
+    if (query->rcache_key && query->rcache_key->item)
+    {
+        if (ti_rcache_write(query->rcache_key, buffer))
+        {
+            ex_set_mem(e);
+            msgpack_sbuffer_destroy(buffer);
+        }
+        return e->nr;
+    }
+
     msgpack_packer_init(&vp.pk, buffer, msgpack_sbuffer_write);
 
     if (ti_val_to_client_pk(
@@ -1154,6 +1461,12 @@ static inline int query__pack_response(
     if (buffer->size > ti.counters->largest_result_size)
         ti.counters->largest_result_size = buffer->size;
 
+    if (query->rcache_key)
+        ti_rcache_set(
+                query->rcache_key,
+                buffer->data + offset,
+                buffer->size - offset);
+
     return 0;
 }
 
@@ -1165,7 +1478,7 @@ static int query__response_api(ti_query_t * query, ex_t * e)
     if (e->nr)
         goto response_err;
 
-    if (mp_sbuffer_alloc_init(&buffer, ti_val_alloc_size(query->rval), 0))
+    if (mp_sbuffer_alloc_init(&buffer, query__alloc_size(query), 0))
     {
         ex_set_mem(e);
         goto response_err;
@@ -1190,7 +1503,7 @@ static int query__response_pkg(ti_query_t * query, ex_t * e)
 
     if (mp_sbuffer_alloc_init(
             &buffer,
-            ti_val_alloc_size(query->rval),
+            query__alloc_size(query),
             sizeof(ti_pkg_t)))
     {
         ex_set_mem(e);
@@ -1223,12 +1536,42 @@ pkg_err:
     return -1;
 }
 
+static int query__response_batch(ti_query_t * query, ex_t * e)
+{
+    msgpack_sbuffer buffer;
+
+    if (e->nr)
+        goto batch_err;
+
+    if (mp_sbuffer_alloc_init(
+            &buffer,
+            query__alloc_size(query),
+            sizeof(ti_data_t)))
+    {
+        ex_set_mem(e);
+        goto batch_err;
+    }
+
+    if (query__pack_response(query, &buffer, e))
+        goto batch_err;
+
+    ti_data_init((ti_data_t *) buffer.data, buffer.size);
+    ti_batch_set_data(query->batch, query->pkg_id, (ti_data_t *) buffer.data);
+    return 0;
+
+batch_err:
+    ti_batch_set_err(query->batch, query->pkg_id, e);
+    return -1;
+}
+
 typedef int (*query__cb)(ti_query_t *, ex_t *);
 
 void ti_query_send_response(ti_query_t * query, ex_t * e)
 {
     double duration, warn = ti.cfg->query_duration_warn;
-    query__cb cb = query->flags & TI_QUERY_FLAG_API
+    query__cb cb = query->batch
+            ? query__response_batch
+            : query->flags & TI_QUERY_FLAG_API
             ? query__response_api
             : query__response_pkg;
 
@@ -1248,6 +1591,11 @@ void ti_query_send_response(ti_query_t * query, ex_t * e)
                     ex_str(e->nr),
                     e->msg);
             break;
+        case TI_QUERY_WITH_BATCH:
+            log_debug("batch failed: %s: `%s`",
+                    ex_str(e->nr),
+                    e->msg);
+            break;
         case TI_QUERY_WITH_FUTURE:
         case TI_QUERY_WITH_TASK:
         case TI_QUERY_WITH_TASK_FINISH:
@@ -1260,6 +1608,9 @@ void ti_query_send_response(ti_query_t * query, ex_t * e)
     }
 
     duration = ti_counters_upd_success_query(&query->time);
+    if (query->collection)
+        ti_collection_upd_hist(query->collection, duration);
+
     if (warn && duration > warn)
     {
         double derror = ti.cfg->query_duration_error;
@@ -30,9 +30,18 @@ ti_quorum_t * ti_quorum_new(ti_quorum_cb cb, void * data)
     quorum->data = data;
     quorum->cb_ = cb;
 
+    (void) clock_gettime(TI_CLOCK_MONOTONIC, &quorum->start);
+
     return quorum;
 }
 
+static void quorum__cb(ti_quorum_t * quorum, _Bool accepted)
+{
+    (void) ti_counters_upd_hist(&ti.counters->hist_quorum, &quorum->start);
+    quorum->cb_(quorum->data, accepted);
+    quorum->cb_ = NULL;
+}
+
 void ti_quorum_go(ti_quorum_t * quorum)
 {
     uint8_t n = quorum->accepted + quorum->rejected + quorum->collisions;
@@ -41,13 +50,11 @@ void ti_quorum_go(ti_quorum_t * quorum)
     {
         if (quorum->requests < quorum->quorum)
         {
-            quorum->cb_(quorum->data, false);
-            quorum->cb_ = NULL;
+            quorum__cb(quorum, false);
         }
         else if (quorum->accepted == quorum->accept_threshold)
         {
-            quorum->cb_(quorum->data, true);
-            quorum->cb_ = NULL;
+            quorum__cb(quorum, true);
         }
         else if (
                 /* With an even number of requests, for example with 3 nodes
@@ -59,8 +66,7 @@ void ti_quorum_go(ti_quorum_t * quorum)
                 quorum->rejected + (quorum->requests & 1) >
                 quorum->accept_threshold)
         {
-            quorum->cb_(quorum->data, false);
-            quorum->cb_ = NULL;
+            quorum__cb(quorum, false);
         }
     }
 
@@ -68,8 +74,8 @@ void ti_quorum_go(ti_quorum_t * quorum)
         return;
 
     if (quorum->cb_)
-        quorum->cb_(
-            quorum->data,
+        quorum__cb(
+            quorum,
             quorum->diff_requests < 0
             ? false
             : quorum->collisions > quorum->diff_requests &&
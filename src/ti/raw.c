@@ -15,6 +15,16 @@
 #include <util/logger.h>
 #include <util/strx.h>
 
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#define raw__alloc_sz malloc_size
+#else
+#include <malloc.h>
+#define raw__alloc_sz malloc_usable_size
+#endif
+
+#define RAW__APPEND_MIN_SZ 64
+
 static const int base64__idx[256] = {
         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 0,  0,  0,  0,  0,  0,
         0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 0,  0,  0,  0,
@@ -491,6 +501,45 @@ ti_raw_t * ti_raw_cat(const ti_raw_t * a, const ti_raw_t * b)
     return r;
 }
 
+/*
+ * Append data to a string or bytes value which is not referenced elsewhere;
+ * thus the reference count must be one and the value must not be a name.
+ * The allocation grows geometrically, so repeated appending takes amortized
+ * linear time. The value might be moved so `raw` is updated and `s` must not
+ * point to data inside the value. Returns 0 on success.
+ */
+int ti_raw_append(ti_raw_t ** raw, const void * s, size_t n)
+{
+    ti_raw_t * r = *raw;
+    size_t nn = (size_t) r->n + n;
+    size_t sz = sizeof(ti_raw_t) + nn;
+
+    assert(r->ref == 1);
+    assert(r->tp == TI_VAL_STR || r->tp == TI_VAL_BYTES);
+
+    if (nn > UINT32_MAX)
+        return -1;
+
+    if (sz > raw__alloc_sz(r))
+    {
+        size_t cap = sizeof(ti_raw_t) + ((size_t) r->n << 1);
+        if (cap < sz)
+            cap = sz;
+        if (cap < RAW__APPEND_MIN_SZ)
+            cap = RAW__APPEND_MIN_SZ;
+
+        r = realloc(r, cap);
+        if (!r)
+            return -1;
+
+        *raw = r;
+    }
+
+    memcpy(r->data + r->n, s, n);
+    r->n = nn;
+    return 0;
+}
+
 ti_raw_t * ti_raw_cat_strn(const ti_raw_t * a, const char * s, size_t n)
 {
     size_t nn = a->n + n;
@@ -0,0 +1,255 @@
+/*
+ * ti/rcache.c
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <ti.h>
+#include <ti/counters.h>
+#include <ti/flags.h>
+#include <ti/query.h>
+#include <ti/rcache.h>
+#include <ti/user.h>
+#include <util/ptrmap.h>
+#include <util/util.h>
+
+/*
+ * Results larger than a 1/16th of the cache size are never cached, as a few
+ * of such results would otherwise push all other results out of the cache.
+ */
+#define RCACHE__MAX_ITEM_DIV 16
+
+/* user id (8), deep (1) and flags (1) are packed before the arguments */
+#define RCACHE__KEY_HEADER 10
+
+static struct
+{
+    ptrmap_t * items;               /* (procedure, hash) -> ti_rcache_item_t */
+    ti_rcache_item_t * head;        /* most recently used */
+    ti_rcache_item_t * tail;        /* least recently used */
+    size_t size;                    /* total size of the items */
+} rcache;
+
+static inline size_t rcache__item_size(ti_rcache_item_t * item)
+{
+    return sizeof(ti_rcache_item_t) + item->key_n + item->n;
+}
+
+/*
+ * The hash is used as the second key pointer; items with the same procedure
+ * and hash but with other key data simply replace each other.
+ */
+static inline const void * rcache__hash_ptr(uint64_t hash)
+{
+    return (const void *) (uintptr_t) hash;
+}
+
+/* FNV-1a */
+static uint64_t rcache__hash(const unsigned char * data, size_t n)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    while (n--)
+    {
+        hash ^= *data++;
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+static inline void rcache__unlink(ti_rcache_item_t * item)
+{
+    if (item->prev)
+        item->prev->next = item->next;
+    else
+        rcache.head = item->next;
+
+    if (item->next)
+        item->next->prev = item->prev;
+    else
+        rcache.tail = item->prev;
+}
+
+static inline void rcache__push(ti_rcache_item_t * item)
+{
+    item->prev = NULL;
+    item->next = rcache.head;
+    if (rcache.head)
+        rcache.head->prev = item;
+    else
+        rcache.tail = item;
+    rcache.head = item;
+}
+
+static void rcache__remove(ti_rcache_item_t * item)
+{
+    (void) ptrmap_pop(
+            rcache.items,
+            item->procedure,
+            rcache__hash_ptr(item->hash));
+    rcache__unlink(item);
+    rcache.size -= rcache__item_size(item);
+    free(item);
+}
+
+static inline uint64_t rcache__change_id(ti_collection_t * collection)
+{
+    return collection ? collection->change_id : ti.node->ccid;
+}
+
+int ti_rcache_create(void)
+{
+    if (!ti.cfg->procedure_cache_size)
+        return 0;  /* the cache is disabled */
+
+    rcache.items = ptrmap_create();
+    return -(!rcache.items);
+}
+
+void ti_rcache_destroy(void)
+{
+    while (rcache.head)
+        rcache__remove(rcache.head);
+
+    ptrmap_destroy(rcache.items);
+    rcache.items = NULL;
+}
+
+/*
+ * Returns a key when the result of the procedure may be cached, NULL if not
+ * (or when allocation has failed, in which case the procedure simply runs
+ * without the cache). The arguments must be the packed `run` arguments.
+ */
+ti_rcache_key_t * ti_rcache_key_create(
+        ti_query_t * query,
+        ti_procedure_t * procedure,
+        const void * args,
+        size_t n)
+{
+    ti_rcache_key_t * key;
+    size_t key_n = RCACHE__KEY_HEADER + n;
+
+    if (!rcache.items ||
+        !procedure->cache_ttl ||
+        (procedure->closure->flags & TI_CLOSURE_FLAG_WSE))
+        return NULL;
+
+    key = malloc(sizeof(ti_rcache_key_t) + key_n);
+    if (!key)
+        return NULL;
+
+    memcpy(key->data, &query->user->id, sizeof(uint64_t));
+    key->data[8] = query->qbind.deep;
+    key->data[9] = query->flags & TI_FLAGS_NO_IDS;
+    memcpy(key->data + RCACHE__KEY_HEADER, args, n);
+
+    key->procedure = procedure;
+    key->item = NULL;
+    key->hash = rcache__hash(key->data, key_n);
+    key->change_id = rcache__change_id(query->collection);
+    key->n = key_n;
+    return key;
+}
+
+/*
+ * Returns `true` if a valid result is found in the cache. In this case, the
+ * result must be written using ti_rcache_write() before anything else may
+ * change the cache.
+ */
+_Bool ti_rcache_hit(ti_rcache_key_t * key)
+{
+    ti_rcache_item_t * item = ptrmap_get(
+            rcache.items,
+            key->procedure,
+            rcache__hash_ptr(key->hash));
+
+    if (!item ||
+        item->change_id != key->change_id ||
+        item->expire_at <= util_now_usec() ||
+        item->key_n != key->n ||
+        memcmp(item->data, key->data, key->n))
+    {
+        ++ti.counters->procedure_cache_misses;
+        return false;
+    }
+
+    ++ti.counters->procedure_cache_hits;
+
+    if (item != rcache.head)
+    {
+        rcache__unlink(item);
+        rcache__push(item);
+    }
+
+    key->item = item;
+    return true;
+}
+
+int ti_rcache_write(ti_rcache_key_t * key, msgpack_sbuffer * buffer)
+{
+    ti_rcache_item_t * item = key->item;
+    return msgpack_sbuffer_write(
+            buffer,
+            (const char *) item->data + item->key_n,
+            item->n);
+}
+
+/*
+ * Store the packed result for a key. Failures are ignored as the procedure
+ * will simply run again on the next request.
+ */
+void ti_rcache_set(ti_rcache_key_t * key, const char * data, size_t n)
+{
+    ti_procedure_t * procedure = key->procedure;
+    ti_rcache_item_t * item;
+    size_t cache_size = ti.cfg->procedure_cache_size;
+    size_t size = sizeof(ti_rcache_item_t) + key->n + n;
+    const void * hash_ptr = rcache__hash_ptr(key->hash);
+
+    if (size > cache_size / RCACHE__MAX_ITEM_DIV)
+        return;
+
+    item = ptrmap_get(rcache.items, procedure, hash_ptr);
+    if (item)
+        rcache__remove(item);
+
+    item = malloc(size);
+    if (!item)
+        return;
+
+    if (ptrmap_set(rcache.items, procedure, hash_ptr, item))
+    {
+        free(item);
+        return;
+    }
+
+    item->procedure = procedure;
+    item->hash = key->hash;
+    item->change_id = key->change_id;
+    item->expire_at = util_now_usec() + procedure->cache_ttl;
+    item->key_n = key->n;
+    item->n = n;
+    memcpy(item->data, key->data, key->n);
+    memcpy(item->data + key->n, data, n);
+
+    rcache.size += size;
+    rcache__push(item);
+
+    while (rcache.size > cache_size)
+        rcache__remove(rcache.tail);
+}
+
+void ti_rcache__drop_procedure(ti_procedure_t * procedure)
+{
+    ti_rcache_item_t * item = rcache.head, * next;
+
+    for (; item; item = next)
+    {
+        next = item->next;
+        if (item->procedure == procedure)
+            rcache__remove(item);
+    }
+}
+
+size_t ti_rcache_n(void)
+{
+    return rcache.items ? rcache.items->n : 0;
+}
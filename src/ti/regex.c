@@ -4,21 +4,183 @@
 #include <assert.h>
 #include <ctype.h>
 #include <stdlib.h>
+#include <ti.h>
+#include <ti/counters.h>
 #include <ti/raw.inline.h>
 #include <ti/regex.h>
 #include <ti/val.h>
 #include <ti/val.inline.h>
 #include <util/logger.h>
+#include <util/smap.h>
+#include <util/vec.h>
+
+/*
+ * Compiled regular expressions are shared by pattern (including the flags).
+ * A regular expression is immutable, so values created from the same pattern
+ * can safely point to the same compiled code. When the cache is full, only
+ * entries which are not in use by any other value are removed.
+ */
+#define REGEX__CACHE_SZ 1024
+
+/* Initial size of the JIT stack, it grows up to `regex_jit_stack_size` */
+#define REGEX__JIT_STACK_START 32768
+
+static smap_t * regex__cache;
+static pcre2_jit_stack * regex__jit_stack;
+static pcre2_match_context * regex__mcontext;
+
+int ti_regex_init(void)
+{
+    uint32_t has_jit = 0;
+    size_t max_sz = ti.cfg->regex_jit_stack_size;
+
+    regex__cache = smap_create();
+    if (!regex__cache)
+        return -1;
+
+    if (!max_sz)
+    {
+        log_info("JIT compilation for regular expressions is disabled");
+        return 0;
+    }
+
+    if (pcre2_config(PCRE2_CONFIG_JIT, &has_jit) < 0 || !has_jit)
+    {
+        log_warning("JIT compilation is not supported by libpcre2");
+        return 0;
+    }
+
+    regex__mcontext = pcre2_match_context_create(NULL);
+    regex__jit_stack = pcre2_jit_stack_create(
+            max_sz < REGEX__JIT_STACK_START ? max_sz : REGEX__JIT_STACK_START,
+            max_sz,
+            NULL);
+
+    if (!regex__mcontext || !regex__jit_stack)
+    {
+        ti_regex_drop_common();
+        return -1;
+    }
+
+    pcre2_jit_stack_assign(regex__mcontext, NULL, regex__jit_stack);
+    return 0;
+}
+
+void ti_regex_drop_common(void)
+{
+    smap_destroy(regex__cache, (smap_destroy_cb) ti_val_unsafe_drop);
+    pcre2_match_context_free(regex__mcontext);
+    pcre2_jit_stack_free(regex__jit_stack);
+
+    regex__cache = NULL;
+    regex__mcontext = NULL;
+    regex__jit_stack = NULL;
+}
+
+size_t ti_regex_cache_n(void)
+{
+    return regex__cache ? regex__cache->n : 0;
+}
+
+_Bool ti_regex_has_jit(void)
+{
+    return regex__mcontext != NULL;
+}
+
+static int regex__unused_cb(ti_regex_t * regex, vec_t ** vec)
+{
+    return regex->ref == 1 && vec_push(vec, regex);
+}
+
+static void regex__cache_cleanup(void)
+{
+    vec_t * vec = vec_new(regex__cache->n);
+    if (!vec)
+        return;
+
+    (void) smap_values(regex__cache, (smap_val_cb) regex__unused_cb, &vec);
+
+    for (vec_each(vec, ti_regex_t, regex))
+    {
+        (void) smap_popn(
+                regex__cache,
+                (const char *) regex->pattern->data,
+                regex->pattern->n);
+        ti_regex_destroy(regex);
+    }
+
+    free(vec);
+}
+
+static void regex__cache_add(ti_regex_t * regex)
+{
+    if (!regex__cache)
+        return;
+
+    if (regex__cache->n >= REGEX__CACHE_SZ)
+    {
+        regex__cache_cleanup();
+        if (regex__cache->n >= REGEX__CACHE_SZ)
+            return;
+    }
+
+    if (smap_addn(
+            regex__cache,
+            (const char *) regex->pattern->data,
+            regex->pattern->n,
+            regex) == 0)
+        ti_incref(regex);
+}
+
+/*
+ * Run a match using the regular expression `match_data`. The JIT fast path is
+ * used when the pattern is JIT compiled; this skips the sanity checks which
+ * are not required since ThingsDB does not use match options and patterns in
+ * UTF mode are never JIT compiled.
+ */
+int ti_regex_match(ti_regex_t * regex, ti_raw_t * raw, PCRE2_SIZE pos)
+{
+    if (regex->flags & TI_REGEX_FLAG_JIT)
+    {
+        ++ti.counters->regex_jit_matches;
+        return pcre2_jit_match(
+                regex->code,
+                (PCRE2_SPTR8) raw->data,
+                raw->n,
+                pos,                    /* start looking at this point */
+                0,                      /* OPTIONS */
+                regex->match_data,
+                regex__mcontext);
+    }
+    return pcre2_match(
+            regex->code,
+            (PCRE2_SPTR8) raw->data,
+            raw->n,
+            pos,                        /* start looking at this point */
+            0,                          /* OPTIONS */
+            regex->match_data,
+            NULL);
+}
 
 static ti_regex_t * regex_create(ti_raw_t * re, ex_t * e)
 {
     ti_regex_t * regex;
     size_t n = re->n;
     int options = 0;
+    uint32_t all_options;
     int pcre_error_num;
     char * str = (char *) re->data;
     PCRE2_SIZE pcre_error_offset;
 
+    if (regex__cache &&
+        (regex = smap_getn(regex__cache, str, n)))
+    {
+        ++ti.counters->regex_cache_hits;
+        ti_incref(regex);
+        ti_val_unsafe_drop((ti_val_t *) re);
+        return regex;
+    }
+
     regex = malloc(sizeof(ti_regex_t));
     if (!regex)
     {
@@ -93,6 +255,19 @@ static ti_regex_t * regex_create(ti_raw_t * re, ex_t * e)
         goto fail1;
     }
 
+    /* a pattern may enable UTF mode using `(*UTF)`; the JIT fast path does
+     * not check the subject for valid UTF thus such patterns must use the
+     * normal match function */
+    if (regex__mcontext &&
+        pcre2_pattern_info(
+            regex->code,
+            PCRE2_INFO_ALLOPTIONS,
+            &all_options) == 0 &&
+        (all_options & PCRE2_UTF) == 0 &&
+        pcre2_jit_compile(regex->code, PCRE2_JIT_COMPLETE) == 0)
+        regex->flags |= TI_REGEX_FLAG_JIT;
+
+    regex__cache_add(regex);
     return regex;
 
 fail1:
@@ -182,6 +182,9 @@ static void restore__cb(void)
     /* make sure we forget nodes info */
     ti.args->forget_nodes = 1;
 
+    /* incremental backups must continue with a new snapshot */
+    ti_backups_new_chains();
+
     /* write global status (write zero status) */
     (void) ti_nodes_write_global_status();
 }
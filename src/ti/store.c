@@ -46,9 +46,19 @@ static const char * store__modules_fn           = "modules.mp";
 static ti_store_t * store;
 static ti_store_t store_;
 
-static int store__thing_drop(ti_thing_t * thing, void * UNUSED(arg))
+static int store__thing_drop(ti_thing_t * thing, ti_collection_t * collection)
 {
     assert(thing->ref > 1);
+
+    /* the flag is not stored; while a streaming import is unfinished, all
+     * things (except the root) keep the reference like they had when they
+     * were created by the import */
+    if (collection->import_id && thing != collection->root)
+    {
+        thing->flags |= TI_THING_FLAG_IMPORT;
+        return 0;
+    }
+
     --thing->ref;
     return 0;
 }
@@ -193,8 +203,11 @@ void ti_store_destroy(void)
 int ti_store_store(void)
 {
     int rc = 0;
+    struct timespec start;
     assert(store);
 
+    (void) clock_gettime(TI_CLOCK_MONOTONIC, &start);
+
     /* not need for checking on errors */
     (void) fx_rmdir(store->prev_path);
     if (mkdir(store->tmp_path, FX_DEFAULT_DIR_ACCESS))
@@ -308,6 +321,7 @@ int ti_store_store(void)
 
     rc = store__collection_ids();  /* can only fail with mem allow error */
 
+    (void) ti_counters_upd_hist(&ti.counters->hist_store, &start);
     goto done;
 
 failed:
@@ -457,7 +471,7 @@ int ti_store_restore(void)
         (void) imap_walk(
                 collection->things,
                 (imap_cb) store__thing_drop,
-                NULL);
+                collection);
         /*
          * The things in the garbage collection must keep a reference,
          * therefore the garbage collection must not be walked.
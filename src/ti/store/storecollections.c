@@ -34,13 +34,14 @@ int ti_store_collections_store(const char * fn)
     for (vec_each(vec, ti_collection_t, collection))
     {
         if (
-            msgpack_pack_array(&pk, 6) ||
+            msgpack_pack_array(&pk, 7) ||
             mp_pack_strn(&pk, collection->guid.guid, sizeof(guid_t)) ||
             mp_pack_strn(&pk, collection->name->data, collection->name->n) ||
             msgpack_pack_uint64(&pk, collection->created_at) ||
             msgpack_pack_uint64(&pk, collection->id) ||
             msgpack_pack_uint64(&pk, collection->tz->index) ||
-            msgpack_pack_uint8(&pk, collection->deep)
+            msgpack_pack_uint8(&pk, collection->deep) ||
+            msgpack_pack_uint64(&pk, collection->import_id)
         ) goto fail;
     }
 
@@ -65,6 +66,7 @@ int ti_store_collections_restore(const char * fn)
     size_t i;
     ssize_t n;
     mp_obj_t obj, mp_guid, mp_name, mp_created, mp_deep, mp_tz, mp_id;
+    mp_obj_t mp_import_id;
     mp_unp_t up;
     guid_t guid;
     ti_collection_t * collection;
@@ -99,13 +101,17 @@ int ti_store_collections_restore(const char * fn)
         if (guid.guid[sizeof(guid_t) - 1])
             goto fail;
 
+        mp_import_id.via.u64 = 0;
+
         switch(obj.via.sz)
         {
+        case 7:
         case 6:
             if (mp_next(&up, &mp_id) != MP_U64 ||
                 mp_next(&up, &mp_tz) != MP_U64 ||
                 mp_next(&up, &mp_deep) != MP_U64 ||
-                mp_deep.via.u64 > TI_MAX_DEEP)
+                mp_deep.via.u64 > TI_MAX_DEEP ||
+                (obj.via.sz == 7 && mp_next(&up, &mp_import_id) != MP_U64))
                 goto fail;
             tz = ti_tz_from_index(mp_tz.via.u64);
             break;
@@ -160,6 +166,8 @@ int ti_store_collections_restore(const char * fn)
         if (!collection || vec_push(&ti.collections->vec, collection))
             goto fail;  /* might leak a few bytes for the time zone */
 
+        collection->import_id = mp_import_id.via.u64;
+
     }
     goto done;
 
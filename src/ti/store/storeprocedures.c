@@ -15,10 +15,11 @@
 static int procedure__store_cb(ti_procedure_t * procedure, msgpack_packer * pk)
 {
     return -(
-        msgpack_pack_array(pk, 3) ||
+        msgpack_pack_array(pk, 4) ||
         mp_pack_strn(pk, procedure->name->str, procedure->name->n) ||
         msgpack_pack_uint64(pk, procedure->created_at) ||
-        ti_closure_to_store_pk(procedure->closure, pk)
+        ti_closure_to_store_pk(procedure->closure, pk) ||
+        msgpack_pack_uint32(pk, procedure->cache_ttl)
     );
 }
 
@@ -64,8 +65,8 @@ int ti_store_procedures_restore(
 {
     int rc = -1;
     fx_mmap_t fmap;
-    size_t i;
-    mp_obj_t obj, mp_ver, mp_name, mp_created;
+    size_t i, sz;
+    mp_obj_t obj, mp_ver, mp_name, mp_created, mp_ttl;
     mp_unp_t up;
     ti_closure_t * closure;
     ti_procedure_t * procedure;
@@ -93,11 +94,14 @@ int ti_store_procedures_restore(
     for (i = obj.via.sz; i--;)
     {
         if (
-            mp_next(&up, &obj) != MP_ARR || obj.via.sz != 3 ||
+            /* the cache TTL (4th value) is not stored by older versions */
+            mp_next(&up, &obj) != MP_ARR ||
+            (obj.via.sz != 3 && obj.via.sz != 4) ||
             mp_next(&up, &mp_name) != MP_STR ||
             mp_next(&up, &mp_created) != MP_U64
         ) goto fail1;
 
+        sz = obj.via.sz;
         closure = (ti_closure_t *) ti_val_from_vup(&vup);
         procedure = NULL;
 
@@ -112,6 +116,13 @@ int ti_store_procedures_restore(
             goto fail2;
 
         ti_decref(closure);
+
+        if (sz == 4)
+        {
+            if (mp_next(&up, &mp_ttl) != MP_U64)
+                goto fail1;
+            procedure->cache_ttl = (uint32_t) mp_ttl.via.u64;
+        }
     }
 
     rc = 0;
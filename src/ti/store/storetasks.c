@@ -161,7 +161,7 @@ int ti_store_tasks_restore(
 
         /* push the task to the list, use ti_tasks_append() to re-schedule
          * at startup, bug #248 */
-        (void) ti_tasks_append(vtasks, vtask);
+        (void) ti_tasks_append(vtasks, vtask, collection);
     }
 
     up.pt = keep;
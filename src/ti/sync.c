@@ -7,6 +7,7 @@
 #include <ti/proto.h>
 #include <ti/req.h>
 #include <ti/sync.h>
+#include <ti/syncfull.h>
 #include <util/mpack.h>
 
 /*
@@ -155,6 +156,9 @@ static void sync__find_away_node_cb(uv_timer_t * UNUSED(repeat))
 
     msgpack_pack_uint64(&pk, ti.node->ccid + 1);
 
+    /* older nodes only read the change id and ignore the protocol version */
+    msgpack_pack_uint8(&pk, TI_SYNCFULL_PROTO_DELTA);
+
     pkg = (ti_pkg_t *) buffer.data;
     pkg_init(pkg, 0, TI_PROTO_NODE_REQ_SYNC, buffer.size);
 
@@ -6,7 +6,10 @@
 #include <ti.h>
 
 
-ti_syncer_t * ti_syncer_create(ti_stream_t * stream, uint64_t first)
+ti_syncer_t * ti_syncer_create(
+        ti_stream_t * stream,
+        uint64_t first,
+        uint8_t proto)
 {
     ti_syncer_t * syncer = malloc(sizeof(ti_syncer_t));
     if (!syncer)
@@ -14,6 +17,7 @@ ti_syncer_t * ti_syncer_create(ti_stream_t * stream, uint64_t first)
 
     syncer->stream = stream;
     syncer->first = first;
+    syncer->proto = proto;
 
     return syncer;
 }
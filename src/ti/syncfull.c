@@ -303,9 +303,12 @@ done:
     ti_req_destroy(req);
 }
 
-int ti_syncfull_start(ti_stream_t * stream)
+static int syncfull__start_parts(
+        ti_stream_t * stream,
+        uint64_t scope_id,
+        syncfull__file_t ft)
 {
-    ti_pkg_t * pkg = syncfull__pkg(0, SYNCFULL__USERS_FILE, 0);
+    ti_pkg_t * pkg = syncfull__pkg(scope_id, ft, 0);
     if (!pkg)
         return -1;
 
@@ -322,6 +325,549 @@ int ti_syncfull_start(ti_stream_t * stream)
     return 0;
 }
 
+/*
+ * Delta synchronization compares digests before sending data. For each
+ * collection, a single digest over all collection files is compared first so
+ * unchanged collections are skipped at once. For other files, a digest per
+ * part is compared and only the parts which are different are sent.
+ *
+ * Parts are written at an offset on the other node so they do not need to
+ * arrive in order. Up to SYNCFULL__WINDOW parts are sent without waiting for
+ * a response, and the digests for the next file are requested while parts of
+ * the previous file are still in flight.
+ */
+#define SYNCFULL__WINDOW 8
+
+typedef struct
+{
+    uint64_t scope_id;
+    syncfull__file_t ft;        /* SYNCFULL__COLLECTION_END for a collection
+                                   digest */
+    off_t offset;               /* next offset to compare */
+    off_t fsize;                /* file size on the other node, -1 when the
+                                   file does not exist */
+    size_t n;                   /* number of digests from the other node */
+    unsigned char * digests;    /* digests from the other node */
+    size_t in_flight;           /* number of requests without response */
+    _Bool wait_digest;          /* waiting for a digest response */
+    _Bool finished;             /* all files are sent */
+    _Bool failed;               /* stop sending and wait for all responses */
+    _Bool compress;             /* compress parts before sending */
+} syncfull__delta_t;
+
+static ti_syncfull_stats_t syncfull__stats;
+
+static void syncfull__delta_cb(ti_req_t * req, ex_enum status);
+static void syncfull__delta_digest_cb(ti_req_t * req, ex_enum status);
+
+static void syncfull__delta_destroy(syncfull__delta_t * delta)
+{
+    if (!delta)
+        return;
+    free(delta->digests);
+    free(delta);
+}
+
+/*
+ * The collection digest is a digest over the size and part digests of all
+ * the collection files.
+ */
+static int syncfull__collection_digest(uint64_t scope_id, unsigned char * dst)
+{
+    off_t fsize = 0;
+    size_t pos;
+    buf_t buf;
+    buf_init(&buf);
+
+    for (syncfull__file_t ft = SYNCFULL__COLLECTION_DAT_FILE;
+         ft < SYNCFULL__COLLECTION_END;
+         ++ft)
+    {
+        char * fn = syncfull__get_fn(scope_id, ft);
+
+        pos = buf.len;  /* position of the file size */
+
+        if (!fn ||
+            buf_append(&buf, (const char *) &fsize, sizeof(off_t)) ||
+            syncpart_digests(fn, &fsize, &buf))
+        {
+            free(fn);
+            free(buf.data);
+            return -1;
+        }
+
+        memcpy(buf.data + pos, &fsize, sizeof(off_t));
+        free(fn);
+    }
+
+    syncpart_digest((const unsigned char *) buf.data, buf.len, dst);
+    free(buf.data);
+    return 0;
+}
+
+static int syncfull__delta_req_digest(
+        ti_stream_t * stream,
+        syncfull__delta_t * delta)
+{
+    ti_pkg_t * pkg;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+
+    if (mp_sbuffer_alloc_init(&buffer, 32, sizeof(ti_pkg_t)))
+        return -1;
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    msgpack_pack_array(&pk, 2);
+    msgpack_pack_uint64(&pk, delta->scope_id);
+    msgpack_pack_uint8(&pk, delta->ft);
+
+    pkg = (ti_pkg_t *) buffer.data;
+    pkg_init(pkg, 0, TI_PROTO_NODE_REQ_SYNCFDIGEST, buffer.size);
+
+    if (ti_req_create(
+            stream,
+            pkg,
+            TI_PROTO_NODE_REQ_SYNCFDIGEST_TIMEOUT,
+            syncfull__delta_digest_cb,
+            delta))
+    {
+        free(pkg);
+        return -1;
+    }
+
+    delta->wait_digest = true;
+    ++delta->in_flight;
+    return 0;
+}
+
+static int syncfull__delta_req_part(
+        ti_stream_t * stream,
+        syncfull__delta_t * delta,
+        unsigned char * data,
+        size_t n,
+        unsigned char * cbuf,
+        off_t fsize)
+{
+    size_t cn = (delta->compress && n)
+            ? syncpart_compress(data, n, cbuf, SYNCPART_SIZE)
+            : 0;
+    ti_pkg_t * pkg;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+
+    if (mp_sbuffer_alloc_init(&buffer, 64 + n, sizeof(ti_pkg_t)))
+    {
+        log_critical(EX_MEMORY_S);
+        return -1;
+    }
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    msgpack_pack_array(&pk, 6);
+    msgpack_pack_uint64(&pk, delta->scope_id);
+    msgpack_pack_uint8(&pk, delta->ft);
+    msgpack_pack_fix_int64(&pk, delta->offset);
+    if (cn)
+        mp_pack_bin(&pk, cbuf, cn);
+    else
+        mp_pack_bin(&pk, data, n);
+    msgpack_pack_fix_int64(&pk, fsize);
+    msgpack_pack_uint64(&pk, cn ? n : 0);  /* size before compression */
+
+    pkg = (ti_pkg_t *) buffer.data;
+    pkg_init(pkg, 0, TI_PROTO_NODE_REQ_SYNCFDPART, buffer.size);
+
+    if (ti_req_create(
+            stream,
+            pkg,
+            TI_PROTO_NODE_REQ_SYNCFDPART_TIMEOUT,
+            syncfull__delta_cb,
+            delta))
+    {
+        free(pkg);
+        return -1;
+    }
+
+    /* the file on the other node will be of size `fsize` */
+    delta->fsize = fsize;
+    delta->offset += n;
+    ++delta->in_flight;
+    ++syncfull__stats.parts_in_flight;
+    syncfull__stats.bytes_sent += cn ? cn : n;
+    return 0;
+}
+
+/*
+ * Send parts of the current file until the window is full. Returns 1 if the
+ * window is full, 0 if the file is complete or -1 on error.
+ */
+static int syncfull__delta_send_parts(
+        ti_stream_t * stream,
+        syncfull__delta_t * delta)
+{
+    int rc = -1;
+    size_t n;
+    off_t fsize;
+    unsigned char digest[SYNCPART_DIGEST_SIZE];
+    unsigned char * buff = NULL, * cbuf = NULL;
+    char * fn = syncfull__get_fn(delta->scope_id, delta->ft);
+    FILE * fp = fn ? fopen(fn, "r") : NULL;
+
+    if (!fp)
+    {
+        log_errno_file("cannot open file", errno, fn ? fn : "?");
+        goto fail0;
+    }
+
+    if (fseeko(fp, 0, SEEK_END) == -1 || (fsize = ftello(fp)) == -1 ||
+        fseeko(fp, delta->offset, SEEK_SET) == -1)
+    {
+        log_errno_file("error seeking file", errno, fn);
+        goto fail1;
+    }
+
+    buff = malloc(SYNCPART_SIZE);
+    cbuf = delta->compress ? malloc(SYNCPART_SIZE) : NULL;
+    if (!buff || (delta->compress && !cbuf))
+    {
+        log_critical(EX_MEMORY_S);
+        goto fail1;
+    }
+
+    while (delta->offset < fsize)
+    {
+        size_t i = (size_t) (delta->offset / SYNCPART_SIZE);
+
+        if (delta->in_flight >= SYNCFULL__WINDOW)
+        {
+            rc = 1;
+            goto fail1;
+        }
+
+        n = fread(buff, sizeof(char), SYNCPART_SIZE, fp);
+        if (!n)
+        {
+            log_critical("cannot read from file `%s`", fn);
+            goto fail1;
+        }
+
+        syncfull__stats.bytes_compared += n;
+
+        if (i < delta->n)
+        {
+            syncpart_digest(buff, n, digest);
+            if (memcmp(
+                    digest,
+                    delta->digests + i * SYNCPART_DIGEST_SIZE,
+                    SYNCPART_DIGEST_SIZE) == 0)
+            {
+                delta->offset += n;
+                continue;
+            }
+        }
+
+        if (syncfull__delta_req_part(stream, delta, buff, n, cbuf, fsize))
+            goto fail1;
+    }
+
+    if (delta->fsize != fsize)
+    {
+        if (delta->in_flight >= SYNCFULL__WINDOW)
+        {
+            rc = 1;
+            goto fail1;
+        }
+        /* only the file size is different */
+        if (syncfull__delta_req_part(stream, delta, buff, 0, cbuf, fsize))
+            goto fail1;
+    }
+
+    rc = 0;  /* file is complete */
+
+fail1:
+    free(buff);
+    free(cbuf);
+    (void) fclose(fp);
+fail0:
+    free(fn);
+    return rc;
+}
+
+static int syncfull__delta_done(
+        ti_stream_t * stream,
+        syncfull__delta_t * delta)
+{
+    ti_pkg_t * pkg;
+
+    log_info(
+            "delta synchronization for `%s` has sent %zu bytes "
+            "(%zu bytes compared)",
+            ti_stream_name(stream),
+            syncfull__stats.bytes_sent,
+            syncfull__stats.bytes_compared);
+
+    pkg = ti_pkg_new(0, TI_PROTO_NODE_REQ_SYNCFDONE, NULL, 0);
+    if (!pkg)
+        return -1;
+
+    if (ti_req_create(
+            stream,
+            pkg,
+            TI_PROTO_NODE_REQ_SYNCFDONE_TIMEOUT,
+            syncfull__done_cb,
+            NULL))
+    {
+        free(pkg);
+        return -1;
+    }
+
+    syncfull__delta_destroy(delta);
+    return 0;
+}
+
+/*
+ * Fill the window with parts and digest requests. When all files are sent
+ * and all responses are received, the synchronization is finished and
+ * `delta` is destroyed.
+ */
+static int syncfull__delta_next_file(
+        ti_stream_t * stream,
+        syncfull__delta_t * delta)
+{
+    if (!syncfull__next_file(&delta->scope_id, &delta->ft))
+    {
+        delta->finished = true;
+        return 0;
+    }
+
+    if (delta->ft == SYNCFULL__COLLECTION_DAT_FILE)
+        delta->ft = SYNCFULL__COLLECTION_END;  /* collection digest first */
+
+    return syncfull__delta_req_digest(stream, delta);
+}
+
+static int syncfull__delta_pump(
+        ti_stream_t * stream,
+        syncfull__delta_t * delta)
+{
+    while (!delta->wait_digest && !delta->finished)
+    {
+        int rc = syncfull__delta_send_parts(stream, delta);
+        if (rc)
+            return rc < 0 ? rc : 0;
+
+        if (syncfull__delta_next_file(stream, delta))
+            return -1;
+    }
+
+    return delta->finished && !delta->in_flight
+            ? syncfull__delta_done(stream, delta)
+            : 0;
+}
+
+/*
+ * Stop the synchronization; `delta` is destroyed once all requests which are
+ * still in flight have returned.
+ */
+static void syncfull__delta_fail(
+        ti_stream_t * stream,
+        syncfull__delta_t * delta)
+{
+    if (!delta->failed)
+    {
+        delta->failed = true;
+        ti_stream_stop_listeners(stream);
+    }
+    if (!delta->in_flight)
+        syncfull__delta_destroy(delta);
+}
+
+static void syncfull__delta_cb(ti_req_t * req, ex_enum status)
+{
+    syncfull__delta_t * delta = req->data;
+
+    --delta->in_flight;
+    --syncfull__stats.parts_in_flight;
+
+    if (delta->failed)
+        goto failed;
+
+    if (status)
+        goto failed;
+
+    if (!req->stream)
+    {
+        log_error("connection to stream lost while synchronizing");
+        goto failed;
+    }
+
+    if (req->pkg_res->tp != TI_PROTO_NODE_RES_SYNCFDPART)
+    {
+        ti_pkg_log(req->pkg_res);
+        goto failed;
+    }
+
+    if (syncfull__delta_pump(req->stream, delta) == 0)
+        goto done;
+
+failed:
+    syncfull__delta_fail(req->stream, delta);
+done:
+    ti_req_destroy(req);
+}
+
+static void syncfull__delta_digest_cb(ti_req_t * req, ex_enum status)
+{
+    mp_unp_t up;
+    ti_pkg_t * pkg = req->pkg_res;
+    mp_obj_t obj, mp_scope, mp_ft, mp_size, mp_digests;
+    syncfull__delta_t * delta = req->data;
+    unsigned char digest[SYNCPART_DIGEST_SIZE];
+
+    --delta->in_flight;
+    delta->wait_digest = false;
+
+    if (delta->failed)
+        goto failed;
+
+    if (!req->stream)
+    {
+        log_error("connection to stream lost while synchronizing");
+        goto failed;
+    }
+
+    if (status)
+        goto failed;
+
+    if (pkg->tp != TI_PROTO_NODE_RES_SYNCFDIGEST)
+    {
+        ti_pkg_log(pkg);
+        goto failed;
+    }
+
+    mp_unp_init(&up, pkg->data, pkg->n);
+
+    if (mp_next(&up, &obj) != MP_ARR || obj.via.sz < 3 ||
+        mp_next(&up, &mp_scope) != MP_U64 ||
+        mp_next(&up, &mp_ft) != MP_U64 ||
+        mp_scope.via.u64 != delta->scope_id ||
+        mp_ft.via.u64 != delta->ft)
+    {
+        log_error("invalid `%s`", ti_proto_str(pkg->tp));
+        goto failed;
+    }
+
+    if (delta->ft == SYNCFULL__COLLECTION_END)
+    {
+        if (mp_next(&up, &mp_digests) != MP_BIN ||
+            mp_digests.via.bin.n != SYNCPART_DIGEST_SIZE)
+        {
+            log_error("invalid `%s`", ti_proto_str(pkg->tp));
+            goto failed;
+        }
+
+        if (syncfull__collection_digest(delta->scope_id, digest))
+            goto failed;
+
+        if (memcmp(digest, mp_digests.via.bin.data, SYNCPART_DIGEST_SIZE))
+        {
+            delta->ft = SYNCFULL__COLLECTION_DAT_FILE;
+            if (syncfull__delta_req_digest(req->stream, delta))
+                goto failed;
+            goto done;
+        }
+
+        log_debug(
+                "skip synchronizing "TI_COLLECTION_ID" since it is equal on "
+                "both nodes",
+                delta->scope_id);
+
+        /* continue with the next collection, nothing to send */
+        delta->ft = SYNCFULL__COLLECTION_COMMITS_FILE;
+        delta->offset = 0;
+        delta->fsize = 0;
+        delta->n = 0;
+        if (syncfull__delta_next_file(req->stream, delta) == 0 &&
+            syncfull__delta_pump(req->stream, delta) == 0)
+            goto done;
+        goto failed;
+    }
+
+    if (mp_next(&up, &mp_size) != MP_I64 ||
+        mp_next(&up, &mp_digests) != MP_BIN ||
+        mp_digests.via.bin.n % SYNCPART_DIGEST_SIZE)
+    {
+        log_error("invalid `%s`", ti_proto_str(pkg->tp));
+        goto failed;
+    }
+
+    free(delta->digests);
+    delta->digests = NULL;
+    delta->n = mp_digests.via.bin.n / SYNCPART_DIGEST_SIZE;
+    delta->fsize = (off_t) mp_size.via.i64;
+    delta->offset = 0;
+
+    if (delta->n)
+    {
+        delta->digests = malloc(mp_digests.via.bin.n);
+        if (!delta->digests)
+        {
+            log_critical(EX_MEMORY_S);
+            goto failed;
+        }
+        memcpy(delta->digests, mp_digests.via.bin.data, mp_digests.via.bin.n);
+    }
+
+    if (syncfull__delta_pump(req->stream, delta) == 0)
+        goto done;
+
+failed:
+    syncfull__delta_fail(req->stream, delta);
+done:
+    ti_req_destroy(req);
+}
+
+/*
+ * Start a full synchronization. The digests are only compared when the other
+ * node supports the delta synchronization protocol, otherwise all store files
+ * are sent.
+ */
+int ti_syncfull_start(ti_stream_t * stream, uint8_t proto)
+{
+    syncfull__delta_t * delta;
+
+    if (proto < TI_SYNCFULL_PROTO_DELTA)
+    {
+        log_info(
+                "`%s` does not support delta synchronization; "
+                "all store files are sent",
+                ti_stream_name(stream));
+        return syncfull__start_parts(stream, 0, SYNCFULL__USERS_FILE);
+    }
+
+    delta = calloc(1, sizeof(syncfull__delta_t));
+    if (!delta)
+        return -1;
+
+    delta->scope_id = 0;
+    delta->ft = SYNCFULL__USERS_FILE;
+    delta->compress = ti.cfg->sync_compression;
+
+    syncfull__stats.bytes_compared = 0;
+    syncfull__stats.bytes_sent = 0;
+
+    if (syncfull__delta_req_digest(stream, delta))
+    {
+        syncfull__delta_destroy(delta);
+        return -1;
+    }
+    return 0;
+}
+
+const ti_syncfull_stats_t * ti_syncfull_stats(void)
+{
+    return &syncfull__stats;
+}
+
 ti_pkg_t * ti_syncfull_on_part(ti_pkg_t * pkg, ex_t * e)
 {
     int rc;
@@ -401,3 +947,205 @@ ti_pkg_t * ti_syncfull_on_part(ti_pkg_t * pkg, ex_t * e)
 }
 
 
+
+static void syncfull__ensure_collection_path(uint64_t scope_id)
+{
+    char * path = ti_store_collection_get_path(ti.store->store_path, scope_id);
+    if (!path)
+        return;
+
+    if (!fx_is_dir(path) && mkdir(path, FX_DEFAULT_DIR_ACCESS))
+        log_errno_file("cannot create directory", errno, path);
+
+    free(path);
+}
+
+ti_pkg_t * ti_syncfull_on_digest(ti_pkg_t * pkg, ex_t * e)
+{
+    mp_unp_t up;
+    ti_pkg_t * resp;
+    mp_obj_t obj, mp_scope, mp_ft;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+    syncfull__file_t ft;
+    uint64_t scope_id;
+    off_t fsize = -1;
+    buf_t buf;
+
+    mp_unp_init(&up, pkg->data, pkg->n);
+
+    if (mp_next(&up, &obj) != MP_ARR || obj.via.sz != 2 ||
+        mp_next(&up, &mp_scope) != MP_U64 ||
+        mp_next(&up, &mp_ft) != MP_U64 ||
+        mp_ft.via.u64 > SYNCFULL__COLLECTION_END)
+    {
+        ex_set(e, EX_BAD_DATA, "invalid digest request (full sync)");
+        return NULL;
+    }
+
+    scope_id = mp_scope.via.u64;
+    ft = (syncfull__file_t) mp_ft.via.u64;
+
+    if (ft >= SYNCFULL__COLLECTION_DAT_FILE)
+        syncfull__ensure_collection_path(scope_id);
+    else if (ft == SYNCFULL__USERS_FILE)
+        syncfull__stats.bytes_received = 0;  /* start of a synchronization */
+
+    buf_init(&buf);
+
+    if (ft == SYNCFULL__COLLECTION_END)
+    {
+        unsigned char digest[SYNCPART_DIGEST_SIZE];
+        if (syncfull__collection_digest(scope_id, digest) ||
+            buf_append(&buf, (const char *) digest, SYNCPART_DIGEST_SIZE))
+            goto failed;
+    }
+    else
+    {
+        char * fn = syncfull__get_fn(scope_id, ft);
+        if (!fn)
+        {
+            ex_set(e, EX_BAD_DATA,
+                    "invalid file type %d for "TI_COLLECTION_ID,
+                    ft, scope_id);
+            return NULL;
+        }
+
+        if (syncpart_digests(fn, &fsize, &buf))
+        {
+            free(fn);
+            goto failed;
+        }
+        free(fn);
+    }
+
+    if (mp_sbuffer_alloc_init(&buffer, 64 + buf.len, sizeof(ti_pkg_t)))
+        goto failed;
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    if (ft == SYNCFULL__COLLECTION_END)
+    {
+        msgpack_pack_array(&pk, 3);
+        msgpack_pack_uint64(&pk, scope_id);
+        msgpack_pack_uint64(&pk, ft);
+        mp_pack_bin(&pk, buf.data, buf.len);
+    }
+    else
+    {
+        msgpack_pack_array(&pk, 4);
+        msgpack_pack_uint64(&pk, scope_id);
+        msgpack_pack_uint64(&pk, ft);
+        msgpack_pack_fix_int64(&pk, fsize);
+        mp_pack_bin(&pk, buf.data, buf.len);
+    }
+
+    free(buf.data);
+
+    resp = (ti_pkg_t *) buffer.data;
+    pkg_init(resp, pkg->id, TI_PROTO_NODE_RES_SYNCFDIGEST, buffer.size);
+
+    return resp;
+
+failed:
+    free(buf.data);
+    ex_set(e, EX_INTERNAL, "failed to create digests for "TI_COLLECTION_ID,
+            scope_id);
+    return NULL;
+}
+
+ti_pkg_t * ti_syncfull_on_dpart(ti_pkg_t * pkg, ex_t * e)
+{
+    int rc;
+    mp_unp_t up;
+    ti_pkg_t * resp;
+    mp_obj_t obj, mp_scope, mp_ft, mp_offset, mp_bin, mp_size, mp_raw;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+    syncfull__file_t ft;
+    uint64_t scope_id;
+    const unsigned char * data;
+    unsigned char * raw = NULL;
+    size_t n;
+    char * fn;
+
+    mp_unp_init(&up, pkg->data, pkg->n);
+
+    if (mp_next(&up, &obj) != MP_ARR || obj.via.sz != 6 ||
+        mp_next(&up, &mp_scope) != MP_U64 ||
+        mp_next(&up, &mp_ft) != MP_U64 ||
+        mp_next(&up, &mp_offset) != MP_I64 ||
+        mp_next(&up, &mp_bin) != MP_BIN ||
+        mp_next(&up, &mp_size) != MP_I64 ||
+        mp_next(&up, &mp_raw) != MP_U64 ||
+        mp_offset.via.i64 < 0 ||
+        mp_size.via.i64 < 0 ||
+        mp_raw.via.u64 > SYNCPART_SIZE)
+    {
+        ex_set(e, EX_BAD_DATA, "invalid multipart request (delta sync)");
+        return NULL;
+    }
+
+    scope_id = mp_scope.via.u64;
+    ft = (syncfull__file_t) mp_ft.via.u64;
+    data = mp_bin.via.bin.data;
+    n = mp_bin.via.bin.n;
+
+    syncfull__stats.bytes_received += n;
+
+    if (mp_raw.via.u64)
+    {
+        /* the part is compressed */
+        raw = malloc(mp_raw.via.u64);
+        if (!raw)
+        {
+            ex_set_mem(e);
+            return NULL;
+        }
+        if (syncpart_decompress(data, n, raw, mp_raw.via.u64))
+        {
+            ex_set(e, EX_BAD_DATA, "failed to decompress part (delta sync)");
+            free(raw);
+            return NULL;
+        }
+        data = raw;
+        n = mp_raw.via.u64;
+    }
+
+    fn = syncfull__get_fn(scope_id, ft);
+    if (!fn)
+    {
+        ex_set(e, EX_BAD_DATA, "invalid file type %d for "TI_COLLECTION_ID,
+                ft, scope_id);
+        free(raw);
+        return NULL;
+    }
+
+    rc = syncpart_write_at(
+            fn,
+            data,
+            n,
+            (off_t) mp_offset.via.i64,
+            (off_t) mp_size.via.i64,
+            e);
+    free(fn);
+    free(raw);
+    if (rc)
+        return NULL;
+
+    if (mp_sbuffer_alloc_init(&buffer, 64, sizeof(ti_pkg_t)))
+    {
+        ex_set_mem(e);
+        return NULL;
+    }
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    msgpack_pack_array(&pk, 3);
+    msgpack_pack_uint64(&pk, scope_id);
+    msgpack_pack_uint64(&pk, ft);
+    msgpack_pack_fix_int64(&pk, mp_offset.via.i64);
+
+    resp = (ti_pkg_t *) buffer.data;
+    pkg_init(resp, pkg->id, TI_PROTO_NODE_RES_SYNCFDPART, buffer.size);
+
+    return resp;
+}
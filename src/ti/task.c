@@ -8,6 +8,8 @@
 #include <ti/enum.inline.h>
 #include <ti/field.h>
 #include <ti/method.h>
+#include <ti/pcache.h>
+#include <ti/rcache.h>
 #include <ti/proto.h>
 #include <ti/raw.h>
 #include <ti/task.h>
@@ -43,7 +45,12 @@ ti_task_t * ti_task_create(uint64_t change_id, ti_thing_t * thing)
 
 ti_task_t * ti_task_new_task(ti_change_t * change, ti_thing_t * thing)
 {
-    ti_task_t * task = ti_task_create(change->id, thing);
+    ti_task_t * task;
+
+    ti_pcache_changed(thing);
+    ti_rcache_changed(thing->collection, change->id);
+
+    task = ti_task_create(change->id, thing);
     if (!task)
         goto failed;
 
@@ -60,6 +67,11 @@ failed:
 ti_task_t * ti_task_get_task(ti_change_t * change, ti_thing_t * thing)
 {
     ti_task_t * task = vec_last(change->tasks);
+
+    /* the thing changes, also when the last task is re-used */
+    ti_pcache_changed(thing);
+    ti_rcache_changed(thing->collection, change->id);
+
     if (task && task->thing_id == thing->id)
         return task;
 
@@ -2776,6 +2788,36 @@ fail_data:
     return -1;
 }
 
+int ti_task_add_import_abort(ti_task_t * task, uint64_t import_id)
+{
+    size_t alloc = 32;
+    ti_data_t * data;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+
+    if (mp_sbuffer_alloc_init(&buffer, alloc, sizeof(ti_data_t)))
+        return -1;
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    msgpack_pack_array(&pk, 2);
+
+    msgpack_pack_uint8(&pk, TI_TASK_IMPORT_ABORT);
+    msgpack_pack_uint64(&pk, import_id);
+
+    data = (ti_data_t *) buffer.data;
+    ti_data_init(data, buffer.size);
+
+    if (vec_push(&task->list, data))
+        goto fail_data;
+
+    task__upd_approx_sz(task, data);
+    return 0;
+
+fail_data:
+    free(data);
+    return -1;
+}
+
 int ti_task_add_set_enum(ti_task_t * task, ti_enum_t * enum_)
 {
     size_t alloc = 8192;
@@ -3290,4 +3332,42 @@ int ti_task_add_del_history(
 fail_data:
     free(data);
     return -1;
-}
\ No newline at end of file
+}
+
+int ti_task_add_set_procedure_cache(
+        ti_task_t * task,
+        ti_procedure_t * procedure)
+{
+    size_t alloc = 64 + procedure->name->n;
+    ti_data_t * data;
+    msgpack_packer pk;
+    msgpack_sbuffer buffer;
+
+    if (mp_sbuffer_alloc_init(&buffer, alloc, sizeof(ti_data_t)))
+        return -1;
+    msgpack_packer_init(&pk, &buffer, msgpack_sbuffer_write);
+
+    msgpack_pack_array(&pk, 2);
+
+    msgpack_pack_uint8(&pk, TI_TASK_SET_PROCEDURE_CACHE);
+    msgpack_pack_map(&pk, 2);
+
+    mp_pack_str(&pk, "name");
+    mp_pack_strn(&pk, procedure->name->str, procedure->name->n);
+
+    mp_pack_str(&pk, "ttl");
+    msgpack_pack_uint32(&pk, procedure->cache_ttl);
+
+    data = (ti_data_t *) buffer.data;
+    ti_data_init(data, buffer.size);
+
+    if (vec_push(&task->list, data))
+        goto fail_data;
+
+    task__upd_approx_sz(task, data);
+    return 0;
+
+fail_data:
+    free(data);
+    return -1;
+}
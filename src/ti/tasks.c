@@ -14,9 +14,18 @@
 #include <ti/vtask.inline.h>
 #include <util/fx.h>
 
-/* Tasks will be checked every X seconds */
+/* Wake up at least every X milliseconds, even when no task is due, so
+ * changes in the node status and the system clock are picked up */
 #define VTASKS__INTERVAL 1 * 1000
 
+/* A task which fails to start is tried again after X milliseconds */
+#define VTASKS__RETRY 1 * 1000
+
+#define VTASKS__HEAP_INIT_SZ 64
+
+/* Maximum number of tasks which are combined in a single change */
+#define VTASKS__BATCH_MAX 256
+
 static ti_tasks_t * tasks;
 
 static void tasks__destroy(uv_handle_t * UNUSED(handle));
@@ -30,11 +39,13 @@ int ti_tasks_create(void)
 
     tasks->is_stopping = false;
     tasks->is_started = false;
-    tasks->lowest_run_at = 0;
+    tasks->n = 0;
+    tasks->sz = VTASKS__HEAP_INIT_SZ;
+    tasks->heap = malloc(sizeof(ti_tasks_item_t) * VTASKS__HEAP_INIT_SZ);
     tasks->timer = malloc(sizeof(uv_timer_t));
     tasks->vtasks = vec_new(4);
 
-    if (!tasks->timer || !tasks->vtasks)
+    if (!tasks->heap || !tasks->timer || !tasks->vtasks)
         goto failed;
 
     ti.tasks = tasks;
@@ -46,19 +57,39 @@ failed:
     return -1;
 }
 
+/*
+ * Start the timer for the first scheduled task, but wait at most
+ * VTASKS__INTERVAL milliseconds.
+ */
+static void tasks__timer_start(void)
+{
+    uint64_t timeout = VTASKS__INTERVAL;
+
+    if (!tasks->is_started)
+        return;
+
+    if (tasks->n)
+    {
+        uint64_t now = util_now_msec();
+        uint64_t run_at = tasks->heap[0].run_at;
+        if (run_at <= now)
+            timeout = 0;
+        else if (run_at - now < timeout)
+            timeout = run_at - now;
+    }
+
+    (void) uv_timer_start(tasks->timer, tasks__cb, timeout, 0);
+}
+
 int ti_tasks_start(void)
 {
     assert(tasks->is_started == false);
 
-    if (uv_timer_init(ti.loop, tasks->timer) ||
-        uv_timer_start(
-            tasks->timer,
-            tasks__cb,
-            VTASKS__INTERVAL,       /* start at VTASKS__INTERVAL */
-            VTASKS__INTERVAL))      /* repeat at VTASKS__INTERVAL */
+    if (uv_timer_init(ti.loop, tasks->timer))
         goto fail;
 
     tasks->is_started = true;
+    tasks__timer_start();
     return 0;
 
 fail:
@@ -89,6 +120,11 @@ static void tasks__destroy(uv_handle_t * UNUSED(handle))
 {
     if (tasks)
     {
+        /* tasks might still exist, make sure they are no longer scheduled */
+        for (uint32_t i = 0; i < tasks->n; ++i)
+            tasks->heap[i].vtask->heap_idx = TI_VTASK_UNSCHEDULED;
+
+        free(tasks->heap);
         free(tasks->timer);
         vec_destroy(tasks->vtasks, (vec_destroy_cb) ti_vtask_drop);
     }
@@ -96,79 +132,324 @@ static void tasks__destroy(uv_handle_t * UNUSED(handle))
     tasks = ti.tasks = NULL;
 }
 
-static inline int tasks__handle_vtask(
+static inline void tasks__set(uint32_t idx, ti_tasks_item_t item)
+{
+    tasks->heap[idx] = item;
+    item.vtask->heap_idx = idx;
+}
+
+static void tasks__up(uint32_t idx)
+{
+    ti_tasks_item_t item = tasks->heap[idx];
+
+    while (idx)
+    {
+        uint32_t parent = (idx - 1) / 2;
+        if (tasks->heap[parent].run_at <= item.run_at)
+            break;
+        tasks__set(idx, tasks->heap[parent]);
+        idx = parent;
+    }
+    tasks__set(idx, item);
+}
+
+static void tasks__down(uint32_t idx)
+{
+    ti_tasks_item_t item = tasks->heap[idx];
+    uint32_t half = tasks->n / 2;
+
+    while (idx < half)
+    {
+        uint32_t child = idx * 2 + 1;
+        if (child + 1 < tasks->n &&
+            tasks->heap[child + 1].run_at < tasks->heap[child].run_at)
+            ++child;
+        if (item.run_at <= tasks->heap[child].run_at)
+            break;
+        tasks__set(idx, tasks->heap[child]);
+        idx = child;
+    }
+    tasks__set(idx, item);
+}
+
+static void tasks__remove(uint32_t idx)
+{
+    ti_vtask_t * vtask = tasks->heap[idx].vtask;
+
+    vtask->heap_idx = TI_VTASK_UNSCHEDULED;
+
+    if (--tasks->n == idx)
+        return;
+
+    tasks__set(idx, tasks->heap[tasks->n]);
+    tasks__down(idx);
+    tasks__up(tasks->heap[idx].vtask->heap_idx);
+}
+
+static int tasks__push(
         ti_vtask_t * vtask,
-        ti_collection_t * collection,
-        const uint64_t now,
-        const uint32_t rel_id,
-        const uint32_t nodes_n)
-{
-    if (vtask->run_at &&
-        (vtask->id % nodes_n == rel_id) &&
-        (~vtask->flags & TI_VTASK_FLAG_RUNNING))
+        uint64_t run_at,
+        uint64_t scope_id)
+{
+    uint32_t idx = vtask->heap_idx;
+
+    if (idx == TI_VTASK_UNSCHEDULED)
     {
-        if (vtask->run_at <= now)
+        if (tasks->n == tasks->sz)
         {
-            if (ti_vtask_run(vtask, collection) == 0)
-                return 1;
-            /* re-schedule on error */
+            uint32_t sz = tasks->sz * 2;
+            ti_tasks_item_t * heap = realloc(
+                    tasks->heap,
+                    sizeof(ti_tasks_item_t) * sz);
+            if (!heap)
+                return -1;
+            tasks->heap = heap;
+            tasks->sz = sz;
         }
+        idx = tasks->n++;
+    }
+
+    tasks__set(idx, (ti_tasks_item_t) {
+        .run_at = run_at,
+        .scope_id = scope_id,
+        .vtask = vtask,
+    });
+    tasks__down(idx);
+    tasks__up(vtask->heap_idx);
+    return 0;
+}
+
+static inline _Bool tasks__is_owner(ti_vtask_t * vtask)
+{
+    uint32_t nodes_n = ti.nodes->vec->n;
+    return nodes_n && vtask->id % nodes_n == ti.rel_id;
+}
+
+/*
+ * Schedule a task, or update the position when the task is already
+ * scheduled. Tasks without a run time, tasks which are running and tasks
+ * which are owned by another node are removed from the schedule.
+ */
+int ti_tasks_schedule(ti_vtask_t * vtask, ti_collection_t * collection)
+{
+    if (!tasks)
+        return 0;
+
+    if (!vtask->run_at ||
+        (vtask->flags & TI_VTASK_FLAG_RUNNING) ||
+        !tasks__is_owner(vtask))
+    {
+        ti_tasks_unschedule(vtask);
+        return 0;
+    }
+
+    if (tasks__push(
+            vtask,
+            vtask->run_at * 1000,
+            collection ? collection->id : 0))
+        return -1;
+
+    /* re-start the timer when this task is the first to run */
+    if (vtask->heap_idx == 0)
+        tasks__timer_start();
+
+    return 0;
+}
+
+void ti_tasks_unschedule(ti_vtask_t * vtask)
+{
+    if (tasks && vtask->heap_idx != TI_VTASK_UNSCHEDULED)
+        tasks__remove(vtask->heap_idx);
+}
+
+static inline int tasks__is_wse(ti_vtask_t * vtask)
+{
+    return vtask->closure && (vtask->closure->flags & TI_CLOSURE_FLAG_WSE);
+}
+
+/*
+ * Sort by scope, tasks with side effects and finally by run time.
+ */
+static int tasks__item_cmp(const void * va, const void * vb)
+{
+    const ti_tasks_item_t * a = va, * b = vb;
+    int wa, wb;
+
+    if (a->scope_id != b->scope_id)
+        return (a->scope_id > b->scope_id) - (a->scope_id < b->scope_id);
 
-        /* update the next lowest run */
-        if (vtask->run_at < tasks->lowest_run_at)
-            tasks->lowest_run_at = vtask->run_at;
+    wa = tasks__is_wse(a->vtask) != 0;
+    wb = tasks__is_wse(b->vtask) != 0;
+    if (wa != wb)
+        return wb - wa;
+
+    return (a->run_at > b->run_at) - (a->run_at < b->run_at);
+}
+
+static void tasks__retry(ti_tasks_item_t * items, uint32_t n, uint64_t now)
+{
+    uint64_t run_at = now + VTASKS__RETRY;
+    for (uint32_t i = 0; i < n; ++i)
+        if (tasks__push(items[i].vtask, run_at, items[i].scope_id))
+            log_critical(EX_MEMORY_S);
+}
+
+/*
+ * Pop all tasks which are due. Returns 0 if successful or -1 in case of an
+ * allocation error in which case the schedule is left unchanged.
+ */
+static int tasks__pop_due(
+        ti_tasks_item_t ** items,
+        uint32_t * nitems,
+        uint64_t now)
+{
+    uint32_t n = 0, sz = 0;
+    ti_tasks_item_t * due = NULL;
+
+    while (tasks->n && tasks->heap[0].run_at <= now)
+    {
+        if (n == sz)
+        {
+            ti_tasks_item_t * tmp;
+            sz = sz ? sz * 2 : 8;
+            tmp = realloc(due, sizeof(ti_tasks_item_t) * sz);
+            if (!tmp)
+            {
+                /* restore the schedule, this cannot fail as the heap has
+                 * enough space for all the removed tasks */
+                while (n--)
+                    (void) tasks__push(
+                            due[n].vtask,
+                            due[n].run_at,
+                            due[n].scope_id);
+                free(due);
+                return -1;
+            }
+            due = tmp;
+        }
+        due[n++] = tasks->heap[0];
+        tasks__remove(0);
     }
+
+    *items = due;
+    *nitems = n;
     return 0;
 }
 
 /*
- * Called from the main thread at CONNECT__INTERVAL (every X seconds)
+ * Called from the main thread when the first task is due, or at least every
+ * VTASKS__INTERVAL milliseconds.
+ *
+ * When this node is ready, due tasks with side effects for the same scope are
+ * combined and run as a batch with a single change. Tasks without side
+ * effects do not require a change and still run one by one, as do all tasks
+ * when this node is not ready and tasks are forwarded to another node.
  */
 static void tasks__cb(uv_timer_t * UNUSED(handle))
 {
-    const uint64_t now = util_now_usec();
-    const uint32_t rel_id = ti.rel_id;
-    const uint32_t nodes_n = ti.nodes->vec->n;
-    int n = 0;
+    uint64_t now;
+    uint32_t i, j, n, started = 0;
+    ti_tasks_item_t * items;
+    vec_t * batch = NULL;
+    _Bool is_ready;
 
-    /* ThingsDB knows the first time-stamp it should handle, thus this call is
-     * usually very sort as it will return immediately. Only when required, it
-     * will loop through the tasks.
-     */
-    if (tasks->lowest_run_at > now || ti_restore_is_busy() || (
+    if (ti_restore_is_busy() || (
         ti.node->status & (
             TI_NODE_STAT_AWAY|
             TI_NODE_STAT_AWAY_SOON|
             TI_NODE_STAT_READY)) == 0)
-        return;
+        goto retry;
 
-    tasks->lowest_run_at = UINT64_MAX;
+    now = util_now_msec();
+    if (tasks__pop_due(&items, &n, now))
+    {
+        log_critical(EX_MEMORY_S);
+        goto retry;
+    }
 
-    for (vec_each(tasks->vtasks, ti_vtask_t, vtask))
-        n += tasks__handle_vtask(vtask, NULL, now, rel_id, nodes_n);
+    is_ready = ti.node->status == TI_NODE_STAT_READY;
+    if (is_ready && n > 1)
+    {
+        batch = vec_new(VTASKS__BATCH_MAX);
+        if (batch)
+            qsort(items, n, sizeof(ti_tasks_item_t), tasks__item_cmp);
+        else
+            log_error(EX_MEMORY_S);
+    }
 
-    for (vec_each(ti.collections->vec, ti_collection_t, collection))
-        for (vec_each(collection->vtasks, ti_vtask_t, vtask))
-            n += tasks__handle_vtask(vtask, collection, now, rel_id, nodes_n);
+    for (i = 0; i < n; i = j)
+    {
+        ti_collection_t * collection = NULL;
+        uint64_t scope_id = items[i].scope_id;
+        int rc;
+
+        /* select tasks with side effects for the same scope, up to
+         * VTASKS__BATCH_MAX */
+        for (j = i + 1;
+             batch &&
+             j < n &&
+             j - i < VTASKS__BATCH_MAX &&
+             items[j].scope_id == scope_id &&
+             tasks__is_wse(items[j].vtask);
+             ++j);
+
+        if (scope_id)
+        {
+            collection = ti_collections_get_by_id(scope_id);
+            if (!collection)
+                continue;  /* collection is removed */
+        }
+
+        if (j - i == 1)
+            rc = ti_vtask_run(items[i].vtask, collection);
+        else
+        {
+            vec_clear(batch);
+            while (i < j)
+                VEC_push(batch, items[i++].vtask);
+            i -= batch->n;
+            rc = ti_vtask_run_batch(batch, collection);
+        }
+
+        if (rc == 0)
+            started += j - i;
+        else
+            /* re-schedule on error */
+            tasks__retry(items + i, j - i, now);
+    }
+
+    if (started)
+        log_info("initiated %u task%s", started, started == 1 ? "": "s");
 
-    if (n)
-        log_info("initiated %d task%s", n, n == 1 ? "": "s");
+    vec_destroy(batch, NULL);
+    free(items);
+
+    tasks__timer_start();
+    return;
+
+retry:
+    /* due tasks are not removed, so wait before trying again as otherwise
+     * the timer would fire immediately */
+    if (tasks->is_started)
+        (void) uv_timer_start(tasks->timer, tasks__cb, VTASKS__RETRY, 0);
 }
 
-int ti_tasks_append(vec_t ** vtasks, ti_vtask_t * vtask)
+int ti_tasks_append(
+        vec_t ** vtasks,
+        ti_vtask_t * vtask,
+        ti_collection_t * collection)
 {
-    uint32_t rel_id = ti.rel_id;
-    uint32_t nodes_n = ti.nodes->vec->n;
+    if (ti_tasks_schedule(vtask, collection))
+        return -1;
 
     if (vec_push(vtasks, vtask))
+    {
+        ti_tasks_unschedule(vtask);
         return -1;
-
-    if ((vtask->id % nodes_n == rel_id) &&
-        vtask->run_at < tasks->lowest_run_at)
-        tasks->lowest_run_at = vtask->run_at;
-
+    }
     return 0;
 }
+
 /*
  * Only for dropped collections.
  */
@@ -177,6 +458,7 @@ void ti_tasks_clear_dropped(vec_t ** vtasks)
     ti_vtask_t * vtask;
     while ((vtask = vec_pop(*vtasks)))
     {
+        ti_tasks_unschedule(vtask);
         ti_vtask_unsafe_drop(vtask);
     }
     vec_shrink(vtasks);
@@ -230,22 +512,31 @@ vec_t * ti_tasks_from_scope_id(uint64_t scope_id)
     return NULL;
 }
 
-void ti_tasks_reset_lowest_run_at(void)
+/*
+ * Rebuild the schedule. This is required when the number of nodes or the
+ * relative node id changes as this changes which tasks this node owns.
+ */
+void ti_tasks_reschedule(void)
 {
-    tasks->lowest_run_at = 0;  /* forces a one time loop */
+    if (!tasks)
+        return;
+
+    while (tasks->n)
+        tasks->heap[--tasks->n].vtask->heap_idx = TI_VTASK_UNSCHEDULED;
+
+    for (vec_each(tasks->vtasks, ti_vtask_t, vtask))
+        if (ti_tasks_schedule(vtask, NULL))
+            log_critical(EX_MEMORY_S);
+
+    for (vec_each(ti.collections->vec, ti_collection_t, collection))
+        for (vec_each(collection->vtasks, ti_vtask_t, vtask))
+            if (ti_tasks_schedule(vtask, collection))
+                log_critical(EX_MEMORY_S);
 }
 
-void ti_tasks_vtask_finish(ti_vtask_t * vtask)
+void ti_tasks_vtask_finish(ti_vtask_t * vtask, ti_collection_t * collection)
 {
-    if (vtask->run_at)
-    {
-        uint32_t rel_id = ti.rel_id;
-        uint32_t nodes_n = ti.nodes->vec->n;
-
-        if ((vtask->id % nodes_n == rel_id) &&
-            vtask->run_at < tasks->lowest_run_at)
-            tasks->lowest_run_at = vtask->run_at;
-    }
     vtask->flags &= ~(TI_VTASK_FLAG_RUNNING|TI_VTASK_FLAG_AGAIN);
+    if (ti_tasks_schedule(vtask, collection))
+        log_critical(EX_MEMORY_S);
 }
-
@@ -14,6 +14,7 @@
 #include <ti/method.h>
 #include <ti/names.h>
 #include <ti/opr.h>
+#include <ti/pcache.h>
 #include <ti/procedures.h>
 #include <ti/prop.h>
 #include <ti/proto.h>
@@ -29,10 +30,84 @@
 #include <ti/watch.h>
 #include <util/logger.h>
 #include <util/mpack.h>
+#include <util/ptrmap.h>
 
 static vec_t * thing__gc_swp;
 vec_t * ti_thing_gc_vec;
 
+/*
+ * The property index is a hash table per collection for all objects with
+ * many properties, keyed by the thing and the (interned) name of a property.
+ * This keeps lookups fast for large objects while small objects pay nothing
+ * for it; the properties stay in the vector so the order does not change.
+ *
+ * The index is part of the collection as things might be destroyed by the
+ * garbage collector in away-mode. Things without a collection are never
+ * indexed.
+ */
+static void thing__index_clear(ti_thing_t * thing)
+{
+    ptrmap_t * index = thing->collection->index;
+    for (vec_each(thing->items.vec, ti_prop_t, prop))
+        (void) ptrmap_pop(index, thing, prop->name);
+    thing->flags &= ~TI_THING_FLAG_INDEX;
+}
+
+static int thing__index_build(ti_thing_t * thing)
+{
+    ti_collection_t * collection = thing->collection;
+
+    if (!collection ||
+        (!collection->index && !(collection->index = ptrmap_create())))
+        return -1;
+
+    thing->flags |= TI_THING_FLAG_INDEX;
+    for (vec_each(thing->items.vec, ti_prop_t, prop))
+    {
+        if (ptrmap_set(collection->index, thing, prop->name, prop))
+        {
+            thing__index_clear(thing);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static inline void thing__index_drop(ti_thing_t * thing)
+{
+    if (thing->flags & TI_THING_FLAG_INDEX)
+        thing__index_clear(thing);
+}
+
+static inline void thing__index_add(ti_thing_t * thing, ti_prop_t * prop)
+{
+    /* without an index, lookups fall back to a linear scan */
+    if ((thing->flags & TI_THING_FLAG_INDEX) &&
+        ptrmap_set(thing->collection->index, thing, prop->name, prop))
+        thing__index_clear(thing);
+}
+
+static inline void thing__index_pop(ti_thing_t * thing, ti_name_t * name)
+{
+    if (thing->flags & TI_THING_FLAG_INDEX)
+        (void) ptrmap_pop(thing->collection->index, thing, name);
+}
+
+/*
+ * Called by ti_thing_p_prop_weak_get() for objects with at least
+ * TI_THING_INDEX_MIN properties. The index is created on the first lookup.
+ */
+ti_prop_t * ti_thing_p_index_get(ti_thing_t * thing, ti_name_t * name)
+{
+    if ((thing->flags & TI_THING_FLAG_INDEX) || !thing__index_build(thing))
+        return ptrmap_get(thing->collection->index, thing, name);
+
+    for (vec_each(thing->items.vec, ti_prop_t, prop))
+        if (prop->name == name)
+            return prop;
+    return NULL;
+}
+
 
 ti_thing_t * ti_thing_o_create(
         uint64_t id,
@@ -185,6 +260,8 @@ void ti_thing_destroy(ti_thing_t * thing)
     if (ti_thing_is_instance(thing))
         ti_thing_t_vcache_drop(thing);
 
+    ti_pcache_drop(thing);
+
     /*
      * While dropping, mutable variable must clear the parent; for example
      *
@@ -192,6 +269,8 @@ void ti_thing_destroy(ti_thing_t * thing)
      *
      * In this case the `thing` will be removed while the list stays alive.
      */
+    thing__index_drop(thing);
+
     if (ti_thing_is_dict(thing))
         smap_destroy(
                 thing->items.smap,
@@ -213,9 +292,12 @@ void ti_thing_clear(ti_thing_t * thing)
                     thing->items.smap,
                     (smap_destroy_cb) ti_item_unassign_destroy);
         else
+        {
+            thing__index_drop(thing);
             vec_clear_cb(
                     thing->items.vec,
                     (vec_destroy_cb) ti_prop_unassign_destroy);
+        }
     }
     else
     {
@@ -243,6 +325,7 @@ void ti_thing_o_items_destroy(ti_thing_t * thing)
     }
     else
     {
+        thing__index_drop(thing);
         vec_destroy(
                 thing->items.vec,
                 (vec_destroy_cb) ti_prop_unsafe_vdestroy);
@@ -259,6 +342,7 @@ int ti_thing_to_dict(ti_thing_t * thing)
         if (smap_add(smap, prop->name->str, prop))
             goto fail0;
 
+    thing__index_drop(thing);
     thing->flags |= TI_THING_FLAG_DICT;
     free(thing->items.vec);
     thing->items.smap = smap;
@@ -397,6 +481,7 @@ ti_prop_t * ti_thing_p_prop_add(
         free(prop);
         return NULL;
     }
+    thing__index_add(thing, prop);
     return prop;
 }
 
@@ -477,6 +562,7 @@ int ti_thing_p_prop_add_assign(
         return e->nr;
     }
 
+    thing__index_add(thing, prop);
     ti_incref(name);
     return 0;
 }
@@ -596,21 +682,17 @@ static int thing_p__prop_set_e(
         ti_val_t * val,
         ex_t * e)
 {
-    ti_prop_t * prop;
-
-    for (vec_each(thing->items.vec, ti_prop_t, p))
+    ti_prop_t * prop = ti_thing_p_prop_weak_get(thing, name);
+    if (prop)
     {
-        if (p->name == name)
-        {
-            if (ti_val_tlocked(p->val, thing, p->name, e))
-                return e->nr;
+        if (ti_val_tlocked(prop->val, thing, prop->name, e))
+            return e->nr;
 
-            ti_decref(name);
-            ti_val_replace_drop(p->val, val);
-            p->val = val;
+        ti_decref(name);
+        ti_val_replace_drop(prop->val, val);
+        prop->val = val;
 
-            return e->nr;
-        }
+        return e->nr;
     }
 
     prop = ti_prop_create(name, val);
@@ -618,8 +700,10 @@ static int thing_p__prop_set_e(
     {
         free(prop);
         ex_set_mem(e);
+        return e->nr;
     }
 
+    thing__index_add(thing, prop);
     return e->nr;
 }
 
@@ -666,23 +750,20 @@ ti_prop_t * ti_thing_p_prop_set(
         ti_name_t * name,
         ti_val_t * val)
 {
-    ti_prop_t * prop;
-
-    for (vec_each(thing->items.vec, ti_prop_t, p))
+    ti_prop_t * prop = ti_thing_p_prop_weak_get(thing, name);
+    if (prop)
     {
-        if (p->name == name)
-        {
-            ti_decref(name);
-            ti_val_replace_drop(p->val, val);
-            p->val = val;
-            return p;
-        }
+        ti_decref(name);
+        ti_val_replace_drop(prop->val, val);
+        prop->val = val;
+        return prop;
     }
 
     prop = ti_prop_create(name, val);
     if (!prop || vec_push(&thing->items.vec, prop))
         return free(prop), NULL;
 
+    thing__index_add(thing, prop);
     return prop;
 }
 
@@ -906,6 +987,7 @@ void ti_thing_o_del(ti_thing_t * thing, const char * str, size_t n)
         {
             if (prop->name == name)
             {
+                thing__index_pop(thing, name);
                 ti_prop_unassign_destroy(
                         vec_swap_remove(thing->items.vec, idx));
                 return;
@@ -948,9 +1030,12 @@ ti_item_t * ti_thing_o_del_e(ti_thing_t * thing, ti_raw_t * rname, ex_t * e)
             for (vec_each(thing->items.vec, ti_prop_t, prop), ++i)
             {
                 if (prop->name == name)
-                    return ti_val_tlocked(prop->val, thing, prop->name, e)
-                        ? NULL
-                        : vec_swap_remove(thing->items.vec, i);
+                {
+                    if (ti_val_tlocked(prop->val, thing, prop->name, e))
+                        return NULL;
+                    thing__index_pop(thing, name);
+                    return vec_swap_remove(thing->items.vec, i);
+                }
             }
         }
     }
@@ -1020,6 +1105,7 @@ int ti_thing_o_ren(
         {
             if (prop->name == name)
             {
+                thing__index_pop(thing, name);
                 vec_swap_remove(thing->items.vec, idx);
                 val = prop->val;
                 ti_prop_unsafe_vdestroy(prop);
@@ -1076,14 +1162,12 @@ static _Bool thing_p__get_by_name(
         ti_thing_t * thing,
         ti_name_t * name)
 {
-    for (vec_each(thing->items.vec, ti_prop_t, prop))
+    ti_prop_t * prop = ti_thing_p_prop_weak_get(thing, name);
+    if (prop)
     {
-        if (prop->name == name)
-        {
-            wprop->name = name;
-            wprop->val = &prop->val;
-            return true;
-        }
+        wprop->name = name;
+        wprop->val = &prop->val;
+        return true;
     }
     return false;
 }
@@ -1286,6 +1370,8 @@ void ti_thing_t_to_object(ti_thing_t * thing)
         *val = (ti_val_t *) prop;
     }
 
+    /* other things might refer to this thing using the type's Id name */
+    ti_pcache_drop_collection(thing->collection);
     ti_thing_t_vcache_drop(thing);
     thing->type_id = TI_SPEC_OBJECT;
     thing->via.spec = TI_SPEC_ANY;  /* fixes bug #277 */
@@ -1306,7 +1392,7 @@ static inline int thing__client_pk_cb(ti_item_t * item, thing__pk_cb_t * w)
     );
 }
 
-int ti_thing__to_client_pk(
+static int thing__to_client_pk(
         ti_thing_t * thing,
         ti_vp_t * vp,
         int deep,
@@ -1389,6 +1475,84 @@ fail:
     return -1;
 }
 
+/*
+ * Tasks are packed with their owner, schedule and status. These change
+ * without a task on the thing which holds the task value, so things with
+ * task values are never stored in the pack cache.
+ */
+static int thing__val_has_task(ti_val_t * val)
+{
+    if (ti_val_is_task(val))
+        return 1;
+
+    if (ti_val_is_array(val))
+        for (vec_each(VARR(val), ti_val_t, v))
+            if (thing__val_has_task(v))
+                return 1;
+    return 0;
+}
+
+static int thing__item_has_task(ti_item_t * item, void * UNUSED(arg))
+{
+    return thing__val_has_task(item->val);
+}
+
+static _Bool thing__has_task(ti_thing_t * thing)
+{
+    if (ti_thing_is_dict(thing))
+        return smap_values(
+                thing->items.smap,
+                (smap_val_cb) thing__item_has_task,
+                NULL);
+
+    if (ti_thing_is_object(thing))
+    {
+        for (vec_each(thing->items.vec, ti_prop_t, prop))
+            if (thing__val_has_task(prop->val))
+                return true;
+        return false;
+    }
+
+    for (vec_each(thing->items.vec, ti_val_t, val))
+        if (thing__val_has_task(val))
+            return true;
+    return false;
+}
+
+int ti_thing__to_client_pk(
+        ti_thing_t * thing,
+        ti_vp_t * vp,
+        int deep,
+        int flags)
+{
+    msgpack_sbuffer * buffer = vp->pk.data;
+    size_t offset;
+    int rc;
+
+    /*
+     * With a `deep` value of 1, nested things are packed using only their
+     * Id so the packed data only changes when the thing itself changes.
+     */
+    if (deep != 1 || !thing->id)
+        return thing__to_client_pk(thing, vp, deep, flags);
+
+    rc = ti_pcache_get(thing, vp, flags);
+    if (rc <= 0)
+        return rc;
+
+    offset = buffer->size;
+    if (thing__to_client_pk(thing, vp, deep, flags))
+        return -1;
+
+    if (!thing__has_task(thing))
+        ti_pcache_set(
+                thing,
+                flags,
+                buffer->data + offset,
+                buffer->size - offset);
+    return 0;
+}
+
 static inline int thing__store_pk_cb(ti_item_t * item, msgpack_packer * pk)
 {
     return -(
@@ -1123,7 +1123,7 @@ static int ttask__vtask_new(mp_unp_t * up)
         goto fail0;
 
     ti_update_next_free_id(vtask->id);
-    VEC_push(ti.tasks->vtasks, vtask);
+    (void) ti_tasks_append(&ti.tasks->vtasks, vtask, NULL);
     free(varr);
     ti_decref(closure);
     return 0;
@@ -1220,7 +1220,7 @@ static int ttask__vtask_finish(mp_unp_t * up)
         goto fail0;
 
     vtask->run_at = mp_run_at.via.u64;
-    ti_tasks_vtask_finish(vtask);
+    ti_tasks_vtask_finish(vtask, NULL);
 
     ti_val_drop((ti_val_t *) vtask->verr);
     vtask->verr = (ti_verror_t *) val;
@@ -1599,6 +1599,42 @@ static int ttask__rename_procedure(mp_unp_t * up)
             mp_name.via.str.n);
 }
 
+/*
+ * Returns 0 on success
+ * - for example: {'name':name, 'ttl':ttl}
+ */
+static int ttask__set_procedure_cache(mp_unp_t * up)
+{
+    ti_procedure_t * procedure;
+    mp_obj_t obj, mp_name, mp_ttl;
+
+    if (mp_next(up, &obj) != MP_MAP || obj.via.sz != 2 ||
+        mp_skip(up) != MP_STR ||
+        mp_next(up, &mp_name) != MP_STR ||
+        mp_skip(up) != MP_STR ||
+        mp_next(up, &mp_ttl) != MP_U64)
+    {
+        log_critical("task `set_procedure_cache`: invalid format");
+        return -1;
+    }
+
+    procedure = ti_procedures_by_strn(
+            ti.procedures,
+            mp_name.via.str.data,
+            mp_name.via.str.n);
+
+    if (!procedure)
+    {
+        log_critical(
+                "task `set_procedure_cache` cannot find `%.*s`",
+                mp_name.via.str.n, mp_name.via.str.data);
+        return -1;
+    }
+
+    ti_procedure_set_cache_ttl(procedure, (uint32_t) mp_ttl.via.u64);
+    return 0;
+}
+
 /*
  * Returns 0 on success
  * - for example: {'id':id, 'name':name}
@@ -1873,6 +1909,11 @@ int ti_ttask_run(ti_change_t * change, mp_unp_t * up)
     case TI_TASK_DEL_HISTORY:       return ttask__del_history(up);
     case TI_TASK_COMMIT:            return ttask__commit(up);
     case TI_TASK_MOD_TYPE_IDX:      break;
+    case TI_TASK_SET_PROCEDURE_CACHE:
+        return ttask__set_procedure_cache(up);
+    case TI_TASK_IMPORT_THINGS:     break;
+    case TI_TASK_IMPORT_DATA:       break;
+    case TI_TASK_IMPORT_ABORT:      break;
     }
 
     log_critical("unknown thingsdb task: %"PRIu64, mp_task.via.u64);
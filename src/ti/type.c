@@ -13,9 +13,9 @@
 #include <ti/field.h>
 #include <ti/gc.h>
 #include <ti/map.h>
-#include <ti/mapping.h>
 #include <ti/method.h>
 #include <ti/names.h>
+#include <ti/pcache.h>
 #include <ti/prop.h>
 #include <ti/query.h>
 #include <ti/raw.inline.h>
@@ -1292,48 +1292,23 @@ ti_val_t * ti_type_as_mpval(ti_type_t * type, _Bool with_definition)
 }
 
 /*
- * Returns a vector with all the properties of a given `to` type when are
- * found and compatible with a `to` type.
+ * Returns the compiled map for wrapping instances of `from` type into the
+ * `to` type. Maps are cached on the `to` type so they are only created the
+ * first time a conversion from `to_type` -> `from_type` is asked.
  * The return is NULL when a memory allocation has occurred.
  */
 ti_map_t * ti_type_map(ti_type_t * t_type, ti_type_t * f_type)
 {
-    ti_field_t * f_field;
-    ti_mapping_t * mapping;
-    vec_t * mappings;
     ti_map_t * map = imap_get(t_type->t_mappings, f_type->type_id);
     if (map)
         return map;
 
-    mappings = vec_new(t_type->fields->n);
-    if (!mappings)
-        return NULL;
-
-    for (vec_each(t_type->fields, ti_field_t, t_field))
-    {
-        f_field = ti_field_by_name(f_type, t_field->name);
-        if (!f_field)
-            continue;
-
-        if (ti_field_maps_to_field(t_field, f_field))
-        {
-            mapping = ti_mapping_new(t_field, f_field);
-            if (!mapping)
-            {
-                vec_destroy(mappings, free);
-                return NULL;
-            }
-            VEC_push(mappings, mapping);
-        }
-    }
-    map = ti_map_new(mappings);
-    if (!map)
+    map = ti_map_new(t_type, f_type);
+    if (map && imap_add(t_type->t_mappings, f_type->type_id, map))
     {
-        vec_destroy(mappings, free);
+        ti_map_destroy(map);
         return NULL;
     }
-
-    (void) imap_add(t_type->t_mappings, f_type->type_id, map);
     return map;
 }
 
@@ -1489,6 +1464,9 @@ int ti_type_convert(
 
     ti_thing_o_items_destroy(thing);
 
+    /* other things might refer to this thing using the type's Id name */
+    ti_pcache_drop_collection(thing->collection);
+
     /* make sure the `dictionary` flag is removed */
     thing->flags &= ~TI_THING_FLAG_DICT;
     thing->type_id = type->type_id;
@@ -2,7 +2,9 @@
  * ti/tz.c
  */
 #include <assert.h>
+#include <limits.h>
 #include <ti/tz.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
@@ -10,6 +12,8 @@
 #include <util/logger.h>
 #include <util/mpack.h>
 
+#define TZ__DIR "/usr/share/zoneinfo"
+
 enum
 {
     TOTAL_KEYWORDS = 597,
@@ -795,24 +799,74 @@ void ti_tz_init(void)
     }
 }
 
-void ti_tz_set_utc(void)
+void ti_tz_destroy(void)
 {
-    *tz__write_chr = ':';
-    memcpy(tz__write_env, "UTC", 4);
+    for (size_t i = 0, n = TOTAL_KEYWORDS; i < n; ++i)
+    {
+        ti_tz_t * tz = &tz__list[i];
+        tzif_destroy(tz->tzif);
+        tz->tzif = NULL;
+        tz->loaded = false;
+    }
 }
 
-void ti_tz_set(ti_tz_t * tz)
+static void tz__set(ti_tz_t * tz)
 {
     *tz__write_chr = ':';
     memcpy(tz__write_env, tz->name, tz->n+1);
 }
 
-void ti_tz_set_offset(int16_t offset)
+/*
+ * Returns the transition table for a time zone, which is read only once from
+ * the zoneinfo directory. Returns NULL when the zone cannot be loaded; the
+ * C library is used for such zones.
+ */
+static tzif_t * tz__tzif(ti_tz_t * tz)
 {
-    int hours = abs(offset / 60);
-    int minutes = abs(offset % 60);
-    char sign = offset < 0 ? '+' : '-';  /* offset works in reverse here */
-    sprintf(tz__write_chr, "UTC%c%02d:%02d", sign, hours, minutes);
+    if (!tz->loaded)
+    {
+        char fn[PATH_MAX];
+        const char * tzdir = getenv("TZDIR");
+
+        tz->loaded = true;
+        (void) snprintf(fn, PATH_MAX, "%s/%s",
+                tzdir && *tzdir ? tzdir : TZ__DIR,
+                tz->name);
+
+        tz->tzif = tzif_load(fn);
+        if (!tz->tzif)
+            log_warning(
+                    "failed to load time zone `%s` from `%s`; "
+                    "falling back to the C library", tz->name, fn);
+    }
+    return tz->tzif;
+}
+
+/*
+ * Like localtime_r() for the given time zone; returns 0 on success.
+ */
+int ti_tz_localtime(ti_tz_t * tz, time_t ts, struct tm * tm)
+{
+    tzif_t * tzif = tz__tzif(tz);
+    if (tzif)
+        return tzif_localtime(tzif, ts, tm);
+
+    tz__set(tz);
+    tzset();
+    return -(localtime_r(&ts, tm) != tm);
+}
+
+/*
+ * Like mktime() for the given time zone.
+ */
+time_t ti_tz_mktime(ti_tz_t * tz, struct tm * tm)
+{
+    tzif_t * tzif = tz__tzif(tz);
+    if (tzif)
+        return (time_t) tzif_mktime(tzif, tm);
+
+    tz__set(tz);
+    return mktime(tm);
 }
 
 ti_tz_t * ti_tz_utc(void)
@@ -79,6 +79,7 @@ static ti_val_t * val__charset_str;
 ti_val_t * val__async_name;
 ti_val_t * val__data_name;
 ti_val_t * val__time_name;
+ti_val_t * val__profile_name;
 ti_val_t * val__year_name;
 ti_val_t * val__month_name;
 ti_val_t * val__day_name;
@@ -833,6 +834,7 @@ int ti_val_init_common(void)
     val__async_name = (ti_val_t *) ti_names_from_str_slow("async");
     val__data_name = (ti_val_t *) ti_names_from_str_slow("data");
     val__time_name = (ti_val_t *) ti_names_from_str_slow("time");
+    val__profile_name = (ti_val_t *) ti_names_from_str_slow("profile");
     val__year_name = (ti_val_t *) ti_names_from_str_slow("year");
     val__month_name = (ti_val_t *) ti_names_from_str_slow("month");
     val__day_name = (ti_val_t *) ti_names_from_str_slow("day");
@@ -869,7 +871,8 @@ int ti_val_init_common(void)
         !val__key_name || !val__key_type_name || !val__flags_name ||
         !val__data_name || !val__time_name || !val__re_email ||
         !val__smodule || !val__re_url || !val__re_tel || !val__async_name ||
-        !val__anonymous_name || !val__sano || !val__swano)
+        !val__anonymous_name || !val__sano || !val__swano ||
+        !val__profile_name)
     {
         return -1;
     }
@@ -0,0 +1,243 @@
+/*
+ * ti/vhash.c
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ti/datetime.h>
+#include <ti/opr.h>
+#include <ti/raw.h>
+#include <ti/val.h>
+#include <ti/vbool.h>
+#include <ti/vfloat.h>
+#include <ti/vhash.h>
+#include <ti/vint.h>
+
+#define VHASH__MIN_SZ 8
+#define VHASH__EXACT_INT 9007199254740992.0     /* 2^53 */
+#define VHASH__DATETIME_SEED 0x5be0cd19137e2179ULL
+
+static inline uint64_t vhash__mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static inline uint64_t vhash__double(double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(uint64_t));
+    return vhash__mix(bits);
+}
+
+static uint64_t vhash__raw(const unsigned char * data, size_t n)
+{
+    uint64_t k, h = 0x9e3779b97f4a7c15ULL ^ n;
+
+    for (; n >= sizeof(uint64_t); n -= sizeof(uint64_t))
+    {
+        memcpy(&k, data, sizeof(uint64_t));
+        h = (h ^ vhash__mix(k)) * 0x100000001b3ULL;
+        data += sizeof(uint64_t);
+    }
+
+    k = 0;
+    memcpy(&k, data, n);
+    return vhash__mix(h ^ k);
+}
+
+/*
+ * Numbers must return the same hash when they are equal according to
+ * `ti_opr_eq()`, so `1`, `1.0` and `true` share the same hash. Integer values
+ * which cannot be exactly represented as a double compare equal with the
+ * double they round to and are therefore hashed as that double.
+ */
+static inline uint64_t vhash__int(int64_t i)
+{
+    return (i > -VHASH__EXACT_INT && i < VHASH__EXACT_INT)
+            ? vhash__mix((uint64_t) i)
+            : vhash__double((double) i);
+}
+
+static inline uint64_t vhash__float(double d)
+{
+    return (d > -VHASH__EXACT_INT && d < VHASH__EXACT_INT &&
+            d == (double) ((int64_t) d))
+            ? vhash__mix((uint64_t) ((int64_t) d))
+            : vhash__double(d);
+}
+
+/*
+ * Set `hash` for a given value and return `true`, or return `false` if the
+ * value is compared by content but has no hash (list, set, regex etc.).
+ * Values which are only equal to themselves are hashed by address.
+ */
+_Bool ti_val_hash(ti_val_t * val, uint64_t * hash)
+{
+    switch ((ti_val_enum) val->tp)
+    {
+    case TI_VAL_INT:
+        *hash = vhash__int(VINT(val));
+        return true;
+    case TI_VAL_FLOAT:
+        *hash = vhash__float(VFLOAT(val));
+        return true;
+    case TI_VAL_BOOL:
+        *hash = vhash__mix((uint64_t) VBOOL(val));
+        return true;
+    case TI_VAL_DATETIME:
+        *hash = vhash__mix((uint64_t) DATETIME(val) ^ VHASH__DATETIME_SEED);
+        return true;
+    case TI_VAL_NAME:
+    case TI_VAL_STR:
+    case TI_VAL_BYTES:
+        *hash = vhash__raw(((ti_raw_t *) val)->data, ((ti_raw_t *) val)->n);
+        return true;
+    case TI_VAL_REGEX:
+    case TI_VAL_WRAP:
+    case TI_VAL_ARR:
+    case TI_VAL_SET:
+    case TI_VAL_ERROR:
+    case TI_VAL_ANO:
+    case TI_VAL_WANO:
+        return false;
+    case TI_VAL_NIL:
+    case TI_VAL_THING:
+    case TI_VAL_ROOM:
+    case TI_VAL_TASK:
+    case TI_VAL_MEMBER:
+    case TI_VAL_MPDATA:
+    case TI_VAL_CLOSURE:
+    case TI_VAL_FUTURE:
+    case TI_VAL_MODULE:
+    case TI_VAL_TEMPLATE:
+        break;
+    }
+    *hash = vhash__mix((uint64_t) ((uintptr_t) val));
+    return true;
+}
+
+/*
+ * Create a new value hash set with room for at least `n` values before the
+ * table needs to grow.
+ */
+ti_vhash_t * ti_vhash_create(size_t n)
+{
+    size_t sz = VHASH__MIN_SZ;
+    ti_vhash_t * vhash = malloc(sizeof(ti_vhash_t));
+    if (!vhash)
+        return NULL;
+
+    while (sz < n * 2)
+        sz <<= 1;
+
+    vhash->n = 0;
+    vhash->mask = sz - 1;
+    vhash->others = NULL;
+    vhash->table = calloc(sz, sizeof(ti_vhash_item_t));
+    if (!vhash->table)
+    {
+        free(vhash);
+        return NULL;
+    }
+    return vhash;
+}
+
+void ti_vhash_destroy(ti_vhash_t * vhash)
+{
+    if (!vhash)
+        return;
+    free(vhash->others);
+    free(vhash->table);
+    free(vhash);
+}
+
+static int vhash__grow(ti_vhash_t * vhash)
+{
+    size_t sz = (vhash->mask + 1) << 1, mask = sz - 1;
+    ti_vhash_item_t
+        * item = vhash->table,
+        * end = item + vhash->mask + 1,
+        * table = calloc(sz, sizeof(ti_vhash_item_t));
+
+    if (!table)
+        return -1;
+
+    for (; item < end; ++item)
+    {
+        if (item->val)
+        {
+            size_t i = item->hash & mask;
+            while (table[i].val)
+                i = (i + 1) & mask;
+            table[i] = *item;
+        }
+    }
+
+    free(vhash->table);
+    vhash->table = table;
+    vhash->mask = mask;
+    return 0;
+}
+
+static ti_vhash_item_t * vhash__find(
+        ti_vhash_t * vhash,
+        ti_val_t * val,
+        uint64_t hash)
+{
+    size_t i = hash & vhash->mask;
+    ti_vhash_item_t * item;
+
+    while ((item = vhash->table + i)->val)
+    {
+        if (item->hash == hash && ti_opr_eq(item->val, val))
+            return item;
+        i = (i + 1) & vhash->mask;
+    }
+    return item;  /* empty slot */
+}
+
+static ti_val_t ** vhash__other(ti_vhash_t * vhash, ti_val_t * val)
+{
+    if (vhash->others)
+        for (vec_each_addr(vhash->others, ti_val_t, v))
+            if (ti_opr_eq(*v, val))
+                return v;
+    return NULL;
+}
+
+/*
+ * Add a value to the set. Returns `0` if the value is added, `1` if an equal
+ * value was already in the set, or `-1` in case of an allocation error.
+ */
+int ti_vhash_add(ti_vhash_t * vhash, ti_val_t * val)
+{
+    uint64_t hash;
+    ti_vhash_item_t * item;
+
+    if (!ti_val_hash(val, &hash))
+        return vhash__other(vhash, val)
+                ? 1
+                : vec_push_create(&vhash->others, val);
+
+    item = vhash__find(vhash, val, hash);
+    if (item->val)
+        return 1;
+
+    item->hash = hash;
+    item->val = val;
+
+    return (++vhash->n << 1) > vhash->mask ? vhash__grow(vhash) : 0;
+}
+
+_Bool ti_vhash_has(ti_vhash_t * vhash, ti_val_t * val)
+{
+    uint64_t hash;
+    return ti_val_hash(val, &hash)
+            ? vhash__find(vhash, val, hash)->val != NULL
+            : vhash__other(vhash, val) != NULL;
+}
@@ -25,6 +25,7 @@
 static ti_vtask_t vtask__nil = {
         .ref=1,
         .tp=TI_VAL_TASK,
+        .heap_idx=TI_VTASK_UNSCHEDULED,
 };
 
 ti_vtask_t * ti_vtask_create(
@@ -48,6 +49,7 @@ ti_vtask_t * ti_vtask_create(
     vtask->closure = closure;
     vtask->args = args;
     vtask->verr = verr;
+    vtask->heap_idx = TI_VTASK_UNSCHEDULED;
 
     ti_incref(user);
     ti_incref(closure);
@@ -67,6 +69,7 @@ void ti_vtask_destroy(ti_vtask_t * vtask)
 {
     if (vtask && vtask->id)
     {
+        ti_tasks_unschedule(vtask);
         ti_user_drop(vtask->user);
         ti_closure_drop(vtask->closure);
         ti_verror_drop(vtask->verr);
@@ -194,8 +197,71 @@ int ti_vtask_run(ti_vtask_t * vtask, ti_collection_t * collection)
     return 0;
 }
 
+/*
+ * Run multiple tasks with side effects for the same scope using a single
+ * change. The first task in the given vector runs first. The vector itself is
+ * not used after this call. This function should only be used when this node
+ * is ready, otherwise use ti_vtask_run() for each task.
+ */
+int ti_vtask_run_batch(vec_t * vtasks, ti_collection_t * collection)
+{
+    ex_t e = {0};
+    ti_vtask_t * vtask = vec_first(vtasks);
+    ti_query_t * query;
+
+    assert(ti.node->status == TI_NODE_STAT_READY);
+
+    if (vtasks->n == 1)
+        return ti_vtask_run(vtask, collection);
+
+    query = ti_query_create(0);
+    if (!query || !(query->vtasks = vec_new(vtasks->n - 1)))
+    {
+        log_error(EX_MEMORY_S);
+        ti_query_destroy(query);
+        return -1;
+    }
+
+    query->user = vtask->user;
+    query->with_tp = TI_QUERY_WITH_TASK;
+    query->pkg_id = 0;
+    query->with.vtask = vtask;
+    query->collection = collection;     /* may be NULL */
+    query->qbind.flags |= (collection
+            ? TI_QBIND_FLAG_COLLECTION
+            : TI_QBIND_FLAG_THINGSDB) | TI_QBIND_FLAG_WSE;
+    query->qbind.deep = collection ? collection->deep : ti.t_deep;
+
+    ti_incref(vtask);
+    ti_incref(query->user);
+
+    if (query->collection)
+        ti_incref(query->collection);
+
+    /* the remaining tasks are popped from the end, so add them reversed */
+    for (uint32_t i = vtasks->n; --i;)
+    {
+        ti_vtask_t * vt = VEC_get(vtasks, i);
+        VEC_push(query->vtasks, vt);
+        ti_incref(vt);
+    }
+
+    if (ti_changes_create_new_change(query, &e))
+    {
+        log_error("%s", e.msg);
+        ti_query_destroy(query);
+        return -1;
+    }
+
+    for (vec_each(vtasks, ti_vtask_t, vt))
+        vt->flags |= TI_VTASK_FLAG_RUNNING;
+
+    return 0;
+}
+
 static void vtask__clear(ti_vtask_t * vtask)
 {
+    ti_tasks_unschedule(vtask);
     ti_user_drop(vtask->user);
     ti_closure_drop(vtask->closure);
     ti_verror_drop(vtask->verr);
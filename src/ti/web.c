@@ -1,10 +1,12 @@
 /*
  * ti/web.c
  *
- * Exposes a status, healthy and ready handler.
+ * Exposes a status, healthy, ready and metrics handler.
  */
 #include <ti/web.h>
 #include <ti.h>
+#include <ti/metrics.h>
+#include <util/buf.h>
 #include <util/logger.h>
 
 #define OK_RESPONSE \
@@ -56,6 +58,12 @@
     "\r\n" \
     "READY\n"
 
+#define METRICS_HEADER \
+    "HTTP/1.1 200 OK\r\n" \
+    "Content-Type: text/plain; version=0.0.4\r\n" \
+    "Content-Length: %zu\r\n" \
+    "\r\n"
+
 /* static response buffers */
 static uv_buf_t web__uv_ok_buf;
 static uv_buf_t web__uv_nok_buf;
@@ -71,6 +79,7 @@ static http_parser_settings web__settings;
 static void web__close_cb(uv_handle_t * handle)
 {
     ti_web_request_t * web_request = handle->data;
+    free(web_request->buf.base);
     free(web_request);
 }
 
@@ -212,6 +221,10 @@ static int web__url_cb(http_parser * parser, const char * at, size_t length)
         : (length == 8 && memcmp(at, "/healthy", 8) == 0)
         ? &web__uv_ok_buf
 
+        /* metrics response, created when the request is complete */
+        : (length == 8 && memcmp(at, "/metrics", 8) == 0)
+        ? &web_request->buf
+
         /* everything else */
         : &web__uv_nfound_buf;
 
@@ -228,10 +241,51 @@ static void web__write_cb(uv_write_t * req, int status)
     ti_web_close((ti_web_request_t *) req->handle->data);
 }
 
+/*
+ * Create the metrics response in the request buffer. The body is created
+ * first since the header requires the content length.
+ */
+static uv_buf_t * web__get_metrics_response(ti_web_request_t * web_request)
+{
+    buf_t body;
+    char header[128];
+    int n;
+
+    buf_init(&body);
+
+    if (ti_metrics_to_buf(&body))
+        goto fail;
+
+    n = snprintf(header, sizeof(header), METRICS_HEADER, body.len);
+    if (n < 0 || (size_t) n >= sizeof(header))
+        goto fail;
+
+    web_request->buf.base = malloc(n + body.len);
+    if (!web_request->buf.base)
+        goto fail;
+
+    memcpy(web_request->buf.base, header, n);
+    memcpy(web_request->buf.base + n, body.data, body.len);
+    web_request->buf.len = n + body.len;
+
+    free(body.data);
+    return &web_request->buf;
+
+fail:
+    log_error("failed to create the metrics response");
+    free(body.data);
+    return &web__uv_nok_buf;
+}
+
 static int web__message_complete_cb(http_parser * parser)
 {
     ti_web_request_t * web_request = parser->data;
 
+    if (web_request->response == &web_request->buf)
+        web_request->response = parser->method == HTTP_GET
+                ? web__get_metrics_response(web_request)
+                : &web__uv_mna_buf;
+
     (void) uv_write(
             &web_request->req,
             &web_request->uvstream,
@@ -271,6 +325,7 @@ static void web__connection_cb(uv_stream_t * server, int status)
     web_request->uvstream.data = web_request;
     web_request->parser.data = web_request;
     web_request->response = &web__uv_nfound_buf;
+    web_request->buf = uv_buf_init(NULL, 0);
 
     rc = uv_accept(server, &web_request->uvstream);
     if (rc)
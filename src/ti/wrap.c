@@ -8,6 +8,7 @@
 #include <ti/closure.h>
 #include <ti/field.h>
 #include <ti/future.h>
+#include <ti/map.h>
 #include <ti/mapping.h>
 #include <ti/member.h>
 #include <ti/member.t.h>
@@ -27,6 +28,11 @@
 #include <util/vec.h>
 #include <util/logger.h>
 
+/*
+ * Objects are wrapped using a temporary array with the matching properties;
+ * this array is allocated on the stack unless the type has more fields.
+ */
+#define WRAP__MAP_PROPS_STACK 16
 
 ti_wrap_t * ti_wrap_create(ti_thing_t * thing, uint16_t type_id)
 {
@@ -403,6 +409,16 @@ int ti__wrap_methods_to_pk(
     return rc;
 }
 
+static inline _Bool wrap__mapping_skip(
+        const ti_mapping_t * mapping,
+        ti_val_t * val)
+{
+    return (
+        ((mapping->skip & TI_FIELD_FLAG_SKIP_FALSE) && !ti_val_as_bool(val)) ||
+        ((mapping->skip & TI_FIELD_FLAG_SKIP_NIL) && ti_val_is_nil(val))
+    );
+}
+
 static int wrap__field_thing(
         ti_thing_t * thing,
         ti_vp_t * vp,
@@ -431,8 +447,11 @@ static int wrap__field_thing(
             ti_field_t * field;
             ti_prop_t * prop;
         } map_prop_t;
+        map_prop_t map_stack[WRAP__MAP_PROPS_STACK];
         size_t n = ti_min(t_type->fields->n, ti_thing_n(thing));
-        map_prop_t * map_props = malloc(sizeof(map_prop_t) * n);
+        map_prop_t * map_props = n > WRAP__MAP_PROPS_STACK
+                ? malloc(sizeof(map_prop_t) * n)
+                : map_stack;
         map_prop_t * map_set = map_props;
         map_prop_t * map_get = map_props;
         if (!map_props)
@@ -462,7 +481,8 @@ static int wrap__field_thing(
          */
         if (wrap__id_to_pk(thing, t_type, &vp->pk, n + nm, flags))
         {
-            free(map_props);
+            if (map_props != map_stack)
+                free(map_props);
             goto fail;
         }
 
@@ -483,101 +503,58 @@ static int wrap__field_thing(
                         ti_field_deep(map_get->field, deep),
                         flags | ti_field_ret_flags(map_get->field))
             ) {
-                free(map_props);
+                if (map_props != map_stack)
+                    free(map_props);
                 goto fail;
             }
         }
 
-        free(map_props);
+        if (map_props != map_stack)
+            free(map_props);
     }
     else
     {
         /*
-         * Type mappings are only created the first time a conversion from
-         * `to_type` -> `from_type` is asked so most likely the mappings are
+         * The compiled map is only created the first time a conversion from
+         * `to_type` -> `from_type` is asked so most likely the map is
          * returned from cache.
          */
         register const ti_map_t * map = ti_type_map(t_type, thing->via.type);
+        register const ti_mapping_t * mapping, * end;
+        ti_val_t ** vals = (ti_val_t **) thing->items.vec->data;
+        size_t skip = 0;
+
         if (!map)
             goto fail;
 
+        end = map->mappings + map->n;
+
         if (map->can_skip)
-        {
-            size_t skip = 0;
-            ti_val_t * val;
-
-            for (vec_each(map->mappings, ti_mapping_t, mapping))
-                skip += (
-                    (mapping->t_field->flags & TI_FIELD_FLAG_SKIP_FALSE) &&
-                    !ti_val_as_bool(
-                        VEC_get(thing->items.vec, mapping->f_field->idx)
-                    )
-                ) || (
-                    (mapping->t_field->flags & TI_FIELD_FLAG_SKIP_NIL) &&
-                    ti_val_is_nil(
-                        VEC_get(thing->items.vec, mapping->f_field->idx)
-                    )
-                );
+            for (mapping = map->mappings; mapping < end; ++mapping)
+                skip += wrap__mapping_skip(mapping, vals[mapping->f_idx]);
 
-            if (wrap__id_to_pk(
-                    thing,
-                    t_type,
-                    &vp->pk,
-                    map->mappings->n + nm - skip,
-                    flags))
-                goto fail;
+        if (wrap__id_to_pk(thing, t_type, &vp->pk, map->n + nm - skip, flags))
+            goto fail;
 
-            for (vec_each(map->mappings, ti_mapping_t, mapping))
-            {
-                val = VEC_get(thing->items.vec, mapping->f_field->idx);
-
-                if ((
-                    (mapping->t_field->flags & TI_FIELD_FLAG_SKIP_FALSE) &&
-                    !ti_val_as_bool(val)) || (
-                    (mapping->t_field->flags & TI_FIELD_FLAG_SKIP_NIL) &&
-                    ti_val_is_nil(val)))
-                    continue;
-
-                if (mp_pack_strn(
-                            &vp->pk,
-                            mapping->f_field->name->str,
-                            mapping->f_field->name->n) ||
-                        wrap__field_val(
-                            mapping->t_field,
-                            &mapping->t_field->spec,
-                            val,
-                            vp,
-                            ti_field_deep(mapping->t_field, deep),
-                            flags | ti_field_ret_flags(mapping->t_field))
-                ) goto fail;
-            }
-        }
-        else
+        for (mapping = map->mappings; mapping < end; ++mapping)
         {
-            /* scenario where the type has no skippable fields */
-            if (wrap__id_to_pk(
-                    thing,
-                    t_type,
-                    &vp->pk,
-                    map->mappings->n + nm,
-                    flags))
-                goto fail;
+            ti_val_t * val = vals[mapping->f_idx];
 
-            for (vec_each(map->mappings, ti_mapping_t, mapping))
-            {
-                if (mp_pack_strn(
-                            &vp->pk,
-                            mapping->f_field->name->str,
-                            mapping->f_field->name->n) ||
-                        wrap__field_val(
-                            mapping->t_field,
-                            &mapping->t_field->spec,
-                            VEC_get(thing->items.vec, mapping->f_field->idx),
-                            vp,
-                            ti_field_deep(mapping->t_field, deep),
-                            flags | ti_field_ret_flags(mapping->t_field))
-                ) goto fail;
-            }
+            if (skip && wrap__mapping_skip(mapping, val))
+                continue;
+
+            if (mp_pack_strn(
+                        &vp->pk,
+                        mapping->name->str,
+                        mapping->name->n) ||
+                    wrap__field_val(
+                        mapping->t_field,
+                        &mapping->t_field->spec,
+                        val,
+                        vp,
+                        ti_field_deep(mapping->t_field, deep),
+                        flags | ti_field_ret_flags(mapping->t_field))
+            ) goto fail;
         }
     }
 
@@ -333,3 +333,97 @@ done:
     free(buf);
     return is_true;
 }
+
+/*
+ * Copy file `src` to `dst`. An existing file `dst` will be overwritten.
+ */
+int fx_copy(const char * src, const char * dst)
+{
+    int rc = 0;
+    char buf[8192];
+    size_t n;
+    FILE * fsrc, * fdst;
+
+    fsrc = fopen(src, "r");
+    if (!fsrc)
+    {
+        log_errno_file("cannot open file", errno, src);
+        return -1;
+    }
+
+    fdst = fopen(dst, "w");
+    if (!fdst)
+    {
+        log_errno_file("cannot open file", errno, dst);
+        rc = -1;
+        goto done;
+    }
+
+    while ((n = fread(buf, 1, sizeof(buf), fsrc)))
+    {
+        if (fwrite(buf, 1, n, fdst) != n)
+        {
+            log_error("cannot write %zu bytes to `%s`", n, dst);
+            rc = -1;
+            break;
+        }
+    }
+
+    if (ferror(fsrc))
+    {
+        log_error("cannot read from file `%s`", src);
+        rc = -1;
+    }
+
+    if (fclose(fdst))
+    {
+        log_errno_file("cannot close file", errno, dst);
+        rc = -1;
+    }
+
+done:
+    if (fclose(fsrc))
+        log_errno_file("cannot close file", errno, src);
+
+    return rc;
+}
+
+/*
+ * Returns `true` when both files exist and have equal content.
+ */
+_Bool fx_equal(const char * fn1, const char * fn2)
+{
+    _Bool is_equal = false;
+    char buf1[8192], buf2[8192];
+    size_t n;
+    struct stat st1, st2;
+    FILE * fp1, * fp2;
+
+    if (stat(fn1, &st1) || stat(fn2, &st2) || st1.st_size != st2.st_size)
+        return false;
+
+    fp1 = fopen(fn1, "r");
+    if (!fp1)
+        return false;
+
+    fp2 = fopen(fn2, "r");
+    if (!fp2)
+        goto done;
+
+    do
+    {
+        n = fread(buf1, 1, sizeof(buf1), fp1);
+        if (fread(buf2, 1, sizeof(buf2), fp2) != n ||
+            memcmp(buf1, buf2, n))
+            goto stop;
+    }
+    while (n);
+
+    is_equal = !ferror(fp1) && !ferror(fp2);
+
+stop:
+    (void) fclose(fp2);
+done:
+    (void) fclose(fp1);
+    return is_equal;
+}
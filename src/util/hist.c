@@ -0,0 +1,91 @@
+/*
+ * util/hist.c
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <util/hist.h>
+
+static inline uint32_t hist__idx(uint64_t usec)
+{
+    uint32_t e;
+
+    if (usec < HIST_SUB)
+        return (uint32_t) usec;
+
+    e = 63 - __builtin_clzll(usec);
+    if (e > HIST_MAX_BITS)
+        return HIST_BUCKETS - 1;
+
+    /* bucket for the power of two, plus the sub-bucket within */
+    return (e - HIST_SUB_BITS + 1) * HIST_SUB +
+            (uint32_t) ((usec >> (e - HIST_SUB_BITS)) & (HIST_SUB - 1));
+}
+
+/*
+ * Returns the highest value in micro-seconds which is recorded in a bucket.
+ */
+static inline uint64_t hist__upper(uint32_t idx)
+{
+    uint32_t e, m;
+
+    if (idx < HIST_SUB)
+        return idx;
+
+    e = idx / HIST_SUB + HIST_SUB_BITS - 1;
+    m = idx % HIST_SUB;
+    return ((uint64_t) (HIST_SUB + m + 1) << (e - HIST_SUB_BITS)) - 1;
+}
+
+hist_t * hist_create(void)
+{
+    return calloc(1, sizeof(hist_t));
+}
+
+void hist_destroy(hist_t * hist)
+{
+    free(hist);
+}
+
+void hist_reset(hist_t * hist)
+{
+    memset(hist, 0, sizeof(hist_t));
+}
+
+void hist_add(hist_t * hist, double duration)
+{
+    uint64_t usec = duration > 0.0 ? (uint64_t) (duration * 1000000.0) : 0;
+
+    ++hist->buckets[hist__idx(usec)];
+    ++hist->count;
+    hist->sum += duration;
+    if (duration > hist->max)
+        hist->max = duration;
+}
+
+/*
+ * Returns the value in seconds for quantile `q` (0.0 .. 1.0), or 0.0 when the
+ * histogram is empty. The result never exceeds the largest recorded value.
+ */
+double hist_quantile(hist_t * hist, double q)
+{
+    uint64_t rank, seen = 0;
+    double val;
+
+    if (!hist->count)
+        return 0.0;
+
+    rank = (uint64_t) (q * (double) hist->count + 0.5);
+    if (rank < 1)
+        rank = 1;
+
+    for (uint32_t i = 0; i < HIST_BUCKETS; ++i)
+    {
+        seen += hist->buckets[i];
+        if (seen >= rank)
+        {
+            val = (double) hist__upper(i) / 1000000.0;
+            return val < hist->max ? val : hist->max;
+        }
+    }
+    return hist->max;
+}
@@ -541,6 +541,86 @@ int imap_walk(imap_t * imap, imap_cb cb, void * arg)
     return rc;
 }
 
+static int imap__walk_after(
+        imap_node_t * node,
+        uint64_t id,
+        imap_cb cb,
+        void * arg);
+
+static int imap__walk_after_nd(
+        imap_node_t * nd,
+        imap_node_t * end,
+        uint64_t id,
+        imap_cb cb,
+        void * arg)
+{
+    int rc;
+
+    /* node `nd` is on the path of `id`; when `id` is zero, the data of `nd`
+     * belongs to `id` itself, otherwise the data is walked before `id` */
+    if (nd->nodes && (rc = id
+            ? imap__walk_after(nd, id - 1, cb, arg)
+            : imap__walk(nd, cb, arg)))
+        return rc;
+
+    while (++nd < end)
+    {
+        if (nd->data && (rc = (*cb)(nd->data, arg)))
+            return rc;
+
+        if (nd->nodes && (rc = imap__walk(nd, cb, arg)))
+            return rc;
+    }
+
+    return 0;
+}
+
+static int imap__walk_after(
+        imap_node_t * node,
+        uint64_t id,
+        imap_cb cb,
+        void * arg)
+{
+    uint8_t key = id % IMAP_NODE_SZ;
+
+    if (node->key == IMAP_NODE_SZ)
+        return imap__walk_after_nd(
+                node->nodes + key,
+                node->nodes + IMAP_NODE_SZ,
+                id / IMAP_NODE_SZ,
+                cb,
+                arg);
+
+    if (node->key == key)
+        return imap__walk_after_nd(
+                node->nodes,
+                node->nodes + 1,
+                id / IMAP_NODE_SZ,
+                cb,
+                arg);
+
+    /* the only child node is either before or after the given id */
+    return node->key > key ? imap__walk(node, cb, arg) : 0;
+}
+
+/*
+ * Run the call-back function on all items which are walked after the given
+ * id by imap_walk(). The id does not need to exist in the map which makes it
+ * possible to continue a walk in steps, even when the map has changed.
+ *
+ * Walking stops on the first callback returning a non zero value.
+ * The return value is the last callback result.
+ */
+int imap_walk_after(imap_t * imap, uint64_t id, imap_cb cb, void * arg)
+{
+    return imap->n ? imap__walk_after_nd(
+            imap->nodes + (id % IMAP_NODE_SZ),
+            imap->nodes + IMAP_NODE_SZ,
+            id / IMAP_NODE_SZ,
+            cb,
+            arg) : 0;
+}
+
 int imap_walk_cp(
         imap_t * imap,
         imap_cb cb,
@@ -0,0 +1,563 @@
+/*
+ * util/jsonp.c
+ */
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <util/jsonp.h>
+#include <util/strx.h>
+
+enum
+{
+    JSONP__VALUE,           /* expect a value */
+    JSONP__VALUE_OR_END,    /* expect a value or the end of an array */
+    JSONP__KEY,             /* expect a key */
+    JSONP__KEY_OR_END,      /* expect a key or the end of a map */
+    JSONP__NEXT,            /* expect `,` or the end of a map or array */
+    JSONP__DONE,            /* expect the end of the document */
+    JSONP__ERR,             /* an error has occurred */
+};
+
+enum
+{
+    JSONP__MAP,
+    JSONP__ARR,
+};
+
+#define JSONP__ONES 0x0101010101010101ULL
+#define JSONP__HIGH 0x8080808080808080ULL
+
+/* non-zero when one of the bytes in `x` is zero */
+#define JSONP__HAS_ZERO(x) (((x) - JSONP__ONES) & ~(x) & JSONP__HIGH)
+
+/* non-zero when one of the bytes in `x` is less than `n`, with n <= 128 */
+#define JSONP__HAS_LESS(x, n) (((x) - JSONP__ONES * (n)) & ~(x) & JSONP__HIGH)
+
+#define JSONP__IS_DIGIT(c) ((c) >= '0' && (c) <= '9')
+
+static jsonp_tp_t jsonp__err(jsonp_t * jp, jsonp_err_t err, const char * msg)
+{
+    jp->err = err;
+    jp->errmsg = msg;
+    jp->state_ = JSONP__ERR;
+    return JSONP_ERR;
+}
+
+static inline jsonp_tp_t jsonp__eof(jsonp_t * jp)
+{
+    return jsonp__err(jp, JSONP_ERR_SYNTAX, "parse error: premature EOF");
+}
+
+static inline void jsonp__skip_ws(jsonp_t * jp)
+{
+    while (jp->pt_ < jp->end_)
+    {
+        switch (*jp->pt_)
+        {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            ++jp->pt_;
+            continue;
+        }
+        return;
+    }
+}
+
+static int jsonp__reserve(jsonp_t * jp, size_t sz)
+{
+    char * buf;
+    if (sz <= jp->sz_)
+        return 0;
+
+    if (sz < jp->sz_ * 2)
+        sz = jp->sz_ * 2;
+
+    buf = realloc(jp->buf_, sz);
+    if (!buf)
+        return -1;
+
+    jp->buf_ = buf;
+    jp->sz_ = sz;
+    return 0;
+}
+
+static inline int jsonp__hex4(
+        const unsigned char ** pt,
+        const unsigned char * end,
+        uint32_t * cp)
+{
+    const unsigned char * p = *pt;
+    uint32_t v = 0;
+
+    if (end - p < 4)
+        return -1;
+
+    for (int i = 0; i < 4; ++i, ++p)
+    {
+        unsigned char c = *p, l = c | 0x20;
+        v <<= 4;
+        if (JSONP__IS_DIGIT(c))
+            v |= c - '0';
+        else if (l >= 'a' && l <= 'f')
+            v |= l - 'a' + 10;
+        else
+            return -1;
+    }
+
+    *pt = p;
+    *cp = v;
+    return 0;
+}
+
+static inline size_t jsonp__utf8(char * s, uint32_t cp)
+{
+    if (cp < 0x80)
+    {
+        s[0] = (char) cp;
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        s[0] = (char) (0xc0 | (cp >> 6));
+        s[1] = (char) (0x80 | (cp & 0x3f));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        s[0] = (char) (0xe0 | (cp >> 12));
+        s[1] = (char) (0x80 | ((cp >> 6) & 0x3f));
+        s[2] = (char) (0x80 | (cp & 0x3f));
+        return 3;
+    }
+    s[0] = (char) (0xf0 | (cp >> 18));
+    s[1] = (char) (0x80 | ((cp >> 12) & 0x3f));
+    s[2] = (char) (0x80 | ((cp >> 6) & 0x3f));
+    s[3] = (char) (0x80 | (cp & 0x3f));
+    return 4;
+}
+
+/*
+ * Slow path for strings with escape sequences; the string is unescaped into
+ * the buffer of the parser, starting with the part which is already scanned.
+ */
+static jsonp_tp_t jsonp__str_esc(
+        jsonp_t * jp,
+        jsonp_tp_t tp,
+        const unsigned char * start,
+        const unsigned char * pt,
+        uint64_t high)
+{
+    const unsigned char * end = (const unsigned char *) jp->end_;
+    size_t n = pt - start;
+
+    if (jsonp__reserve(jp, n + 64))
+        goto alloc;
+
+    memcpy(jp->buf_, start, n);
+
+    while (1)
+    {
+        unsigned char c;
+        uint32_t cp;
+
+        /* at most 4 bytes are written for each loop */
+        if (n + 4 > jp->sz_ && jsonp__reserve(jp, n + 4))
+            goto alloc;
+
+        if (pt == end)
+            return jsonp__eof(jp);
+
+        c = *pt++;
+        if (c == '"')
+            break;
+
+        if (c < 0x20)
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "lexical error: invalid character inside string.");
+
+        if (c != '\\')
+        {
+            high |= c;
+            jp->buf_[n++] = (char) c;
+            continue;
+        }
+
+        if (pt == end)
+            return jsonp__eof(jp);
+
+        switch ((c = *pt++))
+        {
+        case '"':
+        case '\\':
+        case '/':
+            break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case 'n': c = '\n'; break;
+        case 'r': c = '\r'; break;
+        case 't': c = '\t'; break;
+        case 'u':
+            if (jsonp__hex4(&pt, end, &cp))
+                return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                        "lexical error: invalid (non-hex) character occurs "
+                        "after '\\u' inside string.");
+
+            if (cp >= 0xd800 && cp <= 0xdbff)
+            {
+                /* like yajl, a lone surrogate is replaced with `?` */
+                const unsigned char * p = pt;
+                uint32_t lo;
+                if (end - p >= 6 && p[0] == '\\' && p[1] == 'u' &&
+                    (p += 2, jsonp__hex4(&p, end, &lo) == 0) &&
+                    lo >= 0xdc00 && lo <= 0xdfff)
+                {
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                    pt = p;
+                }
+                else
+                    cp = '?';
+            }
+            else if (cp >= 0xdc00 && cp <= 0xdfff)
+                cp = '?';
+
+            n += jsonp__utf8(jp->buf_ + n, cp);
+            continue;
+        default:
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "lexical error: inside a string, '\\' occurs before a "
+                    "character which it may not.");
+        }
+        jp->buf_[n++] = (char) c;
+    }
+
+    if ((high & JSONP__HIGH) && !strx_is_utf8n(jp->buf_, n))
+        return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                "lexical error: invalid bytes in UTF8 string.");
+
+    jp->str = jp->buf_;
+    jp->n = n;
+    jp->pt_ = (const char *) pt;
+    return tp;
+
+alloc:
+    return jsonp__err(jp, JSONP_ERR_ALLOC, "allocation error");
+}
+
+/*
+ * Read a string; the position must be just after the opening double quote.
+ * The string is scanned eight bytes at a time until a word is found with a
+ * double quote, backslash or control character.
+ */
+static jsonp_tp_t jsonp__str(jsonp_t * jp, jsonp_tp_t tp)
+{
+    const unsigned char * start = (const unsigned char *) jp->pt_;
+    const unsigned char * end = (const unsigned char *) jp->end_;
+    const unsigned char * pt = start;
+    uint64_t high = 0;
+    size_t n;
+
+    while (1)
+    {
+        unsigned char c;
+
+        while (end - pt >= 8)
+        {
+            uint64_t x;
+            memcpy(&x, pt, 8);
+            if (JSONP__HAS_ZERO(x ^ (JSONP__ONES * '"')) ||
+                JSONP__HAS_ZERO(x ^ (JSONP__ONES * '\\')) ||
+                JSONP__HAS_LESS(x, 0x20))
+                break;
+            high |= x;
+            pt += 8;
+        }
+
+        if (pt == end)
+            return jsonp__eof(jp);
+
+        c = *pt;
+        if (c == '"')
+            break;
+
+        if (c == '\\')
+            return jsonp__str_esc(jp, tp, start, pt, high);
+
+        if (c < 0x20)
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "lexical error: invalid character inside string.");
+        high |= c;
+        ++pt;
+    }
+
+    n = pt - start;
+    if ((high & JSONP__HIGH) && !strx_is_utf8n((const char *) start, n))
+        return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                "lexical error: invalid bytes in UTF8 string.");
+
+    jp->str = (const char *) start;
+    jp->n = n;
+    jp->pt_ = (const char *) pt + 1;
+    return tp;
+}
+
+static jsonp_tp_t jsonp__num(jsonp_t * jp)
+{
+    const char * start = jp->pt_, * end = jp->end_, * pt = start, * digits;
+    bool is_neg = *pt == '-', is_float = false;
+    uint64_t u = 0;
+    size_t n;
+
+    pt += is_neg;
+    digits = pt;
+
+    if (pt < end && *pt == '0')
+        ++pt;
+    else if (pt < end && JSONP__IS_DIGIT(*pt))
+        while (++pt < end && JSONP__IS_DIGIT(*pt));
+    else
+        return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                "lexical error: malformed number, a digit is required after "
+                "the minus sign.");
+
+    if (pt < end && *pt == '.')
+    {
+        is_float = true;
+        if (++pt == end || !JSONP__IS_DIGIT(*pt))
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "lexical error: malformed number, a digit is required "
+                    "after the decimal point.");
+        while (++pt < end && JSONP__IS_DIGIT(*pt));
+    }
+
+    if (pt < end && (*pt == 'e' || *pt == 'E'))
+    {
+        is_float = true;
+        if (++pt < end && (*pt == '+' || *pt == '-'))
+            ++pt;
+        if (pt == end || !JSONP__IS_DIGIT(*pt))
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "lexical error: malformed number, a digit is required "
+                    "after the exponent.");
+        while (++pt < end && JSONP__IS_DIGIT(*pt));
+    }
+
+    jp->pt_ = pt;
+
+    if (is_float)
+    {
+        /* strtod() requires a null terminated string */
+        n = pt - start;
+        if (jsonp__reserve(jp, n + 1))
+            return jsonp__err(jp, JSONP_ERR_ALLOC, "allocation error");
+
+        memcpy(jp->buf_, start, n);
+        jp->buf_[n] = '\0';
+
+        errno = 0;
+        jp->via.f64 = strtod(jp->buf_, NULL);
+        if (errno == ERANGE && isinf(jp->via.f64))
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "parse error: numeric (floating point) overflow");
+        return JSONP_FLOAT;
+    }
+
+    for (; digits < pt; ++digits)
+    {
+        uint64_t d = (uint64_t) (*digits - '0');
+        if (u > (UINT64_MAX - d) / 10)
+            goto overflow;
+        u = u * 10 + d;
+    }
+
+    if (is_neg)
+    {
+        if (u > (uint64_t) INT64_MAX + 1)
+            goto overflow;
+        jp->via.i64 = u == (uint64_t) INT64_MAX + 1 ? INT64_MIN : -(int64_t) u;
+    }
+    else
+    {
+        if (u > INT64_MAX)
+            goto overflow;
+        jp->via.i64 = (int64_t) u;
+    }
+    return JSONP_INT;
+
+overflow:
+    return jsonp__err(jp, JSONP_ERR_SYNTAX, "parse error: integer overflow");
+}
+
+static inline jsonp_tp_t jsonp__lit(
+        jsonp_t * jp,
+        const char * lit,
+        size_t n,
+        jsonp_tp_t tp)
+{
+    if ((size_t) (jp->end_ - jp->pt_) < n || memcmp(jp->pt_, lit, n))
+        return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                "lexical error: invalid string in json text.");
+    jp->pt_ += n;
+    return tp;
+}
+
+static inline jsonp_tp_t jsonp__push(
+        jsonp_t * jp,
+        uint8_t kind,
+        int state,
+        jsonp_tp_t tp)
+{
+    if (jp->deep + 1 >= JSONP_MAX_DEPTH)
+        return jsonp__err(jp, JSONP_ERR_MAX_DEPTH, "JSON max depth exceeded");
+
+    jp->stack_[++jp->deep] = kind;
+    jp->state_ = state;
+    ++jp->pt_;
+    return tp;
+}
+
+static inline jsonp_tp_t jsonp__pop(jsonp_t * jp, jsonp_tp_t tp)
+{
+    jp->state_ = --jp->deep ? JSONP__NEXT : JSONP__DONE;
+    ++jp->pt_;
+    return tp;
+}
+
+void jsonp_init(jsonp_t * jp, const void * data, size_t n)
+{
+    jp->str = NULL;
+    jp->n = 0;
+    jp->errmsg = NULL;
+    jp->err = JSONP_ERR_NONE;
+    jp->deep = 0;
+    jp->pt_ = data;
+    jp->end_ = jp->pt_ + n;
+    jp->buf_ = NULL;
+    jp->sz_ = 0;
+    jp->state_ = JSONP__VALUE;
+}
+
+void jsonp_clear(jsonp_t * jp)
+{
+    free(jp->buf_);
+    jp->buf_ = NULL;
+    jp->sz_ = 0;
+}
+
+jsonp_tp_t jsonp_next(jsonp_t * jp)
+{
+    jsonp__skip_ws(jp);
+
+    switch (jp->state_)
+    {
+    case JSONP__NEXT:
+        if (jp->pt_ == jp->end_)
+            return jsonp__eof(jp);
+
+        switch (*jp->pt_)
+        {
+        case ',':
+            ++jp->pt_;
+            jsonp__skip_ws(jp);
+            if (jp->stack_[jp->deep] == JSONP__MAP)
+                goto key;
+            goto value;
+        case '}':
+            if (jp->stack_[jp->deep] == JSONP__MAP)
+                return jsonp__pop(jp, JSONP_MAP_END);
+            break;
+        case ']':
+            if (jp->stack_[jp->deep] == JSONP__ARR)
+                return jsonp__pop(jp, JSONP_ARR_END);
+            break;
+        }
+        return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                jp->stack_[jp->deep] == JSONP__MAP
+                ? "parse error: after key and value, inside map, "
+                  "I expect ',' or '}'"
+                : "parse error: after array element, I expect ',' or ']'");
+
+    case JSONP__KEY_OR_END:
+        if (jp->pt_ < jp->end_ && *jp->pt_ == '}')
+            return jsonp__pop(jp, JSONP_MAP_END);
+        /* fall through */
+    case JSONP__KEY:
+    key:
+        if (jp->pt_ == jp->end_)
+            return jsonp__eof(jp);
+
+        if (*jp->pt_ != '"')
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "parse error: invalid object key (must be a string)");
+
+        ++jp->pt_;
+        if (jsonp__str(jp, JSONP_KEY) == JSONP_ERR)
+            return JSONP_ERR;
+
+        jsonp__skip_ws(jp);
+        if (jp->pt_ == jp->end_)
+            return jsonp__eof(jp);
+
+        if (*jp->pt_ != ':')
+            return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                    "parse error: object key and value must be separated by "
+                    "a colon (':')");
+
+        ++jp->pt_;
+        jp->state_ = JSONP__VALUE;
+        return JSONP_KEY;
+
+    case JSONP__VALUE_OR_END:
+        if (jp->pt_ < jp->end_ && *jp->pt_ == ']')
+            return jsonp__pop(jp, JSONP_ARR_END);
+        /* fall through */
+    case JSONP__VALUE:
+    value:
+        if (jp->pt_ == jp->end_)
+        {
+            if (jp->deep)
+                return jsonp__eof(jp);
+
+            /* an empty document */
+            jp->state_ = JSONP__DONE;
+            return JSONP_END;
+        }
+
+        jp->state_ = jp->deep ? JSONP__NEXT : JSONP__DONE;
+
+        switch (*jp->pt_)
+        {
+        case '{':
+            return jsonp__push(
+                    jp, JSONP__MAP, JSONP__KEY_OR_END, JSONP_MAP_START);
+        case '[':
+            return jsonp__push(
+                    jp, JSONP__ARR, JSONP__VALUE_OR_END, JSONP_ARR_START);
+        case '"':
+            ++jp->pt_;
+            return jsonp__str(jp, JSONP_STR);
+        case 't':
+            return jsonp__lit(jp, "true", 4, JSONP_TRUE);
+        case 'f':
+            return jsonp__lit(jp, "false", 5, JSONP_FALSE);
+        case 'n':
+            return jsonp__lit(jp, "null", 4, JSONP_NULL);
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return jsonp__num(jp);
+        }
+        return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                "lexical error: invalid char in json text.");
+
+    case JSONP__DONE:
+        if (jp->pt_ == jp->end_)
+            return JSONP_END;
+        return jsonp__err(jp, JSONP_ERR_SYNTAX,
+                "parse error: trailing garbage");
+    }
+    return JSONP_ERR;
+}
@@ -0,0 +1,142 @@
+/*
+ * util/ptrmap.c
+ */
+#include <stdlib.h>
+#include <util/ptrmap.h>
+
+static inline size_t ptrmap__hash(const void * a, const void * b)
+{
+    uint64_t h = (uint64_t) (uintptr_t) a * 0x9e3779b97f4a7c15ULL;
+    h ^= (uint64_t) (uintptr_t) b + (h >> 29);
+    h *= 0xbf58476d1ce4e5b9ULL;
+    return (size_t) (h ^ (h >> 32));
+}
+
+static ptrmap__t * ptrmap__slot(
+        ptrmap_t * ptrmap,
+        const void * a,
+        const void * b)
+{
+    size_t i = ptrmap__hash(a, b) & ptrmap->mask_;
+    for (;; i = (i + 1) & ptrmap->mask_)
+    {
+        ptrmap__t * slot = ptrmap->slots_ + i;
+        if (!slot->data_ || (slot->a_ == a && slot->b_ == b))
+            return slot;
+    }
+}
+
+static int ptrmap__resize(ptrmap_t * ptrmap, size_t sz)
+{
+    ptrmap__t * slots = ptrmap->slots_;
+    size_t n = ptrmap->mask_ + 1;
+
+    ptrmap->slots_ = calloc(sz, sizeof(ptrmap__t));
+    if (!ptrmap->slots_)
+    {
+        ptrmap->slots_ = slots;
+        return -1;
+    }
+    ptrmap->mask_ = sz - 1;
+
+    for (ptrmap__t * slot = slots, * end = slots + n; slot < end; ++slot)
+        if (slot->data_)
+            *ptrmap__slot(ptrmap, slot->a_, slot->b_) = *slot;
+
+    free(slots);
+    return 0;
+}
+
+ptrmap_t * ptrmap_create(void)
+{
+    ptrmap_t * ptrmap = malloc(sizeof(ptrmap_t));
+    if (!ptrmap)
+        return NULL;
+
+    ptrmap->slots_ = calloc(PTRMAP_MIN_SZ, sizeof(ptrmap__t));
+    if (!ptrmap->slots_)
+    {
+        free(ptrmap);
+        return NULL;
+    }
+
+    ptrmap->n = 0;
+    ptrmap->mask_ = PTRMAP_MIN_SZ - 1;
+    return ptrmap;
+}
+
+void ptrmap_destroy(ptrmap_t * ptrmap)
+{
+    if (!ptrmap)
+        return;
+    free(ptrmap->slots_);
+    free(ptrmap);
+}
+
+void * ptrmap_get(ptrmap_t * ptrmap, const void * a, const void * b)
+{
+    return ptrmap__slot(ptrmap, a, b)->data_;
+}
+
+/*
+ * Set `data` for the given key; an existing value will be overwritten.
+ * Returns 0 when successful or -1 in case of an allocation error.
+ */
+int ptrmap_set(ptrmap_t * ptrmap, const void * a, const void * b, void * data)
+{
+    ptrmap__t * slot;
+
+    /* the load factor is kept at 1/2 at most */
+    if ((ptrmap->n + 1) * 2 > ptrmap->mask_ + 1 &&
+        ptrmap__resize(ptrmap, (ptrmap->mask_ + 1) * 2))
+        return -1;
+
+    slot = ptrmap__slot(ptrmap, a, b);
+    if (!slot->data_)
+    {
+        slot->a_ = a;
+        slot->b_ = b;
+        ++ptrmap->n;
+    }
+    slot->data_ = data;
+    return 0;
+}
+
+/*
+ * Remove the entry for the given key and return its value, or NULL if the
+ * key was not found.
+ */
+void * ptrmap_pop(ptrmap_t * ptrmap, const void * a, const void * b)
+{
+    size_t mask = ptrmap->mask_;
+    ptrmap__t * slots = ptrmap->slots_;
+    ptrmap__t * slot = ptrmap__slot(ptrmap, a, b);
+    size_t i = (size_t) (slot - slots), j = i;
+    void * data = slot->data_;
+
+    if (!data)
+        return NULL;
+
+    /*
+     * Shift back entries which follow in the same cluster, unless an entry
+     * is already at, or in between, its home slot and the empty slot.
+     */
+    while (1)
+    {
+        size_t home;
+        j = (j + 1) & mask;
+        if (!slots[j].data_)
+            break;
+        home = ptrmap__hash(slots[j].a_, slots[j].b_) & mask;
+        if (((j - home) & mask) < ((j - i) & mask))
+            continue;
+        slots[i] = slots[j];
+        i = j;
+    }
+    slots[i].data_ = NULL;
+
+    if (--ptrmap->n * 8 < mask + 1 && mask + 1 > PTRMAP_MIN_SZ)
+        (void) ptrmap__resize(ptrmap, (mask + 1) / 2);
+
+    return data;
+}
@@ -3,11 +3,16 @@
  */
 #include <errno.h>
 #include <ex.h>
+#include <fcntl.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <util/logger.h>
+#include <util/sha256.h>
 #include <util/syncpart.h>
+#include <zlib.h>
 
 /*
  * Returns 0 if the file is complete, 1 if more data is available and -1 on
@@ -34,7 +39,8 @@ int syncpart_to_pk(msgpack_packer * pk, const char * fn, off_t offset)
 
     if (offset > restsz)
     {
-        log_critical("got an illegal offset for file `%s` (%zd)", fn, offset);
+        log_critical("got an illegal offset for file `%s` (%jd)",
+                fn, (intmax_t) offset);
         goto fail1;
     }
 
@@ -145,3 +151,160 @@ done:
     return e->nr;
 }
 
+
+/*
+ * Write `data` at `offset` to file `fn` and set the file size to `fsize`. The
+ * file will be created when it does not exist.
+ */
+int syncpart_write_at(
+        const char * fn,
+        const unsigned char * data,
+        size_t size,
+        off_t offset,
+        off_t fsize,
+        ex_t * e)
+{
+    char ebuf[512];
+    ssize_t n;
+    int fd = open(fn, O_WRONLY|O_CREAT, 0666);
+    if (fd < 0)
+    {
+        /* lock is required for use of strerror */
+        ex_set(e, EX_INTERNAL,
+                "cannot open file `%s` (%s)",
+                fn, log_strerror(errno, ebuf, sizeof(ebuf)));
+        return e->nr;
+    }
+
+    if (ftruncate(fd, fsize))
+    {
+        ex_set(e, EX_INTERNAL,
+                "cannot set the size of file `%s` to %jd (%s)",
+                fn, (intmax_t) fsize, log_strerror(errno, ebuf, sizeof(ebuf)));
+        goto done;
+    }
+
+    while (size)
+    {
+        n = pwrite(fd, data, size, offset);
+        if (n <= 0)
+        {
+            ex_set(e, EX_INTERNAL, "error writing %zu bytes to file `%s`",
+                    size, fn);
+            goto done;
+        }
+        data += n;
+        size -= (size_t) n;
+        offset += n;
+    }
+
+done:
+    if (close(fd) && !e->nr)
+        ex_set(e, EX_INTERNAL, "cannot close file `%s` (%s)",
+                fn, log_strerror(errno, ebuf, sizeof(ebuf)));
+
+    return e->nr;
+}
+
+/*
+ * Write a SHA-256 digest of `SYNCPART_DIGEST_SIZE` bytes for the given data.
+ * A part is skipped when the digests are equal, so the digest must be
+ * collision resistant, also for data written by users.
+ */
+void syncpart_digest(
+        const unsigned char * data,
+        size_t size,
+        unsigned char * digest)
+{
+    sha256(data, size, digest);
+}
+
+/*
+ * Append a digest for each part of file `fn` to `buf` and set `fsize` to the
+ * size of the file. When the file does not exist, `fsize` is set to -1 and
+ * no digests are written.
+ *
+ * Returns 0 on success or -1 in case of an error.
+ */
+int syncpart_digests(const char * fn, off_t * fsize, buf_t * buf)
+{
+    int rc = -1;
+    size_t n;
+    unsigned char digest[SYNCPART_DIGEST_SIZE];
+    unsigned char * buff;
+    FILE * fp = fopen(fn, "r");
+    if (!fp)
+    {
+        if (errno != ENOENT)
+        {
+            log_errno_file("cannot open file", errno, fn);
+            return -1;
+        }
+        *fsize = -1;
+        return 0;
+    }
+
+    buff = malloc(SYNCPART_SIZE);
+    if (!buff)
+    {
+        log_critical(EX_MEMORY_S);
+        goto done;
+    }
+
+    *fsize = 0;
+    while ((n = fread(buff, sizeof(char), SYNCPART_SIZE, fp)))
+    {
+        syncpart_digest(buff, n, digest);
+        if (buf_append(buf, (const char *) digest, SYNCPART_DIGEST_SIZE))
+        {
+            log_critical(EX_MEMORY_S);
+            goto done;
+        }
+        *fsize += n;
+    }
+
+    if (ferror(fp))
+        log_critical("cannot read from file `%s`", fn);
+    else
+        rc = 0;
+
+done:
+    free(buff);
+    if (fclose(fp))
+    {
+        log_errno_file("cannot close file", errno, fn);
+        rc = -1;
+    }
+    return rc;
+}
+
+/*
+ * Compress `data` into `dst` using zlib. Returns the compressed size, or 0 if
+ * the compressed data does not fit in `dst` or is not smaller than `size`,
+ * in which case the data should be sent uncompressed.
+ */
+size_t syncpart_compress(
+        const unsigned char * data,
+        size_t size,
+        unsigned char * dst,
+        size_t dst_size)
+{
+    uLongf n = (uLongf) dst_size;
+    return (compress2(dst, &n, data, (uLong) size, Z_BEST_SPEED) == Z_OK &&
+            n < size) ? (size_t) n : 0;
+}
+
+/*
+ * Decompress `data` into `dst`. Returns 0 on success or -1 if the data is
+ * invalid or the decompressed size is not equal to `dst_size`.
+ */
+int syncpart_decompress(
+        const unsigned char * data,
+        size_t size,
+        unsigned char * dst,
+        size_t dst_size)
+{
+    uLongf n = (uLongf) dst_size;
+    return (uncompress(dst, &n, data, (uLong) size) == Z_OK &&
+            n == dst_size) ? 0 : -1;
+}
@@ -0,0 +1,640 @@
+/*
+ * util/tzif.c
+ */
+#include <ctype.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <util/tzif.h>
+
+#define TZIF__MAX_FILE_SZ 0x100000
+#define TZIF__HDR_SZ 44
+
+/*
+ * Values used by the glibc mktime() implementation to search for a time
+ * with the requested `tm_isdst` value.
+ */
+#define TZIF__DST_STRIDE INT64_C(601200)
+#define TZIF__DST_BOUND (INT64_C(457243200) / 2 + TZIF__DST_STRIDE)
+
+typedef struct
+{
+    uint32_t isutcnt;
+    uint32_t isstdcnt;
+    uint32_t leapcnt;
+    uint32_t timecnt;
+    uint32_t typecnt;
+    uint32_t charcnt;
+} tzif__hdr_t;
+
+static inline uint32_t tzif__u32(const unsigned char * p)
+{
+    return  (uint32_t) p[0] << 24 |
+            (uint32_t) p[1] << 16 |
+            (uint32_t) p[2] << 8 |
+            (uint32_t) p[3];
+}
+
+static inline int64_t tzif__i64(const unsigned char * p)
+{
+    return (int64_t) ((uint64_t) tzif__u32(p) << 32 | tzif__u32(p + 4));
+}
+
+static inline int64_t tzif__floor_div(int64_t a, int64_t b)
+{
+    return a / b - (a % b < 0);
+}
+
+static inline _Bool tzif__is_leap(int64_t y)
+{
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+static inline int tzif__mdays(int64_t y, int m)
+{
+    static const int mdays[12] = {
+        31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+    };
+    return mdays[m-1] + (m == 2 && tzif__is_leap(y));
+}
+
+/*
+ * Days since 1970-01-01 for a date in the proleptic Gregorian calendar,
+ * month `m` must be in the range 1..12.
+ */
+static int64_t tzif__days(int64_t y, int m, int64_t d)
+{
+    int64_t era, yoe, doy, doe;
+
+    y -= m <= 2;
+    era = tzif__floor_div(y, 400);
+    yoe = y - era * 400;
+    doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static void tzif__civil(int64_t days, int64_t * y, int * m, int * d)
+{
+    int64_t era, doe, yoe, doy, mp;
+
+    days += 719468;
+    era = tzif__floor_div(days, 146097);
+    doe = days - era * 146097;
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    *d = (int) (doy - (153 * mp + 2) / 5 + 1);
+    *m = (int) (mp < 10 ? mp + 3 : mp - 9);
+    *y = yoe + era * 400 + (*m <= 2);
+}
+
+static inline int tzif__wday(int64_t days)
+{
+    /* 1970-01-01 was a Thursday */
+    return (int) (days + 4 - tzif__floor_div(days + 4, 7) * 7);
+}
+
+static int tzif__tm(int64_t ts, const tzif_type_t * type, struct tm * tm)
+{
+    int64_t t, days, secs, y;
+    int m, d;
+
+    if (ts < -(INT64_C(1) << 60) || ts > (INT64_C(1) << 60))
+        return -1;
+
+    t = ts + type->utoff;
+    days = tzif__floor_div(t, 86400);
+    secs = t - days * 86400;
+
+    tzif__civil(days, &y, &m, &d);
+    if (y - 1900 < INT_MIN || y - 1900 > INT_MAX)
+        return -1;
+
+    tm->tm_sec = (int) (secs % 60);
+    tm->tm_min = (int) (secs / 60 % 60);
+    tm->tm_hour = (int) (secs / 3600);
+    tm->tm_mday = d;
+    tm->tm_mon = m - 1;
+    tm->tm_year = (int) (y - 1900);
+    tm->tm_wday = tzif__wday(days);
+    tm->tm_yday = (int) (days - tzif__days(y, 1, 1));
+    tm->tm_isdst = (int) type->isdst;
+    tm->tm_gmtoff = type->utoff;
+    tm->tm_zone = type->abbr;
+    return 0;
+}
+
+/*
+ * Returns the local time in `tm` as seconds since the epoch, like it would
+ * be UTC. Fields out of their normal range are allowed.
+ */
+static int64_t tzif__local(const struct tm * tm)
+{
+    int64_t mon = tm->tm_mon;
+    int64_t y = (int64_t) tm->tm_year + 1900 + tzif__floor_div(mon, 12);
+
+    mon -= tzif__floor_div(mon, 12) * 12;
+
+    return  (tzif__days(y, (int) mon + 1, 1) + tm->tm_mday - 1) * 86400 +
+            tm->tm_hour * INT64_C(3600) +
+            tm->tm_min * INT64_C(60) +
+            tm->tm_sec;
+}
+
+static int64_t tzif__rule_day(const tzif_date_t * date, int64_t y)
+{
+    int64_t first;
+    int mday, mdays;
+
+    switch (date->kind)
+    {
+    case 'J':
+        /* Julian day 1..365, February 29 is never counted */
+        return tzif__days(y, 1, date->d) + (date->d >= 60 && tzif__is_leap(y));
+    case 'D':
+        /* zero based day 0..365, February 29 is counted */
+        return tzif__days(y, 1, 1) + date->d;
+    }
+
+    /* day `d` of week `w` in month `m`, week 5 is the last week */
+    first = tzif__days(y, date->m, 1);
+    mdays = tzif__mdays(y, date->m);
+    mday = (date->d - tzif__wday(first) + 7) % 7 + (date->w - 1) * 7;
+    while (mday >= mdays)
+        mday -= 7;
+
+    return first + mday;
+}
+
+static const tzif_type_t * tzif__rule_type(
+        const tzif_rule_t * rule,
+        int64_t ts)
+{
+    int64_t y, start, end;
+    int m, d;
+
+    if (!rule->has_dst)
+        return &rule->std;
+
+    tzif__civil(tzif__floor_div(ts + rule->std.utoff, 86400), &y, &m, &d);
+
+    start = tzif__rule_day(&rule->start, y) * 86400 +
+            rule->start.time - rule->std.utoff;
+    end = tzif__rule_day(&rule->end, y) * 86400 +
+            rule->end.time - rule->dst.utoff;
+
+    /* on the southern hemisphere, daylight saving time spans new year */
+    return start < end
+        ? (ts >= start && ts < end ? &rule->dst : &rule->std)
+        : (ts >= end && ts < start ? &rule->std : &rule->dst);
+}
+
+/*
+ * Returns the local time type for a time stamp using a binary search in the
+ * transition times. The footer rule is used after the last transition.
+ */
+static const tzif_type_t * tzif__type(tzif_t * tzif, int64_t ts)
+{
+    uint32_t lo, hi, mid;
+
+    if (!tzif->timecnt || ts < tzif->times[0])
+        return &tzif->types[0];
+
+    hi = tzif->timecnt - 1;
+    if (ts >= tzif->times[hi])
+        return tzif->rule
+            ? tzif__rule_type(tzif->rule, ts)
+            : &tzif->types[tzif->idx[hi]];
+
+    lo = 0;
+    while (hi - lo > 1)
+    {
+        mid = lo + (hi - lo) / 2;
+        if (tzif->times[mid] <= ts)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return &tzif->types[tzif->idx[lo]];
+}
+
+static const char * tzif__num(const char * s, int * num, int max)
+{
+    if (!isdigit((unsigned char) *s))
+        return NULL;
+
+    *num = 0;
+    while (isdigit((unsigned char) *s))
+    {
+        *num = *num * 10 + (*s++ - '0');
+        if (*num > max)
+            return NULL;
+    }
+    return s;
+}
+
+static const char * tzif__name(const char * s, char * abbr)
+{
+    size_t n = 0;
+
+    if (*s == '<')
+    {
+        for (++s; *s && *s != '>'; ++s, ++n)
+        {
+            if (n == TZIF_ABBR_SZ - 1)
+                return NULL;
+            abbr[n] = *s;
+        }
+        if (*s++ != '>')
+            return NULL;
+    }
+    else for (; isalpha((unsigned char) *s); ++s, ++n)
+    {
+        if (n == TZIF_ABBR_SZ - 1)
+            return NULL;
+        abbr[n] = *s;
+    }
+
+    abbr[n] = '\0';
+    return n < 3 ? NULL : s;
+}
+
+static const char * tzif__time(const char * s, int32_t * secs)
+{
+    int sign = 1, h, m = 0, sec = 0;
+
+    if (*s == '+' || *s == '-')
+        sign = *s++ == '-' ? -1 : 1;
+
+    if (!(s = tzif__num(s, &h, 167)))
+        return NULL;
+
+    if (*s == ':' && (!(s = tzif__num(s + 1, &m, 59)) ||
+        (*s == ':' && !(s = tzif__num(s + 1, &sec, 59)))))
+        return NULL;
+
+    *secs = sign * (h * 3600 + m * 60 + sec);
+    return s;
+}
+
+static const char * tzif__date(const char * s, tzif_date_t * date)
+{
+    date->kind = *s;
+    switch (*s)
+    {
+    case 'J':
+        if (!(s = tzif__num(s + 1, &date->d, 365)) || !date->d)
+            return NULL;
+        break;
+    case 'M':
+        if (!(s = tzif__num(s + 1, &date->m, 12)) || !date->m ||
+            *s != '.' ||
+            !(s = tzif__num(s + 1, &date->w, 5)) || !date->w ||
+            *s != '.' ||
+            !(s = tzif__num(s + 1, &date->d, 6)))
+            return NULL;
+        break;
+    default:
+        date->kind = 'D';
+        if (!(s = tzif__num(s, &date->d, 365)))
+            return NULL;
+    }
+
+    date->time = 7200;  /* default transition time is 02:00:00 */
+    return *s == '/' ? tzif__time(s + 1, &date->time) : s;
+}
+
+/*
+ * Parse a POSIX TZ string like `CET-1CEST,M3.5.0,M10.5.0/3`. Note that POSIX
+ * offsets are west of UTC, thus the reverse of the UTC offsets in TZif.
+ */
+static int tzif__rule(const char * s, tzif_rule_t * rule)
+{
+    int32_t offset;
+
+    if (!(s = tzif__name(s, rule->std_abbr)) ||
+        !(s = tzif__time(s, &offset)))
+        return -1;
+
+    rule->std.utoff = -offset;
+    rule->std.isdst = 0;
+    rule->std.abbr = rule->std_abbr;
+    rule->has_dst = *s != '\0';
+
+    if (!rule->has_dst)
+        return 0;
+
+    if (!(s = tzif__name(s, rule->dst_abbr)))
+        return -1;
+
+    rule->dst.utoff = rule->std.utoff + 3600;
+    rule->dst.isdst = 1;
+    rule->dst.abbr = rule->dst_abbr;
+
+    if (*s && *s != ',')
+    {
+        if (!(s = tzif__time(s, &offset)))
+            return -1;
+        rule->dst.utoff = -offset;
+    }
+
+    if (!*s)
+    {
+        /* no rule, POSIX defaults to the rules of the United States */
+        return -(!tzif__date("M3.2.0", &rule->start) ||
+                 !tzif__date("M11.1.0", &rule->end));
+    }
+
+    return -(*s != ',' ||
+             !(s = tzif__date(s + 1, &rule->start)) ||
+             *s != ',' ||
+             !(s = tzif__date(s + 1, &rule->end)) ||
+             *s);
+}
+
+static int tzif__hdr(
+        const unsigned char * data,
+        size_t n,
+        tzif__hdr_t * hdr,
+        size_t timesz,
+        size_t * sz)
+{
+    if (n < TZIF__HDR_SZ || memcmp(data, "TZif", 4))
+        return -1;
+
+    hdr->isutcnt = tzif__u32(data + 20);
+    hdr->isstdcnt = tzif__u32(data + 24);
+    hdr->leapcnt = tzif__u32(data + 28);
+    hdr->timecnt = tzif__u32(data + 32);
+    hdr->typecnt = tzif__u32(data + 36);
+    hdr->charcnt = tzif__u32(data + 40);
+
+    if (!hdr->typecnt || hdr->typecnt > 256 || !hdr->charcnt ||
+        hdr->timecnt > n || hdr->charcnt > n || hdr->leapcnt > n ||
+        hdr->isstdcnt > n || hdr->isutcnt > n)
+        return -1;
+
+    *sz = TZIF__HDR_SZ +
+            hdr->timecnt * timesz +
+            hdr->timecnt +
+            hdr->typecnt * 6 +
+            hdr->charcnt +
+            hdr->leapcnt * (timesz + 4) +
+            hdr->isstdcnt +
+            hdr->isutcnt;
+
+    return -(*sz > n);
+}
+
+static tzif_t * tzif__parse(const unsigned char * data, size_t n)
+{
+    tzif__hdr_t hdr;
+    tzif_t * tzif;
+    tzif_rule_t rule;
+    const unsigned char * p, * end;
+    size_t sz, timesz = 4;
+    _Bool has_rule = 0;
+    char * pt;
+
+    if (tzif__hdr(data, n, &hdr, timesz, &sz))
+        return NULL;
+
+    if (data[4] >= '2')
+    {
+        /* skip the 32-bit data; version 2+ has a 64-bit data block */
+        data += sz;
+        n -= sz;
+        timesz = 8;
+        if (tzif__hdr(data, n, &hdr, timesz, &sz))
+            return NULL;
+
+        /* footer with a POSIX TZ string between two new lines */
+        p = data + sz;
+        end = data + n;
+        if (p < end && *p == '\n')
+        {
+            char buf[128];
+            size_t len;
+            const unsigned char * nl;
+
+            ++p;
+            nl = memchr(p, '\n', (size_t) (end - p));
+            len = nl ? (size_t) (nl - p) : 0;
+            if (len >= sizeof(buf))
+                return NULL;
+
+            if (len)
+            {
+                memcpy(buf, p, len);
+                buf[len] = '\0';
+                memset(&rule, 0, sizeof(tzif_rule_t));
+                if (tzif__rule(buf, &rule))
+                    return NULL;
+                has_rule = 1;
+            }
+        }
+    }
+
+    /* one allocation for the zone, its rule and all arrays */
+    tzif = malloc(
+            sizeof(tzif_t) +
+            sizeof(tzif_rule_t) +
+            hdr.timecnt * sizeof(int64_t) +
+            hdr.typecnt * sizeof(tzif_type_t) +
+            hdr.timecnt +
+            hdr.charcnt + 1);
+    if (!tzif)
+        return NULL;
+
+    tzif->timecnt = hdr.timecnt;
+    tzif->typecnt = hdr.typecnt;
+    tzif->rule = (tzif_rule_t *) (tzif + 1);
+    tzif->times = (int64_t *) (tzif->rule + 1);
+    tzif->types = (tzif_type_t *) (tzif->times + hdr.timecnt);
+    tzif->idx = (uint8_t *) (tzif->types + hdr.typecnt);
+    tzif->chars = (char *) (tzif->idx + hdr.timecnt);
+
+    p = data + TZIF__HDR_SZ;
+    for (uint32_t i = 0; i < hdr.timecnt; ++i, p += timesz)
+    {
+        tzif->times[i] = timesz == 8
+            ? tzif__i64(p)
+            : (int64_t) (int32_t) tzif__u32(p);
+        if (i && tzif->times[i] <= tzif->times[i-1])
+            goto fail;
+    }
+
+    for (uint32_t i = 0; i < hdr.timecnt; ++i, ++p)
+    {
+        if (*p >= hdr.typecnt)
+            goto fail;
+        tzif->idx[i] = *p;
+    }
+
+    pt = tzif->chars;
+    memcpy(pt, p + hdr.typecnt * 6, hdr.charcnt);
+    pt[hdr.charcnt] = '\0';
+
+    for (uint32_t i = 0; i < hdr.typecnt; ++i, p += 6)
+    {
+        tzif_type_t * type = &tzif->types[i];
+        if (p[5] >= hdr.charcnt)
+            goto fail;
+        type->utoff = (int32_t) tzif__u32(p);
+        type->isdst = p[4] != 0;
+        type->abbr = pt + p[5];
+    }
+
+    if (has_rule)
+    {
+        memcpy(tzif->rule, &rule, sizeof(tzif_rule_t));
+        tzif->rule->std.abbr = tzif->rule->std_abbr;
+        tzif->rule->dst.abbr = tzif->rule->dst_abbr;
+    }
+    else
+        tzif->rule = NULL;
+
+    return tzif;
+
+fail:
+    free(tzif);
+    return NULL;
+}
+
+/*
+ * Load a TZif file. Returns NULL if the file cannot be read or is invalid.
+ */
+tzif_t * tzif_load(const char * fn)
+{
+    tzif_t * tzif = NULL;
+    unsigned char * data;
+    long sz;
+    FILE * fp = fopen(fn, "r");
+
+    if (!fp)
+        return NULL;
+
+    if (fseek(fp, 0, SEEK_END) || (sz = ftell(fp)) <= 0 ||
+        sz > TZIF__MAX_FILE_SZ || fseek(fp, 0, SEEK_SET))
+        goto done;
+
+    data = malloc((size_t) sz);
+    if (!data)
+        goto done;
+
+    if (fread(data, 1, (size_t) sz, fp) == (size_t) sz)
+        tzif = tzif__parse(data, (size_t) sz);
+
+    free(data);
+done:
+    (void) fclose(fp);
+    return tzif;
+}
+
+void tzif_destroy(tzif_t * tzif)
+{
+    free(tzif);
+}
+
+/*
+ * Like localtime_r(), returns 0 on success or -1 when the year does not fit
+ * in `tm`.
+ */
+int tzif_localtime(tzif_t * tzif, int64_t ts, struct tm * tm)
+{
+    return tzif__tm(ts, tzif__type(tzif, ts), tm);
+}
+
+static inline _Bool tzif__isdst_differ(int a, int b)
+{
+    return !a != !b && a >= 0 && b >= 0;
+}
+
+static inline _Bool tzif__type_eq(
+        const tzif_type_t * a,
+        const tzif_type_t * b)
+{
+    return a->utoff == b->utoff && a->isdst == b->isdst;
+}
+
+/*
+ * Like mktime(), the fields in `tm` are normalized and the time stamp is
+ * returned, or -1 when the result does not fit in `tm`.
+ *
+ * The semantics of glibc are preserved; when `tm_isdst` is not negative and
+ * does not match the local time, the UTC offset of the nearest time with the
+ * requested `tm_isdst` is used, or a one hour shift when no such time is
+ * found. For a time which does not exist, the offset before the transition
+ * is used and for an ambiguous time, daylight saving time is preferred
+ * unless `tm_isdst` asks for standard time.
+ */
+int64_t tzif_mktime(tzif_t * tzif, struct tm * tm)
+{
+    int isdst = tm->tm_isdst, want;
+    int64_t lt = tzif__local(tm), ta, tb, t;
+    const tzif_type_t * a = tzif__type(tzif, lt - 86400);
+    const tzif_type_t * b = tzif__type(tzif, lt + 86400);
+    const tzif_type_t * type;
+    _Bool va, vb;
+
+    ta = lt - a->utoff;
+    tb = lt - b->utoff;
+    va = tzif__type_eq(tzif__type(tzif, ta), a);
+    vb = tzif__type_eq(tzif__type(tzif, tb), b);
+
+    /* without a preference, daylight saving time wins for ambiguous times */
+    want = isdst < 0 && va && vb ? 1 : isdst;
+
+    t = ((vb && !va) || (va == vb &&
+            tzif__isdst_differ(want, (int) a->isdst) &&
+            !tzif__isdst_differ(want, (int) b->isdst))) ? tb : ta;
+
+    type = tzif__type(tzif, t);
+    if (tzif__isdst_differ(isdst, (int) type->isdst))
+    {
+        for (int64_t delta = TZIF__DST_STRIDE;
+             delta < TZIF__DST_BOUND;
+             delta += TZIF__DST_STRIDE)
+        {
+            for (int64_t dir = -1; dir <= 1; dir += 2)
+            {
+                const tzif_type_t * o = tzif__type(tzif, t + delta * dir);
+                if (!tzif__isdst_differ(isdst, (int) o->isdst))
+                {
+                    t = lt - o->utoff;
+                    goto found;
+                }
+            }
+        }
+
+        /* no time with the requested `tm_isdst` nearby; assume one hour */
+        t += 3600 * ((isdst == 0) - (type->isdst == 0));
+    }
+
+found:
+    return tzif__tm(t, tzif__type(tzif, t), tm) ? -1 : t;
+}
+
+/*
+ * Like gmtime_r() but for a fixed UTC offset in seconds.
+ */
+int tzif_gmtime(int64_t ts, int32_t utoff, struct tm * tm)
+{
+    tzif_type_t type = {
+            .utoff = utoff,
+            .isdst = 0,
+            .abbr = "UTC",
+    };
+    return tzif__tm(ts, &type, tm);
+}
+
+/*
+ * Like timegm(), returns -1 when the result does not fit in `tm`.
+ */
+int64_t tzif_timegm(struct tm * tm)
+{
+    int64_t ts = tzif__local(tm);
+    return tzif_gmtime(ts, 0, tm) ? -1 : ts;
+}
@@ -36,6 +36,13 @@ uint64_t util_now_usec(void)
     return util__now.tv_sec;
 }
 
+/* Returns the current UNIX time-stamp in milliseconds */
+uint64_t util_now_msec(void)
+{
+    (void) clock_gettime(CLOCK_REALTIME, &util__now);
+    return (uint64_t) util__now.tv_sec * 1000 + util__now.tv_nsec / 1000000;
+}
+
 /* Returns the current UNIX time-stamp in seconds */
 time_t util_now_tsec(void)
 {
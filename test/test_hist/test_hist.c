@@ -0,0 +1,70 @@
+#include "../test.h"
+#include <util/hist.h>
+
+
+static int test_hist_quantile(void)
+{
+    test_start("hist (quantile)");
+
+    hist_t * hist = hist_create();
+    _assert (hist);
+    _assert (hist_quantile(hist, 0.99) == 0.0);
+
+    /* 1..1000 milli-seconds */
+    for (int i = 1; i <= 1000; ++i)
+        hist_add(hist, i / 1000.0);
+
+    _assert (hist->count == 1000);
+    _assert (hist->max == 1.0);
+
+    double p50 = hist_quantile(hist, 0.5);
+    double p99 = hist_quantile(hist, 0.99);
+    double p999 = hist_quantile(hist, 0.999);
+
+    /* values have a relative error of at most 1/HIST_SUB */
+    _assert (p50 >= 0.5 && p50 <= 0.5 * (1.0 + 1.0 / HIST_SUB));
+    _assert (p99 >= 0.99 && p99 <= 1.0);
+    _assert (p999 >= 0.999 && p999 <= 1.0);
+    _assert (hist_quantile(hist, 1.0) == 1.0);
+
+    hist_reset(hist);
+    _assert (hist->count == 0);
+    _assert (hist_quantile(hist, 0.5) == 0.0);
+
+    hist_destroy(hist);
+    return test_end();
+}
+
+static int test_hist_bounds(void)
+{
+    test_start("hist (bounds)");
+
+    hist_t * hist = hist_create();
+    _assert (hist);
+
+    hist_add(hist, 0.0);
+    hist_add(hist, -1.0);
+    _assert (hist->buckets[0] == 2);
+
+    /* values larger than the range are added to the last bucket */
+    hist_add(hist, 1e9);
+    _assert (hist->buckets[HIST_BUCKETS - 1] == 1);
+    _assert (hist_quantile(hist, 1.0) <= 1e9);
+
+    /* micro-second values below HIST_SUB are exact */
+    hist_reset(hist);
+    hist_add(hist, 0.0000055);
+    _assert (hist->buckets[5] == 1);
+
+    hist_destroy(hist);
+    return test_end();
+}
+
+int main()
+{
+    return (
+        test_hist_quantile() ||
+        test_hist_bounds() ||
+        0
+    );
+}
@@ -1,6 +1,17 @@
 #include "../test.h"
 #include <util/imap.h>
 
+static int collect_cb(void * data, vec_t ** vec)
+{
+    return vec_push(vec, data);
+}
+
+static int stop_cb(void * data, size_t * n)
+{
+    (void) data;
+    return !--(*n);
+}
+
 int main()
 {
     test_start("imap");
@@ -20,5 +31,62 @@ int main()
 
     imap_destroy(imap, NULL);
 
+    /* test walk after */
+    {
+        static uint64_t ids[] = {1, 2, 31, 32, 33, 64, 1000, 1023, 1024, 1025,
+                                 33000, 70000, 1234567, 987654321};
+        size_t i, n = sizeof(ids) / sizeof(uint64_t);
+        vec_t * all = vec_new(n);
+        vec_t * after;
+
+        imap = imap_create();
+        _assert (imap);
+        _assert (all);
+
+        for (i = 0; i < n; ++i)
+            _assert (imap_add(imap, ids[i], &ids[i]) == IMAP_SUCCESS);
+
+        _assert (imap_walk(imap, (imap_cb) collect_cb, &all) == 0);
+        _assert (all->n == n);
+
+        /* zero is never used as id, walking after zero walks all items */
+        after = vec_new(n);
+        _assert (imap_walk_after(imap, 0, (imap_cb) collect_cb, &after) == 0);
+        _assert (after->n == n);
+        free(after);
+
+        for (i = 0; i < n; ++i)
+        {
+            id = *((uint64_t *) vec_get(all, i));
+            after = vec_new(n);
+            _assert (after);
+            _assert (imap_walk_after(
+                    imap, id, (imap_cb) collect_cb, &after) == 0);
+            _assert (after->n == n - i - 1);
+            for (size_t j = 0; j < after->n; ++j)
+                _assert (vec_get(after, j) == vec_get(all, i + j + 1));
+            free(after);
+        }
+
+        /* continue after an id which is removed from the map */
+        id = *((uint64_t *) vec_get(all, 5));
+        _assert (imap_pop(imap, id) != NULL);
+
+        after = vec_new(n);
+        _assert (imap_walk_after(imap, id, (imap_cb) collect_cb, &after) == 0);
+        _assert (after->n == n - 6);
+        for (size_t j = 0; j < after->n; ++j)
+            _assert (vec_get(after, j) == vec_get(all, j + 6));
+        free(after);
+
+        /* walking stops when the callback returns a non zero value */
+        i = 3;
+        _assert (imap_walk_after(imap, 0, (imap_cb) stop_cb, &i) == 1);
+        _assert (i == 0);
+
+        free(all);
+        imap_destroy(imap, NULL);
+    }
+
     return test_end();
 }
@@ -0,0 +1,312 @@
+#include "../test.h"
+#include <stdint.h>
+#include <util/jsonp.h>
+#include <yajl/yajl_parse.h>
+
+static int test_jsonp_tokens(void)
+{
+    test_start("jsonp (tokens)");
+
+    jsonp_t jp;
+    const char * doc =
+        " {\"name\": \"Iris\", \"age\": 6, \"h\": 1.25, \"n\": null,\n"
+        "  \"list\": [true, false, -12, {}], \"x\": []} ";
+
+    jsonp_init(&jp, doc, strlen(doc));
+    _assert (jsonp_next(&jp) == JSONP_MAP_START);
+    _assert (jsonp_next(&jp) == JSONP_KEY);
+    _assert (jp.n == 4 && memcmp(jp.str, "name", 4) == 0);
+    _assert (jsonp_next(&jp) == JSONP_STR);
+    _assert (jp.n == 4 && memcmp(jp.str, "Iris", 4) == 0);
+    _assert (jsonp_next(&jp) == JSONP_KEY);
+    _assert (jsonp_next(&jp) == JSONP_INT && jp.via.i64 == 6);
+    _assert (jsonp_next(&jp) == JSONP_KEY);
+    _assert (jsonp_next(&jp) == JSONP_FLOAT && jp.via.f64 == 1.25);
+    _assert (jsonp_next(&jp) == JSONP_KEY);
+    _assert (jsonp_next(&jp) == JSONP_NULL);
+    _assert (jsonp_next(&jp) == JSONP_KEY);
+    _assert (jsonp_next(&jp) == JSONP_ARR_START && jp.deep == 2);
+    _assert (jsonp_next(&jp) == JSONP_TRUE);
+    _assert (jsonp_next(&jp) == JSONP_FALSE);
+    _assert (jsonp_next(&jp) == JSONP_INT && jp.via.i64 == -12);
+    _assert (jsonp_next(&jp) == JSONP_MAP_START && jp.deep == 3);
+    _assert (jsonp_next(&jp) == JSONP_MAP_END && jp.deep == 2);
+    _assert (jsonp_next(&jp) == JSONP_ARR_END && jp.deep == 1);
+    _assert (jsonp_next(&jp) == JSONP_KEY);
+    _assert (jsonp_next(&jp) == JSONP_ARR_START);
+    _assert (jsonp_next(&jp) == JSONP_ARR_END);
+    _assert (jsonp_next(&jp) == JSONP_MAP_END && jp.deep == 0);
+    _assert (jsonp_next(&jp) == JSONP_END);
+    _assert (jsonp_next(&jp) == JSONP_END);
+    jsonp_clear(&jp);
+
+    jsonp_init(&jp, "  ", 2);
+    _assert (jsonp_next(&jp) == JSONP_END);
+    jsonp_clear(&jp);
+
+    jsonp_init(&jp, "42", 2);
+    _assert (jsonp_next(&jp) == JSONP_INT && jp.via.i64 == 42);
+    _assert (jsonp_next(&jp) == JSONP_END);
+    jsonp_clear(&jp);
+
+    return test_end();
+}
+
+static int test_jsonp_strings(void)
+{
+    test_start("jsonp (strings)");
+
+    jsonp_t jp;
+    const char * doc =
+        "[\"a long string without any escape sequences\", "
+        "\"tab\\tquote\\\" slash\\/ back\\\\\", "
+        "\"\\u00e9\\u20ac\\ud83d\\ude00\", "
+        "\"\\ud83d!\", "
+        "\"caf\xc3\xa9 in a longer UTF-8 string\"]";
+
+    jsonp_init(&jp, doc, strlen(doc));
+    _assert (jsonp_next(&jp) == JSONP_ARR_START);
+    _assert (jsonp_next(&jp) == JSONP_STR);
+    _assert (jp.n == 42);
+    _assert (jp.str > doc && jp.str < doc + strlen(doc));  /* no copy */
+    _assert (jsonp_next(&jp) == JSONP_STR);
+    _assert (jp.n == 23 && memcmp(
+            jp.str, "tab\tquote\" slash/ back\\", 23) == 0);
+    _assert (jsonp_next(&jp) == JSONP_STR);
+    _assert (jp.n == 9 && memcmp(
+            jp.str, "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80", 9) == 0);
+    _assert (jsonp_next(&jp) == JSONP_STR);
+    _assert (jp.n == 2 && memcmp(jp.str, "?!", 2) == 0);
+    _assert (jsonp_next(&jp) == JSONP_STR);
+    _assert (jp.n == 30);
+    _assert (jsonp_next(&jp) == JSONP_ARR_END);
+    _assert (jsonp_next(&jp) == JSONP_END);
+    jsonp_clear(&jp);
+
+    return test_end();
+}
+
+static int test_jsonp_numbers(void)
+{
+    test_start("jsonp (numbers)");
+
+    jsonp_t jp;
+    const char * doc =
+        "[0, -0, 9223372036854775807, -9223372036854775808, "
+        "1e3, -2.5E-1, 0.1]";
+
+    jsonp_init(&jp, doc, strlen(doc));
+    _assert (jsonp_next(&jp) == JSONP_ARR_START);
+    _assert (jsonp_next(&jp) == JSONP_INT && jp.via.i64 == 0);
+    _assert (jsonp_next(&jp) == JSONP_INT && jp.via.i64 == 0);
+    _assert (jsonp_next(&jp) == JSONP_INT && jp.via.i64 == INT64_MAX);
+    _assert (jsonp_next(&jp) == JSONP_INT && jp.via.i64 == INT64_MIN);
+    _assert (jsonp_next(&jp) == JSONP_FLOAT && jp.via.f64 == 1e3);
+    _assert (jsonp_next(&jp) == JSONP_FLOAT && jp.via.f64 == -0.25);
+    _assert (jsonp_next(&jp) == JSONP_FLOAT && jp.via.f64 == 0.1);
+    _assert (jsonp_next(&jp) == JSONP_ARR_END);
+    _assert (jsonp_next(&jp) == JSONP_END);
+    jsonp_clear(&jp);
+
+    return test_end();
+}
+
+static jsonp_err_t parse_err(const char * doc)
+{
+    jsonp_t jp;
+    jsonp_tp_t tp;
+
+    jsonp_init(&jp, doc, strlen(doc));
+    while ((tp = jsonp_next(&jp)) != JSONP_END && tp != JSONP_ERR);
+    jsonp_clear(&jp);
+    return jp.err;
+}
+
+static int test_jsonp_errors(void)
+{
+    test_start("jsonp (errors)");
+
+    char deep[JSONP_MAX_DEPTH + 1];
+    memset(deep, '[', JSONP_MAX_DEPTH);
+    deep[JSONP_MAX_DEPTH] = '\0';
+
+    _assert (parse_err("[1, 2]") == JSONP_ERR_NONE);
+    _assert (parse_err("[1, 2") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[1 2]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[1, ..]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[1,]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("{\"a\" 1}") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("{1: 1}") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("{\"a\": 1]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[1] 2") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[tru]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[01]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[-]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[1.]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[1e]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[9223372036854775808]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[1e999]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[\"a\\x\"]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[\"\\u12g4\"]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[\"new\nline\"]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[\"invalid \xc3\x28 utf-8\"]") == JSONP_ERR_SYNTAX);
+    _assert (parse_err("[\"unterminated") == JSONP_ERR_SYNTAX);
+    _assert (parse_err(deep) == JSONP_ERR_MAX_DEPTH);
+    _assert (parse_err(deep + 1) == JSONP_ERR_SYNTAX);  /* premature EOF */
+
+    return test_end();
+}
+
+/*
+ * The benchmarks below parse the same generated document with yajl, using
+ * callbacks, and with the pull parser.
+ */
+#define BENCH_N 10
+
+static char * bench_doc(size_t * n)
+{
+    size_t sz = 1 << 22, i = 0;
+    char * doc = malloc(sz);
+    if (!doc)
+        return NULL;
+
+    doc[i++] = '[';
+    for (int k = 0; i < sz - 256; ++k)
+        i += sprintf(doc + i,
+                "%s{\"id\": %d, \"name\": \"item with a longer name %d\", "
+                "\"price\": %d.%02d, "
+                "\"tags\": [\"one\", \"two\", \"\\u00e9\"], "
+                "\"active\": %s, \"parent\": null}",
+                k ? ", " : "", k, k, k % 1000, k % 100,
+                k & 1 ? "true" : "false");
+    doc[i++] = ']';
+    *n = i;
+    return doc;
+}
+
+static int bench__count(void * ctx)
+{
+    ++*(size_t *) ctx;
+    return 1;
+}
+
+static int bench__bool(void * ctx, int b)
+{
+    *(size_t *) ctx += 1 + b;
+    return 1;
+}
+
+static int bench__int(void * ctx, long long i)
+{
+    *(size_t *) ctx += 1 + (i & 1);
+    return 1;
+}
+
+static int bench__double(void * ctx, double d)
+{
+    *(size_t *) ctx += 1 + (d > 1.0);
+    return 1;
+}
+
+static int bench__str(void * ctx, const unsigned char * s, size_t n)
+{
+    *(size_t *) ctx += 1 + n + (s[0] & 1);
+    return 1;
+}
+
+static yajl_callbacks bench__callbacks = {
+    bench__count,
+    bench__bool,
+    bench__int,
+    bench__double,
+    NULL,
+    bench__str,
+    bench__count,
+    bench__str,
+    bench__count,
+    bench__count,
+    bench__count,
+};
+
+static size_t bench_yajl(const char * doc, size_t n)
+{
+    size_t count = 0;
+    yajl_handle hand = yajl_alloc(&bench__callbacks, NULL, &count);
+    if (!hand ||
+        yajl_parse(hand, (const unsigned char *) doc, n) != yajl_status_ok ||
+        yajl_complete_parse(hand) != yajl_status_ok)
+        count = 0;
+    yajl_free(hand);
+    return count;
+}
+
+static size_t bench_jsonp(const char * doc, size_t n)
+{
+    size_t count = 0;
+    jsonp_t jp;
+    jsonp_tp_t tp;
+
+    jsonp_init(&jp, doc, n);
+    while ((tp = jsonp_next(&jp)) != JSONP_END)
+    {
+        switch (tp)
+        {
+        case JSONP_ERR:
+            jsonp_clear(&jp);
+            return 0;
+        case JSONP_TRUE:
+            count += 2;
+            break;
+        case JSONP_FALSE:
+            count += 1;
+            break;
+        case JSONP_INT:
+            count += 1 + (jp.via.i64 & 1);
+            break;
+        case JSONP_FLOAT:
+            count += 1 + (jp.via.f64 > 1.0);
+            break;
+        case JSONP_STR:
+        case JSONP_KEY:
+            count += 1 + jp.n + (jp.str[0] & 1);
+            break;
+        default:
+            ++count;
+        }
+    }
+    jsonp_clear(&jp);
+    return count;
+}
+
+static int test_jsonp_bench(void)
+{
+    size_t n = 0, expect;
+    char * doc = bench_doc(&n);
+
+    test_start("jsonp (benchmark yajl)");
+    _assert (doc);
+    expect = bench_yajl(doc, n);
+    _assert (expect);
+    for (int i = 1; i < BENCH_N; ++i)
+        _assert (bench_yajl(doc, n) == expect);
+    test_end();
+
+    test_start("jsonp (benchmark)");
+    for (int i = 0; i < BENCH_N; ++i)
+        _assert (bench_jsonp(doc, n) == expect);
+    free(doc);
+
+    return test_end();
+}
+
+int main()
+{
+    return (
+        test_jsonp_tokens() ||
+        test_jsonp_strings() ||
+        test_jsonp_numbers() ||
+        test_jsonp_errors() ||
+        test_jsonp_bench() ||
+        0
+    );
+}
@@ -0,0 +1,276 @@
+#include "../test.h"
+#include <cleri/cleri.h>
+#include <cleri/rxscan.h>
+#include <langdef/langdef.h>
+#include <pthread.h>
+#include <time.h>
+
+#define PARSE_ITERATIONS 200
+#define PARSE_THREADS 4
+#define PARSE_THREAD_ITERATIONS 5
+#define PARSE_LARGE_SZ 65536
+
+static const char * rxscan__patterns[] = {
+    "^[A-Za-z_][0-9A-Za-z_]{0,254}(?![0-9A-Za-z_])",
+    "^[-+]?((0b[01]+)|(0o[0-8]+)|(0x[0-9a-fA-F]+)|([0-9]+))"
+    "(?![0-9A-Za-z_\\.])",
+    "^[-+]?(inf|nan|[0-9]*\\.[0-9]+(e[+-][0-9]+)?)(?![0-9A-Za-z_\\.])",
+    "^(((?:\'(?:[^\']*)\')+)|((?:\"(?:[^\"]*)\")+))",
+    "^/((?:.(?!(?<![\\\\])/))*.?)/[a-z]*",
+    "^(\\s*~)*(\\s*!|\\s*[\\-+](?=[^0-9]))*",
+    "^([^`{}]|``|{{|}})+",
+};
+
+static const char * rxscan__strings[] = {
+    "", "a", "_", "a1", "1a", "name_123 ", "x.y", "0", "-1", "+12", "-",
+    "0b101", "0b2", "0o17", "0o9", "0x1f", "0xg", "12a", "12.", "12_",
+    ".5", "-.5", "1.5e+3", "1.5e3", "1.5e+", "inf", "-nan", "info", "1.2.3",
+    "'a'", "'a''b'", "'a", "\"a\"\"\"", "\"", "''", "'it''s' x",
+    "/a/", "/a/i", "//", "/a\\/b/g", "/a\\/", "/a\nb/", "/\\//", "/a",
+    "~", " ~ ~!", "-a", "-1", "+ a", "!!x", "- ", "-",
+    "abc", "a``b", "a{{b}}", "a{b", "`", "}}",
+};
+
+static int test_langdef_rxscan(void)
+{
+    test_start("langdef (native scanners)");
+
+    size_t np = sizeof(rxscan__patterns) / sizeof(rxscan__patterns[0]);
+    size_t ns = sizeof(rxscan__strings) / sizeof(rxscan__strings[0]);
+
+    for (size_t i = 0; i < np; ++i)
+    {
+        int err;
+        PCRE2_SIZE offset;
+        pcre2_code * re = pcre2_compile(
+                (PCRE2_SPTR8) rxscan__patterns[i],
+                PCRE2_ZERO_TERMINATED,
+                0,
+                &err,
+                &offset,
+                NULL);
+        pcre2_match_data * md =
+                pcre2_match_data_create_from_pattern(re, NULL);
+        cleri_rxscan_t kind = cleri__rxscan_kind(rxscan__patterns[i]);
+
+        _assert (kind != CLERI_RXSCAN_NONE);
+
+        for (size_t j = 0; j < ns; ++j)
+        {
+            const char * s = rxscan__strings[j];
+            int rc = pcre2_match(
+                    re,
+                    (PCRE2_SPTR8) s,
+                    PCRE2_ZERO_TERMINATED,
+                    0,
+                    0,
+                    md,
+                    NULL);
+            ssize_t n = rc < 0
+                    ? -1
+                    : (ssize_t) pcre2_get_ovector_pointer(md)[1];
+            _assert (cleri__rxscan(kind, s) == n);
+        }
+
+        pcre2_match_data_free(md);
+        pcre2_code_free(re);
+    }
+
+    _assert (cleri__rxscan_kind("^[a-z]+") == CLERI_RXSCAN_NONE);
+
+    return test_end();
+}
+
+/*
+ * Queries as they are used by clients, most of them are short and below the
+ * default `threshold_query_cache`.
+ */
+static const char * parse__corpus[] = {
+    "x = 1;",
+    ".greet = 'Hello world!';",
+    "users = .users.filter(|u| u.age > 18).map(|u| u.name);",
+    "new_type('Person'); set_type('Person', {name: 'str', age: 'int'});",
+    "Person{name: 'Iris', age: 6};",
+    ".list.push(1, 2, 3.5, -4, 0x1f, 0b101, true, nil);",
+    "if (.has('x')) { .x += 1; } else { .x = 0; };",
+    "range(10).reduce(|a, b| a + b, 0);",
+    "/^[a-z]+$/i.test('abc');",
+    "`Hello {name}, you are {age} years old`;",
+    "try(.get('missing'));",
+    "return .things.len(), 2;",
+    "for (x in range(5)) { if (x == 3) break; .total += x; };",
+    "!is_nil(.a) && (.b || ~.c) ? 'yes' : 'no';",
+    "datetime().extend({days: 1}).format('%Y-%m-%d');",
+    ".arr[1:3] = ['a', 'b'];",
+    "wse(); .counter += 1;",
+    "new_procedure('add', |a, b| a + b); run('add', 1, 2);",
+    "// comment\nx = \"double \"\" quotes\";\n",
+    "/* multi\n line */ nse(.id());",
+    "{a: 1, b: [1, 2, {c: 3}]}.keys();",
+    "(1 + 2) * -3 / 4 % 5 - +6;",
+    "thing(42).name;",
+    "e = err('oops'); is_err(e);",
+    "match = 'abc'.split('').map_id();",
+};
+
+static int test_langdef_parse(void)
+{
+    test_start("langdef (parse corpus)");
+
+    size_t nc = sizeof(parse__corpus) / sizeof(parse__corpus[0]);
+    size_t nbytes = 0;
+    struct timespec t0, t1;
+    double elapsed;
+    cleri_grammar_t * grammar = compile_langdef();
+
+    _assert (grammar);
+
+    for (size_t i = 0; i < nc; ++i)
+    {
+        cleri_parse_t * pr = cleri_parse2(
+                grammar,
+                parse__corpus[i],
+                CLERI_FLAG_EXPECTING_DISABLED|
+                CLERI_FLAG_EXCLUDE_OPTIONAL|
+                CLERI_FLAG_EXCLUDE_FM_CHOICE|
+                CLERI_FLAG_EXCLUDE_RULE_THIS);
+        _assert (pr && pr->is_valid);
+        cleri_parse_free(pr);
+        nbytes += strlen(parse__corpus[i]);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (size_t n = 0; n < PARSE_ITERATIONS; ++n)
+    {
+        for (size_t i = 0; i < nc; ++i)
+        {
+            cleri_parse_t * pr = cleri_parse2(
+                    grammar,
+                    parse__corpus[i],
+                    CLERI_FLAG_EXPECTING_DISABLED|
+                    CLERI_FLAG_EXCLUDE_OPTIONAL|
+                    CLERI_FLAG_EXCLUDE_FM_CHOICE|
+                    CLERI_FLAG_EXCLUDE_RULE_THIS);
+            cleri_parse_free(pr);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf("(%.0f queries/s, %.2f MB/s) ",
+            (nc * PARSE_ITERATIONS) / elapsed,
+            (nbytes * PARSE_ITERATIONS) / elapsed / 1e6);
+
+    cleri_grammar_free(grammar);
+    return test_end();
+}
+
+static size_t parse__count_nodes(cleri_node_t * node)
+{
+    size_t n = 1;
+    for (node = node->children; node; node = node->next)
+        n += parse__count_nodes(node);
+    return n;
+}
+
+typedef struct
+{
+    cleri_grammar_t * grammar;
+    const char * query;
+    size_t nodes;
+    int failed;
+} parse__thread_t;
+
+static void * parse__thread(void * arg)
+{
+    parse__thread_t * w = arg;
+    for (size_t n = 0; n < PARSE_THREAD_ITERATIONS; ++n)
+    {
+        cleri_parse_t * pr = cleri_parse2(
+                w->grammar,
+                w->query,
+                CLERI_FLAG_EXPECTING_DISABLED|
+                CLERI_FLAG_EXCLUDE_OPTIONAL|
+                CLERI_FLAG_EXCLUDE_FM_CHOICE|
+                CLERI_FLAG_EXCLUDE_RULE_THIS);
+        if (!pr || !pr->is_valid || parse__count_nodes(pr->tree) != w->nodes)
+            w->failed = 1;
+        cleri_parse_free(pr);
+    }
+    return NULL;
+}
+
+/*
+ * Large queries are parsed on worker threads while the event loop continues;
+ * parsing must therefore not share state between parses of one grammar.
+ */
+static int test_langdef_parse_threads(void)
+{
+    test_start("langdef (parse on threads)");
+
+    size_t nc = sizeof(parse__corpus) / sizeof(parse__corpus[0]);
+    size_t n = 0;
+    struct timespec t0, t1;
+    pthread_t threads[PARSE_THREADS];
+    parse__thread_t w[PARSE_THREADS];
+    cleri_grammar_t * grammar = compile_langdef();
+    char * query = malloc(PARSE_LARGE_SZ + 256);
+    cleri_parse_t * pr;
+
+    _assert (grammar && query);
+
+    /* a single large query as it would be parsed on a worker thread */
+    for (size_t i = 0; n < PARSE_LARGE_SZ; i = (i + 1) % nc)
+    {
+        size_t sz = strlen(parse__corpus[i]);
+        memcpy(query + n, parse__corpus[i], sz);
+        n += sz;
+    }
+    query[n] = '\0';
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pr = cleri_parse2(
+            grammar,
+            query,
+            CLERI_FLAG_EXPECTING_DISABLED|
+            CLERI_FLAG_EXCLUDE_OPTIONAL|
+            CLERI_FLAG_EXCLUDE_FM_CHOICE|
+            CLERI_FLAG_EXCLUDE_RULE_THIS);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    _assert (pr && pr->is_valid);
+
+    for (int i = 0; i < PARSE_THREADS; ++i)
+    {
+        w[i].grammar = grammar;
+        w[i].query = query;
+        w[i].nodes = parse__count_nodes(pr->tree);
+        w[i].failed = 0;
+        _assert (pthread_create(&threads[i], NULL, parse__thread, &w[i]) == 0);
+    }
+
+    for (int i = 0; i < PARSE_THREADS; ++i)
+    {
+        pthread_join(threads[i], NULL);
+        _assert (!w[i].failed);
+    }
+
+    printf("(%zu bytes in %.3f ms) ",
+            n,
+            (t1.tv_sec - t0.tv_sec) * 1e3 + (t1.tv_nsec - t0.tv_nsec) / 1e6);
+
+    cleri_parse_free(pr);
+    cleri_grammar_free(grammar);
+    free(query);
+    return test_end();
+}
+
+int main()
+{
+    return (
+        test_langdef_rxscan() ||
+        test_langdef_parse() ||
+        test_langdef_parse_threads() ||
+        0
+    );
+}
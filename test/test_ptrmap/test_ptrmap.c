@@ -0,0 +1,84 @@
+#include "../test.h"
+#include <util/ptrmap.h>
+
+#define NUM_KEYS 1000
+#define NUM_NAMES 8
+
+static int keys[NUM_KEYS];
+static int names[NUM_NAMES];
+
+static int test_ptrmap_set_get(void)
+{
+    test_start("ptrmap (set/get)");
+
+    ptrmap_t * ptrmap = ptrmap_create();
+    _assert (ptrmap);
+
+    for (int i = 0; i < NUM_KEYS; ++i)
+        for (int j = 0; j < NUM_NAMES; ++j)
+            _assert (ptrmap_set(ptrmap, keys + i, names + j, names + j) == 0);
+
+    _assert (ptrmap->n == NUM_KEYS * NUM_NAMES);
+
+    for (int i = 0; i < NUM_KEYS; ++i)
+        for (int j = 0; j < NUM_NAMES; ++j)
+            _assert (ptrmap_get(ptrmap, keys + i, names + j) == names + j);
+
+    /* overwrite existing values */
+    _assert (ptrmap_set(ptrmap, keys, names, keys) == 0);
+    _assert (ptrmap->n == NUM_KEYS * NUM_NAMES);
+    _assert (ptrmap_get(ptrmap, keys, names) == keys);
+
+    /* the order of the key pair matters */
+    _assert (ptrmap_get(ptrmap, names, keys) == NULL);
+
+    ptrmap_destroy(ptrmap);
+
+    return test_end();
+}
+
+static int test_ptrmap_pop(void)
+{
+    test_start("ptrmap (pop)");
+
+    ptrmap_t * ptrmap = ptrmap_create();
+    _assert (ptrmap);
+
+    for (int i = 0; i < NUM_KEYS; ++i)
+        for (int j = 0; j < NUM_NAMES; ++j)
+            _assert (ptrmap_set(ptrmap, keys + i, names + j, keys + i) == 0);
+
+    /* remove every other key, which leaves gaps in the clusters */
+    for (int i = 0; i < NUM_KEYS; i += 2)
+        for (int j = 0; j < NUM_NAMES; ++j)
+            _assert (ptrmap_pop(ptrmap, keys + i, names + j) == keys + i);
+
+    _assert (ptrmap->n == NUM_KEYS * NUM_NAMES / 2);
+    _assert (ptrmap_pop(ptrmap, keys, names) == NULL);
+
+    for (int i = 0; i < NUM_KEYS; ++i)
+        for (int j = 0; j < NUM_NAMES; ++j)
+            _assert (ptrmap_get(ptrmap, keys + i, names + j) ==
+                    (i % 2 ? keys + i : NULL));
+
+    /* the map shrinks while entries are removed */
+    for (int i = 1; i < NUM_KEYS; i += 2)
+        for (int j = 0; j < NUM_NAMES; ++j)
+            _assert (ptrmap_pop(ptrmap, keys + i, names + j) == keys + i);
+
+    _assert (ptrmap->n == 0);
+    _assert (ptrmap->mask_ + 1 == PTRMAP_MIN_SZ);
+
+    ptrmap_destroy(ptrmap);
+
+    return test_end();
+}
+
+int main()
+{
+    return (
+        test_ptrmap_set_get() ||
+        test_ptrmap_pop() ||
+        0
+    );
+}
@@ -0,0 +1,67 @@
+#include "../test.h"
+#include <string.h>
+#include <util/sha256.h>
+
+
+static int sha256__eq(unsigned char * digest, const char * hex)
+{
+    char buf[SHA256_DIGEST_SIZE * 2 + 1];
+    for (int i = 0; i < SHA256_DIGEST_SIZE; ++i)
+        sprintf(buf + i * 2, "%02x", digest[i]);
+    return strcmp(buf, hex) == 0;
+}
+
+static int test_sha256_vectors(void)
+{
+    test_start("sha256 (vectors)");
+
+    unsigned char digest[SHA256_DIGEST_SIZE];
+
+    sha256("", 0, digest);
+    _assert (sha256__eq(digest,
+        "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+
+    sha256("abc", 3, digest);
+    _assert (sha256__eq(digest,
+        "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+
+    sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56,
+            digest);
+    _assert (sha256__eq(digest,
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+
+    return test_end();
+}
+
+static int test_sha256_update(void)
+{
+    test_start("sha256 (update)");
+
+    sha256_t ctx;
+    unsigned char digest[SHA256_DIGEST_SIZE];
+    char data[1000];
+
+    memset(data, 'a', sizeof(data));
+
+    /* one million times `a`, in chunks which are not block aligned */
+    sha256_init(&ctx);
+    for (int i = 0; i < 1000; ++i)
+    {
+        sha256_update(&ctx, data, 333);
+        sha256_update(&ctx, data, 667);
+    }
+    sha256_final(&ctx, digest);
+    _assert (sha256__eq(digest,
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+
+    return test_end();
+}
+
+int main()
+{
+    return (
+        test_sha256_vectors() ||
+        test_sha256_update() ||
+        0
+    );
+}
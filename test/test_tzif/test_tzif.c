@@ -0,0 +1,216 @@
+#include "../test.h"
+#include <time.h>
+#include <util/tzif.h>
+
+#define TZDIR "/usr/share/zoneinfo/"
+
+static const char * zones[] = {
+    "Europe/Amsterdam",
+    "America/New_York",
+    "Australia/Sydney",
+    "Asia/Kolkata",
+    "Europe/London",
+    "Pacific/Chatham",
+    "America/Sao_Paulo",
+    "Asia/Tehran",
+};
+
+static const size_t num_zones = sizeof(zones) / sizeof(*zones);
+
+static tzif_t * load(const char * name)
+{
+    char fn[256];
+    snprintf(fn, sizeof(fn), TZDIR"%s", name);
+    return tzif_load(fn);
+}
+
+static void set_env(const char * name)
+{
+    setenv("TZ", name, 1);
+    tzset();
+}
+
+static int test_tzif_localtime(void)
+{
+    test_start("tzif (localtime)");
+
+    for (size_t i = 0; i < num_zones; ++i)
+    {
+        tzif_t * tzif = load(zones[i]);
+        _assert (tzif);
+        set_env(zones[i]);
+
+        /* from 1900 until 2100, including times after the last transition */
+        for (time_t ts = -2208988800; ts < 4102444800; ts += 86400 * 3 + 7)
+        {
+            struct tm a, b;
+            _assert (localtime_r(&ts, &a) == &a);
+            _assert (tzif_localtime(tzif, ts, &b) == 0);
+            _assert (a.tm_year == b.tm_year);
+            _assert (a.tm_yday == b.tm_yday);
+            _assert (a.tm_wday == b.tm_wday);
+            _assert (a.tm_hour == b.tm_hour);
+            _assert (a.tm_min == b.tm_min);
+            _assert (a.tm_sec == b.tm_sec);
+            _assert (a.tm_isdst == b.tm_isdst);
+            _assert (a.tm_gmtoff == b.tm_gmtoff);
+            _assert (strcmp(a.tm_zone, b.tm_zone) == 0);
+        }
+        tzif_destroy(tzif);
+    }
+
+    _assert (load("Europe/Unknown") == NULL);
+    _assert (tzif_load(TZDIR) == NULL);
+
+    return test_end();
+}
+
+static int test_tzif_mktime(void)
+{
+    test_start("tzif (mktime)");
+
+    for (size_t i = 0; i < num_zones; ++i)
+    {
+        tzif_t * tzif = load(zones[i]);
+        _assert (tzif);
+        set_env(zones[i]);
+
+        for (time_t ts = -2208988800; ts < 4102444800; ts += 86400 * 5 + 7)
+        {
+            struct tm a, b;
+            _assert (localtime_r(&ts, &a) == &a);
+            a.tm_mday += 3;
+            a.tm_isdst = -1;
+            b = a;
+            _assert (mktime(&a) == tzif_mktime(tzif, &b));
+            _assert (a.tm_mday == b.tm_mday);
+            _assert (a.tm_gmtoff == b.tm_gmtoff);
+        }
+        tzif_destroy(tzif);
+    }
+
+    {
+        tzif_t * tzif = load("Europe/Amsterdam");
+        struct tm tm = {0};
+
+        /* summer time, while standard time is asked */
+        tm.tm_year = 78;
+        tm.tm_mon = 7;
+        tm.tm_mday = 7;
+        tm.tm_hour = 15;
+        tm.tm_min = 28;
+        tm.tm_sec = 30;
+        _assert (tzif_mktime(tzif, &tm) == 271348110);
+        _assert (tm.tm_hour == 16);
+        _assert (tm.tm_gmtoff == 7200);
+
+        /* time which does not exist */
+        memset(&tm, 0, sizeof(struct tm));
+        tm.tm_year = 121;
+        tm.tm_mon = 2;
+        tm.tm_mday = 28;
+        tm.tm_hour = 2;
+        tm.tm_min = 30;
+        tm.tm_isdst = -1;
+        _assert (tzif_mktime(tzif, &tm) == 1616895000);
+        _assert (tm.tm_hour == 3);
+
+        /* ambiguous time */
+        memset(&tm, 0, sizeof(struct tm));
+        tm.tm_year = 121;
+        tm.tm_mon = 9;
+        tm.tm_mday = 31;
+        tm.tm_hour = 2;
+        tm.tm_min = 30;
+        tm.tm_isdst = -1;
+        _assert (tzif_mktime(tzif, &tm) == 1635640200);
+        _assert (tm.tm_isdst == 1);
+
+        tm.tm_isdst = 0;
+        _assert (tzif_mktime(tzif, &tm) == 1635640200 + 3600);
+        _assert (tm.tm_isdst == 0);
+
+        tzif_destroy(tzif);
+    }
+
+    {
+        struct tm tm = {0};
+        tm.tm_year = 70;
+        tm.tm_mon = 13;
+        tm.tm_mday = 1;
+        _assert (tzif_timegm(&tm) == 34214400);
+        _assert (tm.tm_year == 71 && tm.tm_mon == 1);
+
+        _assert (tzif_gmtime(0, -5400, &tm) == 0);
+        _assert (tm.tm_year == 69 && tm.tm_hour == 22 && tm.tm_min == 30);
+        _assert (tm.tm_gmtoff == -5400);
+    }
+
+    return test_end();
+}
+
+/*
+ * The benchmarks below convert times in alternating zones, which is what
+ * a query does when it formats date/time values from multiple zones.
+ */
+#define BENCH_N 20000
+
+static int test_tzif_bench_libc(void)
+{
+    test_start("tzif (benchmark libc)");
+
+    time_t sum = 0;
+    for (int i = 0; i < BENCH_N; ++i)
+    {
+        struct tm tm;
+        time_t ts = 1600000000 + i * 3607;
+
+        set_env(zones[i % num_zones]);
+        _assert (localtime_r(&ts, &tm) == &tm);
+        tm.tm_mday += 1;
+        tm.tm_isdst = -1;
+        sum += mktime(&tm) - ts;
+    }
+    _assert (sum);
+
+    return test_end();
+}
+
+static int test_tzif_bench(void)
+{
+    tzif_t * tzifs[sizeof(zones) / sizeof(*zones)];
+    for (size_t i = 0; i < num_zones; ++i)
+        tzifs[i] = load(zones[i]);
+
+    test_start("tzif (benchmark)");
+
+    int64_t sum = 0;
+    for (int i = 0; i < BENCH_N; ++i)
+    {
+        struct tm tm;
+        int64_t ts = 1600000000 + i * 3607;
+        tzif_t * tzif = tzifs[i % num_zones];
+
+        _assert (tzif_localtime(tzif, ts, &tm) == 0);
+        tm.tm_mday += 1;
+        tm.tm_isdst = -1;
+        sum += tzif_mktime(tzif, &tm) - ts;
+    }
+    _assert (sum);
+
+    for (size_t i = 0; i < num_zones; ++i)
+        tzif_destroy(tzifs[i]);
+
+    return test_end();
+}
+
+int main()
+{
+    return (
+        test_tzif_localtime() ||
+        test_tzif_mktime() ||
+        test_tzif_bench_libc() ||
+        test_tzif_bench() ||
+        0
+    );
+}